@@ -27,15 +27,26 @@
 
 #include <vle/manager/Manager.hpp>
 #include <vle/manager/ExperimentGenerator.hpp>
+#include <vle/manager/ExperimentTemplate.hpp>
+#include <vle/manager/Simulation.hpp>
+#include <vle/value/Binary.hpp>
+#include <vle/value/Map.hpp>
+#include <vle/value/Matrix.hpp>
+#include <vle/vpz/BaseModel.hpp>
 #include <vle/utils/Tools.hpp>
 #include <vle/utils/Path.hpp>
 #include <vle/utils/Package.hpp>
 #include <vle/utils/i18n.hpp>
 #include <vle/version.hpp>
 #include <vle/vle.hpp>
+#include <algorithm>
+#include <fstream>
 #include <iostream>
+#include <stdexcept>
+#include <vector>
 #include <cstdio>
 #include <cstdarg>
+#include <cstdlib>
 #include <cstring>
 
 #define OMPI_SKIP_MPICXX
@@ -157,14 +168,30 @@ bool mvle_mpi_init(int *argc, char ***argv, uint32_t *rank, uint32_t *world)
     return result;
 }
 
-bool mvle_parse_arg(int argc, char **argv, int *vpz, bool *show,
+/**
+ * Options of the command line.
+ */
+struct mvle_options
+{
+    mvle_options()
+        : show(false), dynamic(false), batch(1)
+    {
+    }
+
+    bool show;
+    bool dynamic;
+    uint32_t batch;
+    std::string output;
+};
+
+bool mvle_parse_arg(int argc, char **argv, int *vpz, mvle_options *options,
         vle::utils::Package& pack)
 {
     int i = 1;
 
     while (i < argc) {
         if ((std::strcmp(argv[i], "-P") == 0 or
-             std::strcmp(argv[i], "--package") == 0) and i + 1 <= argc) {
+             std::strcmp(argv[i], "--package") == 0) and i + 1 < argc) {
             pack.select(argv[++i]);
         } else if (std::strcmp(argv[i], "-h") == 0 or
                    std::strcmp(argv[i], "--help") == 0) {
@@ -176,9 +203,24 @@ bool mvle_parse_arg(int argc, char **argv, int *vpz, bool *show,
             return false;
         } else if (std::strcmp(argv[i], "-s") == 0 or
                    std::strcmp(argv[i], "--show") == 0) {
-            *show = true;
+            options->show = true;
+        } else if (std::strcmp(argv[i], "-d") == 0 or
+                   std::strcmp(argv[i], "--dynamic") == 0) {
+            options->dynamic = true;
+        } else if ((std::strcmp(argv[i], "-b") == 0 or
+                    std::strcmp(argv[i], "--batch") == 0) and i + 1 < argc) {
+            int batch = std::atoi(argv[++i]);
+            if (batch <= 0) {
+                mvle_print_error(_("bad batch size: %s"), argv[i]);
+                return false;
+            }
+            options->batch = batch;
+        } else if ((std::strcmp(argv[i], "-o") == 0 or
+                    std::strcmp(argv[i], "--output") == 0) and i + 1 < argc) {
+            options->output = argv[++i];
         } else {
             *vpz = i;
+            break;
         }
         ++i;
     }
@@ -226,20 +268,356 @@ void mvle_show(const std::string& vpz)
     }
 }
 
+/*
+ * The dynamic mode: the node 0 is a coordinator which sends on demand
+ * batches of combinations [first, last) to the other nodes (the workers)
+ * and receives the results of the simulations.
+ */
+
+enum mvle_tag {
+    MVLE_TAG_REQUEST = 1, /**< worker to coordinator: ask for work. */
+    MVLE_TAG_WORK,        /**< coordinator to worker: a batch, empty to
+                           * stop. */
+    MVLE_TAG_RESULT       /**< worker to coordinator: index, status and
+                           * result or error message of a simulation. */
+};
+
+/**
+ * Run the combinations of an experimental frame one by one. The
+ * experiments are built like the ones of the @c vle::manager::Manager,
+ * see @c vle::manager::ExperimentTemplate.
+ */
+class mvle_runner
+{
+public:
+    mvle_runner(const std::string& filename)
+        : m_vpz(filename), m_expgen(m_vpz, 0, 1), m_base(m_vpz),
+        m_simulations(0), m_busy(0.0)
+    {
+    }
+
+    ~mvle_runner()
+    {
+        delete m_vpz.project().model().model();
+    }
+
+    uint32_t size() const
+    {
+        return m_expgen.size();
+    }
+
+    /**
+     * Run a combination. An exception is returned as an error, so a
+     * worker always answers to the coordinator.
+     */
+    vle::value::Map * run(uint32_t index, vle::utils::ModuleManager& modules,
+                          vle::manager::Error *error)
+    {
+        double start = MPI_Wtime();
+        vle::value::Map *result = 0;
+
+        try {
+            vle::manager::Simulation sim(vle::manager::LOG_NONE,
+                                         vle::manager::SIMULATION_NONE, NULL);
+
+            result = sim.run(m_base.build(index, m_expgen),
+                             &m_vpz.project(), modules, error);
+        } catch (const std::exception& e) {
+            error->code = -1;
+            error->message = e.what();
+        }
+
+        m_simulations++;
+        m_busy += MPI_Wtime() - start;
+
+        return result;
+    }
+
+    uint32_t simulations() const
+    {
+        return m_simulations;
+    }
+
+    double busy() const
+    {
+        return m_busy;
+    }
+
+private:
+    vle::vpz::Vpz m_vpz;
+    vle::manager::ExperimentGenerator m_expgen;
+    vle::manager::ExperimentTemplate m_base;
+    uint32_t m_simulations;
+    double m_busy;
+};
+
+void mvle_send_result(uint32_t index, vle::value::Map *result,
+                      const vle::manager::Error& error)
+{
+    std::string payload;
+
+    if (error.code) {
+        payload = error.message;
+    } else if (result) {
+        payload = vle::value::toBinary(*result);
+    }
+
+    std::vector < char > buffer(sizeof(uint32_t) * 2 + payload.size());
+    uint32_t header[2] = { index, error.code ? 1u : 0u };
+
+    std::memcpy(&buffer[0], header, sizeof(header));
+    std::copy(payload.begin(), payload.end(), buffer.begin() + sizeof(header));
+
+    MPI_Send(&buffer[0], buffer.size(), MPI_CHAR, 0, MVLE_TAG_RESULT,
+             MPI_COMM_WORLD);
+}
+
+void mvle_receive_result(const MPI_Status& status, const char *vpz,
+                         vle::value::Matrix *results)
+{
+    int length;
+    MPI_Get_count(const_cast < MPI_Status* >(&status), MPI_CHAR, &length);
+
+    std::vector < char > buffer(length);
+    MPI_Recv(&buffer[0], length, MPI_CHAR, status.MPI_SOURCE,
+             MVLE_TAG_RESULT, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+
+    uint32_t header[2];
+    std::memcpy(header, &buffer[0], sizeof(header));
+    std::string payload(buffer.begin() + sizeof(header), buffer.end());
+
+    if (header[1]) {
+        mvle_print_error("Experimental frames `%s' combination %u throws"
+                         " error %s", vpz, header[0], payload.c_str());
+    } else if (not payload.empty()) {
+        try {
+            results->add(header[0], 0, vle::value::fromBinary(payload));
+        } catch (const std::exception& e) {
+            mvle_print_error("Experimental frames `%s' combination %u bad"
+                             " result: %s", vpz, header[0], e.what());
+        }
+    }
+}
+
+/**
+ * The coordinator: answers to the requests of the workers until all the
+ * combinations are distributed and all the workers stopped.
+ */
+void mvle_coordinator(uint32_t size, uint32_t world, uint32_t batch,
+                      const char *vpz, vle::value::Matrix *results)
+{
+    uint32_t next = 0;
+    uint32_t active = world - 1;
+
+    while (active > 0) {
+        MPI_Status status;
+        MPI_Probe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &status);
+
+        if (status.MPI_TAG == MVLE_TAG_RESULT) {
+            mvle_receive_result(status, vpz, results);
+        } else {
+            MPI_Recv(NULL, 0, MPI_CHAR, status.MPI_SOURCE, MVLE_TAG_REQUEST,
+                     MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+
+            uint32_t work[2] = { next, std::min(size, next + batch) };
+            next = work[1];
+
+            MPI_Send(work, 2, MPI_UNSIGNED, status.MPI_SOURCE, MVLE_TAG_WORK,
+                     MPI_COMM_WORLD);
+
+            if (work[0] == work[1]) {
+                active--;
+            }
+        }
+    }
+}
+
+/**
+ * The worker: asks for batches until the coordinator sends an empty one.
+ * The results of a batch are sent before the next request, MPI keeps the
+ * order of the messages between two nodes.
+ */
+void mvle_worker(mvle_runner& runner, vle::utils::ModuleManager& modules)
+{
+    for (;;) {
+        uint32_t work[2];
+
+        MPI_Send(NULL, 0, MPI_CHAR, 0, MVLE_TAG_REQUEST, MPI_COMM_WORLD);
+        MPI_Recv(work, 2, MPI_UNSIGNED, 0, MVLE_TAG_WORK, MPI_COMM_WORLD,
+                 MPI_STATUS_IGNORE);
+
+        if (work[0] == work[1]) {
+            break;
+        }
+
+        for (uint32_t i = work[0]; i < work[1]; ++i) {
+            vle::manager::Error error;
+            vle::value::Map *result = runner.run(i, modules, &error);
+
+            mvle_send_result(i, result, error);
+            delete result;
+        }
+    }
+}
+
+/**
+ * Gather on the node 0 the number of simulations (negative if unknown),
+ * the busy time and the wall time of each node and print them with the
+ * imbalance: the greatest busy time divided by the mean busy time of the
+ * nodes which simulate.
+ */
+void mvle_report(uint32_t rank, uint32_t world, const char *vpz,
+                 double simulations, double busy, double wall)
+{
+    double local[3] = { simulations, busy, wall };
+    std::vector < double > all(rank == 0 ? 3 * world : 3);
+
+    MPI_Gather(local, 3, MPI_DOUBLE, &all[0], 3, MPI_DOUBLE, 0,
+               MPI_COMM_WORLD);
+
+    if (rank == 0) {
+        double sum = 0.0, max = 0.0;
+        uint32_t workers = 0;
+
+        mvle_print("Experimental frames `%s'\n", vpz);
+        for (uint32_t i = 0; i < world; ++i) {
+            mvle_print(" - MPI node %u: ", i);
+            if (all[3 * i] >= 0.0) {
+                mvle_print("%.0f simulation(s), ", all[3 * i]);
+            }
+            mvle_print("%.3f s busy, %.3f s wall\n", all[3 * i + 1],
+                       all[3 * i + 2]);
+
+            if (all[3 * i + 1] > 0.0) {
+                sum += all[3 * i + 1];
+                max = std::max(max, all[3 * i + 1]);
+                workers++;
+            }
+        }
+
+        if (workers > 0) {
+            mvle_print(" - Imbalance: %.3f\n", max / (sum / workers));
+        }
+    }
+}
+
+/**
+ * Gather on the node 0 the error of each node, empty if its simulations
+ * succeeded. The node 0 throws the error of the first node which failed,
+ * the other nodes return false: all the nodes leave the loop of the
+ * experimental frames together and none waits for a failed node in a
+ * collective operation.
+ */
+bool mvle_gather_failure(uint32_t rank, uint32_t world,
+                         const std::string& failure)
+{
+    int length = failure.size();
+    std::vector < int > lengths(rank == 0 ? world : 1);
+
+    MPI_Gather(&length, 1, MPI_INT, &lengths[0], 1, MPI_INT, 0,
+               MPI_COMM_WORLD);
+
+    std::vector < int > offsets(lengths.size(), 0);
+    int total = 0;
+
+    if (rank == 0) {
+        for (uint32_t i = 0; i < world; ++i) {
+            offsets[i] = total;
+            total += lengths[i];
+        }
+    }
+
+    std::vector < char > messages(total + 1);
+    MPI_Gatherv(const_cast < char* >(failure.data()), length, MPI_CHAR,
+                &messages[0], &lengths[0], &offsets[0], MPI_CHAR, 0,
+                MPI_COMM_WORLD);
+
+    int failed = total > 0;
+    MPI_Bcast(&failed, 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+    if (rank == 0) {
+        for (uint32_t i = 0; i < world; ++i) {
+            if (lengths[i] > 0) {
+                std::string message(&messages[offsets[i]], lengths[i]);
+
+                throw std::runtime_error(
+                    (vle::fmt(_("MPI node %1%: %2%")) % i % message).str());
+            }
+        }
+    }
+
+    return not failed;
+}
+
+void mvle_write(const std::string& output, const vle::value::Matrix& results)
+{
+    std::ofstream file(output.c_str(), std::ios_base::app);
+
+    if (not file.is_open()) {
+        mvle_print_error(_("cannot open output file `%s'"), output.c_str());
+    } else {
+        file << results.writeToXml() << "\n";
+    }
+}
+
+/**
+ * Run an experimental frame in dynamic mode. With a single node, the node
+ * 0 runs all the combinations.
+ */
+void mvle_run_dynamic(const std::string& filename, const char *vpz,
+                      uint32_t rank, uint32_t world,
+                      const mvle_options& options,
+                      vle::utils::ModuleManager& modules)
+{
+    double start = MPI_Wtime();
+    mvle_runner runner(filename);
+
+    if (rank == 0) {
+        uint32_t size = runner.size();
+        vle::value::Matrix results(size, 1, size, 1);
+
+        if (world == 1) {
+            for (uint32_t i = 0; i < size; ++i) {
+                vle::manager::Error error;
+                vle::value::Map *result = runner.run(i, modules, &error);
+
+                if (error.code) {
+                    mvle_print_error("Experimental frames `%s' combination"
+                                     " %u throws error %s", vpz, i,
+                                     error.message.c_str());
+                } else {
+                    results.add(i, 0, result);
+                }
+            }
+        } else {
+            mvle_coordinator(size, world, options.batch, vpz, &results);
+        }
+
+        if (not options.output.empty()) {
+            mvle_write(options.output, results);
+        }
+    } else {
+        mvle_worker(runner, modules);
+    }
+
+    mvle_report(rank, world, vpz, runner.simulations(), runner.busy(),
+                MPI_Wtime() - start);
+}
+
 int main(int argc, char **argv)
 {
     uint32_t rank = 0;
     uint32_t world = 0;
-    bool show = false;
+    mvle_options options;
     bool result;
 
     vle::Init app;
 
     if ((result = mvle_mpi_init(&argc, &argv, &rank, &world))) {
-        int vpz;
+        int vpz = argc;
         vle::utils::Package pack;
-        if ((result = mvle_parse_arg(argc, argv, &vpz, &show, pack))) {
-            if (show) {
+        if ((result = mvle_parse_arg(argc, argv, &vpz, &options, pack))) {
+            if (options.show) {
                 while (vpz < argc) {
                     mvle_show(
                         pack.getExpFile(argv[vpz], vle::utils::PKG_BINARY));
@@ -255,24 +633,51 @@ int main(int argc, char **argv)
 
                     mvle_print("MPI node %d/%d start\n", rank, world);
 
+                    while (options.dynamic and vpz < argc) {
+                        mvle_run_dynamic(
+                            pack.getExpFile(argv[vpz],
+                                            vle::utils::PKG_BINARY),
+                            argv[vpz], rank, world, options, modules);
+                        vpz++;
+                    }
+
                     while (vpz < argc) {
-                        vle::manager::Error error;
-                        vle::value::Matrix *res = man.run(
-                            new vle::vpz::Vpz(pack.getExpFile(argv[vpz],
-                                    vle::utils::PKG_BINARY)),
-                            modules,
-                            1,
-                            rank,
-                            world,
-                            &error);
-
-                        if (error.code) {
-                            mvle_print_error("Experimental frames `%s' throws error %s",
-                                             argv[vpz], error.message.c_str());
+                        double start = MPI_Wtime();
+                        std::string failure;
+
+                        try {
+                            vle::manager::Error error;
+                            vle::value::Matrix *res = man.run(
+                                new vle::vpz::Vpz(pack.getExpFile(argv[vpz],
+                                        vle::utils::PKG_BINARY)),
+                                modules,
+                                1,
+                                rank,
+                                world,
+                                &error);
+
+                            if (error.code) {
+                                mvle_print_error("Experimental frames `%s' throws error %s",
+                                                 argv[vpz], error.message.c_str());
+                            }
+
+                            delete res;
+                        } catch (const std::exception& e) {
+                            failure = e.what();
+                            if (failure.empty()) {
+                                failure = _("unknown error");
+                            }
                         }
 
-                        delete res;
+                        double busy = MPI_Wtime() - start;
+                        MPI_Barrier(MPI_COMM_WORLD);
+
+                        mvle_report(rank, world, argv[vpz], -1.0, busy,
+                                    MPI_Wtime() - start);
 
+                        if (not mvle_gather_failure(rank, world, failure)) {
+                            break;
+                        }
                         vpz++;
                     }
 
@@ -35,6 +35,7 @@
 #include <vle/utils/RemoteManager.hpp>
 #include <vle/utils/i18n.hpp>
 #include <vle/vle.hpp>
+#include <vle/vpz/Cache.hpp>
 #include <cstdlib>
 #include <iostream>
 #include <fstream>
@@ -223,6 +224,38 @@ static std::string search_vpz(const std::string &param,
     return std::string();
 }
 
+/*
+ * Build the Vpz of the file. With the cache mode, the Vpz is read from
+ * the binary image of the file if it is up to date, otherwise the file
+ * is parsed and its image is rebuilt.
+ */
+static vle::vpz::Vpz* open_vpz(const std::string& filename, bool cache)
+{
+    if (not cache or filename.empty())
+        return new vle::vpz::Vpz(filename);
+
+    vle::vpz::Vpz* vpz = new vle::vpz::Vpz();
+
+    if (vle::vpz::Cache::load(*vpz, filename))
+        return vpz;
+
+    try {
+        vpz->parseFile(filename);
+    } catch (...) {
+        delete vpz;
+        throw;
+    }
+
+    try {
+        vle::vpz::Cache::save(*vpz, filename);
+    } catch (const std::exception& e) {
+        std::cerr << vle::fmt(_("Cannot write the cache of `%1%': %2%\n"))
+            % filename % e.what();
+    }
+
+    return vpz;
+}
+
 static vle::manager::LogOptions convert_log_mode()
 {
     switch (vle::utils::Trace::getLevel()) {
@@ -237,20 +270,28 @@ static vle::manager::LogOptions convert_log_mode()
     }
 }
 
+static vle::manager::SimulationOptions convert_simulation_mode(bool profile)
+{
+    if (profile)
+        return vle::manager::SIMULATION_NO_RETURN |
+            vle::manager::SIMULATION_PROFILE;
+
+    return vle::manager::SIMULATION_NONE | vle::manager::SIMULATION_NO_RETURN;
+}
+
 static int run_manager(CmdArgs::const_iterator it, CmdArgs::const_iterator end,
-        int processor, vle::utils::Package& pkg)
+        int processor, bool cache, bool profile, vle::utils::Package& pkg)
 {
     vle::manager::Manager man(convert_log_mode(),
-                              vle::manager::SIMULATION_NONE |
-                              vle::manager::SIMULATION_NO_RETURN,
+                              convert_simulation_mode(profile),
                               &std::cout);
     vle::utils::ModuleManager modules;
     int success = EXIT_SUCCESS;
 
     for (; it != end; ++it) {
         vle::manager::Error error;
-        vle::value::Matrix *res = man.run(new vle::vpz::Vpz(
-                                               search_vpz(*it, pkg)),
+        vle::value::Matrix *res = man.run(open_vpz(search_vpz(*it, pkg),
+                                                   cache),
                 modules,
                 processor,
                 0,
@@ -271,18 +312,18 @@ static int run_manager(CmdArgs::const_iterator it, CmdArgs::const_iterator end,
 }
 
 static int run_simulation(CmdArgs::const_iterator it,
-        CmdArgs::const_iterator end, vle::utils::Package& pkg)
+        CmdArgs::const_iterator end, bool cache, bool profile,
+        vle::utils::Package& pkg)
 {
     vle::manager::Simulation sim(convert_log_mode(),
-                                 vle::manager::SIMULATION_NONE |
-                                 vle::manager::SIMULATION_NO_RETURN,
+                                 convert_simulation_mode(profile),
                                  &std::cout);
     vle::utils::ModuleManager modules;
     int success = EXIT_SUCCESS;
 
     for (; it != end; ++it) {
         vle::manager::Error error;
-        vle::value::Map *res = sim.run(new vle::vpz::Vpz(search_vpz(*it, pkg)),
+        vle::value::Map *res = sim.run(open_vpz(search_vpz(*it, pkg), cache),
                                        modules,
                                        &error);
 
@@ -316,7 +357,8 @@ static bool init_package(vle::utils::Package& pkg, const CmdArgs &args)
 }
 
 static int manage_package_mode(const std::string &packagename, bool manager,
-                               int processor, const CmdArgs &args)
+                               int processor, bool cache, bool profile,
+                               const CmdArgs &args)
 {
     CmdArgs::const_iterator it = args.begin();
     CmdArgs::const_iterator end = args.end();
@@ -385,9 +427,9 @@ static int manage_package_mode(const std::string &packagename, bool manager,
         ret = EXIT_FAILURE;
     else if (it != end) {
         if (manager)
-            ret = run_manager(it, end, processor, pkg);
+            ret = run_manager(it, end, processor, cache, profile, pkg);
         else
-            ret = run_simulation(it, end, pkg);
+            ret = run_simulation(it, end, cache, profile, pkg);
     }
 
     return ret;
@@ -581,11 +623,13 @@ enum ProgramOptionsCode
 struct ProgramOptions
 {
     ProgramOptions(int *verbose, int *trace, int *processor,
-            bool *manager_mode, std::string *packagename,
-            std::string *remotecmd, std::string *configvar, CmdArgs *args)
+            bool *manager_mode, bool *cache_mode, bool *profile_mode,
+            std::string *packagename, std::string *remotecmd,
+            std::string *configvar, CmdArgs *args)
         : generic(_("Allowed options")), hidden(_("Hidden options")),
         verbose(verbose), trace(trace), processor(processor),
-        manager_mode(manager_mode), packagename(packagename),
+        manager_mode(manager_mode), cache_mode(cache_mode),
+        profile_mode(profile_mode), packagename(packagename),
         remotecmd(remotecmd), configvar(configvar), args(args)
     {
         generic.add_options()
@@ -601,6 +645,10 @@ struct ProgramOptions
             ("manager,m", _("Use the manager mode to run experimental frames"))
             ("processor,o", po::value < int >(processor)->default_value(1),
              _("Select number of processor in manager mode [>= 0]"))
+            ("cache", _("Read the experimental frames from their binary image"
+                        " (file.vpzc), rebuilt when the file changes"))
+            ("profile", _("Profile the models of the simulation(s) into the"
+                          " file experiment.profile"))
             ("verbose,V", po::value < int >(verbose)->default_value(0),
              ("Verbose mode 0 - 3. [default 0]\n"
               "0 no trace and no long exception\n"
@@ -661,6 +709,12 @@ struct ProgramOptions
             if (vm.count("manager"))
                 *manager_mode = true;
 
+            if (vm.count("cache"))
+                *cache_mode = true;
+
+            if (vm.count("profile"))
+                *profile_mode = true;
+
             if (vm.count("input"))
                 *args = vm["input"].as < CmdArgs >();
 
@@ -708,7 +762,7 @@ struct ProgramOptions
     po::options_description desc, generic, hidden;
     po::variables_map vm;
     int *verbose, *trace, *processor;
-    bool *manager_mode;
+    bool *manager_mode, *cache_mode, *profile_mode;
     std::string *packagename, *remotecmd, *configvar;
     CmdArgs *args;
 };
@@ -720,12 +774,15 @@ int main(int argc, char *argv[])
     int processor = 1;
     int trace = -1; /* < 0 = stderr, 0 = file and > 0 = stdout */
     bool manager_mode = false;
+    bool cache_mode = false;
+    bool profile_mode = false;
     std::string packagename, remotecmd, configvar;
     CmdArgs args;
 
     {
         ProgramOptions prgs(&verbose, &trace, &processor, &manager_mode,
-                &packagename, &remotecmd, &configvar, &args);
+                &cache_mode, &profile_mode, &packagename, &remotecmd,
+                &configvar, &args);
 
         ret = prgs.run(argc, argv);
 
@@ -742,7 +799,7 @@ int main(int argc, char *argv[])
     switch (ret) {
     case PROGRAM_OPTIONS_PACKAGE:
         return manage_package_mode(packagename, manager_mode, processor,
-                args);
+                cache_mode, profile_mode, args);
     case PROGRAM_OPTIONS_REMOTE:
         return manage_remote_mode(remotecmd, args);
     case PROGRAM_OPTIONS_CONFIG:
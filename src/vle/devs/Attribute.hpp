@@ -35,6 +35,7 @@
 #include <vle/value/String.hpp>
 #include <vle/value/Boolean.hpp>
 #include <vle/value/Map.hpp>
+#include <vle/value/Scalar.hpp>
 #include <vle/value/Set.hpp>
 #include <string>
 
@@ -47,16 +48,38 @@ namespace vle { namespace devs {
      */
     typedef std::pair < std::string, value::Value* > Attribute;
 
+    /**
+     * @brief An attribute which stores a boolean, an integer, a real or a
+     * string into a \c value::Scalar. The events store it without
+     * allocation. It converts to an Attribute for the functions which
+     * expect a \c value::Value.
+     */
+    struct ScalarAttribute
+    {
+        ScalarAttribute()
+        {}
+
+        ScalarAttribute(const std::string& first, const value::Scalar& second)
+            : first(first), second(second)
+        {}
+
+        operator Attribute() const
+        { return Attribute(first, second.toValue()); }
+
+        std::string     first;
+        value::Scalar   second;
+    };
+
     /**
      * Build an attribute with a specified name and integer value.
      *
      * @param name the name of the attribute.
      * @param value the integer value.
      *
-     * @return a new Attribute.
+     * @return a new ScalarAttribute.
      */
-    inline Attribute attribute(const std::string& name, int value)
-    { return Attribute(name, value::Integer::create(value)); }
+    inline ScalarAttribute attribute(const std::string& name, int value)
+    { return ScalarAttribute(name, value::Scalar(value)); }
 
     /**
      * Build an attribute with a specified name and double value.
@@ -64,10 +87,10 @@ namespace vle { namespace devs {
      * @param name the name of the attribute.
      * @param value the double value.
      *
-     * @return a new Attribute.
+     * @return a new ScalarAttribute.
      */
-    inline Attribute attribute(const std::string& name, double value)
-    { return Attribute(name, value::Double::create(value)); }
+    inline ScalarAttribute attribute(const std::string& name, double value)
+    { return ScalarAttribute(name, value::Scalar(value)); }
 
     /**
      * Build an attribute with a specified name and boolean value.
@@ -75,10 +98,10 @@ namespace vle { namespace devs {
      * @param name the name of the attribute.
      * @param value the boolean value.
      *
-     * @return a new Attribute.
+     * @return a new ScalarAttribute.
      */
-    inline Attribute attribute(const std::string& name, bool value)
-    { return Attribute(name, value::Boolean::create(value)); }
+    inline ScalarAttribute attribute(const std::string& name, bool value)
+    { return ScalarAttribute(name, value::Scalar(value)); }
 
     /**
      * Build an attribute with a specified name and string value.
@@ -86,11 +109,11 @@ namespace vle { namespace devs {
      * @param name the name of the attribute.
      * @param value the string value.
      *
-     * @return a new Attribute.
+     * @return a new ScalarAttribute.
      */
-    inline Attribute attribute(const std::string& name,
-                               const std::string& value)
-    { return Attribute(name, value::String::create(value)); }
+    inline ScalarAttribute attribute(const std::string& name,
+                                     const std::string& value)
+    { return ScalarAttribute(name, value::Scalar(value)); }
 
     /**
      * @brief Build an attribute with a specified name and string value.
@@ -98,10 +121,11 @@ namespace vle { namespace devs {
      * @param name the name of the attribute.
      * @param value the string value.
      *
-     * @return a new Attribute.
+     * @return a new ScalarAttribute.
      */
-    inline Attribute attribute(const std::string& name, const char* value)
-    { return Attribute(name, value::String::create(std::string(value))); }
+    inline ScalarAttribute attribute(const std::string& name,
+                                     const char* value)
+    { return ScalarAttribute(name, value::Scalar(value)); }
 
     /**
      * Build an attribute with a specified name and set value. Be carreful, the
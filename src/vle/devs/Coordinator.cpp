@@ -33,11 +33,14 @@
 #include <vle/devs/InternalEvent.hpp>
 #include <vle/devs/ExternalEventList.hpp>
 #include <vle/devs/StreamWriter.hpp>
+#include <vle/devs/Partition.hpp>
+#include <vle/devs/Snapshot.hpp>
 #include <vle/vpz/BaseModel.hpp>
 #include <vle/vpz/AtomicModel.hpp>
 #include <vle/vpz/CoupledModel.hpp>
 #include <vle/utils/Trace.hpp>
 #include <functional>
+#include <algorithm>
 #include <boost/bind.hpp>
 
 using std::vector;
@@ -51,9 +54,14 @@ Coordinator::Coordinator(const utils::ModuleManager& modulemgr,
                          const vpz::Dynamics& dyn,
                          const vpz::Classes& cls,
                          const vpz::Experiment& experiment,
-                         RootCoordinator& root)
-    : m_currentTime(0.0), m_modelFactory(modulemgr, dyn, cls, experiment, root),
-      m_modulemgr(modulemgr), m_isStarted(false)
+                         RootCoordinator& root,
+                         bool shared)
+    : m_currentTime(0.0), m_transaction(0),
+      m_workers(std::max(experiment.threads(), experiment.partitions())),
+      m_eventTable(experiment.scheduler()),
+      m_modelFactory(modulemgr, dyn, cls, experiment, root, shared),
+      m_toDelete(0), m_modulemgr(modulemgr), m_profile(0),
+      m_isStarted(false), m_restoring(false)
 {
 }
 
@@ -70,26 +78,80 @@ Coordinator::~Coordinator()
                   boost::bind(
                       boost::checked_deleter < View >(),
                       boost::bind(&ViewList::value_type::second, _1)));
+
+    std::for_each(m_partitions.begin(),
+                  m_partitions.end(),
+                  boost::checked_deleter < Partition >());
 }
 
 void Coordinator::init(const vpz::Model& mdls, const Time& current,
                        const Time& duration)
 {
+    EventPool::Scope scope(m_eventPool);
+
     m_currentTime = current;
     m_durationTime = duration;
     buildViews();
     addModels(mdls);
+    checkTransaction(0);
+    buildPartitions(mdls);
+    m_toDelete = 0;
+    m_isStarted = true;
+}
+
+void Coordinator::restore(const vpz::Model& mdls, const Time& current,
+                          const Time& duration, const Snapshot& snapshot)
+{
+    EventPool::Scope scope(m_eventPool);
+
+    m_currentTime = current;
+    m_durationTime = duration;
+    m_restoring = true;
+
+    try {
+        buildViews();
+        addModels(mdls);
+    } catch (...) {
+        m_restoring = false;
+        throw;
+    }
+
+    m_restoring = false;
+    buildPartitions(mdls);
+    m_eventTable.setCurrentTime(current);
+    snapshot.restore(*this, mdls.model());
     m_toDelete = 0;
     m_isStarted = true;
 }
 
 const Time& Coordinator::getNextTime()
 {
-    return m_eventTable.topEvent();
+    if (m_partitions.empty()) {
+        return m_eventTable.topEvent();
+    }
+
+    m_nextTime = m_eventTable.topEvent();
+    for (std::vector < Partition* >::iterator it = m_partitions.begin();
+         it != m_partitions.end(); ++it) {
+        m_nextTime = std::min(m_nextTime, (*it)->getNextTime());
+    }
+
+    return m_nextTime;
 }
 
 void Coordinator::run()
 {
+    EventPool::Scope scope(m_eventPool);
+
+    if (not m_partitions.empty()) {
+        runPartitions();
+
+        if (m_profile and m_profile->bag()) {
+            sampleEventTable();
+        }
+        return;
+    }
+
     DTraceDevs(_("-------- BAG --------"));
     SimulatorList::size_type oldToDelete(m_toDelete);
 
@@ -98,6 +160,11 @@ void Coordinator::run()
         updateCurrentTime(m_eventTable.getCurrentTime());
     }
 
+    if (m_workers.size() > 1 and bags.popBags(m_bags)) {
+        processBags(m_bags);
+        m_bags.clear();
+    }
+
     while (not bags.emptyBag()) {
         std::map < Simulator*, EventBagModel >::value_type& bag(bags.topBag());
         if (not bag.second.emptyInternal()) {
@@ -127,6 +194,27 @@ void Coordinator::run()
         m_toDelete = m_deletedSimulator.size();
     }
 
+    processObservations(bags);
+
+    if (m_profile and m_profile->bag()) {
+        sampleEventTable();
+    }
+}
+
+void Coordinator::sampleEventTable()
+{
+    std::size_t size = m_eventTable.getEventNumber();
+
+    for (std::vector < Partition* >::iterator it = m_partitions.begin();
+         it != m_partitions.end(); ++it) {
+        size += (*it)->eventtable().getEventNumber();
+    }
+
+    m_profile->sample(m_currentTime, size);
+}
+
+void Coordinator::processObservations(CompleteEventBagModel& bags)
+{
     if (not bags.emptyStates()) {
         if (getNextTime() == bags.topObservationEvent()->getTime()) {
             m_obsEventBuffer.insert(bags.states().begin(),
@@ -148,8 +236,202 @@ void Coordinator::run()
     bags.clear();
 }
 
+/**
+ * @brief Run or receive the events of the devs::Partition.
+ */
+class Coordinator::PartitionTask : public WorkerPool::Task
+{
+public:
+    PartitionTask(std::vector < Partition* >& partitions, const Time& time,
+                  bool receive)
+        : m_partitions(partitions), m_time(time), m_receive(receive)
+    {}
+
+    virtual void operator()(std::size_t index)
+    {
+        if (m_receive) {
+            m_partitions[index]->receive(m_partitions);
+        } else {
+            m_partitions[index]->run(m_time, false);
+        }
+    }
+
+private:
+    std::vector < Partition* >& m_partitions;
+    const Time&                 m_time;
+    bool                        m_receive;
+};
+
+void Coordinator::runPartitions()
+{
+    Time next = infinity;
+    for (std::vector < Partition* >::iterator it = m_partitions.begin();
+         it != m_partitions.end(); ++it) {
+        next = std::min(next, (*it)->getNextTime());
+    }
+
+    if (not isInfinity(next) and next <= m_eventTable.topEvent()) {
+        updateCurrentTime(next);
+
+        if (m_eventViewList.empty()) {
+            PartitionTask run(m_partitions, m_currentTime, false);
+            m_workers.run(run, m_partitions.size());
+        } else {
+            for (std::vector < Partition* >::iterator it =
+                 m_partitions.begin(); it != m_partitions.end(); ++it) {
+                (*it)->run(m_currentTime, true);
+            }
+        }
+
+        PartitionTask receive(m_partitions, m_currentTime, true);
+        m_workers.run(receive, m_partitions.size());
+    } else {
+        CompleteEventBagModel& bags = m_eventTable.popEvent();
+        if (not bags.empty()) {
+            updateCurrentTime(m_eventTable.getCurrentTime());
+        }
+
+        processObservations(bags);
+    }
+}
+
+/**
+ * @brief Sort the units of partitioning by decreasing size, then by
+ * index.
+ */
+struct PartitionUnitGreater
+{
+    PartitionUnitGreater(const std::vector < vpz::AtomicModelVector >& units)
+        : units(units)
+    {}
+
+    bool operator()(std::size_t a, std::size_t b) const
+    {
+        return units[a].size() > units[b].size() or
+            (units[a].size() == units[b].size() and a < b);
+    }
+
+    const std::vector < vpz::AtomicModelVector >& units;
+};
+
+void Coordinator::buildPartitions(const vpz::Model& mdls)
+{
+    const vpz::Experiment& experiment(m_modelFactory.experiment());
+    std::size_t number = experiment.partitions();
+
+    if (number < 2 or not mdls.model() or mdls.model()->isAtomic()) {
+        return;
+    }
+
+    for (SimulatorMap::const_iterator it = m_modelList.begin();
+         it != m_modelList.end(); ++it) {
+        if (it->second->dynamics()->isExecutive()) {
+            TraceAlways(fmt(_("Partitioning disabled: the model '%1%' is "
+                              "an Executive")) % it->second->getName());
+            return;
+        }
+    }
+
+    std::vector < vpz::AtomicModelVector > units;
+    const vpz::ModelList& children(static_cast < vpz::CoupledModel* >(
+            mdls.model())->getModelList());
+
+    for (vpz::ModelList::const_iterator it = children.begin();
+         it != children.end(); ++it) {
+        vpz::AtomicModelVector unit;
+        if (it->second->isAtomic()) {
+            unit.push_back(static_cast < vpz::AtomicModel* >(it->second));
+        } else {
+            vpz::BaseModel::getAtomicModelList(it->second, unit);
+        }
+
+        if (not unit.empty()) {
+            units.push_back(unit);
+        }
+    }
+
+    number = std::min(number, units.size());
+    if (number < 2) {
+        return;
+    }
+
+    std::vector < std::size_t > assignment(units.size());
+    if (experiment.partitioning() == "roundrobin") {
+        for (std::size_t i = 0; i < units.size(); ++i) {
+            assignment[i] = i % number;
+        }
+    } else {
+        std::vector < std::size_t > order(units.size());
+        for (std::size_t i = 0; i < units.size(); ++i) {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), PartitionUnitGreater(units));
+
+        std::vector < std::size_t > loads(number, 0);
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            std::size_t lightest = std::min_element(loads.begin(),
+                                                    loads.end()) -
+                loads.begin();
+            assignment[order[i]] = lightest;
+            loads[lightest] += units[order[i]].size();
+        }
+    }
+
+    for (std::size_t i = 0; i < number; ++i) {
+        m_partitions.push_back(new Partition(*this, i, number,
+                                             experiment.scheduler()));
+        m_partitions.back()->eventtable().setCurrentTime(m_currentTime);
+    }
+
+    for (std::size_t i = 0; i < units.size(); ++i) {
+        Partition* partition = m_partitions[assignment[i]];
+
+        for (vpz::AtomicModelVector::iterator it = units[i].begin();
+             it != units[i].end(); ++it) {
+            Simulator* sim = getModel(*it);
+            sim->setPartition(assignment[i]);
+
+            InternalEvent* event = m_eventTable.releaseInternalEvent(sim);
+            if (event) {
+                {
+                    EventPool::Scope scope(partition->eventPool());
+                    partition->eventtable().putInternalEvent(
+                        new InternalEvent(event->getTime(), sim));
+                }
+                delete event;
+            }
+        }
+    }
+}
+
+std::size_t Coordinator::eventAllocations() const
+{
+    std::size_t result = m_eventPool.allocations() + m_workers.allocations();
+
+    for (std::vector < Partition* >::const_iterator it =
+         m_partitions.begin(); it != m_partitions.end(); ++it) {
+        result += (*it)->eventPool().allocations();
+    }
+
+    return result;
+}
+
+std::size_t Coordinator::eventRequests() const
+{
+    std::size_t result = m_eventPool.requests() + m_workers.requests();
+
+    for (std::vector < Partition* >::const_iterator it =
+         m_partitions.begin(); it != m_partitions.end(); ++it) {
+        result += (*it)->eventPool().requests();
+    }
+
+    return result;
+}
+
 void Coordinator::finish()
 {
+    EventPool::Scope scope(m_eventPool);
+
     std::for_each(m_modelList.begin(), m_modelList.end(),
                   boost::bind(
                       &Simulator::finish,
@@ -286,12 +568,64 @@ void Coordinator::updateSimulatorsTarget(
         for (std::vector < std::pair < Simulator*, std::string > >::iterator
              it = lst.begin(); it != lst.end(); ++it) {
             if (it->first != 0) {
-                it->first->updateSimulatorTargets(it->second, m_modelList);
+                if (m_transaction) {
+                    m_pendingTargets.insert(*it);
+                } else {
+                    it->first->updateSimulatorTargets(it->second,
+                                                      m_modelList);
+                }
             }
         }
     }
 }
 
+void Coordinator::beginTransaction()
+{
+    ++m_transaction;
+}
+
+void Coordinator::commitTransaction()
+{
+    if (m_transaction == 0) {
+        throw utils::InternalError(
+            _("Coordinator: commit without transaction"));
+    }
+
+    if (--m_transaction == 0) {
+        PendingTargetList pending;
+        pending.swap(m_pendingTargets);
+
+        for (PendingTargetList::iterator it = pending.begin();
+             it != pending.end(); ++it) {
+            it->first->updateSimulatorTargets(it->second, m_modelList);
+        }
+    }
+}
+
+void Coordinator::abortTransaction(Simulator* sim)
+{
+    m_transaction = 1;
+    commitTransaction();
+
+    if (sim and sim->getStructure()) {
+        throw utils::ModellingError(
+            fmt(_("Executive '%1%': transaction not committed at the end of "
+                  "the transition")) % sim->getName());
+    } else {
+        throw utils::ModellingError(
+            _("Executive: transaction not committed at the end of the "
+              "initialization"));
+    }
+}
+
+void Coordinator::buildSimulatorsTarget(const vpz::AtomicModelVector& models)
+{
+    for (vpz::AtomicModelVector::const_iterator it = models.begin();
+         it != models.end(); ++it) {
+        getModel(*it)->buildSimulatorTargets(m_modelList);
+    }
+}
+
 void Coordinator::addSimulatorTargetPort(vpz::AtomicModel* model,
                                          const std::string& port)
 {
@@ -301,7 +635,10 @@ void Coordinator::addSimulatorTargetPort(vpz::AtomicModel* model,
 void Coordinator::removeSimulatorTargetPort(vpz::AtomicModel* model,
                                             const std::string& port)
 {
-    getModel(model)->removeTargetPort(port);
+    Simulator* sim = getModel(model);
+
+    m_pendingTargets.erase(std::make_pair(sim, port));
+    sim->removeTargetPort(port);
 }
 
 // / / / /
@@ -320,6 +657,34 @@ void Coordinator::addModel(vpz::AtomicModel* model, Simulator* simulator)
                     "The Atomic model node '%1% have already a simulator"))
             % model->getName());
     }
+
+    m_modelNames.insert(std::make_pair(model->getName(), simulator));
+
+    if (m_profile) {
+        simulator->setProfile(m_profile->attach(model->getCompleteName(),
+                                                model->dynamics()));
+    }
+}
+
+void Coordinator::renameModel(vpz::AtomicModel* model,
+                              const std::string& oldname)
+{
+    Simulator* sim = getModel(model);
+
+    if (sim) {
+        std::pair < SimulatorNameIndex::iterator,
+                    SimulatorNameIndex::iterator > r =
+            m_modelNames.equal_range(oldname);
+
+        for (; r.first != r.second; ++r.first) {
+            if (r.first->second == sim) {
+                m_modelNames.erase(r.first);
+                break;
+            }
+        }
+
+        m_modelNames.insert(std::make_pair(model->getName(), sim));
+    }
 }
 
 Simulator* Coordinator::getModel(const vpz::AtomicModel* model) const
@@ -331,14 +696,8 @@ Simulator* Coordinator::getModel(const vpz::AtomicModel* model) const
 
 Simulator* Coordinator::getModel(const std::string& name) const
 {
-    SimulatorMap::const_iterator it = m_modelList.begin();
-    while (it != m_modelList.end()) {
-        if ((*it).first->getName() == name) {
-            return (*it).second;
-        }
-        ++it;
-    }
-    return 0;
+    SimulatorNameIndex::const_iterator it = m_modelNames.find(name);
+    return (it == m_modelNames.end()) ? 0 : it->second;
 }
 
 View* Coordinator::getView(const std::string& name) const
@@ -367,11 +726,26 @@ void Coordinator::delAtomicModel(vpz::AtomicModel* atom)
     Simulator* satom = (*it).second;
     m_modelList.erase(it);
 
-    std::map < std::string , View* >::iterator it2;
-    for (it2 = m_viewList.begin(); it2 != m_viewList.end();
-         ++it2) {
-        View* View = (*it2).second;
-        View->removeObservable(satom);
+    std::pair < SimulatorNameIndex::iterator,
+                SimulatorNameIndex::iterator > names =
+        m_modelNames.equal_range(atom->getName());
+    for (; names.first != names.second; ++names.first) {
+        if (names.first->second == satom) {
+            m_modelNames.erase(names.first);
+            break;
+        }
+    }
+
+    PendingTargetList::iterator pending = m_pendingTargets.lower_bound(
+        std::make_pair(satom, std::string()));
+    while (pending != m_pendingTargets.end() and pending->first == satom) {
+        m_pendingTargets.erase(pending++);
+    }
+
+    Simulator::ObserverList views(satom->views());
+    for (Simulator::ObserverList::iterator it2 = views.begin();
+         it2 != views.end(); ++it2) {
+        (*it2)->removeObservable(satom);
     }
     m_eventTable.delModelEvents(satom);
     satom->clear();
@@ -413,13 +787,14 @@ void Coordinator::dispatchExternalEvent(ExternalEventList& eventList,
         std::pair < Simulator::iterator, Simulator::iterator > x;
         x = sim->targets((*it)->getPortName(), m_modelList);
 
-        if (x.first != x.second and x.first->second.first) {
-            for (Simulator::iterator jt = x.first; jt != x.second; ++jt) {
-                m_eventTable.putExternalEvent(
-                    new ExternalEvent(*(*it),
-                                      jt->second.first,
-                                      jt->second.second));
-            }
+        if (sim->profile()) {
+            sim->profile()->route((*it)->getPortName(),
+                                  x.second - x.first);
+        }
+
+        for (Simulator::iterator jt = x.first; jt != x.second; ++jt) {
+            m_eventTable.putExternalEvent(
+                new ExternalEvent(*(*it), jt->first, jt->second));
         }
 
         delete (*it);
@@ -472,8 +847,13 @@ StreamWriter* Coordinator::buildOutput(const vpz::View& view,
                       m_modelFactory.experiment().name() %
                       view.name()).str());
 
+    if (m_restoring) {
+        file += (fmt("_%1%") % m_currentTime).str();
+    }
+
     stream->open(output.plugin(), output.package(), output.location(), file,
                  (output.data()) ? output.data()->clone() : 0, m_currentTime);
+    stream->async(view.name(), output.buffer());
 
     return stream;
 }
@@ -495,6 +875,7 @@ void Coordinator::processInternalEvent(
         if (internal) {
             m_eventTable.putInternalEvent(internal);
         }
+        checkTransaction(sim);
     }
 
     processEventView(sim);
@@ -511,6 +892,7 @@ void Coordinator::processExternalEvents(
         if (internal) {
             m_eventTable.putInternalEvent(internal);
         }
+        checkTransaction(sim);
     }
 
     processEventView(sim);
@@ -534,16 +916,144 @@ void Coordinator::processConflictEvents(
     if (internal) {
         m_eventTable.putInternalEvent(internal);
     }
+    checkTransaction(sim);
 }
 
-void Coordinator::processEventView(Simulator* model)
+/**
+ * @brief Compute the output of the Simulator of the bags and, if
+ * required, its transition. The devs::EventTable is not used: the events
+ * are stored into the BagSlot.
+ */
+class Coordinator::BagTask : public WorkerPool::Task
+{
+public:
+    BagTask(BagSlotList& slots, const Time& time, bool transition)
+        : m_slots(slots), m_time(time), m_transition(transition)
+    {}
+
+    virtual void operator()(std::size_t index)
+    {
+        BagSlot& slot(m_slots[index]);
+
+        if (not slot.bag->emptyInternal()) {
+            slot.sim->output(m_time, slot.outputs);
+        }
+
+        if (m_transition) {
+            transition(slot);
+        }
+    }
+
+    void transition(BagSlot& slot)
+    {
+        if (not slot.bag->emptyInternal()) {
+            if (not slot.bag->emptyExternal()) {
+                slot.internal = slot.sim->confluentTransitions(
+                    *slot.bag->internal(), slot.bag->externals());
+            } else {
+                slot.internal = slot.sim->internalTransition(
+                    *slot.bag->internal());
+            }
+        } else if (not slot.bag->emptyExternal()) {
+            slot.internal = slot.sim->externalTransition(
+                slot.bag->externals(), m_time);
+        }
+    }
+
+private:
+    BagSlotList& m_slots;
+    const Time&  m_time;
+    bool         m_transition;
+};
+
+void Coordinator::processBags(BagList& bags)
 {
-    for (EventViewList::iterator it = m_eventViewList.begin(); it !=
-         m_eventViewList.end(); ++it) {
+    if (bags.size() < 2 * m_workers.size()) {
+        for (BagList::iterator it = bags.begin(); it != bags.end(); ++it) {
+            if (not (*it)->second.emptyInternal()) {
+                if (not (*it)->second.emptyExternal()) {
+                    processConflictEvents((*it)->first, (*it)->second);
+                } else {
+                    processInternalEvent((*it)->first, (*it)->second);
+                }
+            } else if (not (*it)->second.emptyExternal()) {
+                processExternalEvents((*it)->first, (*it)->second);
+            }
+        }
+        return;
+    }
+
+    bool observed = false;
+    m_slots.resize(bags.size());
+    for (BagSlotList::size_type i = 0; i < bags.size(); ++i) {
+        m_slots[i].sim = bags[i]->first;
+        m_slots[i].bag = &bags[i]->second;
+        m_slots[i].internal = 0;
 
-        if (it->second->exist(model)) {
-            it->second->run(m_currentTime);
+        if (not observed and isEventObserved(m_slots[i].sim)) {
+            observed = true;
         }
+
+        const ExternalEventList& externals(m_slots[i].bag->externals());
+        for (ExternalEventList::const_iterator it = externals.begin();
+             it != externals.end(); ++it) {
+            (*it)->materializeShared();
+        }
+    }
+
+    try {
+        BagTask task(m_slots, m_currentTime, not observed);
+        m_workers.run(task, m_slots.size());
+
+        for (BagSlotList::iterator it = m_slots.begin();
+             it != m_slots.end(); ++it) {
+            dispatchExternalEvent(it->outputs, it->sim);
+
+            if (observed) {
+                task.transition(*it);
+            }
+
+            if (it->internal) {
+                m_eventTable.putInternalEvent(it->internal);
+                it->internal = 0;
+            }
+
+            if (observed) {
+                processEventView(it->sim);
+            }
+        }
+    } catch (...) {
+        clearSlots();
+        throw;
+    }
+
+    clearSlots();
+}
+
+void Coordinator::clearSlots()
+{
+    for (BagSlotList::iterator it = m_slots.begin(); it != m_slots.end();
+         ++it) {
+        std::for_each(it->outputs.begin(), it->outputs.end(),
+                      boost::checked_deleter < ExternalEvent >());
+        delete it->internal;
+    }
+
+    m_slots.clear();
+}
+
+bool Coordinator::isEventObserved(Simulator* model) const
+{
+    return not model->eventViews().empty();
+}
+
+void Coordinator::processEventView(Simulator* model)
+{
+    const Simulator::ObserverList& views(model->eventViews());
+
+    for (Simulator::ObserverList::const_iterator it = views.begin();
+         it != views.end(); ++it) {
+        (*it)->run(m_currentTime);
     }
 }
 
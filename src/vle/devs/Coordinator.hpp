@@ -31,13 +31,19 @@
 #include <vle/DllDefines.hpp>
 #include <vle/devs/Simulator.hpp>
 #include <vle/devs/EventTable.hpp>
+#include <vle/devs/EventPool.hpp>
+#include <vle/devs/WorkerPool.hpp>
 #include <vle/devs/View.hpp>
 #include <vle/devs/Time.hpp>
 #include <vle/devs/ModelFactory.hpp>
+#include <boost/unordered_map.hpp>
+#include <set>
 
 namespace vle { namespace devs {
 
 class Executive;
+class Partition;
+class Snapshot;
 
 typedef std::vector < Simulator* > SimulatorList;
 typedef std::map < vpz::AtomicModel*, devs::Simulator* > SimulatorMap;
@@ -55,7 +61,8 @@ public:
                 const vpz::Dynamics& dyn,
                 const vpz::Classes& cls,
                 const vpz::Experiment& experiment,
-                RootCoordinator& root);
+                RootCoordinator& root,
+                bool shared = false);
 
     ~Coordinator();
 
@@ -71,6 +78,31 @@ public:
     void init(const vpz::Model& mdls, const Time& current,
               const Time& duration);
 
+    /**
+     * @brief Initialise the Coordinator from a devs::Snapshot instead of
+     * the init functions of the models: the simulators are built without
+     * calling devs::Dynamics::init, then the snapshot restores their state
+     * and the events of the simulation. The outputs of the views are
+     * opened with the date of the snapshot appended to their name, to
+     * keep the outputs of the first run.
+     * @param mdls the model tree read from the snapshot.
+     * @param current the date of the snapshot.
+     * @param duration the end of the simulation.
+     * @param snapshot the snapshot to restore.
+     * @throw utils::FileError if the snapshot does not match the model
+     * tree.
+     */
+    void restore(const vpz::Model& mdls, const Time& current,
+                 const Time& duration, const Snapshot& snapshot);
+
+    /**
+     * @brief Check if the Coordinator is restored from a devs::Snapshot:
+     * the devs::ModelFactory does not call the init functions of the
+     * models.
+     * @return true during restore().
+     */
+    bool isRestoring() const { return m_restoring; }
+
     /**
      * @brief Return the top devs::Time of the devs::EventTable.
      * @return A devs::Time.
@@ -173,9 +205,58 @@ public:
         const std::string& port,
         std::vector < std::pair < Simulator*, std::string > >& lst);
 
+    /**
+     * @brief Rebuild the routing of the output ports of the simulators.
+     * In a transaction, the ports are only recorded and rebuilt by
+     * commitTransaction().
+     * @param lst the list of simulators and output ports to rebuild.
+     */
     void updateSimulatorsTarget(
         std::vector < std::pair < Simulator*, std::string > >& lst);
 
+    /**
+     * @brief Start a transaction of structural changes. Until the
+     * matching commitTransaction(), the routing of the output ports
+     * modified by the changes is not rebuilt but recorded, once per
+     * simulator and port. Transactions can be nested, only the outermost
+     * commit rebuilds the routing.
+     */
+    void beginTransaction();
+
+    /**
+     * @brief Close a transaction and, for the outermost one, rebuild the
+     * routing of all the output ports recorded since
+     * beginTransaction(), in one pass.
+     * @throw utils::InternalError if no transaction is started.
+     */
+    void commitTransaction();
+
+    /**
+     * @brief Check if a transaction of structural changes is started.
+     * @return true if the routing updates are delayed.
+     */
+    bool inTransaction() const
+    { return m_transaction > 0; }
+
+    /**
+     * @brief Split the atomic models into devs::Partition if the
+     * experiment defines more than one partition. The children of the
+     * top-level coupled model are assigned to the partitions by the
+     * strategy of the experiment. Nothing is done if the model has an
+     * Executive or less than two children. This function is called by
+     * init() when all the devs::Simulator are built.
+     * @param mdls The model of the simulation.
+     */
+    void buildPartitions(const vpz::Model& mdls);
+
+    /**
+     * @brief Build the routing tables of the devs::Simulator attached to
+     * the specified atomic models. This function must be called when all
+     * the devs::Simulator of the models are built.
+     * @param models the list of atomic models.
+     */
+    void buildSimulatorsTarget(const vpz::AtomicModelVector& models);
+
     void addSimulatorTargetPort(vpz::AtomicModel* model,
                                 const std::string& port);
 
@@ -205,8 +286,17 @@ public:
     Simulator* getModel(const vpz::AtomicModel* model) const;
 
     /**
-     * Return the devs::Simulator with a specified atomic model name.
-     * Complexity: linear O(n).
+     * @brief Update the index of the names of the simulators after the
+     * rename of an atomic model.
+     * @param model the renamed atomic model.
+     * @param oldname the previous name of the model.
+     */
+    void renameModel(vpz::AtomicModel* model, const std::string& oldname);
+
+    /**
+     * Return the devs::Simulator with a specified atomic model name. If
+     * several atomic models share the name, one of them is returned.
+     * Complexity: constant on average.
      * @param model the name of atomic model to search.
      * @return a reference to the devs::Simulator or 0 if not found.
      */
@@ -281,17 +371,119 @@ public:
     vpz::Observables& observables()
     { return m_modelFactory.observables(); }
 
+    /**
+     * @brief Get a constant reference to the list of vpz::Classes objects.
+     * @return A constant reference to the list of vpz::Classes objects.
+     */
+    const vpz::Classes& classes() const
+    { return m_modelFactory.classes(); }
+
+    /**
+     * @brief Get a constant reference to the vpz::Experiment of the
+     * simulation, with the conditions and the views added by the
+     * Executive models.
+     * @return A constant reference to the vpz::Experiment.
+     */
+    const vpz::Experiment& experiment() const
+    { return m_modelFactory.experiment(); }
+
     bool isStarted() const { return m_isStarted; }
 
     const ViewList& getViews() const { return m_viewList; }
 
+    /**
+     * @brief Get a constant reference to the devs::EventPool used to
+     * build the events of this Coordinator.
+     * @return A constant reference to the devs::EventPool.
+     */
+    const EventPool& eventPool() const { return m_eventPool; }
+
+    /**
+     * @brief Get a constant reference to the devs::WorkerPool used to
+     * execute the bags in parallel.
+     * @return A constant reference to the devs::WorkerPool.
+     */
+    const WorkerPool& workerPool() const { return m_workers; }
+
+    /**
+     * @brief Get the partitions of the simulation.
+     * @return A reference to the list of devs::Partition, empty if the
+     * simulation is not partitioned.
+     */
+    const std::vector < Partition* >& partitions() const
+    { return m_partitions; }
+
+    /**
+     * @brief Get the number of allocations requested to the system by all
+     * the devs::EventPool of the simulation: the Coordinator, the
+     * devs::WorkerPool and the devs::Partition.
+     * @return A number of allocations.
+     */
+    std::size_t eventAllocations() const;
+
+    /**
+     * @brief Get the number of events built with all the devs::EventPool
+     * of the simulation.
+     * @return A number of events.
+     */
+    std::size_t eventRequests() const;
+
+    /**
+     * @brief Record the activity of the simulation into a devs::Profile.
+     * Must be called before init() to attach a devs::Profile::Record to
+     * each Simulator.
+     * @param profile The profile, null to disable the profiling.
+     */
+    void setProfile(Profile* profile) { m_profile = profile; }
+
+    /**
+     * @brief Get the devs::Profile of the simulation.
+     * @return The profile or null if the simulation is not profiled.
+     */
+    Profile* profile() const { return m_profile; }
+
 private:
     Coordinator(const Coordinator& other);
     Coordinator& operator=(const Coordinator& other);
 
+    typedef std::vector < std::map < Simulator*,
+            EventBagModel >::value_type* > BagList;
+
+    /**
+     * @brief The work of a Simulator of a bag executed by the
+     * devs::WorkerPool: the output of the Simulator and the internal event
+     * built by its transition.
+     */
+    struct BagSlot
+    {
+        Simulator*          sim;
+        EventBagModel*      bag;
+        ExternalEventList   outputs;
+        InternalEvent*      internal;
+    };
+
+    typedef std::vector < BagSlot > BagSlotList;
+
+    typedef boost::unordered_multimap < std::string, Simulator* >
+        SimulatorNameIndex;
+    typedef std::set < std::pair < Simulator*, std::string > >
+        PendingTargetList;
+
+    class BagTask;
+    class PartitionTask;
+    friend class Partition;
+    friend class Snapshot;
+
     Time                        m_currentTime;
     Time                        m_durationTime;
     SimulatorMap                m_modelList;
+    SimulatorNameIndex          m_modelNames;
+    PendingTargetList           m_pendingTargets; /**< The output ports
+                                                    to rebuild at the end
+                                                    of the transaction. */
+    unsigned int                m_transaction;
+    EventPool                   m_eventPool;
+    WorkerPool                  m_workers;
     EventTable                  m_eventTable;
     ViewList                    m_viewList;
     EventViewList               m_eventViewList;
@@ -302,7 +494,19 @@ private:
     SimulatorList::size_type    m_toDelete;
     const utils::ModuleManager& m_modulemgr;
     ViewEventList               m_obsEventBuffer;
+    BagList                     m_bags;
+    BagSlotList                 m_slots;
+    std::vector < Partition* >  m_partitions;
+    Time                        m_nextTime;
+    Profile*                    m_profile;
     bool                        m_isStarted;
+    bool                        m_restoring;
+
+    /**
+     * @brief Keep the size of the devs::EventTable and of the
+     * devs::EventTable of the partitions into the devs::Profile.
+     */
+    void sampleEventTable();
 
     /**
      * @brief Build, for each vpz::View a StreamWriter and View.
@@ -328,6 +532,66 @@ private:
     void processConflictEvents(Simulator* sim,
                                const EventBagModel& modelbag);
 
+    /**
+     * @brief Process the bags of a CompleteEventBagModel without
+     * Executive model with the devs::WorkerPool. The outputs and the
+     * transitions of the Simulator are computed in parallel, then the
+     * events are dispatched and scheduled in the order of the bags. If a
+     * Simulator of the bags is observed by an EventView, only the outputs
+     * are computed in parallel: the transitions and the observations stay
+     * sequential. The results are identical to the sequential execution.
+     *
+     * @param bags The bags to process.
+     */
+    void processBags(BagList& bags);
+
+    /**
+     * @brief Process the observation events of a CompleteEventBagModel.
+     * The observations are delayed until the last bag of the current
+     * date.
+     * @param bags The CompleteEventBagModel to process and clear.
+     */
+    void processObservations(CompleteEventBagModel& bags);
+
+    /**
+     * @brief Run a round of the devs::Partition: the partitions imminent
+     * at the next date process their bag in parallel then receive the
+     * events sent by the others. If the next date is an observation date,
+     * the observations are processed.
+     */
+    void runPartitions();
+
+    /**
+     * @brief Delete the events built by the devs::WorkerPool and not yet
+     * dispatched and clear the slots.
+     */
+    void clearSlots();
+
+    /**
+     * @brief Check if a Simulator is observed by an EventView.
+     * @param model The Simulator to check.
+     * @return True if an EventView observes the Simulator.
+     */
+    bool isEventObserved(Simulator* model) const;
+
+    /**
+     * @brief Check that the transactions started by an Executive are
+     * committed at the end of its transition: otherwise the routing of
+     * the following changes would never be rebuilt. The pending routing
+     * is rebuilt before the error is reported.
+     * @param sim The Simulator of the transition, null for the
+     * initialization of the models.
+     * @throw utils::ModellingError if a transaction is not committed.
+     */
+    void checkTransaction(Simulator* sim)
+    {
+        if (m_transaction) {
+            abortTransaction(sim);
+        }
+    }
+
+    void abortTransaction(Simulator* sim);
+
     /**
      * @brief Process for each ObservationEvent in the bag and observation
      * for the specified model. All ObservationEvent are destroyed by this
@@ -377,8 +641,12 @@ private:
      */
     void delCoupledModel(vpz::CoupledModel* mdl);
 
-
-
+    /**
+     * @brief Run the event views which observe the Simulator, after one
+     * of its transitions. Use the list of event views of the Simulator,
+     * an unobserved Simulator costs nothing.
+     * @param model The Simulator.
+     */
     void processEventView(Simulator* model);
 
     /**
@@ -33,10 +33,19 @@
 #include <vle/value/String.hpp>
 #include <vle/utils/Path.hpp>
 #include <vle/utils/Package.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/i18n.hpp>
 
 
 namespace vle { namespace devs {
 
+void Dynamics::deserialize(const value::Value& /* state */)
+{
+    throw utils::ModellingError(fmt(
+            _("The model '%1%' does not support the snapshots")) %
+        getModel().getCompleteName());
+}
+
 ExternalEvent* Dynamics::buildEvent(const std::string& portName) const
 {
   return new ExternalEvent(portName);
@@ -48,8 +57,7 @@ ExternalEvent* Dynamics::buildEventWithADouble(
     double attributeValue) const
 {
     ExternalEvent* event = new ExternalEvent(portName);
-    event->putAttribute(attributeName,
-                        value::Double::create(attributeValue));
+    event->putAttribute(attributeName, value::Scalar(attributeValue));
     return event;
 }
 
@@ -61,7 +69,7 @@ ExternalEvent* Dynamics::buildEventWithAInteger(
     ExternalEvent* event = new ExternalEvent(portName);
 
     event->putAttribute(attributeName,
-                          value::Integer::create(attributeValue));
+                        value::Scalar(static_cast < int32_t >(attributeValue)));
     return event;
 }
 
@@ -72,8 +80,7 @@ ExternalEvent* Dynamics::buildEventWithABoolean(
 {
     ExternalEvent* event = new ExternalEvent(portName);
 
-    event->putAttribute(attributeName,
-                        value::Boolean::create(attributeValue));
+    event->putAttribute(attributeName, value::Scalar(attributeValue));
     return event;
 }
 
@@ -84,8 +91,7 @@ ExternalEvent* Dynamics::buildEventWithAString(
 {
     ExternalEvent* event = new ExternalEvent(portName);
 
-    event->putAttribute(attributeName,
-                        value::String::create(attributeValue));
+    event->putAttribute(attributeName, value::Scalar(attributeValue));
     return event;
 }
 
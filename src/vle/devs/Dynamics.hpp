@@ -41,6 +41,7 @@
 #include <vle/value/Boolean.hpp>
 #include <vle/value/String.hpp>
 #include <vle/utils/PackageTable.hpp>
+#include <vle/utils/Rand.hpp>
 #include <vle/version.hpp>
 #include <string>
 
@@ -77,9 +78,20 @@ namespace vle { namespace devs {
     class VLE_API DynamicsInit
     {
     public:
+        /**
+         * @brief Build the initialiser of a Dynamics.
+         * @param model The atomic model of the Dynamics.
+         * @param packageid The package of the Dynamics.
+         * @param seed The seed of the experiment.
+         * @param replica The replica of the experiment (the instance of the
+         * vpz::Project).
+         */
         DynamicsInit(const vpz::AtomicModel& model,
-                     PackageId packageid)
-            : m_model(model), m_packageid(packageid)
+                     PackageId packageid,
+                     uint32_t seed = 0,
+                     uint32_t replica = 0)
+            : m_model(model), m_packageid(packageid), m_seed(seed),
+            m_replica(replica)
         {}
 
         virtual ~DynamicsInit()
@@ -87,10 +99,14 @@ namespace vle { namespace devs {
 
         const vpz::AtomicModel& model() const { return m_model; }
         PackageId packageid() const { return m_packageid; }
+        uint32_t seed() const { return m_seed; }
+        uint32_t replica() const { return m_replica; }
 
     private:
         const vpz::AtomicModel&       m_model;
         PackageId                       m_packageid;
+        uint32_t                        m_seed;
+        uint32_t                        m_replica;
     };
 
     /**
@@ -108,7 +124,9 @@ namespace vle { namespace devs {
          */
         Dynamics(const DynamicsInit& init,
                  const vle::devs::InitEventList&  /* events */)
-            : m_model(init.model()), m_packageid(init.packageid())
+            : m_model(init.model()), m_packageid(init.packageid()),
+            m_randStream(init.seed(), init.replica(),
+                         init.model().getCompleteName())
         {}
 
 	/**
@@ -200,6 +218,26 @@ namespace vle { namespace devs {
         virtual void finish()
         { }
 
+        /**
+         * @brief Build a copy of the state of the model, stored into the
+         * snapshots of the simulation (devs::Snapshot). By default, the
+         * model does not support the snapshots.
+         * @return the state, owned by the caller, or null if the model
+         * does not support the snapshots.
+         */
+        virtual vle::value::Value* serialize() const
+        { return 0; }
+
+        /**
+         * @brief Restore the state built by serialize(), instead of
+         * init(), when a simulation restarts from a snapshot. The random
+         * stream of the model is already restored.
+         * @param state the state of the model.
+         * @throw utils::ModellingError if the model does not support the
+         * snapshots.
+         */
+        virtual void deserialize(const vle::value::Value& state);
+
 	/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 	  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 	 * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
@@ -453,6 +491,15 @@ namespace vle { namespace devs {
          */
         inline PackageId packageid() const { return m_packageid; }
 
+        /**
+         * @brief Get the random stream of the model. The stream only
+         * depends on the seed and the replica of the experiment and on the
+         * complete name of the model, so a model draws the same numbers in
+         * a sequential or a parallel simulation.
+         * @return A reference to the random stream.
+         */
+        inline utils::RandStream& randStream() { return m_randStream; }
+
     private:
         const vpz::AtomicModel& m_model; /**< A constant reference to the
                                              atomic model node of the graph.
@@ -460,6 +507,9 @@ namespace vle { namespace devs {
 
         PackageId m_packageid; /**< An iterator to std::set of the
                                  vle::utils::PackageTable. */
+
+        utils::RandStream m_randStream; /**< The random stream of the
+                                          model. */
     };
 
 }} // namespace vle devs
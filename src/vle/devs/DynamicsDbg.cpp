@@ -125,5 +125,23 @@ void DynamicsDbg::finish()
     mDynamics->finish();
 }
 
+vle::value::Value* DynamicsDbg::serialize() const
+{
+    TraceDevs(fmt(_("                     %1% [DEVS] serialize")) % mName);
+
+    const_cast < DynamicsDbg* >(this)->randStream() =
+        mDynamics->randStream();
+
+    return mDynamics->serialize();
+}
+
+void DynamicsDbg::deserialize(const vle::value::Value& state)
+{
+    TraceDevs(fmt(_("                     %1% [DEVS] deserialize")) % mName);
+
+    mDynamics->randStream() = randStream();
+    mDynamics->deserialize(state);
+}
+
 }} // namespace vle devs
 
@@ -155,6 +155,22 @@ namespace vle { namespace devs {
          */
         virtual void finish();
 
+        /**
+         * @brief Build a copy of the state of the debugged model. The
+         * random stream of the debugged model is copied into the stream
+         * of this wrapper, saved by the snapshot.
+         * @return the state or null if the model does not support the
+         * snapshots.
+         */
+        virtual vle::value::Value* serialize() const;
+
+        /**
+         * @brief Restore the state and the random stream of the debugged
+         * model.
+         * @param state the state of the model.
+         */
+        virtual void deserialize(const vle::value::Value& state);
+
     private:
         Dynamics* mDynamics;
         std::string mName;
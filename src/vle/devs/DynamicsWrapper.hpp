@@ -61,8 +61,11 @@ namespace vle { namespace devs {
     public:
         DynamicsWrapperInit(const vpz::AtomicModel& atom,
                             PackageId packageid,
-                            const std::string& library)
-            : DynamicsInit(atom, packageid), m_library(library)
+                            const std::string& library,
+                            uint32_t seed = 0,
+                            uint32_t replica = 0)
+            : DynamicsInit(atom, packageid, seed, replica),
+            m_library(library)
         {}
 
         virtual ~DynamicsWrapperInit()
@@ -0,0 +1,196 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <vle/devs/EventPool.hpp>
+#include <vle/devs/InternalEvent.hpp>
+#include <vle/devs/ExternalEvent.hpp>
+#include <vle/devs/ViewEvent.hpp>
+#include <new>
+
+#if defined(_MSC_VER)
+#   define VLE_DEVS_THREAD_LOCAL __declspec(thread)
+#else
+#   define VLE_DEVS_THREAD_LOCAL __thread
+#endif
+
+namespace vle { namespace devs {
+
+/**
+ * The EventPool used by the current thread. A native thread local
+ * storage is used instead of the boost::thread_specific_ptr to keep the
+ * cost of the operator new of the events to a single load.
+ */
+static VLE_DEVS_THREAD_LOCAL EventPool* currentEventPool = 0;
+
+Pool::Pool(std::size_t size, std::size_t chunk)
+    : m_free(0), m_chunk(chunk ? chunk : 1), m_allocations(0),
+      m_requests(0), m_used(0)
+{
+    m_size = sizeof(Block) +
+        ((size + sizeof(Block) - 1) / sizeof(Block)) * sizeof(Block);
+}
+
+Pool::~Pool()
+{
+    for (std::vector < void* >::iterator it = m_chunks.begin();
+         it != m_chunks.end(); ++it) {
+        ::operator delete(*it);
+    }
+}
+
+void* Pool::allocate(std::size_t size)
+{
+    ++m_requests;
+
+    if (size + sizeof(Block) > m_size) {
+        ++m_allocations;
+        return allocateSystem(size);
+    }
+
+    if (not m_free) {
+        grow();
+    }
+
+    Block* block = m_free;
+    m_free = block->next;
+    block->owner = this;
+    ++m_used;
+
+    return block + 1;
+}
+
+void* Pool::allocateSystem(std::size_t size)
+{
+    Block* block = static_cast < Block* >(
+        ::operator new(sizeof(Block) + size));
+
+    block->owner = 0;
+    return block + 1;
+}
+
+void Pool::deallocate(void* ptr)
+{
+    if (ptr) {
+        Block* block = static_cast < Block* >(ptr) - 1;
+        Pool* owner = block->owner;
+
+        if (owner) {
+            block->next = owner->m_free;
+            owner->m_free = block;
+            --owner->m_used;
+        } else {
+            ::operator delete(block);
+        }
+    }
+}
+
+void Pool::grow()
+{
+    char* chunk = static_cast < char* >(::operator new(m_size * m_chunk));
+    m_chunks.push_back(chunk);
+    ++m_allocations;
+
+    for (std::size_t i = m_chunk; i > 0; --i) {
+        Block* block = reinterpret_cast < Block* >(chunk + (i - 1) * m_size);
+        block->next = m_free;
+        m_free = block;
+    }
+
+    if (m_chunk < 65536) {
+        m_chunk *= 2;
+    }
+}
+
+                       /* - - - - - - - - - -*/
+
+EventPool::EventPool()
+    : m_internal(sizeof(InternalEvent)), m_external(sizeof(ExternalEvent)),
+    m_payload(sizeof(ExternalEventPayload)), m_view(sizeof(ViewEvent))
+{
+}
+
+EventPool::~EventPool()
+{
+    if (currentEventPool == this) {
+        currentEventPool = 0;
+    }
+}
+
+void* EventPool::allocateInternal(std::size_t size)
+{
+    return currentEventPool ? currentEventPool->m_internal.allocate(size)
+        : Pool::allocateSystem(size);
+}
+
+void* EventPool::allocateExternal(std::size_t size)
+{
+    return currentEventPool ? currentEventPool->m_external.allocate(size)
+        : Pool::allocateSystem(size);
+}
+
+void* EventPool::allocatePayload(std::size_t size)
+{
+    return currentEventPool ? currentEventPool->m_payload.allocate(size)
+        : Pool::allocateSystem(size);
+}
+
+void* EventPool::allocateView(std::size_t size)
+{
+    return currentEventPool ? currentEventPool->m_view.allocate(size)
+        : Pool::allocateSystem(size);
+}
+
+EventPool* EventPool::current()
+{
+    return currentEventPool;
+}
+
+std::size_t EventPool::allocations() const
+{
+    return m_internal.allocations() + m_external.allocations() +
+        m_payload.allocations() + m_view.allocations();
+}
+
+std::size_t EventPool::requests() const
+{
+    return m_internal.requests() + m_external.requests() +
+        m_payload.requests() + m_view.requests();
+}
+
+EventPool::Scope::Scope(EventPool& pool)
+    : m_previous(currentEventPool)
+{
+    currentEventPool = &pool;
+}
+
+EventPool::Scope::~Scope()
+{
+    currentEventPool = m_previous;
+}
+
+}} // namespace vle devs
@@ -0,0 +1,240 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef VLE_DEVS_EVENTPOOL_HPP
+#define VLE_DEVS_EVENTPOOL_HPP 1
+
+#include <vle/DllDefines.hpp>
+#include <cstddef>
+#include <vector>
+
+namespace vle { namespace devs {
+
+/**
+ * @brief Pool is a free list of fixed size memory blocks. The blocks are
+ * taken from chunks allocated by the system and never released before
+ * the destruction of the Pool: a released block is pushed in front of
+ * the free list and is reused by the next allocation.
+ *
+ * Each block starts with a small header which stores the owner Pool of
+ * the block. A block can therefore be released without knowing its Pool
+ * and a block allocated by the system (when no Pool is available) can be
+ * released by the same function.
+ */
+class VLE_API Pool
+{
+public:
+    /**
+     * @brief Build an empty Pool.
+     * @param size The size of the blocks.
+     * @param chunk The number of blocks of the first chunk. The next
+     * chunks double in size.
+     */
+    Pool(std::size_t size, std::size_t chunk = 256);
+
+    /**
+     * @brief Release all the chunks. Blocks still used are lost.
+     */
+    ~Pool();
+
+    /**
+     * @brief Get a block from the free list. If the free list is empty, a
+     * new chunk is allocated.
+     * @param size The size of the object to build. If the size is greater
+     * than the size of the block, the block is allocated by the system.
+     * @return A pointer to the memory.
+     */
+    void* allocate(std::size_t size);
+
+    /**
+     * @brief Allocate a block by the system, without Pool.
+     * @param size The size of the object to build.
+     * @return A pointer to the memory.
+     */
+    static void* allocateSystem(std::size_t size);
+
+    /**
+     * @brief Release a block allocated by a Pool::allocate() or
+     * Pool::allocateSystem() function.
+     * @param ptr The block to release, can be null.
+     */
+    static void deallocate(void* ptr);
+
+    /**
+     * @brief Get the number of allocations requested to the system.
+     * @return A number of chunks and large blocks.
+     */
+    std::size_t allocations() const { return m_allocations; }
+
+    /**
+     * @brief Get the number of blocks requested to the Pool.
+     * @return A number of blocks.
+     */
+    std::size_t requests() const { return m_requests; }
+
+    /**
+     * @brief Get the number of blocks currently used.
+     * @return A number of blocks.
+     */
+    std::size_t used() const { return m_used; }
+
+private:
+    Pool(const Pool&);
+    Pool& operator=(const Pool&);
+
+    /**
+     * @brief The header of all the blocks. When the block is free, the
+     * header stores the next free block, otherwise the owner Pool. The
+     * double and the pointer ensure the alignment of the object.
+     */
+    union Block
+    {
+        Pool   *owner;
+        Block  *next;
+        double  align;
+        void   *palign;
+    };
+
+    void grow();
+
+    std::vector < void* > m_chunks; /**< Chunks allocated by the
+                                      system. */
+    Block       *m_free;            /**< The head of the free list. */
+    std::size_t  m_size;            /**< Size of the blocks, header
+                                      included. */
+    std::size_t  m_chunk;           /**< Number of blocks of the next
+                                      chunk. */
+    std::size_t  m_allocations;
+    std::size_t  m_requests;
+    std::size_t  m_used;
+};
+
+/**
+ * @brief EventPool groups the Pool of devs::InternalEvent,
+ * devs::ExternalEvent, devs::ExternalEventPayload and devs::ViewEvent of a
+ * devs::Coordinator.
+ *
+ * The operators new and delete of these events use the EventPool of the
+ * current thread, defined by an EventPool::Scope. Without EventPool, the
+ * events are allocated by the system. An event can be deleted anywhere:
+ * the block goes back to its own Pool. The EventPool must outlive its
+ * events and must only be used by one thread at a time.
+ *
+ * @code
+ * EventPool pool;
+ * {
+ *     EventPool::Scope scope(pool);
+ *     ExternalEvent* evt = new ExternalEvent("out"); // from the pool.
+ *     delete evt;                                    // to the pool.
+ * }
+ * @endcode
+ */
+class VLE_API EventPool
+{
+public:
+    EventPool();
+
+    ~EventPool();
+
+    /**
+     * @brief Get a block for a devs::InternalEvent from the current
+     * EventPool or from the system.
+     */
+    static void* allocateInternal(std::size_t size);
+
+    /**
+     * @brief Get a block for a devs::ExternalEvent from the current
+     * EventPool or from the system.
+     */
+    static void* allocateExternal(std::size_t size);
+
+    /**
+     * @brief Get a block for a devs::ExternalEventPayload from the current
+     * EventPool or from the system.
+     */
+    static void* allocatePayload(std::size_t size);
+
+    /**
+     * @brief Get a block for a devs::ViewEvent from the current EventPool
+     * or from the system.
+     */
+    static void* allocateView(std::size_t size);
+
+    /**
+     * @brief Release a block of an event.
+     */
+    static void deallocate(void* ptr) { Pool::deallocate(ptr); }
+
+    /**
+     * @brief Get the EventPool used by the current thread.
+     * @return A pointer to the EventPool or null.
+     */
+    static EventPool* current();
+
+    /**
+     * @brief Get the number of allocations requested to the system by the
+     * Pool.
+     */
+    std::size_t allocations() const;
+
+    /**
+     * @brief Get the number of events built with the Pool.
+     */
+    std::size_t requests() const;
+
+    /**
+     * @brief Scope installs an EventPool as the current EventPool of the
+     * thread and restores the previous one at the end of the scope.
+     */
+    class VLE_API Scope
+    {
+    public:
+        Scope(EventPool& pool);
+
+        ~Scope();
+
+    private:
+        Scope(const Scope&);
+        Scope& operator=(const Scope&);
+
+        EventPool* m_previous;
+    };
+
+private:
+    EventPool(const EventPool&);
+    EventPool& operator=(const EventPool&);
+
+    Pool m_internal;
+    Pool m_external;
+    Pool m_payload;
+    Pool m_view;
+};
+
+}} // namespace vle devs
+
+#endif
@@ -56,6 +56,28 @@ std::map < Simulator*, EventBagModel >::value_type&
     throw utils::InternalError(_("Top bag problem"));
 }
 
+bool CompleteEventBagModel::popBags(
+    std::vector < std::map < Simulator*, EventBagModel >::value_type* >& bags)
+{
+    assert(_itbags == _bags.begin());
+
+    for (std::map < Simulator*, EventBagModel >::iterator it = _bags.begin();
+         it != _bags.end(); ++it) {
+        if (it->first->dynamics()->isExecutive()) {
+            return false;
+        }
+    }
+
+    bags.reserve(bags.size() + _bags.size());
+    for (std::map < Simulator*, EventBagModel >::iterator it = _bags.begin();
+         it != _bags.end(); ++it) {
+        bags.push_back(&(*it));
+    }
+
+    _itbags = _bags.end();
+    return true;
+}
+
 void CompleteEventBagModel::delModel(Simulator* mdl)
 {
     assert(_itbags == _bags.end()); // Normally, _itbags equals _bags.end since
@@ -66,71 +88,52 @@ void CompleteEventBagModel::delModel(Simulator* mdl)
 }
 
 EventTable::EventTable(size_t sz)
+    : mScheduler(new HeapScheduler(sz))
+{
+}
+
+EventTable::EventTable(const std::string& scheduler)
+    : mScheduler(Scheduler::build(scheduler))
 {
-    mInternalEventList.reserve(sz);
 }
 
 EventTable::~EventTable()
 {
-    std::for_each(mInternalEventList.begin(),
-                  mInternalEventList.end(),
-                  boost::checked_deleter < InternalEvent >());
+    delete mScheduler;
 
     std::for_each(mObservationEventList.begin(),
                   mObservationEventList.end(),
                   boost::checked_deleter < ViewEvent >());
-
-    {
-	for (ExternalEventModel::iterator it = mExternalEventModel.begin();
-	     it != mExternalEventModel.end(); ++it) {
-
-            std::for_each((*it).second.begin(),
-                          (*it).second.end(),
-                          boost::checked_deleter < ExternalEvent >());
-	}
-    }
 }
 
 size_t EventTable::getEventNumber() const
 {
-    size_t sum = mObservationEventList.size() + mInternalEventList.size();
+    size_t sum = mObservationEventList.size() + mScheduler->size();
 
     for (ExternalEventModel::const_iterator it = mExternalEventModel.begin();
 	     it != mExternalEventModel.end(); ++it) {
-	sum += (*it).second.size();
+	sum += (*it)->m_externalEvents.size();
     }
 
     return sum;
 }
 
-void EventTable::cleanInternalEventList()
-{
-    while (not mInternalEventList.empty() and
-	   not mInternalEventList[0]->isValid()) {
-	delete mInternalEventList[0];
-        std::pop_heap(mInternalEventList.begin(), mInternalEventList.end(),
-                      internalLessThan);
-        mInternalEventList.pop_back();
-    }
-
-}
-
 const Time& EventTable::topEvent()
 {
     if (not mExternalEventModel.empty()) {
         return mCurrentTime;
     } else {
-        cleanInternalEventList();
-        if (not mInternalEventList.empty()) {
+        const InternalEvent* internal = mScheduler->top();
+        if (internal) {
             if (not mObservationEventList.empty()) {
-                if (mInternalEventList[0]->getTime() <=
+                if (internal->getTime() <=
                     mObservationEventList.front()->getTime()) {
-                    return mInternalEventList[0]->getTime();
+                    return internal->getTime();
                 } else {
                     return mObservationEventList.front()->getTime();
                 }
             } else {
-                return mInternalEventList[0]->getTime();
+                return internal->getTime();
             }
         } else {
             if (not mObservationEventList.empty()) {
@@ -147,22 +150,23 @@ CompleteEventBagModel& EventTable::popEvent()
     mCurrentTime = topEvent();
 
     if (mCurrentTime != infinity) {
-	while (not mInternalEventList.empty() and
-               mInternalEventList[0]->getTime() == mCurrentTime) {
-            if (mInternalEventList[0]->isValid()) {
-                Simulator* mdl = mInternalEventList[0]->getModel();
-                EventBagModel& bagmodel = mCompleteEventBagModel.getBag(mdl);
-                bagmodel.addInternal(mInternalEventList[0]);
-            }
-            popInternalEvent();
+        InternalEvent* internal;
+	while ((internal = mScheduler->top()) and
+               internal->getTime() == mCurrentTime) {
+            mScheduler->pop();
+            Simulator* mdl = internal->getModel();
+            mdl->m_internalEvent = 0;
+            EventBagModel& bagmodel = mCompleteEventBagModel.getBag(mdl);
+            bagmodel.addInternal(internal);
 	}
 
-        while (not mExternalEventModel.empty()) {
-            Simulator* mdl = (*mExternalEventModel.begin()).first;
-            EventBagModel& bagmodel = mCompleteEventBagModel.getBag(mdl);
-            bagmodel.addExternal((*mExternalEventModel.begin()).second);
-	    mExternalEventModel.erase(mExternalEventModel.begin());
+        for (ExternalEventModel::iterator it = mExternalEventModel.begin();
+             it != mExternalEventModel.end(); ++it) {
+            EventBagModel& bagmodel = mCompleteEventBagModel.getBag(*it);
+            bagmodel.addExternal((*it)->m_externalEvents);
+            (*it)->m_externalEvents.clear();
 	}
+        mExternalEventModel.clear();
 
 	if (mCompleteEventBagModel.emptyBag())
 	  while (not mObservationEventList.empty() and
@@ -177,16 +181,17 @@ CompleteEventBagModel& EventTable::popEvent()
 
 bool EventTable::putInternalEvent(InternalEvent* event)
 {
-    mInternalEventList.push_back(event);
-    std::push_heap(mInternalEventList.begin(), mInternalEventList.end(),
-                   internalLessThan);
-
-    assert(event->getModel());
+    Simulator* mdl = event->getModel();
+    assert(mdl);
 
-    if (mInternalEventModel[event->getModel()])
-      mInternalEventModel[event->getModel()]->invalidate();
+    if (mdl->m_internalEvent) {
+        mScheduler->update(mdl->m_internalEvent, event->getTime());
+        delete event;
+    } else {
+        mScheduler->insert(event);
+        mdl->m_internalEvent = event;
+    }
 
-    mInternalEventModel[event->getModel()] = event;
     return true;
 }
 
@@ -195,12 +200,16 @@ bool EventTable::putExternalEvent(ExternalEvent* event)
     Simulator* mdl = event->getTarget();
     assert(mdl);
 
-    mExternalEventModel[mdl].push_back(event);
-    InternalEventModel::iterator it = mInternalEventModel.find(mdl);
-    if (it != mInternalEventModel.end() and (*it).second and
-        (*it).second->getTime() > getCurrentTime()) {
-	(*it).second->invalidate();
-	(*it).second = 0;
+    if (mdl->m_externalEvents.empty()) {
+        mExternalEventModel.push_back(mdl);
+    }
+    mdl->m_externalEvents.push_back(event);
+
+    if (mdl->m_internalEvent and
+        mdl->m_internalEvent->getTime() > getCurrentTime()) {
+        mScheduler->erase(mdl->m_internalEvent);
+        delete mdl->m_internalEvent;
+        mdl->m_internalEvent = 0;
     }
     return true;
 }
@@ -214,21 +223,6 @@ bool EventTable::putObservationEvent(ViewEvent* event)
     return true;
 }
 
-void EventTable::popInternalEvent()
-{
-    if (not mInternalEventList.empty()) {
-        InternalEvent* evt = mInternalEventList[0];
-        std::pop_heap(mInternalEventList.begin(), mInternalEventList.end(),
-                      internalLessThan);
-        mInternalEventList.pop_back();
-	if (evt->isValid()) {
-	    mInternalEventModel[evt->getModel()] = 0;
-	} else {
-	    delete evt;
-	}
-    }
-}
-
 void EventTable::popObservationEvent()
 {
     if (not mObservationEventList.empty()) {
@@ -239,28 +233,39 @@ void EventTable::popObservationEvent()
     }
 }
 
-void EventTable::delModelEvents(Simulator* mdl)
+void EventTable::clearObservationEvents()
 {
-    {
-        InternalEventModel::iterator it = mInternalEventModel.find(mdl);
-        if (it != mInternalEventModel.end()) {
-            if ((*it).second)
-                (*it).second->invalidate();
+    mObservationEventList.erase();
+}
 
-            mInternalEventModel.erase(it);
-        }
+InternalEvent* EventTable::releaseInternalEvent(Simulator* mdl)
+{
+    InternalEvent* event = mdl->m_internalEvent;
+
+    if (event) {
+        mScheduler->erase(event);
+        mdl->m_internalEvent = 0;
+    }
+
+    return event;
+}
+
+void EventTable::delModelEvents(Simulator* mdl)
+{
+    if (mdl->m_internalEvent) {
+        mScheduler->erase(mdl->m_internalEvent);
+        delete mdl->m_internalEvent;
+        mdl->m_internalEvent = 0;
     }
 
-    {
-        ExternalEventModel::iterator it = mExternalEventModel.find(mdl);
-        if (it != mExternalEventModel.end()) {
-            std::for_each((*it).second.begin(),
-                          (*it).second.end(),
-                          boost::checked_deleter < ExternalEvent >());
+    if (not mdl->m_externalEvents.empty()) {
+        std::for_each(mdl->m_externalEvents.begin(),
+                      mdl->m_externalEvents.end(),
+                      boost::checked_deleter < ExternalEvent >());
+        mdl->m_externalEvents.clear();
 
-            (*it).second.clear();
-            mExternalEventModel.erase(it);
-        }
+        mExternalEventModel.erase(std::find(mExternalEventModel.begin(),
+                                            mExternalEventModel.end(), mdl));
     }
 
     mObservationEventList.remove(mdl);
@@ -33,8 +33,10 @@
 #include <vle/devs/ExternalEvent.hpp>
 #include <vle/devs/ViewEvent.hpp>
 #include <vle/devs/Simulator.hpp>
+#include <vle/devs/Scheduler.hpp>
 #include <list>
 #include <set>
+#include <vector>
 
 namespace vle { namespace devs {
 
@@ -193,6 +195,18 @@ namespace vle { namespace devs {
          */
         std::map < Simulator*, EventBagModel >::value_type& topBag();
 
+        /**
+         * @brief Fill a list with all the bags of this
+         * CompleteEventBagModel, in the order of the topBag() function,
+         * and mark them as executed. Nothing is done if one bag belongs to
+         * an Executive model.
+         * @param bags The list to fill.
+         * @return True if the bags are added to the list, false if one bag
+         * belongs to an Executive model.
+         */
+        bool popBags(std::vector < std::map < Simulator*,
+                     EventBagModel >::value_type* >& bags);
+
         inline ViewEvent* topObservationEvent()
         { return _states.front(); }
 
@@ -240,21 +254,33 @@ namespace vle { namespace devs {
     /**
      * @brief Scheduller class to manage internal, external and state events.
      *
+     * Internal events are stored into a devs::Scheduler. The scheduled
+     * internal event and the waiting external events of a model are
+     * stored into its devs::Simulator, so no search is needed to replace,
+     * to cancel or to dispatch events.
      */
     class VLE_API EventTable
     {
     public:
         /**
-         * Initialisation of events vectors with specified size, and NULL
-         * value.
+         * Build an EventTable with the default devs::HeapScheduler.
          *
          * @param sz minimum size to initialise vectors (Default size if 4096).
          */
         EventTable(size_t sz = 4096);
 
         /**
-         * Delete all existing events in vectors internal, external, state
-         * and init. Be carreful, don't delete Event that you have put.
+         * Build an EventTable with the specified devs::Scheduler.
+         *
+         * @param scheduler The name of the scheduler (see
+         * devs::Scheduler::build).
+         * @throw utils::ArgError if the scheduler is unknown.
+         */
+        EventTable(const std::string& scheduler);
+
+        /**
+         * Delete all existing internal and state events. External events
+         * are deleted with the devs::Simulator.
          */
         ~EventTable();
 
@@ -281,11 +307,12 @@ namespace vle { namespace devs {
         CompleteEventBagModel& popEvent();
 
         /**
-         * Put an external event into vector heap. Delete event and return
-         * false if same model have already external model.
+         * Put an internal event into the scheduler. If the model already
+         * has an internal event, this event is moved to the date of the
+         * new one and the new one is deleted.
          *
-         * @param event InternalEvent to put into vector heap.
-         * @return true if InternalEvent is put into vector, otherwise false.
+         * @param event InternalEvent to put into the scheduler.
+         * @return true.
          */
         bool putInternalEvent(InternalEvent* event);
 
@@ -313,6 +340,40 @@ namespace vle { namespace devs {
         inline const Time& getCurrentTime() const
         { return mCurrentTime; }
 
+        /**
+         * @brief Set the current simulation Time without popping events.
+         * This function is used by the devs::Partition which are not
+         * imminent at the current time of the devs::Coordinator.
+         *
+         * @param time the new current simulation Time.
+         */
+        inline void setCurrentTime(const Time& time)
+        { mCurrentTime = time; }
+
+        /**
+         * @brief Remove the internal event of a Simulator from the
+         * scheduler without deleting it.
+         *
+         * @param mdl the model to remove the internal event.
+         * @return the InternalEvent or 0 if the model has no internal
+         * event.
+         */
+        InternalEvent* releaseInternalEvent(Simulator* mdl);
+
+        /**
+         * @brief Get the observation events of the scheduler, a heap
+         * ordered by date.
+         *
+         * @return the observation events.
+         */
+        inline const ViewEventList& observationEvents() const
+        { return mObservationEventList; }
+
+        /**
+         * @brief Delete all the observation events of the scheduler.
+         */
+        void clearObservationEvents();
+
         /**
          * @brief Delete all event from Simulator.
          *
@@ -321,14 +382,10 @@ namespace vle { namespace devs {
         void delModelEvents(Simulator* mdl);
 
     private:
-        typedef std::map < Simulator*, InternalEvent* > InternalEventModel;
-        typedef std::map < Simulator*, ExternalEventList > ExternalEventModel;
+        EventTable(const EventTable& other);
+        EventTable& operator=(const EventTable& other);
 
-	/**
-	 * Delete the first event in Internal heap.
-	 *
-	 */
-	void popInternalEvent();
+        typedef std::vector < Simulator* > ExternalEventModel;
 
 	/**
 	 * Delete the first event in State heap.
@@ -336,21 +393,13 @@ namespace vle { namespace devs {
 	 */
 	void popObservationEvent();
 
-        /**
-         * @brief delete the first invalid InternalEvent from InternalEventList.
-         */
-        void cleanInternalEventList();
-
 	/// scheduller for internal event.
-	InternalEventList mInternalEventList;
+        Scheduler*          mScheduler;
 
 	/// scheduller for state events.
 	ViewEventList mObservationEventList;
 
-	/// table to quick found event.
-	InternalEventModel mInternalEventModel;
-
-	/// table to conserve external event.
+	/// models with waiting external events.
 	ExternalEventModel mExternalEventModel;
 
 	/// the bag to send with popEvent function.
@@ -123,6 +123,10 @@ void Executive::renameModel(const std::string& oldname,
             fmt(_("Executive error: rename `%1%' into `%2%' failed: `%3%' ")) %
             oldname % newname % e.what());
     }
+
+    if (mdl->isAtomic()) {
+        m_coordinator.renameModel(mdl->toAtomic(), oldname);
+    }
 }
 
 void Executive::addConnection(const std::string& srcModelName,
@@ -155,7 +159,8 @@ void Executive::addConnection(const std::string& srcModelName,
         } else {
             cpled()->addInternalConnection(srcModel, srcPortName, dstModel,
                                            dstPortName);
-            m_coordinator.getSimulatorsSource(dstModel, dstPortName, toupdate);
+            getSimulatorsSource(srcModel, srcPortName, dstModel, dstPortName,
+                                toupdate);
         }
 
         m_coordinator.updateSimulatorsTarget(toupdate);
@@ -192,7 +197,8 @@ void Executive::removeConnection(const std::string& srcModelName,
         } else if (cpled() == dstModel) {
             cpled()->delOutputConnection(srcModel, srcPortName, dstPortName);
         } else {
-            m_coordinator.getSimulatorsSource(dstModel, dstPortName, toupdate);
+            getSimulatorsSource(srcModel, srcPortName, dstModel, dstPortName,
+                                toupdate);
             cpled()->delInternalConnection(srcModel, srcPortName, dstModel,
                                            dstPortName);
         }
@@ -206,6 +212,22 @@ void Executive::removeConnection(const std::string& srcModelName,
     }
 }
 
+void Executive::getSimulatorsSource(
+    vpz::BaseModel* srcModel, const std::string& srcPortName,
+    vpz::BaseModel* dstModel, const std::string& dstPortName,
+    std::vector < std::pair < Simulator*, std::string > >& lst)
+{
+    if (srcModel->isAtomic()) {
+        if (m_coordinator.isStarted()) {
+            lst.push_back(std::make_pair(
+                    m_coordinator.getModel(srcModel->toAtomic()),
+                    srcPortName));
+        }
+    } else {
+        m_coordinator.getSimulatorsSource(dstModel, dstPortName, lst);
+    }
+}
+
 void Executive::addInputPort(const std::string& modelName,
                              const std::string& portName)
 {
@@ -35,6 +35,8 @@
 #include <vle/vpz/Dynamics.hpp>
 #include <vle/vpz/Conditions.hpp>
 #include <vle/vpz/Observables.hpp>
+#include <vle/utils/Trace.hpp>
+#include <vle/utils/i18n.hpp>
 #include <vle/version.hpp>
 
 #define DECLARE_EXECUTIVE(mdl)                                          \
@@ -66,8 +68,11 @@ class VLE_API ExecutiveInit : public DynamicsInit
 public:
     ExecutiveInit(const vpz::AtomicModel& model,
                   PackageId packageid,
-                  Coordinator& coordinator)
-        : DynamicsInit(model, packageid), m_coordinator(coordinator)
+                  Coordinator& coordinator,
+                  uint32_t seed = 0,
+                  uint32_t replica = 0)
+        : DynamicsInit(model, packageid, seed, replica),
+        m_coordinator(coordinator)
     {}
 
     virtual ~ExecutiveInit()
@@ -183,6 +188,81 @@ public:
     //
     // / / / /
 
+    /**
+     * @brief Start a transaction: the following changes of models,
+     * connections and ports are applied to the coupled model at once but
+     * the routing of the simulators is rebuilt only by
+     * commitTransaction(), once for each output port modified. Use a
+     * transaction to rewire many connections in the same transition.
+     * The changes are not rolled back if one of them fails.
+     * @code
+     * void MyExecutive::internalTransition(const devs::Time& time)
+     * {
+     *     beginTransaction();
+     *     for (...) {
+     *         removeConnection(a, "out", b, "in");
+     *         addConnection(a, "out", c, "in");
+     *     }
+     *     commitTransaction();
+     * }
+     * @endcode
+     */
+    void beginTransaction()
+    { m_coordinator.beginTransaction(); }
+
+    /**
+     * @brief Close the transaction started by beginTransaction() and
+     * rebuild the routing of the simulators. The routing must be
+     * rebuilt before the end of the transition, the events sent by the
+     * simulators use it: the devs::Coordinator throws an
+     * utils::ModellingError if a transition ends with a transaction not
+     * committed.
+     * @throw utils::InternalError if no transaction is started.
+     */
+    void commitTransaction()
+    { m_coordinator.commitTransaction(); }
+
+    /**
+     * @brief A scoped transaction: started by the constructor and
+     * committed by commit(). The destructor never throws: a transaction
+     * not committed is traced and left open, so the devs::Coordinator
+     * throws an utils::ModellingError at the end of the transition.
+     * @code
+     * devs::Executive::Transaction transaction(*this);
+     * addConnection(a, "out", c, "in");
+     * transaction.commit();
+     * @endcode
+     */
+    class Transaction
+    {
+    public:
+        Transaction(Executive& executive)
+            : m_executive(executive), m_open(true)
+        { m_executive.beginTransaction(); }
+
+        ~Transaction()
+        {
+            if (m_open) {
+                TraceAlways(fmt(_("Executive '%1%': transaction not "
+                                  "committed")) %
+                            m_executive.getModelName());
+            }
+        }
+
+        void commit()
+        {
+            m_open = false;
+            m_executive.commitTransaction();
+        }
+
+    private:
+        Transaction(const Transaction& other);
+        Transaction& operator=(const Transaction& other);
+
+        Executive& m_executive;
+        bool       m_open;
+    };
+
     /**
      * @brief Build a new devs::Simulator from the dynamics library. Attach
      * to this model information of dynamics, condition and observable.
@@ -359,6 +439,16 @@ private:
      * @return A reference to the coupled model.
      */
     vpz::CoupledModel* cpled() { return getModel().getParent(); }
+
+    /**
+     * @brief Get the simulators whose routing depends on an internal
+     * connection: only the source port if the source is an atomic model,
+     * otherwise all the sources of the destination port.
+     */
+    void getSimulatorsSource(
+        vpz::BaseModel* srcModel, const std::string& srcPortName,
+        vpz::BaseModel* dstModel, const std::string& dstPortName,
+        std::vector < std::pair < Simulator*, std::string > >& lst);
 };
 
 }} // namespace vle devs
@@ -29,12 +29,81 @@
 
 namespace vle { namespace devs {
 
+value::Map& ExternalEventPayload::materialize()
+{
+    if (m_attributes == 0) {
+        m_attributes = new value::Map();
+        if (m_scalars) {
+            m_attributes->value().reserve(m_scalars + 1);
+        }
+
+        for (std::size_t i = 0; i < m_scalars; ++i) {
+            m_attributes->add(m_scalar[i].first, m_scalar[i].second);
+        }
+        m_scalars = 0;
+    }
+
+    return *m_attributes;
+}
+
 void ExternalEvent::putAttributes(const value::Map& mp)
 {
     for (value::MapValue::const_iterator it = mp.value().begin();
          it != mp.value().end(); ++it) {
-        putAttribute((*it).first, (*it).second->clone());
+        if (it->second and value::Scalar::isScalar(*it->second)) {
+            putAttribute(it->first, value::Scalar::fromValue(*it->second));
+        } else {
+            putAttribute(it->first, it->second ? it->second->clone() : 0);
+        }
     }
 }
 
+void ExternalEvent::putAttribute(const std::string& name,
+                                 const value::Scalar& value)
+{
+    ExternalEventPayload& payload = *m_payload;
+
+    if (payload.m_attributes == 0) {
+        for (std::size_t i = 0; i < payload.m_scalars; ++i) {
+            if (payload.m_scalar[i].first == name) {
+                payload.m_scalar[i].second = value;
+                return;
+            }
+        }
+
+        if (payload.m_scalars < ExternalEventPayload::SCALARS) {
+            payload.m_scalar[payload.m_scalars].first = name;
+            payload.m_scalar[payload.m_scalars].second = value;
+            ++payload.m_scalars;
+            return;
+        }
+    }
+
+    attributes().add(name, value);
+}
+
+ExternalEvent* ExternalEvent::copy(Simulator* target,
+                                   const PortName& targetPortName) const
+{
+    ExternalEventPayload* payload = new ExternalEventPayload(
+        m_payload->m_port);
+
+    if (m_payload->m_attributes) {
+        try {
+            payload->m_attributes = static_cast < value::Map* >(
+                m_payload->m_attributes->clone());
+        } catch (...) {
+            payload->unref();
+            throw;
+        }
+    }
+
+    for (std::size_t i = 0; i < m_payload->m_scalars; ++i) {
+        payload->m_scalar[i] = m_payload->m_scalar[i];
+    }
+    payload->m_scalars = m_payload->m_scalars;
+
+    return new ExternalEvent(payload, target, targetPortName);
+}
+
 }} // namespace vle devs
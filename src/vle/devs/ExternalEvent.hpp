@@ -30,24 +30,119 @@
 
 #include <vle/DllDefines.hpp>
 #include <vle/devs/Attribute.hpp>
-#include <boost/shared_ptr.hpp>
+#include <vle/devs/EventPool.hpp>
+#include <vle/devs/PortName.hpp>
 #include <string>
 
 namespace vle { namespace devs {
 
 class Simulator;
 
+/**
+ * @brief ExternalEventPayload is the part of an ExternalEvent shared by
+ * all the targets of an output: the source port and the attributes. The
+ * ExternalEvent built for each target by the devs::Coordinator only
+ * stores the target, the target port and a reference to the payload.
+ *
+ * The first scalar attributes (see value::Scalar) are stored into the
+ * payload without allocation. The value::Map of attributes is only
+ * built for the composite values or when a model asks for it.
+ *
+ * The reference counter is not thread-safe: the events of a simulation
+ * belong to the thread of their devs::Coordinator. Building the
+ * value::Map modifies the payload, even from the const functions of the
+ * ExternalEvent: before running the transitions of a bag on several
+ * threads, the devs::Coordinator builds the value::Map of the payloads
+ * shared by several events (see ExternalEvent::materializeShared).
+ */
+class VLE_API ExternalEventPayload
+{
+public:
+    /**
+     * @brief Allocate the payload from the current devs::EventPool.
+     */
+    static void* operator new(std::size_t size)
+    { return EventPool::allocatePayload(size); }
+
+    /**
+     * @brief Release the payload into its devs::EventPool.
+     */
+    static void operator delete(void* ptr)
+    { EventPool::deallocate(ptr); }
+
+private:
+    ExternalEventPayload(const std::string& port)
+        : m_port(port), m_attributes(0), m_scalars(0), m_references(1)
+    {}
+
+    ~ExternalEventPayload()
+    { delete m_attributes; }
+
+    ExternalEventPayload(const ExternalEventPayload& other);
+    ExternalEventPayload& operator=(const ExternalEventPayload& other);
+
+    void ref()
+    { ++m_references; }
+
+    void unref()
+    {
+        if (--m_references == 0) {
+            delete this;
+        }
+    }
+
+    /**
+     * @brief Move the scalar attributes into the value::Map of
+     * attributes. The strings of the scalars are kept until the
+     * destruction of the payload for the references already returned.
+     */
+    value::Map& materialize();
+
+    /**
+     * @brief Find a scalar attribute.
+     * @return The scalar or NULL if the attribute is not a scalar
+     * attribute.
+     */
+    const value::Scalar* scalar(const std::string& name) const
+    {
+        for (std::size_t i = 0; i < m_scalars; ++i) {
+            if (m_scalar[i].first == name) {
+                return &m_scalar[i].second;
+            }
+        }
+        return 0;
+    }
+
+    friend class ExternalEvent;
+
+    enum { SCALARS = 4 };
+
+    std::string  m_port;        /**< The source port. */
+    value::Map  *m_attributes;  /**< The attributes, built on demand. */
+    ScalarAttribute m_scalar[SCALARS]; /**< The scalar attributes stored
+                                         before the value::Map is
+                                         built. */
+    std::size_t  m_scalars;     /**< Number of scalar attributes. */
+    std::size_t  m_references;  /**< Number of ExternalEvent using this
+                                  payload. */
+};
+
 /**
  * @brief External event based on the devs::Event class and are build by
  * graph::Model when output function are called.
  *
+ * An ExternalEvent built with a port name owns a new
+ * devs::ExternalEventPayload. An ExternalEvent built from another event
+ * for a target shares the payload of the source event: the attributes are
+ * not copied and the target port name is interned (see devs::PortName).
  */
 class VLE_API ExternalEvent
 {
 public:
     ExternalEvent(const std::string& sourcePortName)
         : m_target(0),
-        m_port(sourcePortName)
+        m_payload(new ExternalEventPayload(sourcePortName)),
+        m_port(&m_payload->m_port)
     {
     }
 
@@ -55,23 +150,67 @@ public:
                   Simulator* target,
                   const std::string& targetPortName)
         : m_target(target),
-        m_attributes(event.m_attributes),
-        m_port(targetPortName)
+        m_payload(event.m_payload),
+        m_port(&PortName(targetPortName).str())
     {
+        m_payload->ref();
+    }
+
+    /**
+     * @brief Build an ExternalEvent for a target. This constructor is used
+     * by the devs::Coordinator with the interned port names of the
+     * connections.
+     * @param event The source event to share.
+     * @param target The target simulator.
+     * @param targetPortName The input port of the target.
+     */
+    ExternalEvent(ExternalEvent& event,
+                  Simulator* target,
+                  const PortName& targetPortName)
+        : m_target(target),
+        m_payload(event.m_payload),
+        m_port(&targetPortName.str())
+    {
+        m_payload->ref();
     }
 
     ~ExternalEvent()
     {
+        m_payload->unref();
     }
 
+    /**
+     * @brief Build a copy of this ExternalEvent for a target with its own
+     * payload: the source port is copied and the attributes are cloned.
+     * This function is used to send an event to a target simulated by
+     * another thread (see devs::Partition).
+     * @param target The target simulator.
+     * @param targetPortName The input port of the target.
+     * @return A new ExternalEvent.
+     */
+    ExternalEvent* copy(Simulator* target,
+                        const PortName& targetPortName) const;
+
+    /**
+     * @brief Allocate the ExternalEvent from the current devs::EventPool.
+     */
+    static void* operator new(std::size_t size)
+    { return EventPool::allocateExternal(size); }
+
+    /**
+     * @brief Release the ExternalEvent into its devs::EventPool.
+     */
+    static void operator delete(void* ptr)
+    { EventPool::deallocate(ptr); }
+
     const std::string& getPortName() const
-    { return m_port; }
+    { return *m_port; }
 
     Simulator* getTarget()
     { return m_target; }
 
     bool onPort(const std::string& portName) const
-    { return m_port == portName; }
+    { return *m_port == portName; }
 
     void putAttributes(const value::Map& map);
 
@@ -83,6 +222,15 @@ public:
     void putAttribute(const std::string& name, value::Value* value)
     { attributes().add(name, value); }
 
+    /**
+     * Put a scalar attribute on this Event. The scalar is stored without
+     * allocation if the event has less than four attributes and no
+     * composite attribute.
+     * @param name std::string name of the attribute.
+     * @param value the scalar to copy.
+     */
+    void putAttribute(const std::string& name, const value::Scalar& value);
+
     /**
      * Put an attribute on an event. The goal is to simplify building event.
      * @code
@@ -120,6 +268,20 @@ public:
         return event;
     }
 
+    friend ExternalEvent* operator<<(ExternalEvent* event,
+            const ScalarAttribute& attr)
+    {
+        event->putAttribute(attr.first, attr.second);
+        return event;
+    }
+
+    friend ExternalEvent& operator<<(ExternalEvent& event,
+            const ScalarAttribute& attr)
+    {
+        event.putAttribute(attr.first, attr.second);
+        return event;
+    }
+
     /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
     /**
@@ -128,7 +290,10 @@ public:
      * @return true if Value exist, false otherwise.
      */
     bool existAttributeValue(const std::string& name) const
-    { return haveAttributes() ? attributes().exist(name) : false; }
+    {
+        return m_payload->scalar(name) or
+            (m_payload->m_attributes and m_payload->m_attributes->exist(name));
+    }
 
     /**
      * Get an attribute from this Event.
@@ -145,7 +310,10 @@ public:
      * @return a double.
      */
     double getDoubleAttributeValue(const std::string& name) const
-    { return attributes().getDouble(name); }
+    {
+        const value::Scalar* scalar = m_payload->scalar(name);
+        return scalar ? scalar->toDouble() : attributes().getDouble(name);
+    }
 
     /**
      * Get an integer attribute from this Event.
@@ -153,7 +321,10 @@ public:
      * @return an integer.
      */
     int32_t getIntegerAttributeValue(const std::string& name) const
-    { return attributes().getInt(name); }
+    {
+        const value::Scalar* scalar = m_payload->scalar(name);
+        return scalar ? scalar->toInteger() : attributes().getInt(name);
+    }
 
     /**
      * Get a boolean attribute from this Event.
@@ -161,7 +332,10 @@ public:
      * @return a boolean.
      */
     bool getBooleanAttributeValue(const std::string& name) const
-    { return attributes().getBoolean(name); }
+    {
+        const value::Scalar* scalar = m_payload->scalar(name);
+        return scalar ? scalar->toBoolean() : attributes().getBoolean(name);
+    }
 
     /**
      * Get a string attribute from this Event.
@@ -170,7 +344,10 @@ public:
      */
     const std::string& getStringAttributeValue(
         const std::string& name) const
-    { return attributes().getString(name); }
+    {
+        const value::Scalar* scalar = m_payload->scalar(name);
+        return scalar ? scalar->toString() : attributes().getString(name);
+    }
 
     /**
      * @brief Get a Set attribute from this event.
@@ -209,22 +386,32 @@ public:
      * @return True if the attributes lists exists, false otherwise.
      */
     bool haveAttributes() const
-    { return m_attributes.get(); }
+    { return m_payload->m_attributes or m_payload->m_scalars; }
 
-    value::Map& attributes()
+    /**
+     * @brief Build the value::Map of attributes if the payload is shared
+     * with other events. Afterwards, the attributes of all the events of
+     * this payload are read without modifying the payload and the targets
+     * can read them from several threads.
+     */
+    void materializeShared()
     {
-        if (m_attributes.get() == 0) {
-            m_attributes = boost::shared_ptr < value::Map >(new value::Map());
+        if (m_payload->m_references > 1 and m_payload->m_scalars) {
+            m_payload->materialize();
         }
-        return *m_attributes;
+    }
+
+    value::Map& attributes()
+    {
+        return m_payload->materialize();
     }
 
     const value::Map& attributes() const
     {
-        if (m_attributes.get() == 0) {
+        if (not haveAttributes()) {
             throw utils::ArgError(_("No attribute in this event"));
         }
-        return *m_attributes;
+        return m_payload->materialize();
     }
 
 private:
@@ -232,9 +419,19 @@ private:
     ExternalEvent(const ExternalEvent& other);
     ExternalEvent& operator=(const ExternalEvent& other);
 
-    Simulator                        *m_target;
-    boost::shared_ptr < value::Map >  m_attributes;
-    std::string                       m_port;
+    ExternalEvent(ExternalEventPayload* payload,
+                  Simulator* target,
+                  const PortName& targetPortName)
+        : m_target(target), m_payload(payload),
+        m_port(&targetPortName.str())
+    {
+    }
+
+    Simulator            *m_target;
+    ExternalEventPayload *m_payload;
+    const std::string    *m_port;   /**< The source port stored into the
+                                      payload or an interned target
+                                      port. */
 };
 
 }} // namespace vle devs
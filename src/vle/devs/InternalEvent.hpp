@@ -30,7 +30,9 @@
 
 #include <vle/DllDefines.hpp>
 #include <vle/devs/Time.hpp>
+#include <vle/devs/EventPool.hpp>
 #include <vector>
+#include <cstddef>
 
 namespace vle { namespace devs {
 
@@ -39,8 +41,9 @@ class Simulator;
 /**
  * The @e InternalEvent represents internal events in VLE.
  *
- * The @e InternalEvent is only used by the scheduler of VLE. To
- * speed-up the simulation an @e InternalEvent can be invalidate.
+ * The @e InternalEvent is only used by the scheduler of VLE. An @e
+ * InternalEvent stores the hooks used by the @e Scheduler to cancel or
+ * to move it in place without any search.
  */
 class VLE_API InternalEvent
 {
@@ -52,7 +55,8 @@ public:
      * @param simualtor The @e simulator associated.
      */
     InternalEvent(const Time& time, Simulator* simulator)
-        : m_simulator(simulator), m_time(time), m_isvalid(true)
+        : m_simulator(simulator), m_time(time), m_isvalid(true),
+          m_prev(0), m_next(0), m_position(0)
     {
     }
 
@@ -64,6 +68,18 @@ public:
     {
     }
 
+    /**
+     * @brief Allocate the InternalEvent from the current devs::EventPool.
+     */
+    static void* operator new(std::size_t size)
+    { return EventPool::allocateInternal(size); }
+
+    /**
+     * @brief Release the InternalEvent into its devs::EventPool.
+     */
+    static void operator delete(void* ptr)
+    { EventPool::deallocate(ptr); }
+
     /**
      * Get a pointer to the simulator.
      *
@@ -150,9 +166,17 @@ private:
     InternalEvent(const InternalEvent&);
     InternalEvent& operator=(const InternalEvent&);
 
-    Simulator *m_simulator;     /**< A pointer to the simulator. */
-    Time       m_time;          /**< The time to wake-up the simulator. */
-    bool       m_isvalid;       /**< Is this InternalEvent valid? */
+    friend class HeapScheduler;
+    friend class CalendarScheduler;
+
+    Simulator     *m_simulator; /**< A pointer to the simulator. */
+    Time           m_time;      /**< The time to wake-up the simulator. */
+    bool           m_isvalid;   /**< Is this InternalEvent valid? */
+    InternalEvent *m_prev;      /**< Previous event in the scheduler
+                                  bucket. */
+    InternalEvent *m_next;      /**< Next event in the scheduler bucket. */
+    std::size_t    m_position;  /**< Index in the scheduler heap or
+                                  bucket. */
 };
 
 /**
@@ -44,14 +44,29 @@ ModelFactory::ModelFactory(const utils::ModuleManager& modulemgr,
                            const vpz::Dynamics& dyn,
                            const vpz::Classes& cls,
                            const vpz::Experiment& exp,
-                           RootCoordinator& root)
-    : mModuleMgr(modulemgr), mDynamics(dyn), mClasses(cls), mExperiment(exp),
-      mRoot(root)
+                           RootCoordinator& root,
+                           bool shared)
+    : mModuleMgr(modulemgr), mSharedDynamics(&dyn), mSharedClasses(&cls),
+      mExperiment(exp), mRoot(root)
 {
+    if (not shared) {
+        detach();
+    }
+}
+
+void ModelFactory::detach()
+{
+    if (mSharedDynamics) {
+        mDynamics.add(*mSharedDynamics);
+        mClasses.list().insert(mSharedClasses->begin(), mSharedClasses->end());
+        mSharedDynamics = 0;
+        mSharedClasses = 0;
+    }
 }
 
 void ModelFactory::cleanCache()
 {
+    detach();
     mDynamics.cleanNoPermanent();
     mExperiment.cleanNoPermanent();
 }
@@ -59,6 +74,7 @@ void ModelFactory::cleanCache()
 void ModelFactory::addPermanent(const vpz::Dynamic& dynamics)
 {
     try {
+        detach();
         mDynamics.add(dynamics);
     } catch(const std::exception& e) {
         throw utils::InternalError(fmt(_(
@@ -97,7 +113,8 @@ void ModelFactory::createModel(Coordinator& coordinator,
                                const std::vector < std::string >& conditions,
                                const std::string& observable)
 {
-    const vpz::Dynamic& dyn = mDynamics.get(dynamics);
+    const vpz::Dynamic& dyn = ((const ModelFactory&)*this).dynamics().get(
+        dynamics);
 
     const SimulatorMap& result(coordinator.modellist());
     if (result.find(model) != result.end()) {
@@ -166,9 +183,11 @@ void ModelFactory::createModel(Coordinator& coordinator,
         }
     }
 
-    InternalEvent* evt = sim->init(coordinator.getCurrentTime());
-    if (evt) {
-        coordinator.eventtable().putInternalEvent(evt);
+    if (not coordinator.isRestoring()) {
+        InternalEvent* evt = sim->init(coordinator.getCurrentTime());
+        if (evt) {
+            coordinator.eventtable().putInternalEvent(evt);
+        }
     }
 }
 
@@ -193,6 +212,8 @@ void ModelFactory::createModels(Coordinator& coordinator,
                         (*it)->conditions(),
                         (*it)->observables());
         }
+
+        coordinator.buildSimulatorsTarget(atomicmodellist);
     }
 }
 
@@ -201,7 +222,7 @@ vpz::BaseModel* ModelFactory::createModelFromClass(Coordinator& coordinator,
                                                  const std::string& classname,
                                                  const std::string& modelname)
 {
-    vpz::Class& classe(mClasses.get(classname));
+    const vpz::Class& classe(classes().get(classname));
     vpz::BaseModel* mdl(classe.model()->clone());
     vpz::AtomicModelVector atomicmodellist;
     vpz::BaseModel::getAtomicModelList(mdl, atomicmodellist);
@@ -216,6 +237,8 @@ vpz::BaseModel* ModelFactory::createModelFromClass(Coordinator& coordinator,
                     (*it)->observables());
     }
 
+    coordinator.buildSimulatorsTarget(atomicmodellist);
+
     return mdl;
 }
 
@@ -223,7 +246,9 @@ static devs::Dynamics* buildNewDynamicsWrapper(
     devs::Simulator* atom,
     const vpz::Dynamic& dyn,
     const InitEventList& events,
-    void* symbol)
+    void* symbol,
+    uint32_t seed,
+    uint32_t replica)
 {
     typedef Dynamics*(*fctdw)(const DynamicsWrapperInit&, const InitEventList&);
 
@@ -234,7 +259,7 @@ static devs::Dynamics* buildNewDynamicsWrapper(
         return fct(DynamicsWrapperInit(
                 *atom->getStructure(),
                 pkg_table.get(dyn.package()),
-                dyn.library()), events);
+                dyn.library(), seed, replica), events);
     } catch(const std::exception& e) {
         throw utils::ModellingError(
             fmt(_("Atomic model wrapper `%1%:%2%' (from dynamics `%3%'"
@@ -250,7 +275,9 @@ static devs::Dynamics* buildNewDynamics(
     devs::Simulator* atom,
     const vpz::Dynamic& dyn,
     const InitEventList& events,
-    void *symbol)
+    void *symbol,
+    uint32_t seed,
+    uint32_t replica)
 {
     typedef Dynamics*(*fctdyn)(const DynamicsInit&, const InitEventList&);
 
@@ -260,7 +287,7 @@ static devs::Dynamics* buildNewDynamics(
         utils::PackageTable pkg_table;
         return fct(DynamicsInit(
                 *atom->getStructure(),
-                pkg_table.get(dyn.package())),
+                pkg_table.get(dyn.package()), seed, replica),
             events);
     } catch(const std::exception& e) {
         throw utils::ModellingError(
@@ -277,7 +304,9 @@ static devs::Dynamics* buildNewExecutive(
     devs::Simulator* atom,
     const vpz::Dynamic& dyn,
     const InitEventList& events,
-    void *symbol)
+    void *symbol,
+    uint32_t seed,
+    uint32_t replica)
 {
     typedef Dynamics*(*fctexe)(const ExecutiveInit&, const InitEventList&);
 
@@ -288,7 +317,7 @@ static devs::Dynamics* buildNewExecutive(
         return fct(ExecutiveInit(
                 *atom->getStructure(),
                 pkg_table.get(dyn.package()),
-                coordinator), events);
+                coordinator, seed, replica), events);
     } catch(const std::exception& e) {
         throw utils::ModellingError(
             fmt(_("Executive model `%1%:%2%' (from dynamics `%3%'"
@@ -321,11 +350,14 @@ devs::Dynamics* ModelFactory::attachDynamics(Coordinator& coordinator,
 
     switch (type) {
     case utils::MODULE_DYNAMICS:
-        return buildNewDynamics(atom, dyn, events, symbol);
+        return buildNewDynamics(atom, dyn, events, symbol,
+                                mExperiment.seed(), mRoot.replica());
     case utils::MODULE_DYNAMICS_EXECUTIVE:
-        return buildNewExecutive(coordinator, atom, dyn, events, symbol);
+        return buildNewExecutive(coordinator, atom, dyn, events, symbol,
+                                 mExperiment.seed(), mRoot.replica());
     case utils::MODULE_DYNAMICS_WRAPPER:
-        return buildNewDynamicsWrapper(atom, dyn, events, symbol);
+        return buildNewDynamicsWrapper(atom, dyn, events, symbol,
+                                       mExperiment.seed(), mRoot.replica());
     default:
         throw utils::ModellingError();
     }
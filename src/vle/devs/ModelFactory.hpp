@@ -60,12 +60,16 @@ public:
      * @param sim the simulator attached to this ModelFactory.
      * @param dyn the root dynamics of vpz::Dynamics to load.
      * @param cls the vpz::classes to parse vpz::Dynamics to load.
+     * @param shared if true, @e dyn and @e cls are not copied but read in
+     * place until a modification is requested (copy-on-write). They
+     * must outlive the ModelFactory.
      */
     ModelFactory(const utils::ModuleManager& modulemgr,
                  const vpz::Dynamics& dyn,
                  const vpz::Classes& cls,
                  const vpz::Experiment& experiment,
-                 RootCoordinator& root);
+                 RootCoordinator& root,
+                 bool shared = false);
 
     /**
      * @brief Return the reference to the list of initiale conditions for
@@ -80,7 +84,14 @@ public:
      * @return A constant reference to the vpz::Dynamics.
      */
     inline const vpz::Dynamics& dynamics() const
-    { return mDynamics; }
+    { return mSharedDynamics ? *mSharedDynamics : mDynamics; }
+
+    /**
+     * @brief Return the reference to the list of classes, shared or not.
+     * @return A constant reference to the vpz::Classes.
+     */
+    inline const vpz::Classes& classes() const
+    { return mSharedClasses ? *mSharedClasses : mClasses; }
 
     /**
      * @brief Return the reference to the list of views.
@@ -119,11 +130,12 @@ public:
     { return mExperiment.conditions(); }
 
     /**
-     * @brief Return the reference to the list of dynamcis.
+     * @brief Return the reference to the list of dynamcis. If the
+     * dynamics are shared, they are copied first.
      * @return A constant reference to the vpz::Dynamics.
      */
     inline vpz::Dynamics& dynamics()
-    { return mDynamics; }
+    { detach(); return mDynamics; }
 
     /**
      * @brief Return the reference to the list of views.
@@ -234,10 +246,21 @@ private:
 
     vpz::Dynamics           mDynamics; /**< List of available vpz::Dynamics. */
     vpz::Classes            mClasses; /**< List of available vpz::Classes. */
+    const vpz::Dynamics*    mSharedDynamics; /**< The shared vpz::Dynamics
+                                               or null if mDynamics is
+                                               used. */
+    const vpz::Classes*     mSharedClasses; /**< The shared vpz::Classes or
+                                              null if mClasses is used. */
     vpz::Experiment         mExperiment; /**< A reference to the
                                            vpz::Experiment. */
     RootCoordinator&        mRoot;
 
+    /**
+     * Copy the shared vpz::Dynamics and vpz::Classes into the
+     * ModelFactory before a modification.
+     */
+    void detach();
+
     /**
      * Try to open the plug-in and return the type of opened plugin
      * (MODULE_DYNAMICS, MODULE_DYNAMICS_WRAPPER or MODULE_EXECUTIVE).
@@ -228,6 +228,15 @@ private:
     ObservationEvent(const ObservationEvent& other);
     ObservationEvent& operator=(const ObservationEvent& other);
 
+    /**
+     * @brief The devs::View builds an event for each observable and
+     * updates its date at each observation.
+     */
+    friend class View;
+
+    void setTime(const Time& time)
+    { m_time = time; }
+
     Simulator  *m_model;
     value::Map *m_attributes;
     Time        m_time;
@@ -0,0 +1,224 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#include <vle/devs/Partition.hpp>
+#include <vle/devs/Coordinator.hpp>
+#include <vle/devs/Simulator.hpp>
+#include <vle/devs/ExternalEvent.hpp>
+#include <vle/devs/InternalEvent.hpp>
+#include <boost/checked_delete.hpp>
+#include <algorithm>
+
+namespace vle { namespace devs {
+
+Partition::Partition(Coordinator& coordinator, std::size_t index,
+                     std::size_t partitions, const std::string& scheduler)
+    : m_coordinator(coordinator), m_index(index), m_eventTable(scheduler),
+    m_outboxes(partitions)
+{
+}
+
+Partition::~Partition()
+{
+    clearOutboxes();
+}
+
+void Partition::run(const Time& time, bool observed)
+{
+    EventPool::Scope scope(m_eventPool);
+
+    clearOutboxes();
+
+    if (m_eventTable.topEvent() != time) {
+        m_eventTable.setCurrentTime(time);
+        return;
+    }
+
+    CompleteEventBagModel& bags = m_eventTable.popEvent();
+
+    while (not bags.emptyBag()) {
+        std::map < Simulator*, EventBagModel >::value_type& bag(bags.topBag());
+        if (not bag.second.emptyInternal()) {
+            if (not bag.second.emptyExternal()) {
+                processConflictEvents(bag.first, bag.second, observed);
+            } else {
+                processInternalEvent(bag.first, bag.second, observed);
+            }
+        } else {
+            if (not bag.second.emptyExternal()) {
+                processExternalEvents(bag.first, bag.second, observed);
+            }
+        }
+    }
+
+    bags.clear();
+}
+
+void Partition::receive(const std::vector < Partition* >& partitions)
+{
+    EventPool::Scope scope(m_eventPool);
+
+    m_inboxes.clear();
+    for (std::vector < Partition* >::const_iterator it = partitions.begin();
+         it != partitions.end(); ++it) {
+        const Mailbox& inbox((*it)->m_outboxes[m_index]);
+
+        if (not inbox.empty()) {
+            m_inboxes.push_back(Inbox(inbox.begin(), inbox.end()));
+        }
+    }
+
+    /* merge the inboxes by source Simulator. A Simulator belongs to one
+     * partition, the mails of a source are in a single inbox. */
+    while (not m_inboxes.empty()) {
+        std::vector < Inbox >::iterator first = m_inboxes.begin();
+        for (std::vector < Inbox >::iterator it = first + 1;
+             it != m_inboxes.end(); ++it) {
+            if (it->first->source < first->first->source) {
+                first = it;
+            }
+        }
+
+        Simulator* source = first->first->source;
+        for (; first->first != first->second and
+             first->first->source == source; ++first->first) {
+            const Mail& mail(*first->first);
+
+            if (source->partition() == m_index) {
+                m_eventTable.putExternalEvent(
+                    new ExternalEvent(*mail.event, mail.target, mail.port));
+            } else {
+                m_eventTable.putExternalEvent(
+                    mail.event->copy(mail.target, mail.port));
+            }
+        }
+
+        if (first->first == first->second) {
+            m_inboxes.erase(first);
+        }
+    }
+}
+
+void Partition::processInternalEvent(Simulator* sim,
+                                     const EventBagModel& bag,
+                                     bool observed)
+{
+    {
+        ExternalEventList result;
+        sim->output(m_eventTable.getCurrentTime(), result);
+        dispatchExternalEvent(result, sim);
+    }
+
+    InternalEvent* internal = sim->internalTransition(*bag.internal());
+    if (internal) {
+        m_eventTable.putInternalEvent(internal);
+    }
+
+    if (observed) {
+        m_coordinator.processEventView(sim);
+    }
+}
+
+void Partition::processExternalEvents(Simulator* sim,
+                                      const EventBagModel& bag,
+                                      bool observed)
+{
+    InternalEvent* internal = sim->externalTransition(
+        bag.externals(), m_eventTable.getCurrentTime());
+    if (internal) {
+        m_eventTable.putInternalEvent(internal);
+    }
+
+    if (observed) {
+        m_coordinator.processEventView(sim);
+    }
+}
+
+void Partition::processConflictEvents(Simulator* sim,
+                                      const EventBagModel& bag,
+                                      bool observed)
+{
+    {
+        ExternalEventList result;
+        sim->output(m_eventTable.getCurrentTime(), result);
+        dispatchExternalEvent(result, sim);
+    }
+
+    InternalEvent* internal = sim->confluentTransitions(
+        *bag.internal(), bag.externals());
+
+    if (observed) {
+        m_coordinator.processEventView(sim);
+    }
+
+    if (internal) {
+        m_eventTable.putInternalEvent(internal);
+    }
+}
+
+void Partition::dispatchExternalEvent(ExternalEventList& events,
+                                      Simulator* sim)
+{
+    for (ExternalEventList::iterator it = events.begin(); it != events.end();
+         ++it) {
+        std::pair < Simulator::iterator, Simulator::iterator > x;
+        x = sim->targets((*it)->getPortName(), m_coordinator.m_modelList);
+
+        if (sim->profile()) {
+            sim->profile()->route((*it)->getPortName(),
+                                  x.second - x.first);
+        }
+
+        for (Simulator::iterator jt = x.first; jt != x.second; ++jt) {
+            m_outboxes[jt->first->partition()].push_back(
+                Mail(*it, sim, jt->first, jt->second));
+        }
+
+        if (x.first != x.second) {
+            m_sent.push_back(*it);
+        } else {
+            delete (*it);
+        }
+    }
+    events.clear();
+}
+
+void Partition::clearOutboxes()
+{
+    for (std::vector < Mailbox >::iterator it = m_outboxes.begin();
+         it != m_outboxes.end(); ++it) {
+        it->clear();
+    }
+
+    std::for_each(m_sent.begin(), m_sent.end(),
+                  boost::checked_deleter < ExternalEvent >());
+    m_sent.clear();
+}
+
+}} // namespace vle devs
@@ -0,0 +1,213 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#ifndef VLE_DEVS_PARTITION_HPP
+#define VLE_DEVS_PARTITION_HPP 1
+
+#include <vle/DllDefines.hpp>
+#include <vle/devs/EventPool.hpp>
+#include <vle/devs/EventTable.hpp>
+#include <vle/devs/ExternalEventList.hpp>
+#include <vle/devs/PortName.hpp>
+#include <vle/devs/Time.hpp>
+#include <string>
+#include <vector>
+
+namespace vle { namespace devs {
+
+class Coordinator;
+
+/**
+ * @brief Partition simulates a subset of the atomic models of a
+ * devs::Coordinator with its own devs::EventTable and devs::EventPool.
+ *
+ * The devs::Coordinator synchronises the partitions with rounds: all the
+ * partitions imminent at the smallest next time of the simulation run
+ * their bag with Partition::run(), then all the partitions read the
+ * events sent by the others with Partition::receive(). The DEVS couplings
+ * have no delay, so a round never spans more than one bag: the bags are
+ * the same as with a single devs::EventTable.
+ *
+ * An event sent by a Simulator is written into the outbox of the
+ * partition of each target, its own partition included. An outbox has a
+ * single writer (the source partition during Partition::run()) and a
+ * single reader (the destination partition during Partition::receive()),
+ * so no lock is needed. The destination builds its own copy of the
+ * events of the other partitions with ExternalEvent::copy().
+ *
+ * A partition processes its bag in the order of the Simulator, like the
+ * devs::Coordinator, so each outbox is sorted by source Simulator.
+ * Partition::receive() merges the outboxes by source Simulator: a model
+ * receives its external events in the same order as in the sequential
+ * simulation, whatever the partitioning.
+ *
+ * The events of a round reach the devs::EventTable of their targets in
+ * Partition::receive(), after all the transitions of the round, where the
+ * devs::Coordinator pushes them during its bag. The result is the same:
+ * in both cases the external events are processed by the next bag at the
+ * same date, and EventTable::putExternalEvent() drops the pending internal
+ * event of the target if it is later than the current date, so a target
+ * made passive by its external transition never runs a stale internal
+ * transition.
+ */
+class VLE_API Partition
+{
+public:
+    /**
+     * @brief Build an empty partition.
+     * @param coordinator The coordinator of the simulation.
+     * @param index The index of the partition.
+     * @param partitions The number of partitions.
+     * @param scheduler The name of the scheduler of the devs::EventTable.
+     */
+    Partition(Coordinator& coordinator, std::size_t index,
+              std::size_t partitions, const std::string& scheduler);
+
+    /**
+     * @brief Delete the events sent by the last run.
+     */
+    ~Partition();
+
+    /**
+     * @brief Get the index of the partition.
+     * @return An index.
+     */
+    std::size_t index() const
+    { return m_index; }
+
+    /**
+     * @brief Get the devs::EventTable of the partition.
+     * @return A reference to the devs::EventTable.
+     */
+    EventTable& eventtable()
+    { return m_eventTable; }
+
+    /**
+     * @brief Get the devs::EventPool of the partition.
+     * @return A reference to the devs::EventPool.
+     */
+    EventPool& eventPool()
+    { return m_eventPool; }
+
+    /**
+     * @brief Get the devs::EventPool of the partition.
+     * @return A constant reference to the devs::EventPool.
+     */
+    const EventPool& eventPool() const
+    { return m_eventPool; }
+
+    /**
+     * @brief Get the date of the next bag of the partition.
+     * @return A date or devs::infinity.
+     */
+    const Time& getNextTime()
+    { return m_eventTable.topEvent(); }
+
+    /**
+     * @brief Delete the events sent by the previous round and, if the
+     * partition is imminent at the specified date, process its bag.
+     * @param time The date of the round.
+     * @param observed True if the devs::EventView of the coordinator
+     * must be updated after each transition.
+     */
+    void run(const Time& time, bool observed);
+
+    /**
+     * @brief Push the events sent to this partition by all the partitions
+     * into the devs::EventTable, in the order of their source Simulator.
+     * @param partitions The partitions of the coordinator.
+     */
+    void receive(const std::vector < Partition* >& partitions);
+
+private:
+    Partition(const Partition&);
+    Partition& operator=(const Partition&);
+
+    /**
+     * @brief An event sent to a Simulator.
+     */
+    struct Mail
+    {
+        Mail(ExternalEvent* event, Simulator* source, Simulator* target,
+             const PortName& port)
+            : event(event), source(source), target(target), port(port)
+        {}
+
+        ExternalEvent* event;
+        Simulator*     source;
+        Simulator*     target;
+        PortName       port;
+    };
+
+    typedef std::vector < Mail > Mailbox;
+
+    /**
+     * @brief The unread part of an inbox during Partition::receive().
+     */
+    typedef std::pair < Mailbox::const_iterator,
+                        Mailbox::const_iterator > Inbox;
+
+    void processInternalEvent(Simulator* sim, const EventBagModel& bag,
+                              bool observed);
+
+    void processExternalEvents(Simulator* sim, const EventBagModel& bag,
+                               bool observed);
+
+    void processConflictEvents(Simulator* sim, const EventBagModel& bag,
+                               bool observed);
+
+    /**
+     * @brief Send the output of a Simulator to the outboxes of the
+     * partitions of its targets. The events are deleted if they have no
+     * target or kept until the next round.
+     * @param events The output of the Simulator.
+     * @param sim The Simulator.
+     */
+    void dispatchExternalEvent(ExternalEventList& events, Simulator* sim);
+
+    /**
+     * @brief Delete the events sent by the previous round.
+     */
+    void clearOutboxes();
+
+    Coordinator&            m_coordinator;
+    std::size_t             m_index;
+    EventPool               m_eventPool;
+    EventTable              m_eventTable;
+    std::vector < Mailbox > m_outboxes; /**< The events sent to each
+                                          partition. */
+    ExternalEventList       m_sent; /**< The events referenced by the
+                                      outboxes. */
+    std::vector < Inbox >   m_inboxes; /**< The inboxes merged by
+                                         receive(). */
+};
+
+}} // namespace vle devs
+
+#endif
@@ -0,0 +1,81 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <vle/devs/PortName.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/shared_mutex.hpp>
+#include <set>
+
+namespace vle { namespace devs {
+
+/**
+ * The table of the interned port names. The nodes of the std::set are
+ * never moved, so the references stay valid after the insertions. A name
+ * already interned is found under a shared lock, so the routing threads
+ * do not serialize on the table.
+ */
+struct PortNameTable
+{
+    boost::shared_mutex     mutex;
+    std::set < std::string > names;
+
+    const std::string* intern(const std::string& name)
+    {
+        {
+            boost::shared_lock < boost::shared_mutex > lock(mutex);
+            std::set < std::string >::const_iterator it = names.find(name);
+
+            if (it != names.end()) {
+                return &*it;
+            }
+        }
+
+        boost::unique_lock < boost::shared_mutex > lock(mutex);
+
+        return &*names.insert(name).first;
+    }
+};
+
+static PortNameTable& portNameTable()
+{
+    static PortNameTable table;
+
+    return table;
+}
+
+PortName::PortName()
+    : m_name(portNameTable().intern(std::string()))
+{
+}
+
+PortName::PortName(const std::string& name)
+    : m_name(portNameTable().intern(name))
+{
+}
+
+}} // namespace vle devs
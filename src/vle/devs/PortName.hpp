@@ -0,0 +1,95 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef VLE_DEVS_PORTNAME_HPP
+#define VLE_DEVS_PORTNAME_HPP 1
+
+#include <vle/DllDefines.hpp>
+#include <string>
+
+namespace vle { namespace devs {
+
+/**
+ * @brief PortName is an interned port name: all the PortName built with
+ * the same string share a single std::string which lives until the end
+ * of the program. A PortName is a pointer, it is cheap to copy and two
+ * PortName are compared by address.
+ *
+ * The interning uses a global table protected by a read-write lock. The
+ * names of the connections are interned when they are built; the routing
+ * of an output event only looks up its port name under a shared lock.
+ *
+ * @code
+ * devs::PortName in("in");
+ * assert(in == devs::PortName("in"));
+ * assert(in.str() == "in");
+ * @endcode
+ */
+class VLE_API PortName
+{
+public:
+    /**
+     * @brief Build the empty PortName.
+     */
+    PortName();
+
+    /**
+     * @brief Build the PortName of a string.
+     * @param name The name to intern.
+     */
+    explicit PortName(const std::string& name);
+
+    /**
+     * @brief Get the interned string.
+     * @return A reference valid until the end of the program.
+     */
+    const std::string& str() const
+    { return *m_name; }
+
+    bool empty() const
+    { return m_name->empty(); }
+
+    bool operator==(const PortName& other) const
+    { return m_name == other.m_name; }
+
+    bool operator!=(const PortName& other) const
+    { return m_name != other.m_name; }
+
+    /**
+     * @brief Order the PortName by address, not by name.
+     */
+    bool operator<(const PortName& other) const
+    { return m_name < other.m_name; }
+
+private:
+    const std::string* m_name;
+};
+
+}} // namespace vle devs
+
+#endif
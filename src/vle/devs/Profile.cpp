@@ -0,0 +1,242 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <vle/devs/Profile.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/i18n.hpp>
+#include <boost/checked_delete.hpp>
+#include <algorithm>
+#include <fstream>
+#include <limits>
+
+#if defined _WIN32
+# include <windows.h>
+#else
+# include <time.h>
+#endif
+
+namespace vle { namespace devs {
+
+void Profile::Counter::merge(const Counter& other)
+{
+    calls += other.calls;
+    total += other.total;
+    max = std::max(max, other.max);
+}
+
+Profile::Profile()
+    : m_bags(0), m_period(1), m_start(0.0), m_duration(0.0)
+{
+    m_samples.reserve(SAMPLES);
+}
+
+Profile::~Profile()
+{
+    std::for_each(m_records.begin(), m_records.end(),
+                  boost::checked_deleter < Record >());
+}
+
+Profile::Record* Profile::attach(const std::string& name,
+                                 const std::string& dynamics)
+{
+    m_records.push_back(new Record(name, dynamics));
+
+    return m_records.back();
+}
+
+void Profile::sample(const Time& time, std::size_t size)
+{
+    if (m_samples.size() == SAMPLES) {
+        SampleList::size_type j = 0;
+        for (SampleList::size_type i = 1; i < m_samples.size(); i += 2) {
+            m_samples[j++] = m_samples[i];
+        }
+        m_samples.erase(m_samples.begin() + j, m_samples.end());
+        m_period *= 2;
+
+        if (m_bags % m_period != 0) {
+            return;
+        }
+    }
+
+    m_samples.push_back(Sample(time, size));
+}
+
+void Profile::start()
+{
+    m_start = now();
+}
+
+void Profile::stop()
+{
+    m_duration = now() - m_start;
+}
+
+namespace {
+
+/**
+ * @brief The activity of all the models of a vpz::Dynamic.
+ */
+struct Dynamic
+{
+    Dynamic()
+        : models(0)
+    {}
+
+    std::size_t      models;
+    Profile::Counter functions[Profile::FUNCTIONS];
+};
+
+typedef std::map < std::string, Dynamic > DynamicList;
+
+void writeFunctions(std::ostream& out, const Profile::Counter* counters)
+{
+    for (int i = 0; i < Profile::FUNCTIONS; ++i) {
+        if (counters[i].calls) {
+            out << "   <function name=\""
+                << Profile::name(static_cast < Profile::Function >(i))
+                << "\" calls=\"" << counters[i].calls
+                << "\" total=\"" << counters[i].total
+                << "\" max=\"" << counters[i].max << "\" />\n";
+        }
+    }
+}
+
+} // anonymous namespace
+
+void Profile::write(std::ostream& out) const
+{
+    DynamicList dynamics;
+    for (RecordList::const_iterator it = m_records.begin();
+         it != m_records.end(); ++it) {
+        Dynamic& dyn(dynamics[(*it)->dynamics]);
+
+        ++dyn.models;
+        for (int i = 0; i < FUNCTIONS; ++i) {
+            dyn.functions[i].merge((*it)->functions[i]);
+        }
+    }
+
+    std::streamsize precision = out.precision(
+        std::numeric_limits < double >::digits10);
+
+    out << "<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n"
+        << "<profile duration=\"" << m_duration
+        << "\" bags=\"" << m_bags << "\" >\n";
+
+    out << " <dynamics>\n";
+    for (DynamicList::const_iterator it = dynamics.begin();
+         it != dynamics.end(); ++it) {
+        out << "  <dynamic name=\"" << it->first
+            << "\" models=\"" << it->second.models << "\" >\n";
+        writeFunctions(out, it->second.functions);
+        out << "  </dynamic>\n";
+    }
+    out << " </dynamics>\n";
+
+    out << " <models>\n";
+    for (RecordList::const_iterator it = m_records.begin();
+         it != m_records.end(); ++it) {
+        out << "  <model name=\"" << (*it)->name
+            << "\" dynamics=\"" << (*it)->dynamics << "\" >\n";
+        writeFunctions(out, (*it)->functions);
+        for (PortList::const_iterator jt = (*it)->ports.begin();
+             jt != (*it)->ports.end(); ++jt) {
+            out << "   <port name=\"" << jt->first
+                << "\" events=\"" << jt->second.events
+                << "\" targets=\"" << jt->second.targets << "\" />\n";
+        }
+        out << "  </model>\n";
+    }
+    out << " </models>\n";
+
+    out << " <eventtable>\n";
+    for (SampleList::const_iterator it = m_samples.begin();
+         it != m_samples.end(); ++it) {
+        out << "  <sample time=\"" << it->time
+            << "\" size=\"" << it->size << "\" />\n";
+    }
+    out << " </eventtable>\n"
+        << "</profile>\n";
+
+    out.precision(precision);
+}
+
+void Profile::write(const std::string& filename) const
+{
+    std::ofstream out(filename.c_str());
+
+    if (out.is_open()) {
+        write(out);
+    }
+
+    if (not out.is_open() or not out.good()) {
+        throw utils::FileError(fmt(_("Profile: cannot write file '%1%'")) %
+                               filename);
+    }
+}
+
+const char* Profile::name(Function function)
+{
+    switch (function) {
+    case OUTPUT:
+        return "output";
+    case TIME_ADVANCE:
+        return "timeAdvance";
+    case INTERNAL:
+        return "internalTransition";
+    case EXTERNAL:
+        return "externalTransition";
+    case CONFLUENT:
+        return "confluentTransitions";
+    case OBSERVATION:
+        return "observation";
+    default:
+        return "unknown";
+    }
+}
+
+double Profile::now()
+{
+#if defined _WIN32
+    LARGE_INTEGER frequency, counter;
+    ::QueryPerformanceFrequency(&frequency);
+    ::QueryPerformanceCounter(&counter);
+
+    return static_cast < double >(counter.QuadPart) /
+        static_cast < double >(frequency.QuadPart);
+#else
+    struct timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return static_cast < double >(ts.tv_sec) +
+        static_cast < double >(ts.tv_nsec) * 1e-9;
+#endif
+}
+
+}} // namespace vle devs
@@ -0,0 +1,311 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef VLE_DEVS_PROFILE_HPP
+#define VLE_DEVS_PROFILE_HPP
+
+#include <vle/DllDefines.hpp>
+#include <vle/devs/Time.hpp>
+#include <vle/utils/Types.hpp>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace vle { namespace devs {
+
+    /**
+     * @brief The Profile records the activity of the simulation: the
+     * calls of the functions of each devs::Simulator, the events routed
+     * by their output ports and the size of the devs::EventTable.
+     *
+     * The Profile is enabled by RootCoordinator::setProfile. Each
+     * Simulator gets a Record, kept until the end of the simulation even
+     * if the model is deleted by an Executive. Without profile, the
+     * Simulator only tests a null Record before each function.
+     *
+     * The report is a XML file:
+     * @code
+     * <profile duration="12.5" bags="1000" >
+     *  <dynamics>
+     *   <dynamic name="dynA" models="10" >
+     *    <function name="output" calls="100" total="0.001" max="1e-05" />
+     *    ...
+     *   </dynamic>
+     *  </dynamics>
+     *  <models>
+     *   <model name="top:a" dynamics="dynA" >
+     *    <function name="output" calls="10" total="0.0001" max="1e-05" />
+     *    ...
+     *    <port name="out" events="10" targets="20" />
+     *   </model>
+     *  </models>
+     *  <eventtable>
+     *   <sample time="1.0" size="12" />
+     *   ...
+     *  </eventtable>
+     * </profile>
+     * @endcode
+     * The durations are in seconds.
+     */
+    class VLE_API Profile
+    {
+    public:
+        /**
+         * @brief The functions of a devs::Simulator recorded.
+         */
+        enum Function {
+            OUTPUT,
+            TIME_ADVANCE,
+            INTERNAL,
+            EXTERNAL,
+            CONFLUENT,
+            OBSERVATION,
+            FUNCTIONS /**< The number of functions. */
+        };
+
+        /**
+         * @brief The calls of a function: number and durations.
+         */
+        struct Counter
+        {
+            Counter()
+                : calls(0), total(0.0), max(0.0)
+            {}
+
+            void add(double duration)
+            {
+                ++calls;
+                total += duration;
+                if (duration > max) {
+                    max = duration;
+                }
+            }
+
+            void merge(const Counter& other);
+
+            uint64_t calls;
+            double   total;
+            double   max;
+        };
+
+        /**
+         * @brief The events routed by an output port.
+         */
+        struct Port
+        {
+            Port()
+                : events(0), targets(0)
+            {}
+
+            uint64_t events; /**< The events sent on the port. */
+            uint64_t targets; /**< The copies delivered to the targets. */
+        };
+
+        typedef std::map < std::string, Port > PortList;
+
+        /**
+         * @brief The activity of a devs::Simulator.
+         */
+        struct Record
+        {
+            Record(const std::string& name, const std::string& dynamics)
+                : name(name), dynamics(dynamics)
+            {}
+
+            /**
+             * @brief Count an event sent on an output port.
+             * @param port The name of the output port.
+             * @param targets The number of targets of the event.
+             */
+            void route(const std::string& port, std::size_t targets)
+            {
+                Port& p(ports[port]);
+                ++p.events;
+                p.targets += targets;
+            }
+
+            std::string name; /**< The complete name of the model. */
+            std::string dynamics; /**< The name of the vpz::Dynamic. */
+            Counter     functions[FUNCTIONS];
+            PortList    ports;
+        };
+
+        /**
+         * @brief Measure the duration of a function of a Simulator, from
+         * its construction to its destruction. Does nothing if the record
+         * is null.
+         * @code
+         * Profile::Timer timer(m_profile, Profile::OUTPUT);
+         * m_dynamics->output(time, output);
+         * @endcode
+         */
+        class Timer
+        {
+        public:
+            Timer(Record* record, Function function)
+                : m_record(record), m_function(function),
+                m_start(record ? Profile::now() : 0.0)
+            {}
+
+            ~Timer()
+            {
+                if (m_record) {
+                    m_record->functions[m_function].add(
+                        Profile::now() - m_start);
+                }
+            }
+
+        private:
+            Timer(const Timer& other);
+            Timer& operator=(const Timer& other);
+
+            Record*  m_record;
+            Function m_function;
+            double   m_start;
+        };
+
+        /**
+         * @brief A sample of the size of the devs::EventTable.
+         */
+        struct Sample
+        {
+            Sample(const Time& time, std::size_t size)
+                : time(time), size(size)
+            {}
+
+            Time        time;
+            std::size_t size;
+        };
+
+        typedef std::vector < Record* > RecordList;
+        typedef std::vector < Sample > SampleList;
+
+        /**
+         * @brief The maximum number of samples of the devs::EventTable.
+         * When the list is full, one sample of two is removed and the
+         * period of the sampling is doubled.
+         */
+        static const std::size_t SAMPLES = 4096;
+
+        Profile();
+
+        ~Profile();
+
+        /**
+         * @brief Build the Record of a new devs::Simulator.
+         * @param name The complete name of the model.
+         * @param dynamics The name of the vpz::Dynamic of the model.
+         * @return A Record owned by the Profile.
+         */
+        Record* attach(const std::string& name, const std::string& dynamics);
+
+        /**
+         * @brief Count a bag, called after each bag of the simulation.
+         * @return true if the size of the devs::EventTable must be kept
+         * for this bag.
+         */
+        bool bag()
+        { return ++m_bags % m_period == 0; }
+
+        /**
+         * @brief Keep the size of the devs::EventTable.
+         * @param time The date of the bag.
+         * @param size The number of events of the devs::EventTable.
+         */
+        void sample(const Time& time, std::size_t size);
+
+        /**
+         * @brief Get the number of bags.
+         */
+        uint64_t bags() const
+        { return m_bags; }
+
+        const RecordList& records() const
+        { return m_records; }
+
+        const SampleList& samples() const
+        { return m_samples; }
+
+        /**
+         * @brief Start the measure of the duration of the simulation.
+         */
+        void start();
+
+        /**
+         * @brief Stop the measure of the duration of the simulation.
+         */
+        void stop();
+
+        /**
+         * @brief Get the duration of the simulation.
+         * @return A duration in seconds.
+         */
+        double duration() const
+        { return m_duration; }
+
+        /**
+         * @brief Write the report.
+         * @param out The output stream.
+         */
+        void write(std::ostream& out) const;
+
+        /**
+         * @brief Write the report into a file.
+         * @param filename The name of the file.
+         * @throw utils::FileError if the file cannot be written.
+         */
+        void write(const std::string& filename) const;
+
+        /**
+         * @brief Get the name of a function.
+         * @param function The function.
+         * @return The name used in the report.
+         */
+        static const char* name(Function function);
+
+        /**
+         * @brief Get a monotonic clock.
+         * @return A date in seconds.
+         */
+        static double now();
+
+    private:
+        Profile(const Profile& other);
+        Profile& operator=(const Profile& other);
+
+        RecordList  m_records;
+        SampleList  m_samples;
+        uint64_t    m_bags;
+        uint64_t    m_period;
+        double      m_start;
+        double      m_duration;
+    };
+
+}} // namespace vle devs
+
+#endif
@@ -27,6 +27,13 @@
 
 #include <vle/devs/RootCoordinator.hpp>
 #include <vle/devs/Coordinator.hpp>
+#include <vle/devs/Profile.hpp>
+#include <vle/devs/Snapshot.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/Trace.hpp>
+#include <vle/utils/i18n.hpp>
+#include <algorithm>
+#include <sstream>
 
 namespace vle { namespace devs {
 
@@ -36,17 +43,28 @@ namespace vle { namespace devs {
  * The \c getMatrixFromView is a private implementation function.
  *
  * @param views The \c vle::devs::ViewList to browse.
+ * @param typed Keep the \c vle::value::ResultMatrix of the plug-ins
+ * instead of converting them to \c vle::value::Matrix.
  *
  * @return NULL if the \c vle::devs::ViewList does not have storage
  * plug-ins.
  */
-static value::Map * getMatrixFromView(const ViewList &views)
+static value::Map * getMatrixFromView(const ViewList &views, bool typed)
 {
     value::Map * result = 0;
 
     ViewList::const_iterator it = views.begin();
     while (it != views.end()) {
-        value::Matrix *matrix = it->second->matrix();
+        value::Value *matrix = it->second->results();
+
+        if (not matrix) {
+            matrix = it->second->matrix();
+        } else if (not typed) {
+            value::ResultMatrix *results = &matrix->toResultMatrix();
+
+            matrix = results->buildMatrix();
+            delete results;
+        }
 
         if (matrix) {
             if (not result) {
@@ -64,18 +82,51 @@ static value::Map * getMatrixFromView(const ViewList &views)
                        /* - - - - - - - - - -*/
 
 RootCoordinator::RootCoordinator(const utils::ModuleManager& modulemgr)
-    : m_rand(0), m_begin(0), m_currentTime(0), m_end(1.0), m_result(0),
-      m_coordinator(0), m_root(0), m_modulemgr(modulemgr)
+    : m_rand(0), m_replica(0), m_begin(0), m_currentTime(0), m_end(1.0),
+      m_result(0), m_typedResults(false), m_allocations(0), m_events(0),
+      m_outputQueues(0), m_outputDepth(0),
+      m_outputStall(0.0), m_profile(0), m_snapshotPeriod(0.0),
+      m_snapshotInterval(0.0), m_snapshotNext(0.0), m_snapshotClock(0.0),
+      m_snapshotWriter(0), m_coordinator(0), m_root(0),
+      m_modulemgr(modulemgr)
 {
 }
 
 RootCoordinator::~RootCoordinator()
 {
+    abortSnapshot();
+
+    delete m_snapshotWriter;
     delete m_coordinator;
     delete m_root;
+    delete m_profile;
 }
 
 void RootCoordinator::load(const vpz::Vpz& io)
+{
+    load(io, io.project().dynamics(), io.project().classes(), false);
+}
+
+void RootCoordinator::load(const vpz::Vpz& io, const vpz::Project& shared)
+{
+    load(io, shared.dynamics(), shared.classes(), true);
+}
+
+void RootCoordinator::restore(const std::string& filename)
+{
+    Snapshot snapshot;
+    snapshot.read(filename);
+
+    vpz::Vpz vpz;
+    snapshot.project(vpz);
+
+    load(vpz, vpz.project().dynamics(), vpz.project().classes(), false,
+         &snapshot);
+}
+
+void RootCoordinator::load(const vpz::Vpz& io, const vpz::Dynamics& dyn,
+                           const vpz::Classes& cls, bool shared,
+                           const Snapshot* snapshot)
 {
     if (m_coordinator) {
         delete m_coordinator;
@@ -84,15 +135,38 @@ void RootCoordinator::load(const vpz::Vpz& io)
 
     m_begin = io.project().experiment().begin();
     m_end = m_begin + io.project().experiment().duration();
+    m_rand.seed(io.project().experiment().seed());
+    m_replica = std::max(io.project().instance(), 0);
+
+    if (snapshot) {
+        /* the simulation continues at the date of the snapshot. */
+        m_begin = snapshot->time();
+        m_end = snapshot->end();
+
+        std::istringstream rand(snapshot->rand());
+        rand >> m_rand.gen();
+    }
+
     m_currentTime = m_begin;
 
-    m_coordinator = new Coordinator(m_modulemgr,
-                                    io.project().dynamics(),
-                                    io.project().classes(),
+    m_coordinator = new Coordinator(m_modulemgr, dyn, cls,
                                     io.project().experiment(),
-                                    *this);
+                                    *this, shared);
 
-    m_coordinator->init(io.project().model(), m_currentTime, m_end);
+    delete m_profile;
+    m_profile = 0;
+
+    if (not m_profileFile.empty()) {
+        m_profile = new Profile();
+        m_coordinator->setProfile(m_profile);
+    }
+
+    if (snapshot) {
+        m_coordinator->restore(io.project().model(), m_currentTime, m_end,
+                               *snapshot);
+    } else {
+        m_coordinator->init(io.project().model(), m_currentTime, m_end);
+    }
 
     m_root = io.project().model().model();
 }
@@ -100,6 +174,12 @@ void RootCoordinator::load(const vpz::Vpz& io)
 void RootCoordinator::init()
 {
     m_currentTime = m_begin;
+    m_snapshotNext = m_begin + m_snapshotPeriod;
+    m_snapshotClock = Profile::now();
+
+    if (m_profile) {
+        m_profile->start();
+    }
 }
 
 bool RootCoordinator::run()
@@ -112,16 +192,94 @@ bool RootCoordinator::run()
         return false;
     }
 
-    m_coordinator->run();
+    try {
+        m_coordinator->run();
+    } catch (...) {
+        abortSnapshot();
+        throw;
+    }
+
+    if (not m_snapshotFile.empty()) {
+        const bool date = m_snapshotPeriod > 0.0 and
+            m_currentTime >= m_snapshotNext;
+        const bool clock = m_snapshotInterval > 0.0 and
+            Profile::now() - m_snapshotClock >= m_snapshotInterval;
+
+        if (date or clock) {
+            snapshot(m_snapshotFile);
+            m_snapshotNext = m_currentTime + m_snapshotPeriod;
+            m_snapshotClock = Profile::now();
+        }
+    }
+
     return true;
 }
 
+void RootCoordinator::snapshot(const std::string& filename)
+{
+    if (not m_coordinator) {
+        throw utils::InternalError(_("Snapshot: no simulation loaded"));
+    }
+
+    Snapshot* result = new Snapshot();
+
+    try {
+        result->capture(*m_coordinator, m_root, m_rand, m_replica, m_end);
+    } catch (...) {
+        delete result;
+        throw;
+    }
+
+    if (not m_snapshotWriter) {
+        m_snapshotWriter = new SnapshotWriter();
+    }
+
+    m_snapshotWriter->write(result, filename);
+}
+
+void RootCoordinator::waitSnapshot()
+{
+    if (m_snapshotWriter) {
+        m_snapshotWriter->wait();
+    }
+}
+
+void RootCoordinator::abortSnapshot()
+{
+    try {
+        waitSnapshot();
+    } catch (const std::exception& e) {
+        TraceAlways(fmt(_("The last snapshot failed: %1%")) % e.what());
+    }
+}
+
 void RootCoordinator::finish()
 {
+    const bool profiled = m_coordinator and m_profile;
+
     if (m_coordinator) {
         m_coordinator->finish();
 
-        m_result = getMatrixFromView(m_coordinator->getViews());
+        if (m_profile) {
+            m_profile->stop();
+        }
+
+        m_result = getMatrixFromView(m_coordinator->getViews(),
+                                     m_typedResults);
+        m_allocations = m_coordinator->eventAllocations();
+        m_events = m_coordinator->eventRequests();
+
+        const ViewList& views(m_coordinator->getViews());
+        for (ViewList::const_iterator it = views.begin(); it != views.end();
+             ++it) {
+            const StreamWriter* stream = it->second->getStream();
+
+            if (stream->queueSize() > 0) {
+                ++m_outputQueues;
+                m_outputDepth = std::max(m_outputDepth, stream->queueDepth());
+                m_outputStall += stream->stallTime();
+            }
+        }
 
         delete m_coordinator;
         m_coordinator = 0;
@@ -131,6 +289,12 @@ void RootCoordinator::finish()
         delete m_root;
         m_root = 0;
     }
+
+    if (profiled) {
+        m_profile->write(m_profileFile);
+    }
+
+    waitSnapshot();
 }
 
 }} // namespace vle devs
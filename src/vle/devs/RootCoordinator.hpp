@@ -44,6 +44,9 @@ namespace vle { namespace devs {
 
     class Coordinator;
     class Dynamics;
+    class Profile;
+    class Snapshot;
+    class SnapshotWriter;
 
     /**
      * @brief Define the DEVS root coordinator. Manage a lot of DEVS
@@ -64,6 +67,29 @@ namespace vle { namespace devs {
          */
         void load(const vpz::Vpz& vp);
 
+        /**
+         * @brief initialiase a new Coordinator with the model and the
+         * experiment of the specified vpz::Vpz reference. The dynamics and
+         * the classes are read from the shared project without copy, it
+         * must outlive the simulation.
+         * @param vp a reference to a structure.
+         * @param shared a reference to the project to share.
+         */
+        void load(const vpz::Vpz& vp, const vpz::Project& shared);
+
+        /**
+         * @brief Initialise a new Coordinator from a snapshot file written
+         * by snapshot() instead of load(): the model tree, the experiment
+         * and the state of the simulation are read from the snapshot and
+         * the simulation continues at the date of the snapshot. The
+         * outputs of the views get the date of the snapshot appended to
+         * their name.
+         * @param filename the snapshot file.
+         * @throw utils::FileError if the file is not a snapshot or does
+         * not match the models.
+         */
+        void restore(const std::string& filename);
+
         /**
          * @brief Initialise RootCoordinator and his Coordinator: initiale time
          * is define, coordinator init function is call.
@@ -101,17 +127,141 @@ namespace vle { namespace devs {
          */
         value::Map * outputs() { return m_result; }
 
+        /**
+         * @brief Keep the \c value::ResultMatrix of the plug-ins which
+         * provide typed results into the \c outputs map. By default, they
+         * are converted to \c value::Matrix by the finish() function.
+         * @param typed true to keep the typed results.
+         */
+        void setTypedResults(bool typed) { m_typedResults = typed; }
+
+        bool typedResults() const { return m_typedResults; }
+
         /**
          * @brief Return a reference to the random generator.
          * @return Return a reference to the random generator.
          */
         utils::Rand& rand() { return m_rand; }
 
+        /**
+         * @brief Get the replica of the simulation, the instance of the
+         * vpz::Project or 0. With the seed of the experiment, it derives
+         * the random streams of the models.
+         * @return The replica.
+         */
+        uint32_t replica() const { return m_replica; }
+
+        /**
+         * @brief Return the number of allocations requested to the system
+         * to build the events of the simulation. This counter is updated
+         * by the finish() function.
+         * @return A number of allocations.
+         */
+        std::size_t allocations() const { return m_allocations; }
+
+        /**
+         * @brief Return the number of events built during the simulation.
+         * This counter is updated by the finish() function.
+         * @return A number of events.
+         */
+        std::size_t events() const { return m_events; }
+
+        /**
+         * @brief Return the number of output plug-ins which run on their
+         * own thread. This counter is updated by the finish() function.
+         * @return A number of plug-ins.
+         */
+        std::size_t outputQueues() const { return m_outputQueues; }
+
+        /**
+         * @brief Return the greatest number of observations waiting in
+         * the queue of an output plug-in. This counter is updated by the
+         * finish() function.
+         * @return A number of observations.
+         */
+        std::size_t outputDepth() const { return m_outputDepth; }
+
+        /**
+         * @brief Return the time spent by the simulation waiting for the
+         * output plug-ins when their queue is full. This counter is
+         * updated by the finish() function.
+         * @return A duration in seconds.
+         */
+        double outputStall() const { return m_outputStall; }
+
+        /**
+         * @brief Profile the next simulations: the calls of the functions
+         * of the models, the events routed by their ports and the size of
+         * the event table are recorded into a devs::Profile, written by
+         * the finish() function. Must be called before load().
+         * @param filename The file of the report, empty to disable the
+         * profiling.
+         */
+        void setProfile(const std::string& filename)
+        { m_profileFile = filename; }
+
+        /**
+         * @brief Capture the state of the simulation between two bags and
+         * write it into a file on a thread, while the simulation
+         * continues. The previous snapshot is waited for.
+         * @param filename the snapshot file.
+         * @throw utils::ModellingError if a model does not support the
+         * snapshots (see devs::Dynamics::serialize), nothing is written.
+         * @throw utils::FileError if the previous snapshot failed.
+         */
+        void snapshot(const std::string& filename);
+
+        /**
+         * @brief Write a snapshot of the next simulations into a file
+         * every \c period of simulated time or every \c interval seconds
+         * of wall-clock time, the first reached. Each snapshot replaces
+         * the previous one.
+         * @param filename the snapshot file, empty to disable the
+         * snapshots.
+         * @param period the simulated time between two snapshots, 0 to
+         * use only the wall-clock time.
+         * @param interval the wall-clock time between two snapshots, in
+         * seconds, 0 to use only the simulated time.
+         */
+        void setSnapshot(const std::string& filename, const Time& period,
+                         double interval = 0.0)
+        {
+            m_snapshotFile = filename;
+            m_snapshotPeriod = period;
+            m_snapshotInterval = interval;
+        }
+
+        /**
+         * @brief Wait for the write of the last snapshot. Called by
+         * finish(); run() and the destructor wait for it too and send its
+         * error to the utils::Trace.
+         * @throw utils::FileError if the snapshot failed.
+         */
+        void waitSnapshot();
+
+        /**
+         * @brief Get the devs::Profile of the last simulation.
+         * @return The profile or null if the simulation is not profiled.
+         */
+        const Profile* profile() const { return m_profile; }
+
     private:
         RootCoordinator(const RootCoordinator& other);
         RootCoordinator& operator=(const RootCoordinator& other);
 
+        void load(const vpz::Vpz& vp, const vpz::Dynamics& dyn,
+                  const vpz::Classes& cls, bool shared,
+                  const Snapshot* snapshot = 0);
+
+        /**
+         * @brief Wait for the last snapshot when the simulation stops
+         * without finish(): its error is sent to the utils::Trace, so the
+         * error of the simulation is not hidden.
+         */
+        void abortSnapshot();
+
         utils::Rand         m_rand;
+        uint32_t            m_replica;
 
         /** @brief Store the beginning of the simulation. */
         devs::Time          m_begin;
@@ -124,6 +274,28 @@ namespace vle { namespace devs {
 
         /** @brief Stores the results of the simulation. */
         value::Map          *m_result;
+        bool                 m_typedResults;
+
+        /** @brief Stores the event allocation counters. */
+        std::size_t          m_allocations;
+        std::size_t          m_events;
+
+        /** @brief Stores the output queue counters. */
+        std::size_t          m_outputQueues;
+        std::size_t          m_outputDepth;
+        double               m_outputStall;
+
+        /** @brief Stores the profile and the name of its report. */
+        Profile             *m_profile;
+        std::string          m_profileFile;
+
+        /** @brief Stores the periodic snapshots and their writer. */
+        std::string          m_snapshotFile;
+        Time                 m_snapshotPeriod;
+        double               m_snapshotInterval;
+        Time                 m_snapshotNext;
+        double               m_snapshotClock;
+        SnapshotWriter      *m_snapshotWriter;
 
         Coordinator*        m_coordinator;
         vpz::BaseModel*     m_root;
@@ -0,0 +1,390 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <vle/devs/Scheduler.hpp>
+#include <vle/utils/Exception.hpp>
+#include <boost/checked_delete.hpp>
+#include <algorithm>
+#include <cassert>
+
+namespace vle { namespace devs {
+
+Scheduler* Scheduler::build(const std::string& name)
+{
+    if (name.empty() or name == "heap") {
+        return new HeapScheduler();
+    } else if (name == "calendar") {
+        return new CalendarScheduler();
+    }
+
+    throw utils::ArgError(fmt(_("Unknown scheduler '%1%'")) % name);
+}
+
+                       /* - - - - - - - - - -*/
+
+HeapScheduler::HeapScheduler(std::size_t sz)
+{
+    m_heap.reserve(sz);
+}
+
+HeapScheduler::~HeapScheduler()
+{
+    std::for_each(m_heap.begin(), m_heap.end(),
+                  boost::checked_deleter < InternalEvent >());
+}
+
+void HeapScheduler::insert(InternalEvent* event)
+{
+    assert(event);
+
+    m_heap.push_back(event);
+    event->m_position = m_heap.size() - 1;
+    up(event->m_position);
+}
+
+void HeapScheduler::erase(InternalEvent* event)
+{
+    std::size_t position = event->m_position;
+    InternalEvent* last = m_heap.back();
+
+    assert(position < m_heap.size() and m_heap[position] == event);
+
+    m_heap.pop_back();
+    if (position < m_heap.size()) {
+        place(position, last);
+        up(position);
+        down(last->m_position);
+    }
+}
+
+void HeapScheduler::update(InternalEvent* event, const Time& time)
+{
+    assert(m_heap[event->m_position] == event);
+
+    if (time < event->m_time) {
+        event->m_time = time;
+        up(event->m_position);
+    } else {
+        event->m_time = time;
+        down(event->m_position);
+    }
+}
+
+InternalEvent* HeapScheduler::top()
+{
+    return m_heap.empty() ? 0 : m_heap.front();
+}
+
+InternalEvent* HeapScheduler::pop()
+{
+    if (m_heap.empty()) {
+        return 0;
+    }
+
+    InternalEvent* event = m_heap.front();
+    erase(event);
+    return event;
+}
+
+void HeapScheduler::up(std::size_t position)
+{
+    InternalEvent* event = m_heap[position];
+
+    while (position > 0) {
+        std::size_t parent = (position - 1) / 2;
+
+        if (m_heap[parent]->m_time <= event->m_time) {
+            break;
+        }
+
+        place(position, m_heap[parent]);
+        position = parent;
+    }
+
+    place(position, event);
+}
+
+void HeapScheduler::down(std::size_t position)
+{
+    InternalEvent* event = m_heap[position];
+    std::size_t size = m_heap.size();
+
+    for (;;) {
+        std::size_t child = 2 * position + 1;
+
+        if (child >= size) {
+            break;
+        }
+
+        if (child + 1 < size and
+            m_heap[child + 1]->m_time < m_heap[child]->m_time) {
+            ++child;
+        }
+
+        if (event->m_time <= m_heap[child]->m_time) {
+            break;
+        }
+
+        place(position, m_heap[child]);
+        position = child;
+    }
+
+    place(position, event);
+}
+
+                       /* - - - - - - - - - -*/
+
+/**
+ * Compare two events by time for the sampling of the CalendarScheduler.
+ */
+struct CalendarLessThan
+{
+    bool operator()(const InternalEvent* e1, const InternalEvent* e2) const
+    { return e1->getTime() < e2->getTime(); }
+};
+
+CalendarScheduler::CalendarScheduler()
+    : m_heads(2, (InternalEvent*)0), m_tails(2, (InternalEvent*)0),
+      m_size(0), m_width(1.0), m_current(0), m_window(0.0)
+{
+}
+
+CalendarScheduler::~CalendarScheduler()
+{
+    for (std::size_t i = 0; i < m_heads.size(); ++i) {
+        InternalEvent* event = m_heads[i];
+
+        while (event) {
+            InternalEvent* next = event->m_next;
+            delete event;
+            event = next;
+        }
+    }
+}
+
+void CalendarScheduler::insert(InternalEvent* event)
+{
+    assert(event and not isInfinity(event->getTime()));
+
+    link(event);
+    ++m_size;
+
+    if (m_size > 2 * m_heads.size()) {
+        resize(2 * m_heads.size());
+    }
+}
+
+void CalendarScheduler::erase(InternalEvent* event)
+{
+    unlink(event);
+    --m_size;
+
+    if (m_heads.size() > 2 and m_size < m_heads.size() / 2) {
+        resize(m_heads.size() / 2);
+    }
+}
+
+void CalendarScheduler::update(InternalEvent* event, const Time& time)
+{
+    assert(not isInfinity(time));
+
+    unlink(event);
+    event->m_time = time;
+    link(event);
+}
+
+InternalEvent* CalendarScheduler::top()
+{
+    if (m_size == 0) {
+        return 0;
+    }
+
+    std::size_t mask = m_heads.size() - 1;
+    std::size_t current = m_current;
+    double currentwindow = m_window;
+
+    for (std::size_t i = 0; i < m_heads.size(); ++i) {
+        InternalEvent* event = m_heads[current];
+
+        if (event and window(event->m_time) <= currentwindow) {
+            m_current = current;
+            m_window = currentwindow;
+            return event;
+        }
+
+        current = (current + 1) & mask;
+        currentwindow += 1.0;
+    }
+
+    /*
+     * No event in the next year of the calendar, we search the smallest
+     * head of buckets and we restart the calendar from it.
+     */
+    InternalEvent* result = 0;
+    for (std::size_t i = 0; i < m_heads.size(); ++i) {
+        if (m_heads[i] and (not result or
+                            m_heads[i]->m_time < result->m_time)) {
+            result = m_heads[i];
+        }
+    }
+
+    m_current = result->m_position;
+    m_window = window(result->m_time);
+    return result;
+}
+
+InternalEvent* CalendarScheduler::pop()
+{
+    InternalEvent* event = top();
+
+    if (event) {
+        erase(event);
+    }
+
+    return event;
+}
+
+std::size_t CalendarScheduler::bucket(double window) const
+{
+    double nb = static_cast < double >(m_heads.size());
+    double result = std::fmod(window, nb);
+
+    if (result < 0.0) {
+        result += nb;
+    }
+
+    return static_cast < std::size_t >(result);
+}
+
+void CalendarScheduler::link(InternalEvent* event)
+{
+    double eventwindow = window(event->m_time);
+    std::size_t position = bucket(eventwindow);
+    InternalEvent* it = m_tails[position];
+
+    /*
+     * Events are often pushed in the future or at the same time than the
+     * others so, we search the position of the new event from the tail.
+     */
+    while (it and event->m_time < it->m_time) {
+        it = it->m_prev;
+    }
+
+    event->m_position = position;
+    event->m_prev = it;
+    if (it) {
+        event->m_next = it->m_next;
+        it->m_next = event;
+    } else {
+        event->m_next = m_heads[position];
+        m_heads[position] = event;
+    }
+
+    if (event->m_next) {
+        event->m_next->m_prev = event;
+    } else {
+        m_tails[position] = event;
+    }
+
+    if (m_size == 0 or eventwindow < m_window) {
+        m_window = eventwindow;
+        m_current = position;
+    }
+}
+
+void CalendarScheduler::unlink(InternalEvent* event)
+{
+    std::size_t position = event->m_position;
+
+    if (event->m_prev) {
+        event->m_prev->m_next = event->m_next;
+    } else {
+        m_heads[position] = event->m_next;
+    }
+
+    if (event->m_next) {
+        event->m_next->m_prev = event->m_prev;
+    } else {
+        m_tails[position] = event->m_prev;
+    }
+
+    event->m_prev = 0;
+    event->m_next = 0;
+}
+
+void CalendarScheduler::resize(std::size_t buckets)
+{
+    std::vector < InternalEvent* > events;
+    events.reserve(m_size);
+
+    for (std::size_t i = 0; i < m_heads.size(); ++i) {
+        for (InternalEvent* it = m_heads[i]; it; it = it->m_next) {
+            events.push_back(it);
+        }
+    }
+
+    /*
+     * The new width of the buckets is three times the average separation
+     * of the first events, ignoring the too large separations.
+     */
+    std::size_t sample = std::min(events.size(), (std::size_t)25);
+    if (sample > 1) {
+        std::partial_sort(events.begin(), events.begin() + sample,
+                          events.end(), CalendarLessThan());
+
+        double average = (events[sample - 1]->m_time - events[0]->m_time) /
+            (sample - 1);
+        double sum = 0.0;
+        std::size_t nb = 0;
+
+        for (std::size_t i = 1; i < sample; ++i) {
+            double separation = events[i]->m_time - events[i - 1]->m_time;
+
+            if (separation <= 2.0 * average) {
+                sum += separation;
+                ++nb;
+            }
+        }
+
+        if (nb > 0 and sum > 0.0) {
+            m_width = 3.0 * sum / nb;
+        }
+    }
+
+    m_heads.assign(buckets, (InternalEvent*)0);
+    m_tails.assign(buckets, (InternalEvent*)0);
+    m_size = 0;
+
+    for (std::vector < InternalEvent* >::iterator it = events.begin();
+         it != events.end(); ++it) {
+        link(*it);
+        ++m_size;
+    }
+}
+
+}} // namespace vle devs
@@ -0,0 +1,207 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef VLE_DEVS_SCHEDULER_HPP
+#define VLE_DEVS_SCHEDULER_HPP 1
+
+#include <vle/DllDefines.hpp>
+#include <vle/devs/InternalEvent.hpp>
+#include <vle/devs/Time.hpp>
+#include <string>
+#include <vector>
+
+namespace vle { namespace devs {
+
+/**
+ * @brief Scheduler is the interface of the priority queue used by the
+ * devs::EventTable to store the devs::InternalEvent.
+ *
+ * A Scheduler owns the devs::InternalEvent it stores: the remaining
+ * events are deleted with the Scheduler. An event is returned to the
+ * caller by the pop() function. The erase() and update() functions work
+ * in place, using the hooks stored into the devs::InternalEvent, so no
+ * invalidated event stays in the Scheduler.
+ */
+class VLE_API Scheduler
+{
+public:
+    Scheduler()
+    {}
+
+    virtual ~Scheduler()
+    {}
+
+    /**
+     * @brief Push a new devs::InternalEvent into the Scheduler.
+     * @param event The event to push, the Scheduler takes the ownership.
+     */
+    virtual void insert(InternalEvent* event) = 0;
+
+    /**
+     * @brief Remove a devs::InternalEvent from the Scheduler. The event is
+     * not deleted, the caller takes the ownership.
+     * @param event The event to remove.
+     */
+    virtual void erase(InternalEvent* event) = 0;
+
+    /**
+     * @brief Change the wake up time of an event of the Scheduler.
+     * @param event The event to move.
+     * @param time The new wake up time.
+     */
+    virtual void update(InternalEvent* event, const Time& time) = 0;
+
+    /**
+     * @brief Get the event with the smallest time.
+     * @return A pointer to the event or NULL if the Scheduler is empty.
+     */
+    virtual InternalEvent* top() = 0;
+
+    /**
+     * @brief Remove the event with the smallest time from the Scheduler.
+     * @return A pointer to the event, the caller takes the ownership, or
+     * NULL if the Scheduler is empty.
+     */
+    virtual InternalEvent* pop() = 0;
+
+    /**
+     * @brief Get the number of events stored into the Scheduler.
+     * @return The number of events.
+     */
+    virtual std::size_t size() const = 0;
+
+    /**
+     * @brief Check if the Scheduler is empty.
+     * @return true if the Scheduler is empty, false otherwise.
+     */
+    bool empty() const
+    { return size() == 0; }
+
+    /**
+     * @brief Build a new Scheduler from its name.
+     * @param name The name of the Scheduler, `heap' or `calendar'. An
+     * empty name builds the default `heap' Scheduler.
+     * @throw utils::ArgError if the name is unknown.
+     * @return A new Scheduler.
+     */
+    static Scheduler* build(const std::string& name);
+
+private:
+    Scheduler(const Scheduler& other);
+    Scheduler& operator=(const Scheduler& other);
+};
+
+/**
+ * @brief HeapScheduler is a binary heap where each event knows its
+ * position. All operations are in O(log(n)).
+ */
+class VLE_API HeapScheduler : public Scheduler
+{
+public:
+    HeapScheduler(std::size_t sz = 4096);
+
+    virtual ~HeapScheduler();
+
+    virtual void insert(InternalEvent* event);
+
+    virtual void erase(InternalEvent* event);
+
+    virtual void update(InternalEvent* event, const Time& time);
+
+    virtual InternalEvent* top();
+
+    virtual InternalEvent* pop();
+
+    virtual std::size_t size() const
+    { return m_heap.size(); }
+
+private:
+    std::vector < InternalEvent* > m_heap;
+
+    void place(std::size_t position, InternalEvent* event)
+    {
+        m_heap[position] = event;
+        event->m_position = position;
+    }
+
+    void up(std::size_t position);
+
+    void down(std::size_t position);
+};
+
+/**
+ * @brief CalendarScheduler is a calendar queue (R. Brown, 1988): events
+ * are hashed by time into an array of buckets of a fixed width, each
+ * bucket is a sorted double linked list. The number of buckets and the
+ * width are adapted to the number of events and their distribution, so
+ * insert(), erase(), update() and pop() are in O(1) amortized.
+ */
+class VLE_API CalendarScheduler : public Scheduler
+{
+public:
+    CalendarScheduler();
+
+    virtual ~CalendarScheduler();
+
+    virtual void insert(InternalEvent* event);
+
+    virtual void erase(InternalEvent* event);
+
+    virtual void update(InternalEvent* event, const Time& time);
+
+    virtual InternalEvent* top();
+
+    virtual InternalEvent* pop();
+
+    virtual std::size_t size() const
+    { return m_size; }
+
+private:
+    std::vector < InternalEvent* > m_heads; /**< First event of buckets. */
+    std::vector < InternalEvent* > m_tails; /**< Last event of buckets. */
+    std::size_t m_size;     /**< Number of events. */
+    double      m_width;    /**< Width of a bucket. */
+    std::size_t m_current;  /**< Current bucket of the search. */
+    double      m_window;   /**< Index of the current time window, no
+                              event is before this window. */
+
+    double window(const Time& time) const
+    { return std::floor(time / m_width); }
+
+    std::size_t bucket(double window) const;
+
+    void link(InternalEvent* event);
+
+    void unlink(InternalEvent* event);
+
+    void resize(std::size_t buckets);
+};
+
+}} // namespace vle devs
+
+#endif
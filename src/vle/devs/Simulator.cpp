@@ -28,13 +28,20 @@
 #include <vle/devs/Simulator.hpp>
 #include <vle/devs/Dynamics.hpp>
 #include <vle/devs/Time.hpp>
+#include <vle/devs/ExternalEvent.hpp>
+#include <vle/devs/View.hpp>
 #include <vle/vpz/AtomicModel.hpp>
+#include <boost/checked_delete.hpp>
+#include <algorithm>
 
 namespace vle { namespace devs {
 
 Simulator::Simulator(vpz::AtomicModel* atomic) :
     m_dynamics(0),
-    m_atomicModel(atomic)
+    m_atomicModel(atomic),
+    m_internalEvent(0),
+    m_partition(0),
+    m_profile(0)
 {
     if (not atomic) {
         throw utils::InternalError(_(
@@ -45,6 +52,9 @@ Simulator::Simulator(vpz::AtomicModel* atomic) :
 Simulator::~Simulator()
 {
     delete m_dynamics;
+
+    std::for_each(m_externalEvents.begin(), m_externalEvents.end(),
+                  boost::checked_deleter < ExternalEvent >());
 }
 
 void Simulator::clear()
@@ -54,35 +64,76 @@ void Simulator::clear()
     m_atomicModel = 0;
 }
 
+void Simulator::attachView(View* view)
+{
+    m_views.push_back(view);
+
+    if (view->isEvent()) {
+        m_eventViews.push_back(view);
+    }
+}
+
+void Simulator::detachView(View* view)
+{
+    m_views.erase(std::remove(m_views.begin(), m_views.end(), view),
+                  m_views.end());
+
+    if (view->isEvent()) {
+        m_eventViews.erase(std::remove(m_eventViews.begin(),
+                                       m_eventViews.end(), view),
+                           m_eventViews.end());
+    }
+}
+
 void
 Simulator::updateSimulatorTargets(
         const std::string& port,
         std::map < vpz::AtomicModel*, devs::Simulator* >& simulators)
 {
-    mTargets.erase(port);
-
     vpz::ModelPortList result;
     m_atomicModel->getAtomicModelsTarget(port, result);
 
-    if (result.begin() == result.end()) {
-        mTargets.insert(value_type(port, TargetSimulator(
-                   (Simulator*)0, std::string())));
-    } else {
-        for (vpz::ModelPortList::iterator it = result.begin(); it !=
-                result.end(); ++it) {
-
-            std::map < vpz::AtomicModel*, devs::Simulator* >::iterator target;
-            target = simulators.find(
-                    reinterpret_cast < vpz::AtomicModel*>(it->first));
-
-            if (target == simulators.end()) {
-                mTargets.erase(port);
-                break;
-            } else {
-                mTargets.insert(std::make_pair(port, TargetSimulator(
-                            target->second, it->second)));
+    TargetSimulatorList targets;
+    targets.reserve(result.size());
+
+    PortName name(port);
+    OutputPortList::iterator it = findOutputPort(name);
+
+    for (vpz::ModelPortList::iterator jt = result.begin(); jt !=
+         result.end(); ++jt) {
+
+        std::map < vpz::AtomicModel*, devs::Simulator* >::iterator target;
+        target = simulators.find(
+            reinterpret_cast < vpz::AtomicModel*>(jt->first));
+
+        if (target == simulators.end()) {
+            if (it != mOutputs.end()) {
+                eraseOutputPort(it);
             }
+            return;
         }
+
+        targets.push_back(TargetSimulator(target->second,
+                                          PortName(jt->second)));
+    }
+
+    if (it == mOutputs.end()) {
+        mOutputs.push_back(OutputPort(name, mTargets.size(),
+                                      mTargets.size()));
+        it = mOutputs.end() - 1;
+    }
+
+    replaceTargets(it, targets);
+}
+
+void Simulator::buildSimulatorTargets(
+    std::map < vpz::AtomicModel*, devs::Simulator* >& simulators)
+{
+    const vpz::ConnectionList& outputs(m_atomicModel->getOutputPortList());
+
+    for (vpz::ConnectionList::const_iterator it = outputs.begin();
+         it != outputs.end(); ++it) {
+        updateSimulatorTargets(it->first, simulators);
     }
 }
 
@@ -91,34 +142,80 @@ Simulator::targets(
     const std::string& port,
     std::map < vpz::AtomicModel*, devs::Simulator* >& simulators)
 {
-    std::pair < iterator, iterator > x = mTargets.equal_range(port);
+    PortName name(port);
+    OutputPortList::iterator it = findOutputPort(name);
 
-    if (x.first == x.second) {
+    if (it == mOutputs.end()) {
         updateSimulatorTargets(port, simulators);
-        x = mTargets.equal_range(port);
-    } else if (x.first->second.first == 0) {
-        x = make_pair(mTargets.end(), mTargets.end());
+        it = findOutputPort(name);
+
+        if (it == mOutputs.end()) {
+            return std::make_pair(mTargets.end(), mTargets.end());
+        }
     }
 
-    return x;
+    return std::make_pair(mTargets.begin() + it->begin,
+                          mTargets.begin() + it->end);
 }
 
 void Simulator::removeTargetPort(const std::string& port)
 {
-    iterator it = mTargets.find(port);
+    OutputPortList::iterator it = findOutputPort(PortName(port));
 
-    if (it != mTargets.end()) {
-        mTargets.erase(it);
+    if (it != mOutputs.end()) {
+        eraseOutputPort(it);
     }
 }
 
 void Simulator::addTargetPort(const std::string& port)
 {
-    assert(mTargets.find(port) == mTargets.end());
+    PortName name(port);
+
+    assert(findOutputPort(name) == mOutputs.end());
+
+    mOutputs.push_back(OutputPort(name, mTargets.size(), mTargets.size()));
+}
+
+Simulator::OutputPortList::iterator
+Simulator::findOutputPort(const PortName& port)
+{
+    OutputPortList::iterator it = mOutputs.begin();
+
+    while (it != mOutputs.end() and it->name != port) {
+        ++it;
+    }
+
+    return it;
+}
+
+void Simulator::replaceTargets(OutputPortList::iterator it,
+                               const TargetSimulatorList& targets)
+{
+    size_type size = it->end - it->begin;
+
+    if (size == targets.size()) {
+        std::copy(targets.begin(), targets.end(),
+                  mTargets.begin() + it->begin);
+    } else {
+        mTargets.erase(mTargets.begin() + it->begin,
+                       mTargets.begin() + it->end);
+        mTargets.insert(mTargets.begin() + it->begin, targets.begin(),
+                        targets.end());
+
+        it->end = it->begin + targets.size();
 
-    mTargets.insert(value_type(port,
-                               TargetSimulator((Simulator*)0,
-                                               std::string())));
+        for (OutputPortList::iterator jt = it + 1; jt != mOutputs.end();
+             ++jt) {
+            jt->begin = jt->begin + targets.size() - size;
+            jt->end = jt->end + targets.size() - size;
+        }
+    }
+}
+
+void Simulator::eraseOutputPort(OutputPortList::iterator it)
+{
+    replaceTargets(it, TargetSimulatorList());
+    mOutputs.erase(it);
 }
 
 void Simulator::addDynamics(Dynamics* dynamics)
@@ -167,12 +264,20 @@ void Simulator::finish()
 
 void Simulator::output(const Time& currentTime, ExternalEventList& output)
 {
+    Profile::Timer timer(m_profile, Profile::OUTPUT);
+
     m_dynamics->output(currentTime, output);
 }
 
 Time Simulator::timeAdvance()
 {
-    Time result = m_dynamics->timeAdvance();
+    Time result(0.0);
+    {
+        Profile::Timer timer(m_profile, Profile::TIME_ADVANCE);
+
+        result = m_dynamics->timeAdvance();
+    }
+
     if (result < 0.0) {
         throw utils::ModellingError(fmt(
                 _("Negative time advance in '%1%' (%2%)")) % getName() %
@@ -200,13 +305,23 @@ InternalEvent* Simulator::confluentTransitions(
     const InternalEvent& internal,
     const ExternalEventList& extEventlist)
 {
-    m_dynamics->confluentTransitions(internal.getTime(), extEventlist);
+    {
+        Profile::Timer timer(m_profile, Profile::CONFLUENT);
+
+        m_dynamics->confluentTransitions(internal.getTime(), extEventlist);
+    }
+
     return buildInternalEvent(internal.getTime());
 }
 
 InternalEvent* Simulator::internalTransition(const InternalEvent& event)
 {
-    m_dynamics->internalTransition(event.getTime());
+    {
+        Profile::Timer timer(m_profile, Profile::INTERNAL);
+
+        m_dynamics->internalTransition(event.getTime());
+    }
+
     return buildInternalEvent(event.getTime());
 }
 
@@ -214,12 +329,19 @@ InternalEvent* Simulator::externalTransition(
     const ExternalEventList& event,
     const Time& time)
 {
-    m_dynamics->externalTransition(event, time);
+    {
+        Profile::Timer timer(m_profile, Profile::EXTERNAL);
+
+        m_dynamics->externalTransition(event, time);
+    }
+
     return buildInternalEvent(time);
 }
 
 value::Value* Simulator::observation(const ObservationEvent& event) const
 {
+    Profile::Timer timer(m_profile, Profile::OBSERVATION);
+
     return m_dynamics->observation(event);
 }
 
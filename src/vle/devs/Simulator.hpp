@@ -33,12 +33,16 @@
 #include <vle/devs/InternalEvent.hpp>
 #include <vle/devs/ObservationEvent.hpp>
 #include <vle/devs/ExternalEventList.hpp>
+#include <vle/devs/PortName.hpp>
 #include <vle/devs/Dynamics.hpp>
+#include <vle/devs/Profile.hpp>
 #include <vle/vpz/AtomicModel.hpp>
+#include <vector>
 
 namespace vle { namespace devs {
 
     class Dynamics;
+    class View;
 
     /**
      * @brief Represent a couple devs::AtomicModel and devs::Dynamic class to
@@ -48,14 +52,35 @@ namespace vle { namespace devs {
     class VLE_API Simulator
     {
     public:
-        typedef std::pair < Simulator*, std::string > TargetSimulator;
-        typedef std::multimap < std::string, TargetSimulator >
-            TargetSimulatorList;
+        typedef std::pair < Simulator*, PortName > TargetSimulator;
+        typedef std::vector < TargetSimulator > TargetSimulatorList;
         typedef TargetSimulatorList::const_iterator const_iterator;
         typedef TargetSimulatorList::iterator iterator;
         typedef TargetSimulatorList::size_type size_type;
         typedef TargetSimulatorList::value_type value_type;
 
+        /**
+         * @brief The routing of an output port: the range [begin, end) of
+         * the TargetSimulatorList.
+         */
+        struct OutputPort
+        {
+            OutputPort(const PortName& name, size_type begin, size_type end)
+                : name(name), begin(begin), end(end)
+            {}
+
+            PortName  name;
+            size_type begin;
+            size_type end;
+        };
+
+        typedef std::vector < OutputPort > OutputPortList;
+
+        /**
+         * @brief The views which observe the Simulator.
+         */
+        typedef std::vector < View* > ObserverList;
+
         /**
          * @brief Build a new devs::Simulator with an empty devs::Dynamics, a
          * null last time but a vpz::AtomicModel node.
@@ -65,7 +90,8 @@ namespace vle { namespace devs {
 	Simulator(vpz::AtomicModel* a);
 
         /**
-         * @brief Delete the attached devs::Dynamics user's model.
+         * @brief Delete the attached devs::Dynamics user's model and the
+         * external events waiting for this Simulator.
          */
 	~Simulator();
 
@@ -111,13 +137,75 @@ namespace vle { namespace devs {
         inline const Dynamics* dynamics() const
         { return m_dynamics; }
 
+        /**
+         * @brief Get the index of the devs::Partition which simulates this
+         * Simulator.
+         * @return An index, 0 without partition.
+         */
+        inline std::size_t partition() const
+        { return m_partition; }
+
+        /**
+         * @brief Assign the devs::Partition which simulates this
+         * Simulator.
+         * @param partition The index of the partition.
+         */
+        inline void setPartition(std::size_t partition)
+        { m_partition = partition; }
+
+        /**
+         * @brief Get the views which observe at least one port of this
+         * Simulator.
+         * @return The views, in the order of their first observable.
+         */
+        inline const ObserverList& views() const
+        { return m_views; }
+
+        /**
+         * @brief Get the devs::EventView which observe this Simulator, a
+         * subset of \c views() run after each transition.
+         * @return The event views, empty if the Simulator is not observed
+         * by an event view.
+         */
+        inline const ObserverList& eventViews() const
+        { return m_eventViews; }
+
+        /**
+         * @brief Register a view which observes this Simulator. Called by
+         * devs::View::addObservable for the first port observed.
+         * @param view The view to register.
+         */
+        void attachView(View* view);
+
+        /**
+         * @brief Unregister a view. Called by devs::View::removeObservable.
+         * @param view The view to unregister.
+         */
+        void detachView(View* view);
+
+        /**
+         * @brief Get the devs::Profile::Record of this Simulator.
+         * @return The record or null if the simulation is not profiled.
+         */
+        inline Profile::Record* profile() const
+        { return m_profile; }
+
+        /**
+         * @brief Assign the devs::Profile::Record which records the calls
+         * of the functions of this Simulator.
+         * @param record The record, null to stop the profiling.
+         */
+        inline void setProfile(Profile::Record* record)
+        { m_profile = record; }
+
 
                              /*-*-*-*-*-*-*-*-*-*/
 
         /**
          * @brief Call this function to browse the model's structure (atomic
          * and coupled models) to find all devs::Simulator connected to the
-         * specified output port.
+         * specified output port. Only the range of this output port is
+         * replaced in the routing table.
          * @param port The output port used to build simulators' target list.
          * @param simulators list of available simulators.
          */
@@ -125,6 +213,15 @@ namespace vle { namespace devs {
             const std::string& port,
             std::map < vpz::AtomicModel*, devs::Simulator* >& simulators);
 
+        /**
+         * @brief Build the routing table of all the output ports of the
+         * vpz::AtomicModel. This function is called when all the
+         * devs::Simulator of the model are built.
+         * @param simulators list of available simulators.
+         */
+        void buildSimulatorTargets(
+            std::map < vpz::AtomicModel*, devs::Simulator* >& simulators);
+
         /**
          * @brief Get two iterators (begin, end) on TargetSimulator.
          * @param port The output port to get the simulators' target list.
@@ -175,12 +272,56 @@ namespace vle { namespace devs {
         value::Value* observation(const ObservationEvent& event) const;
 
     private:
-        TargetSimulatorList mTargets;
+        friend class EventTable;
+        friend class Snapshot;
+
+        TargetSimulatorList mTargets; /**< The targets of all the output
+                                        ports, grouped by output port. */
+        OutputPortList      mOutputs; /**< The range of each output port
+                                        into mTargets. */
         Dynamics*           m_dynamics;
         vpz::AtomicModel*   m_atomicModel;
         std::string         m_parents;
+        InternalEvent*      m_internalEvent; /**< The scheduled internal
+                                               event, managed by the
+                                               devs::EventTable. */
+        ExternalEventList   m_externalEvents; /**< The external events
+                                                waiting for the next bag,
+                                                managed by the
+                                                devs::EventTable. */
+        std::size_t         m_partition; /**< The index of the
+                                           devs::Partition. */
+        ObserverList        m_views; /**< The views which observe the
+                                       Simulator. */
+        ObserverList        m_eventViews; /**< The event views of
+                                            m_views. */
+        Profile::Record*    m_profile; /**< The record of the calls, null
+                                         if the simulation is not
+                                         profiled. */
 
 	InternalEvent* buildInternalEvent(const Time& currentTime);
+
+        /**
+         * @brief Find the routing of an output port. The names are
+         * interned, the ports are compared by address.
+         * @param port The name of the output port.
+         * @return An iterator on the OutputPort or mOutputs.end().
+         */
+        OutputPortList::iterator findOutputPort(const PortName& port);
+
+        /**
+         * @brief Replace the targets of an output port.
+         * @param it The output port to update.
+         * @param targets The new targets.
+         */
+        void replaceTargets(OutputPortList::iterator it,
+                            const TargetSimulatorList& targets);
+
+        /**
+         * @brief Remove an output port and its targets.
+         * @param it The output port to remove.
+         */
+        void eraseOutputPort(OutputPortList::iterator it);
     };
 
 }} // namespace vle devs
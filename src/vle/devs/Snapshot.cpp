@@ -0,0 +1,433 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <vle/devs/Snapshot.hpp>
+#include <vle/devs/Coordinator.hpp>
+#include <vle/devs/Partition.hpp>
+#include <vle/devs/Simulator.hpp>
+#include <vle/devs/ExternalEvent.hpp>
+#include <vle/devs/InternalEvent.hpp>
+#include <vle/vpz/Cache.hpp>
+#include <vle/vpz/Vpz.hpp>
+#include <vle/vpz/AtomicModel.hpp>
+#include <vle/value/Binary.hpp>
+#include <vle/value/Map.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/Path.hpp>
+#include <vle/utils/Trace.hpp>
+#include <vle/utils/i18n.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/checked_delete.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace vle { namespace devs {
+
+namespace {
+
+const std::size_t HEADER_SIZE = 48;
+
+template < typename T >
+void put(std::string& out, T value)
+{
+    out.append(reinterpret_cast < const char* >(&value), sizeof(T));
+}
+
+void put(std::string& out, const std::string& str)
+{
+    put(out, static_cast < uint32_t >(str.size()));
+    out.append(str);
+}
+
+void align(std::string& out)
+{
+    out.resize(out.size() + (8 - out.size() % 8) % 8, '\0');
+}
+
+/*
+ * A cursor on the state of the kernel. Each read checks the bounds of
+ * the state to detect truncated or corrupted files.
+ */
+class Cursor
+{
+public:
+    Cursor(const std::string& data)
+        : m_pos(data.data()), m_end(data.data() + data.size())
+    {}
+
+    template < typename T >
+    T get()
+    {
+        T result;
+        std::memcpy(&result, take(sizeof(T)), sizeof(T));
+        return result;
+    }
+
+    std::string getString()
+    {
+        uint32_t size = get < uint32_t >();
+        const char* str = take(size);
+        return std::string(str, size);
+    }
+
+    const char* take(std::size_t size)
+    {
+        if (static_cast < std::size_t >(m_end - m_pos) < size) {
+            throw utils::FileError(
+                _("Snapshot: truncated or corrupted snapshot"));
+        }
+
+        const char* result = m_pos;
+        m_pos += size;
+        return result;
+    }
+
+private:
+    const char* m_pos;
+    const char* m_end;
+};
+
+void atomics(vpz::BaseModel* model, vpz::AtomicModelVector& result)
+{
+    if (model) {
+        vpz::BaseModel::getAtomicModelList(model, result);
+    }
+}
+
+void putViewEvents(std::string& out, const ViewEventList& events)
+{
+    put(out, static_cast < uint32_t >(events.size()));
+    for (ViewEventList::const_iterator it = events.begin();
+         it != events.end(); ++it) {
+        put(out, (*it)->getView().getName());
+        put(out, (*it)->getTime());
+    }
+}
+
+View* getView(const Coordinator& coordinator, const std::string& name)
+{
+    View* view = coordinator.getView(name);
+
+    if (not view) {
+        throw utils::FileError(fmt(
+                _("Snapshot: unknown view '%1%'")) % name);
+    }
+
+    return view;
+}
+
+} // anonymous namespace
+
+void Snapshot::capture(Coordinator& coordinator, vpz::BaseModel* model,
+                       utils::Rand& rand, uint32_t replica, const Time& end)
+{
+    vpz::AtomicModelVector models;
+    atomics(model, models);
+
+    std::vector < value::Value* > states(models.size(),
+                                         (value::Value*)0);
+    std::string state;
+    std::ostringstream values;
+
+    try {
+        for (std::size_t i = 0; i < models.size(); ++i) {
+            states[i] = coordinator.getModel(models[i])->m_dynamics->
+                serialize();
+
+            if (not states[i]) {
+                throw utils::ModellingError(fmt(
+                        _("Snapshot: the model '%1%' does not support the "
+                          "snapshots")) % models[i]->getCompleteName());
+            }
+        }
+
+        value::BinaryWriter writer(values);
+
+        put(state, static_cast < uint32_t >(models.size()));
+        for (std::size_t i = 0; i < models.size(); ++i) {
+            Simulator* sim = coordinator.getModel(models[i]);
+
+            uint32_t stream[utils::Philox::STATE];
+            sim->m_dynamics->randStream().gen().save(stream);
+
+            put(state, models[i]->getCompleteName());
+            put(state, sim->m_internalEvent ?
+                sim->m_internalEvent->getTime() : infinity);
+            state.append(reinterpret_cast < const char* >(stream),
+                         sizeof(stream));
+            put(state, static_cast < uint32_t >(sim->m_externalEvents.size()));
+
+            writer.write(states[i]);
+
+            for (ExternalEventList::iterator it =
+                 sim->m_externalEvents.begin();
+                 it != sim->m_externalEvents.end(); ++it) {
+                put(state, (*it)->getPortName());
+                writer.write((*it)->haveAttributes() ?
+                             &(*it)->attributes() : 0);
+            }
+        }
+
+        putViewEvents(state, coordinator.m_eventTable.observationEvents());
+        putViewEvents(state, coordinator.m_obsEventBuffer);
+    } catch (...) {
+        std::for_each(states.begin(), states.end(),
+                      boost::checked_deleter < value::Value >());
+        throw;
+    }
+
+    std::for_each(states.begin(), states.end(),
+                  boost::checked_deleter < value::Value >());
+
+    std::ostringstream image;
+    vpz::Cache::write(model, coordinator.dynamics(), coordinator.classes(),
+                      coordinator.experiment(), replica, image);
+
+    std::ostringstream generator;
+    generator << rand.gen();
+
+    m_time = coordinator.getCurrentTime();
+    m_end = end;
+    m_rand = generator.str();
+    m_image = image.str();
+    m_state.swap(state);
+    m_values = values.str();
+}
+
+void Snapshot::write(const std::string& filename) const
+{
+    std::string data;
+    put(data, m_rand);
+    align(data);
+    data.append(m_image);
+    align(data);
+
+    std::size_t state = HEADER_SIZE + data.size();
+    data.append(m_state);
+    align(data);
+
+    std::size_t values = HEADER_SIZE + data.size();
+    data.append(m_values);
+
+    std::string header(snapshot::MAGIC, 8);
+    put(header, snapshot::VERSION);
+    put(header, snapshot::ENDIANNESS);
+    put(header, m_time);
+    put(header, m_end);
+    put(header, static_cast < uint64_t >(state));
+    put(header, static_cast < uint64_t >(values));
+
+    header.append(data);
+    utils::Path::writeAtomic(filename, header);
+}
+
+void Snapshot::read(const std::string& filename)
+{
+    std::ifstream in(filename.c_str(), std::ios::binary);
+
+    if (not in.is_open()) {
+        throw utils::FileError(fmt(
+                _("Snapshot: cannot open file '%1%'")) % filename);
+    }
+
+    std::ostringstream content;
+    content << in.rdbuf();
+    const std::string data(content.str());
+    Cursor cursor(data);
+
+    if (data.size() < HEADER_SIZE or
+        std::memcmp(cursor.take(8), snapshot::MAGIC, 8) != 0 or
+        cursor.get < uint32_t >() != snapshot::VERSION or
+        cursor.get < uint32_t >() != snapshot::ENDIANNESS) {
+        throw utils::FileError(fmt(
+                _("Snapshot: '%1%' is not a snapshot or has an unknown "
+                  "version")) % filename);
+    }
+
+    m_time = cursor.get < double >();
+    m_end = cursor.get < double >();
+    uint64_t state = cursor.get < uint64_t >();
+    uint64_t values = cursor.get < uint64_t >();
+
+    m_rand = cursor.getString();
+    std::size_t image = HEADER_SIZE + 4 + m_rand.size();
+    image += (8 - image % 8) % 8;
+
+    if (image > state or state > values or values > data.size()) {
+        throw utils::FileError(
+            _("Snapshot: truncated or corrupted snapshot"));
+    }
+
+    m_image.assign(data, image, state - image);
+    m_state.assign(data, state, values - state);
+    m_values.assign(data, values, std::string::npos);
+}
+
+void Snapshot::project(vpz::Vpz& vpz) const
+{
+    vpz::Cache::read(vpz, m_image.data(), m_image.size());
+}
+
+void Snapshot::restore(Coordinator& coordinator,
+                       vpz::BaseModel* model) const
+{
+    vpz::AtomicModelVector models;
+    atomics(model, models);
+
+    Cursor cursor(m_state);
+
+    try {
+        value::BinaryReader values(m_values.data(), m_values.size());
+
+        if (cursor.get < uint32_t >() != models.size()) {
+            throw utils::FileError(
+                _("Snapshot: the models do not match the snapshot"));
+        }
+
+        for (std::size_t i = 0; i < models.size(); ++i) {
+            Simulator* sim = coordinator.getModel(models[i]);
+            EventTable& table(coordinator.m_partitions.empty() ?
+                              coordinator.m_eventTable :
+                              coordinator.m_partitions[sim->partition()]->
+                              eventtable());
+            EventPool::Scope scope(coordinator.m_partitions.empty() ?
+                                   coordinator.m_eventPool :
+                                   coordinator.m_partitions[
+                                       sim->partition()]->eventPool());
+
+            if (cursor.getString() != models[i]->getCompleteName()) {
+                throw utils::FileError(fmt(
+                        _("Snapshot: the model '%1%' does not match the "
+                          "snapshot")) % models[i]->getCompleteName());
+            }
+
+            Time internal = cursor.get < double >();
+            uint32_t stream[utils::Philox::STATE];
+            std::memcpy(stream, cursor.take(sizeof(stream)), sizeof(stream));
+            uint32_t externals = cursor.get < uint32_t >();
+
+            sim->m_dynamics->randStream().gen().load(stream);
+
+            boost::scoped_ptr < value::Value > state(values.read());
+            if (not state.get()) {
+                throw utils::FileError(
+                    _("Snapshot: truncated or corrupted snapshot"));
+            }
+            sim->m_dynamics->deserialize(*state);
+
+            if (not isInfinity(internal)) {
+                table.putInternalEvent(new InternalEvent(internal, sim));
+            }
+
+            for (uint32_t j = 0; j < externals; ++j) {
+                std::string port(cursor.getString());
+                boost::scoped_ptr < value::Value > attributes(values.read());
+
+                ExternalEvent event(port);
+                if (attributes.get()) {
+                    event.putAttributes(attributes->toMap());
+                }
+                table.putExternalEvent(new ExternalEvent(event, sim, port));
+            }
+        }
+
+        coordinator.m_eventTable.clearObservationEvents();
+        uint32_t views = cursor.get < uint32_t >();
+        for (uint32_t i = 0; i < views; ++i) {
+            View* view = getView(coordinator, cursor.getString());
+            coordinator.m_eventTable.putObservationEvent(
+                new ViewEvent(view, cursor.get < double >()));
+        }
+
+        uint32_t delayed = cursor.get < uint32_t >();
+        for (uint32_t i = 0; i < delayed; ++i) {
+            View* view = getView(coordinator, cursor.getString());
+            coordinator.m_obsEventBuffer.add(
+                new ViewEvent(view, cursor.get < double >()));
+        }
+    } catch (const utils::ParseError& e) {
+        throw utils::FileError(fmt(_("Snapshot: %1%")) % e.what());
+    }
+}
+
+                       /* - - - - - - - - - -*/
+
+SnapshotWriter::~SnapshotWriter()
+{
+    try {
+        wait();
+    } catch (const std::exception& e) {
+        TraceAlways(fmt(_("The last snapshot failed: %1%")) % e.what());
+    }
+}
+
+void SnapshotWriter::write(Snapshot* snapshot, const std::string& filename)
+{
+    try {
+        wait();
+    } catch (...) {
+        delete snapshot;
+        throw;
+    }
+
+    m_snapshot = snapshot;
+    m_filename = filename;
+    m_thread = new boost::thread(boost::bind(&SnapshotWriter::work, this));
+}
+
+void SnapshotWriter::wait()
+{
+    if (m_thread) {
+        m_thread->join();
+        delete m_thread;
+        m_thread = 0;
+    }
+
+    delete m_snapshot;
+    m_snapshot = 0;
+
+    if (not m_error.empty()) {
+        std::string error;
+        error.swap(m_error);
+        throw utils::FileError(error);
+    }
+}
+
+void SnapshotWriter::work()
+{
+    try {
+        m_snapshot->write(m_filename);
+    } catch (const std::exception& e) {
+        m_error = e.what();
+    }
+}
+
+}} // namespace vle devs
@@ -0,0 +1,222 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef VLE_DEVS_SNAPSHOT_HPP
+#define VLE_DEVS_SNAPSHOT_HPP
+
+#include <vle/DllDefines.hpp>
+#include <vle/devs/Time.hpp>
+#include <vle/utils/Rand.hpp>
+#include <vle/utils/Types.hpp>
+#include <string>
+
+namespace boost { class thread; }
+
+namespace vle { namespace vpz {
+
+class BaseModel;
+class Vpz;
+
+}} // namespace vle vpz
+
+namespace vle { namespace devs {
+
+class Coordinator;
+
+/**
+ * @brief The binary format of a snapshot.
+ *
+ * A snapshot file starts with a 48 bytes header: the magic string \c
+ * VLESNAPS, the version and the byte order of the writer (uint32), the
+ * date of the snapshot and the end of the simulation (double), the
+ * offsets of the state and of the values (uint64). Three sections
+ * follow, aligned on 8 bytes:
+ *
+ * - the image of the project (see vpz::Cache): the model tree, with the
+ *   changes of the Executive models, the dynamics, the classes and the
+ *   experiment.
+ * - the state of the kernel: the generator of the RootCoordinator and,
+ *   for each atomic model, its complete name, the date of its internal
+ *   event (infinity without event), the state of its random stream and
+ *   the ports of its pending external events; then the dates of the
+ *   views and of the observations delayed by the Coordinator.
+ * - the values (value::BinaryWriter): the state of each model returned
+ *   by devs::Dynamics::serialize and the attributes of the pending
+ *   external events.
+ */
+namespace snapshot {
+
+const char MAGIC[] = "VLESNAPS";
+const uint32_t VERSION = 1;
+const uint32_t ENDIANNESS = 0x01020304;
+
+} // namespace snapshot
+
+/**
+ * @brief A Snapshot stores the state of a simulation between two bags,
+ * to restart the simulation later from this date (see
+ * RootCoordinator::snapshot and RootCoordinator::restore).
+ *
+ * The state of the models is provided by the devs::Dynamics::serialize
+ * and devs::Dynamics::deserialize functions: a simulation with a model
+ * which does not provide them cannot be captured. The state of the
+ * output plug-ins is not stored: a restored simulation writes its
+ * observations into new outputs.
+ */
+class VLE_API Snapshot
+{
+public:
+    Snapshot()
+        : m_time(0.0), m_end(0.0)
+    {}
+
+    /**
+     * @brief Capture the state of a simulation, between two bags, at the
+     * current time of the Coordinator. Nothing is captured if a model
+     * does not support the snapshots.
+     * @param coordinator the coordinator of the simulation.
+     * @param model the model tree of the coordinator.
+     * @param rand the generator of the RootCoordinator.
+     * @param replica the replica of the simulation.
+     * @param end the end of the simulation.
+     * @throw utils::ModellingError if a model does not support the
+     * snapshots.
+     */
+    void capture(Coordinator& coordinator, vpz::BaseModel* model,
+                 utils::Rand& rand, uint32_t replica, const Time& end);
+
+    /**
+     * @brief Write the snapshot into a file. The snapshot is written into
+     * a temporary file renamed at the end, so the previous snapshot is
+     * kept until the new one is complete.
+     * @param filename the file.
+     * @throw utils::FileError if the file cannot be written.
+     */
+    void write(const std::string& filename) const;
+
+    /**
+     * @brief Read a snapshot from a file.
+     * @param filename the file.
+     * @throw utils::FileError if the file is not a snapshot or is
+     * truncated.
+     */
+    void read(const std::string& filename);
+
+    /**
+     * @brief Read the project of the snapshot.
+     * @param vpz the vpz to fill, it must be empty.
+     * @throw utils::FileError if the image is corrupted.
+     */
+    void project(vpz::Vpz& vpz) const;
+
+    /**
+     * @brief Restore the state of the models and the events of the
+     * simulation into a Coordinator. Called by Coordinator::restore when
+     * the simulators and the views are built.
+     * @param coordinator the coordinator to restore.
+     * @param model the model tree of the coordinator.
+     * @throw utils::FileError if the snapshot does not match the model
+     * tree or is corrupted.
+     */
+    void restore(Coordinator& coordinator, vpz::BaseModel* model) const;
+
+    /**
+     * @brief Get the date of the snapshot.
+     */
+    const Time& time() const
+    { return m_time; }
+
+    /**
+     * @brief Get the end of the simulation.
+     */
+    const Time& end() const
+    { return m_end; }
+
+    /**
+     * @brief Get the state of the generator of the RootCoordinator.
+     */
+    const std::string& rand() const
+    { return m_rand; }
+
+private:
+    Time        m_time;
+    Time        m_end;
+    std::string m_rand;
+    std::string m_image; /**< The image of the project. */
+    std::string m_state; /**< The state of the kernel. */
+    std::string m_values; /**< The values of the models and events. */
+};
+
+/**
+ * @brief The SnapshotWriter writes the snapshots on its own thread: the
+ * simulation continues while the previous snapshot is written. A
+ * snapshot waits for the end of the previous one.
+ */
+class VLE_API SnapshotWriter
+{
+public:
+    SnapshotWriter()
+        : m_snapshot(0), m_thread(0)
+    {}
+
+    /**
+     * @brief Wait for the last snapshot. A destructor cannot throw, so
+     * an error of the snapshot is sent to the utils::Trace.
+     */
+    ~SnapshotWriter();
+
+    /**
+     * @brief Wait for the previous snapshot and start the write of a
+     * new one.
+     * @param snapshot the snapshot, owned by the writer.
+     * @param filename the file.
+     * @throw utils::FileError if the previous snapshot failed.
+     */
+    void write(Snapshot* snapshot, const std::string& filename);
+
+    /**
+     * @brief Wait for the last snapshot.
+     * @throw utils::FileError if the snapshot failed.
+     */
+    void wait();
+
+private:
+    SnapshotWriter(const SnapshotWriter& other);
+    SnapshotWriter& operator=(const SnapshotWriter& other);
+
+    void work();
+
+    Snapshot*       m_snapshot;
+    std::string     m_filename;
+    std::string     m_error; /**< The error of the thread, empty if the
+                               write succeeds. */
+    boost::thread*  m_thread;
+};
+
+}} // namespace vle devs
+
+#endif
@@ -34,9 +34,270 @@
 #endif
 #include <vle/utils/Algo.hpp>
 #include <vle/version.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/bind.hpp>
+#include <algorithm>
+#include <vector>
 
 namespace vle { namespace devs {
 
+/**
+ * @brief The Queue runs the oov::Plugin of a StreamWriter on its own
+ * thread.
+ *
+ * The simulation thread fills the messages of a ring buffer and the
+ * thread of the Queue consumes them in the same order. A message is
+ * owned by one thread at a time: the mutex is only held to move the
+ * head and tail indices, the rows are exchanged by swapping their lanes
+ * (oov::Row::swap), without copy. The thread of the Queue keeps a copy
+ * of the columns of the View, updated by the new and removed observable
+ * messages, to rebuild the oov::Row given to the plug-in.
+ */
+class StreamWriter::Queue
+{
+public:
+    Queue(StreamWriter& stream, const std::string& view, std::size_t size)
+        : m_stream(stream), m_row(view), m_messages(size), m_head(0),
+        m_count(0), m_depth(0), m_stall(0.0), m_stop(false),
+        m_failed(false), m_thread(0)
+    {
+        m_thread = new boost::thread(boost::bind(&Queue::work, this));
+    }
+
+    ~Queue()
+    {
+        stop();
+
+        for (std::size_t i = 0; i < m_messages.size(); ++i) {
+            m_messages[i].lanes.clear();
+        }
+    }
+
+    void pushNewObservable(const oov::Column& column, double time)
+    {
+        Message& msg = acquire();
+        msg.type = Message::NEW_OBSERVABLE;
+        msg.time = time;
+        msg.column = column;
+        commit();
+    }
+
+    void pushRemoveObservable(oov::Row::size_type id, double time)
+    {
+        Message& msg = acquire();
+        msg.type = Message::DEL_OBSERVABLE;
+        msg.time = time;
+        msg.id = id;
+        commit();
+    }
+
+    void pushRow(oov::Row& row)
+    {
+        Message& msg = acquire();
+        msg.type = Message::ROW;
+        row.swap(msg.lanes);
+        commit();
+    }
+
+    /**
+     * @brief Wait until all the messages are written and stop the
+     * thread.
+     */
+    void flush()
+    {
+        Message& msg = acquire();
+        msg.type = Message::CLOSE;
+        commit();
+
+        stop();
+        check();
+    }
+
+    std::size_t size() const
+    { return m_messages.size(); }
+
+    std::size_t depth() const
+    { return m_depth; }
+
+    double stall() const
+    { return m_stall; }
+
+private:
+    struct Message
+    {
+        enum Type { NEW_OBSERVABLE, DEL_OBSERVABLE, ROW, CLOSE };
+
+        Message()
+            : type(CLOSE), time(0.0), id(0)
+        {}
+
+        Type                type;
+        double              time;
+        oov::Column         column;
+        oov::Row::size_type id;
+        oov::Row::Lanes     lanes;
+    };
+
+    /**
+     * @brief Wait for a free message at the tail of the ring.
+     */
+    Message& acquire()
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+
+        if (m_count == m_messages.size() and not m_failed) {
+            boost::posix_time::ptime start =
+                boost::posix_time::microsec_clock::universal_time();
+
+            while (m_count == m_messages.size() and not m_failed) {
+                m_notFull.wait(lock);
+            }
+
+            m_stall += (boost::posix_time::microsec_clock::universal_time()
+                        - start).total_microseconds() / 1e6;
+        }
+
+        if (m_failed) {
+            throw utils::InternalError(m_error);
+        }
+
+        return m_messages[(m_head + m_count) % m_messages.size()];
+    }
+
+    /**
+     * @brief Give the message at the tail of the ring to the thread.
+     */
+    void commit()
+    {
+        {
+            boost::mutex::scoped_lock lock(m_mutex);
+            ++m_count;
+            m_depth = std::max(m_depth, m_count);
+        }
+        m_notEmpty.notify_one();
+    }
+
+    void check()
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+
+        if (m_failed) {
+            throw utils::InternalError(m_error);
+        }
+    }
+
+    void stop()
+    {
+        if (m_thread) {
+            {
+                boost::mutex::scoped_lock lock(m_mutex);
+                m_stop = true;
+            }
+            m_notEmpty.notify_one();
+
+            m_thread->join();
+            delete m_thread;
+            m_thread = 0;
+        }
+    }
+
+    void work()
+    {
+        for (;;) {
+            Message* msg;
+
+            {
+                boost::mutex::scoped_lock lock(m_mutex);
+                while (m_count == 0 and not m_stop) {
+                    m_notEmpty.wait(lock);
+                }
+
+                if (m_count == 0) {
+                    return;
+                }
+
+                msg = &m_messages[m_head];
+            }
+
+            if (msg->type == Message::CLOSE) {
+                return;
+            }
+
+            try {
+                process(*msg);
+            } catch (const std::exception& e) {
+                {
+                    boost::mutex::scoped_lock lock(m_mutex);
+                    m_failed = true;
+                    m_error = e.what();
+                }
+                m_notFull.notify_one();
+                return;
+            }
+
+            {
+                boost::mutex::scoped_lock lock(m_mutex);
+                m_head = (m_head + 1) % m_messages.size();
+                --m_count;
+            }
+            m_notFull.notify_one();
+        }
+    }
+
+    void process(Message& msg)
+    {
+        switch (msg.type) {
+        case Message::NEW_OBSERVABLE:
+            m_row.addColumn(msg.column);
+            m_stream.plugin()->onNewObservable(msg.column.simulator,
+                                               msg.column.parent,
+                                               msg.column.port,
+                                               m_row.view(), msg.time);
+            break;
+        case Message::DEL_OBSERVABLE:
+            {
+                const oov::Column& column = m_row.column(msg.id);
+                m_stream.plugin()->onDelObservable(column.simulator,
+                                                   column.parent,
+                                                   column.port,
+                                                   m_row.view(), msg.time);
+                m_row.delColumn(msg.id);
+            }
+            break;
+        case Message::ROW:
+            m_row.swap(msg.lanes);
+            m_stream.write(m_row);
+            m_row.reset(m_row.time());
+            break;
+        case Message::CLOSE:
+            break;
+        }
+    }
+
+    StreamWriter&                   m_stream;
+    oov::Row                        m_row;
+    std::vector < Message >         m_messages;
+    std::size_t                     m_head;
+    std::size_t                     m_count;
+    std::size_t                     m_depth;
+    double                          m_stall;
+    bool                            m_stop;
+    bool                            m_failed;
+    std::string                     m_error;
+    boost::mutex                    m_mutex;
+    boost::condition_variable       m_notEmpty;
+    boost::condition_variable       m_notFull;
+    boost::thread*                  m_thread;
+};
+
+StreamWriter::~StreamWriter()
+{
+    delete m_queue;
+}
+
 oov::PluginPtr StreamWriter::plugin()
 {
     if (not m_plugin) {
@@ -82,24 +343,58 @@ void StreamWriter::open(const std::string& pluginname,
     plugin()->onParameter(pluginname, location, file, parameters, time);
 }
 
+void StreamWriter::open(oov::PluginPtr plugin,
+                        const std::string& location,
+                        const std::string& file,
+                        value::Value* parameters,
+                        const devs::Time& time)
+{
+    if (not plugin) {
+        throw utils::InternalError(_("Oov: Can not open a null plug-in"));
+    }
+
+    m_plugin = plugin;
+    m_plugin->onParameter(m_plugin->name(), location, file, parameters,
+                          time);
+}
+
+void StreamWriter::async(const std::string& view, unsigned int buffer)
+{
+    if (buffer > 0 and not m_queue) {
+        plugin();
+        m_queue = new Queue(*this, view, buffer);
+    }
+}
+
 void StreamWriter::processNewObservable(Simulator* simulator,
                                         const std::string& portname,
                                         const devs::Time& time,
                                         const std::string& view)
 {
-    plugin()->onNewObservable(simulator->getName(),
-                              simulator->getParent(),
-                              portname, view, time);
+    if (m_queue) {
+        m_queue->pushNewObservable(
+            oov::Column(simulator->getName(), simulator->getParent(),
+                        portname), time);
+    } else {
+        plugin()->onNewObservable(simulator->getName(),
+                                  simulator->getParent(),
+                                  portname, view, time);
+    }
 }
 
 void StreamWriter::processRemoveObservable(Simulator* simulator,
                                            const std::string& portname,
                                            const devs::Time& time,
-                                           const std::string& view)
+                                           const std::string& view,
+                                           oov::Row::size_type column)
 {
-    plugin()->onDelObservable(simulator->getName(),
-                              simulator->getParent(),
-                              portname, view, time);
+    if (m_queue) {
+        m_queue->pushRemoveObservable(column, time);
+    } else {
+        plugin()->onDelObservable(simulator->getName(),
+                                  simulator->getParent(),
+                                  portname, view, time);
+    }
 }
 
 void StreamWriter::process(Simulator* simulator,
@@ -143,11 +438,69 @@ void StreamWriter::process(Simulator* simulator,
 #endif
 }
 
+void StreamWriter::process(oov::Row& row)
+{
+    if (m_queue) {
+        m_queue->pushRow(row);
+    } else {
+        write(row);
+    }
+}
+
+void StreamWriter::write(oov::Row& row)
+{
+#ifdef VLE_HAVE_CAIRO
+    if (plugin()->isCairo()) {
+        oov::CairoPluginPtr plg = oov::toCairoPlugin(plugin());
+        plg->needCopy();
+        plg->onRow(row);
+
+        if (plg->isCopyDone()) {
+            std::string file(
+                utils::Path::buildFilename(
+                    plg->location(), (fmt("img-%1$08d.png") %
+                                      plg->getNextFrameNumber()).str()));
+
+            try {
+                plg->stored()->write_to_png(file);
+            } catch(const std::exception& /*e*/) {
+                throw utils::InternalError(
+                    fmt(_("oov: cannot write image '%1%'")) % file);
+            }
+        }
+    } else {
+#endif
+        plugin()->onRow(row);
+
+#ifdef VLE_HAVE_CAIRO
+    }
+#endif
+}
+
 void StreamWriter::close(const devs::Time& time)
 {
+    if (m_queue) {
+        m_queue->flush();
+    }
+
     plugin()->close(time);
 }
 
+std::size_t StreamWriter::queueSize() const
+{
+    return m_queue ? m_queue->size() : 0;
+}
+
+std::size_t StreamWriter::queueDepth() const
+{
+    return m_queue ? m_queue->depth() : 0;
+}
+
+double StreamWriter::stallTime() const
+{
+    return m_queue ? m_queue->stall() : 0.0;
+}
+
 value::Matrix * StreamWriter::matrix() const
 {
     if (m_plugin) {
@@ -157,4 +510,13 @@ value::Matrix * StreamWriter::matrix() const
     return NULL;
 }
 
+value::ResultMatrix * StreamWriter::results() const
+{
+    if (m_plugin) {
+        return m_plugin->results();
+    }
+
+    return NULL;
+}
+
 }} // namespace vle devs
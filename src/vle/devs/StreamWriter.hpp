@@ -51,13 +51,15 @@ class VLE_API StreamWriter
 {
 public:
     StreamWriter(const utils::ModuleManager& modulemgr)
-        : m_view(0), m_modulemgr(modulemgr)
+        : m_view(0), m_modulemgr(modulemgr), m_queue(0)
     {
     }
 
-    ~StreamWriter()
-    {
-    }
+    /**
+     * @brief Stop the thread of the plug-in, if any. The queued
+     * observations are lost if the \c close function was not called.
+     */
+    ~StreamWriter();
 
     ///
     ////
@@ -79,15 +81,49 @@ public:
               value::Value* parameters,
               const devs::Time& time);
 
+    /**
+     * @brief Initialise a plug-in built by the application, for example
+     * a plug-in compiled into a benchmark, instead of a plug-in of a
+     * package.
+     * @param plugin the plug-in.
+     * @param location where the plugin write data.
+     * @param file name of the file.
+     * @param parameters the value attached to the plug-in.
+     * @param time the date when the plug-in was opened.
+     * @throw utils::InternalError if the plug-in is null.
+     */
+    void open(oov::PluginPtr plugin,
+              const std::string& location,
+              const std::string& file,
+              value::Value* parameters,
+              const devs::Time& time);
+
+    /**
+     * @brief Run the plug-in on its own thread. The observations are
+     * queued by the simulation thread and written by the plug-in's
+     * thread; the simulation waits only when the queue is full. This
+     * function must be called after \c open and before the first
+     * observable.
+     * @param view the name of the view.
+     * @param buffer the number of observations of the queue.
+     */
+    void async(const std::string& view, unsigned int buffer);
+
     void processNewObservable(Simulator* simulator,
                               const std::string& portname,
                               const devs::Time& time,
                               const std::string& view);
 
+    /**
+     * @brief Process the removal of an observable from the View.
+     * @param column the column of the observable in the oov::Row of the
+     * View, released after this call.
+     */
     void processRemoveObservable(Simulator* simulator,
                                  const std::string& portname,
                                  const devs::Time& time,
-                                 const std::string& view);
+                                 const std::string& view,
+                                 oov::Row::size_type column);
 
     /**
      * @brief Process the devs::ObservationEvent and write it to the Stream.
@@ -100,11 +136,40 @@ public:
                  value::Value* value);
 
     /**
-     * Close the output stream.
+     * @brief Write all the values observed by a View at a date to the
+     * Stream in one call to the oov::Plugin.
+     * @param row the values of the observables.
+     */
+    void process(oov::Row& row);
+
+    /**
+     * Close the output stream. If the plug-in runs on its own thread,
+     * the queued observations are written before the plug-in is closed.
      * @return A reference to the oov::Plugin if the plugin is serializable.
      */
     void close(const devs::Time& time);
 
+    /**
+     * @brief Get the size of the queue of observations.
+     * @return the size of the queue, 0 if the plug-in runs on the
+     * simulation thread.
+     */
+    std::size_t queueSize() const;
+
+    /**
+     * @brief Get the greatest number of observations waiting in the
+     * queue during the simulation.
+     * @return a number of observations.
+     */
+    std::size_t queueDepth() const;
+
+    /**
+     * @brief Get the time spent by the simulation thread waiting for a
+     * free place in the queue.
+     * @return a duration in seconds.
+     */
+    double stallTime() const;
+
     /**
      * Return a pointer to the \c value::Matrix.
      *
@@ -117,6 +182,15 @@ public:
      */
     value::Matrix * matrix() const;
 
+    /**
+     * Return a pointer to the \c value::ResultMatrix of the plug-in or
+     * NULL if the plug-in does not manage typed results.
+     *
+     * @attention You are in charge of freeing the value::ResultMatrix
+     * after the end of the simulation.
+     */
+    value::ResultMatrix * results() const;
+
     ///
     ////
     ///
@@ -144,9 +218,18 @@ private:
     StreamWriter(const StreamWriter& other);
     StreamWriter& operator=(const StreamWriter& other);
 
+    class Queue;
+
+    /**
+     * @brief Send the row to the plug-in. Called by the simulation
+     * thread or by the thread of the Queue.
+     */
+    void write(oov::Row& row);
+
     devs::View*                 m_view;
     const utils::ModuleManager& m_modulemgr;
     oov::PluginPtr              m_plugin;
+    Queue*                      m_queue;
 };
 
 }} // namespace vle devs
@@ -27,11 +27,17 @@
 
 #include <vle/devs/View.hpp>
 #include <vle/devs/Simulator.hpp>
+#include <vle/devs/ObservationEvent.hpp>
 
 namespace vle { namespace devs {
 
 View::~View()
 {
+    for (std::vector < Column >::iterator it = m_columns.begin();
+         it != m_columns.end(); ++it) {
+        delete it->event;
+    }
+
     delete m_stream;
 }
 
@@ -42,7 +48,24 @@ void View::addObservable(Simulator* model,
     assert(model);
 
     if (not exist(model, portname)) {
+        if (not exist(model)) {
+            model->attachView(this);
+        }
+
         m_observableList.insert(value_type(model, portname));
+
+        oov::Row::size_type id = m_row.addColumn(
+            oov::Column(model->getName(), model->getParent(), portname));
+
+        if (id >= m_columns.size()) {
+            m_columns.resize(id + 1);
+        }
+
+        m_columns[id].simulator = model;
+        m_columns[id].event = new ObservationEvent(currenttime, model,
+                                                   getName(), portname);
+        m_columnList.insert(ColumnList::value_type(model, id));
+
         m_stream->processNewObservable(model, portname, currenttime,
                                        getName());
     }
@@ -57,16 +80,30 @@ void View::removeObservable(Simulator* sim)
 {
     assert(sim);
 
-    std::pair < ObservableList::iterator, ObservableList::iterator > result;
-    ObservableList::iterator it;
+    std::pair < ColumnList::iterator, ColumnList::iterator > result;
+    result = m_columnList.equal_range(sim);
 
-    result = m_observableList.equal_range(sim);
-    for (it = result.first; it != result.second; ++it) {
-        m_stream->processRemoveObservable(it->first, it->second, 0.0,
-                                          getName());
+    if (result.first == result.second) {
+        return;
     }
 
-    m_observableList.erase(result.first, result.second);
+    sim->detachView(this);
+
+    for (ColumnList::iterator it = result.first; it != result.second;
+         ++it) {
+        Column& column = m_columns[it->second];
+
+        m_stream->processRemoveObservable(sim, m_row.column(it->second).port,
+                                          0.0, getName(), it->second);
+
+        delete column.event;
+        column.event = 0;
+        column.simulator = 0;
+        m_row.delColumn(it->second);
+    }
+
+    m_columnList.erase(result.first, result.second);
+    m_observableList.erase(sim);
 }
 
 bool View::exist(Simulator* simulator, const std::string& portname) const
@@ -91,16 +128,18 @@ bool View::exist(Simulator* simulator) const
 
 void View::run(const Time& time)
 {
-    if (not m_observableList.empty()) {
-        for (ObservableList::iterator it = m_observableList.begin();
-             it != m_observableList.end(); ++it) {
-            ObservationEvent event(time, it->first, getName(), it->second);
-            value::Value* val = it->first->observation(event);
-            m_stream->process(it->first, it->second, time, getName(), val);
+    m_row.reset(time);
+
+    for (oov::Row::size_type i = 0, e = m_columns.size(); i != e; ++i) {
+        Column& column = m_columns[i];
+
+        if (column.simulator) {
+            column.event->setTime(time);
+            m_row.put(i, column.simulator->observation(*column.event));
         }
-    } else {
-        m_stream->process(0, std::string(), time, getName(), 0);
     }
+
+    m_stream->process(m_row);
 }
 
 value::Matrix * View::matrix() const
@@ -112,4 +151,9 @@ value::Matrix * View::matrix() const
     return NULL;
 }
 
+value::ResultMatrix * View::results() const
+{
+    return m_stream->results();
+}
+
 }} // namespace vle devs
@@ -31,14 +31,17 @@
 #include <vle/DllDefines.hpp>
 #include <vle/devs/StreamWriter.hpp>
 #include <vle/devs/Time.hpp>
+#include <vle/oov/Row.hpp>
 #include <vle/value/Matrix.hpp>
 #include <string>
+#include <vector>
 #include <map>
 
 namespace vle { namespace devs {
 
 class Simulator;
 class StreamWriter;
+class ObservationEvent;
 class View;
 
 typedef std::multimap < Simulator*, std::string > ObservableList;
@@ -47,6 +50,9 @@ typedef std::map < std::string, View* > ViewList;
 /**
  * @brief Represent a View on a devs::Simulator and a port name.
  *
+ * Each observable (a devs::Simulator and a port name) owns a column of
+ * an oov::Row. The View fills the whole row at each observation and
+ * sends it to the StreamWriter in one call.
  */
 class VLE_API View
 {
@@ -57,7 +63,7 @@ public:
     typedef ObservableList::value_type value_type;
 
     View(const std::string& name, StreamWriter* stream)
-        : m_name(name), m_stream(stream), m_size(0)
+        : m_name(name), m_stream(stream), m_size(0), m_row(name)
     {}
 
     virtual ~View();
@@ -134,11 +140,41 @@ public:
      */
     value::Matrix * matrix() const;
 
+    /**
+     * Return a pointer to the \c value::ResultMatrix of the plug-in.
+     *
+     * @attention You are in charge of freeing the value::ResultMatrix
+     * after the end of the simulation.
+     */
+    value::ResultMatrix * results() const;
+
 protected:
     ObservableList      m_observableList;
     std::string         m_name;
     StreamWriter*       m_stream;
     size_t              m_size;
+
+private:
+    typedef std::multimap < Simulator*, oov::Row::size_type > ColumnList;
+
+    /**
+     * @brief The observation of a column: the observed devs::Simulator
+     * and the devs::ObservationEvent reused at each observation. Both are
+     * null for the released columns.
+     */
+    struct Column
+    {
+        Column()
+            : simulator(0), event(0)
+        {}
+
+        Simulator*        simulator;
+        ObservationEvent* event;
+    };
+
+    oov::Row               m_row;
+    ColumnList             m_columnList;
+    std::vector < Column > m_columns;
 };
 
 /**
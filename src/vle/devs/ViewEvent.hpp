@@ -30,6 +30,7 @@
 
 #include <vle/DllDefines.hpp>
 #include <vle/devs/View.hpp>
+#include <vle/devs/EventPool.hpp>
 #include <vector>
 
 namespace vle { namespace devs {
@@ -63,6 +64,18 @@ public:
         : mView(view), mTime(time)
     {}
 
+    /**
+     * @brief Allocate the ViewEvent from the current devs::EventPool.
+     */
+    static void* operator new(std::size_t size)
+    { return EventPool::allocateView(size); }
+
+    /**
+     * @brief Release the ViewEvent into its devs::EventPool.
+     */
+    static void operator delete(void* ptr)
+    { EventPool::deallocate(ptr); }
+
     //
     //
 
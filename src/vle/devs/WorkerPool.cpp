@@ -0,0 +1,276 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#include <vle/devs/WorkerPool.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/i18n.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+#include <algorithm>
+#include <exception>
+#include <new>
+#include <stdexcept>
+
+namespace vle { namespace devs {
+
+WorkerPool::WorkerPool(std::size_t threads)
+    : m_task(0), m_size(0), m_next(0), m_chunk(1), m_running(0),
+    m_generation(0), m_stop(false), m_error(0), m_errorType(UNKNOWN_ERROR)
+{
+    for (std::size_t i = 1; i < threads; ++i) {
+        m_pools.push_back(new EventPool());
+    }
+
+    try {
+        for (std::size_t i = 0; i < m_pools.size(); ++i) {
+            m_threads.push_back(new boost::thread(
+                    boost::bind(&WorkerPool::work, this, i)));
+        }
+    } catch (...) {
+        stop();
+        throw;
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    stop();
+}
+
+void WorkerPool::stop()
+{
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+        m_stop = true;
+    }
+    m_start.notify_all();
+
+    for (std::size_t i = 0; i < m_threads.size(); ++i) {
+        m_threads[i]->join();
+        delete m_threads[i];
+    }
+    m_threads.clear();
+
+    for (std::size_t i = 0; i < m_pools.size(); ++i) {
+        delete m_pools[i];
+    }
+    m_pools.clear();
+}
+
+void WorkerPool::run(Task& task, std::size_t size)
+{
+    if (size == 0) {
+        return;
+    }
+
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+        m_task = &task;
+        m_size = size;
+        m_next = 0;
+        m_chunk = std::max(std::size_t(1), size / (4 * this->size()));
+        m_running = m_threads.size();
+        m_error = size;
+        m_message.clear();
+        ++m_generation;
+    }
+    m_start.notify_all();
+
+    execute();
+
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+        while (m_running > 0) {
+            m_done.wait(lock);
+        }
+        m_task = 0;
+    }
+
+    if (m_error != size) {
+        rethrow();
+    }
+}
+
+WorkerPool::ErrorType WorkerPool::errorType(const std::exception& e)
+{
+    if (dynamic_cast < const utils::BaseError* >(&e)) {
+        if (dynamic_cast < const utils::ModellingError* >(&e)) {
+            return MODELLING_ERROR;
+        } else if (dynamic_cast < const utils::ArgError* >(&e)) {
+            return ARG_ERROR;
+        } else if (dynamic_cast < const utils::FileError* >(&e)) {
+            return FILE_ERROR;
+        } else if (dynamic_cast < const utils::InternalError* >(&e)) {
+            return INTERNAL_ERROR;
+        } else if (dynamic_cast < const utils::CastError* >(&e)) {
+            return CAST_ERROR;
+        } else if (dynamic_cast < const utils::ParseError* >(&e)) {
+            return PARSE_ERROR;
+        } else if (dynamic_cast < const utils::NotYetImplemented* >(&e)) {
+            return NOT_YET_IMPLEMENTED;
+        } else if (dynamic_cast < const utils::DevsGraphError* >(&e)) {
+            return DEVS_GRAPH_ERROR;
+        } else if (dynamic_cast < const utils::VpzError* >(&e)) {
+            return VPZ_ERROR;
+        } else if (dynamic_cast < const utils::SaxParserError* >(&e)) {
+            return SAX_PARSER_ERROR;
+        }
+        return BASE_ERROR;
+    } else if (dynamic_cast < const std::bad_alloc* >(&e)) {
+        return BAD_ALLOC;
+    }
+
+    return STD_ERROR;
+}
+
+void WorkerPool::rethrow() const
+{
+    switch (m_errorType) {
+    case BASE_ERROR:
+        throw utils::BaseError(m_message);
+    case FILE_ERROR:
+        throw utils::FileError(m_message);
+    case PARSE_ERROR:
+        throw utils::ParseError(m_message);
+    case ARG_ERROR:
+        throw utils::ArgError(m_message);
+    case CAST_ERROR:
+        throw utils::CastError(m_message);
+    case INTERNAL_ERROR:
+        throw utils::InternalError(m_message);
+    case MODELLING_ERROR:
+        throw utils::ModellingError(m_message);
+    case NOT_YET_IMPLEMENTED:
+        throw utils::NotYetImplemented(m_message);
+    case DEVS_GRAPH_ERROR:
+        throw utils::DevsGraphError(m_message);
+    case VPZ_ERROR:
+        throw utils::VpzError(m_message);
+    case SAX_PARSER_ERROR:
+        throw utils::SaxParserError(m_message);
+    case BAD_ALLOC:
+        throw std::bad_alloc();
+    case STD_ERROR:
+        throw std::runtime_error(m_message);
+    default:
+        throw utils::InternalError(m_message);
+    }
+}
+
+std::size_t WorkerPool::allocations() const
+{
+    std::size_t result = 0;
+
+    for (std::size_t i = 0; i < m_pools.size(); ++i) {
+        result += m_pools[i]->allocations();
+    }
+
+    return result;
+}
+
+std::size_t WorkerPool::requests() const
+{
+    std::size_t result = 0;
+
+    for (std::size_t i = 0; i < m_pools.size(); ++i) {
+        result += m_pools[i]->requests();
+    }
+
+    return result;
+}
+
+void WorkerPool::work(std::size_t id)
+{
+    EventPool::Scope scope(*m_pools[id]);
+    unsigned long generation = 0;
+
+    for (;;) {
+        {
+            boost::mutex::scoped_lock lock(m_mutex);
+            while (not m_stop and m_generation == generation) {
+                m_start.wait(lock);
+            }
+
+            if (m_stop) {
+                return;
+            }
+
+            generation = m_generation;
+        }
+
+        execute();
+
+        {
+            boost::mutex::scoped_lock lock(m_mutex);
+            if (--m_running == 0) {
+                m_done.notify_one();
+            }
+        }
+    }
+}
+
+void WorkerPool::execute()
+{
+    for (;;) {
+        std::size_t begin, end;
+
+        {
+            boost::mutex::scoped_lock lock(m_mutex);
+            if (m_next >= m_size) {
+                return;
+            }
+
+            begin = m_next;
+            end = std::min(m_size, begin + m_chunk);
+            m_next = end;
+        }
+
+        for (std::size_t i = begin; i < end; ++i) {
+            try {
+                (*m_task)(i);
+            } catch (const std::exception& e) {
+                boost::mutex::scoped_lock lock(m_mutex);
+                if (i < m_error) {
+                    m_error = i;
+                    m_errorType = errorType(e);
+                    m_message.assign(e.what());
+                }
+            } catch (...) {
+                boost::mutex::scoped_lock lock(m_mutex);
+                if (i < m_error) {
+                    m_error = i;
+                    m_errorType = UNKNOWN_ERROR;
+                    m_message.assign(_("Unknown error in a worker thread"));
+                }
+            }
+        }
+    }
+}
+
+}} // namespace vle devs
@@ -0,0 +1,218 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#ifndef VLE_DEVS_WORKERPOOL_HPP
+#define VLE_DEVS_WORKERPOOL_HPP 1
+
+#include <vle/DllDefines.hpp>
+#include <vle/devs/EventPool.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <cstddef>
+#include <exception>
+#include <string>
+#include <vector>
+
+namespace boost { class thread; }
+
+namespace vle { namespace devs {
+
+/**
+ * @brief WorkerPool executes the tasks of a devs::Coordinator on a set of
+ * threads. The threads are started by the constructor and wait for the
+ * next WorkerPool::run() call; the calling thread takes part in the
+ * execution.
+ *
+ * Each worker thread owns an EventPool: the events built by a task come
+ * from the EventPool of its thread. These events can be deleted by the
+ * calling thread between two WorkerPool::run() calls, so the WorkerPool
+ * must outlive the events built by the tasks.
+ *
+ * @code
+ * class Square : public WorkerPool::Task
+ * {
+ * public:
+ *     Square(std::vector < double >& v) : v(v) {}
+ *     virtual void operator()(std::size_t i) { v[i] *= v[i]; }
+ *     std::vector < double >& v;
+ * };
+ *
+ * WorkerPool pool(4);
+ * Square task(values);
+ * pool.run(task, values.size());
+ * @endcode
+ */
+class VLE_API WorkerPool
+{
+public:
+    /**
+     * @brief The interface of the tasks executed by the WorkerPool.
+     */
+    class VLE_API Task
+    {
+    public:
+        virtual ~Task() {}
+
+        /**
+         * @brief Execute the task for the specified index. This function
+         * is called concurrently for different indices.
+         * @param index The index of the work in [0..size[.
+         */
+        virtual void operator()(std::size_t index) = 0;
+    };
+
+    /**
+     * @brief Build a WorkerPool and start its threads.
+     * @param threads The number of threads including the calling thread.
+     * With 0 or 1, no thread is started and the tasks are executed by the
+     * calling thread.
+     */
+    WorkerPool(std::size_t threads);
+
+    /**
+     * @brief Stop and join the threads.
+     */
+    ~WorkerPool();
+
+    /**
+     * @brief Execute the task for all the indices [0..size[ and wait the
+     * end of the execution. The indices are distributed by small ranges
+     * to the threads.
+     * @param task The task to execute.
+     * @param size The number of indices.
+     * @throw The exception of the task if it fails: the exceptions of
+     * the utils namespace keep their type and message, the other
+     * std::exception are reported as std::runtime_error and the unknown
+     * ones as utils::InternalError. If several indices fail, the error of
+     * the lowest index is reported.
+     */
+    void run(Task& task, std::size_t size);
+
+    /**
+     * @brief Get the number of threads including the calling thread.
+     * @return A number of threads greater than 0.
+     */
+    std::size_t size() const
+    { return m_threads.size() + 1; }
+
+    /**
+     * @brief Get the number of allocations requested to the system by the
+     * EventPool of the worker threads.
+     * @return A number of allocations.
+     */
+    std::size_t allocations() const;
+
+    /**
+     * @brief Get the number of events built by the worker threads.
+     * @return A number of events.
+     */
+    std::size_t requests() const;
+
+private:
+    WorkerPool(const WorkerPool&);
+    WorkerPool& operator=(const WorkerPool&);
+
+    /**
+     * @brief The type of the exception of a task, rethrown by run() in
+     * the calling thread.
+     */
+    enum ErrorType {
+        BASE_ERROR,
+        FILE_ERROR,
+        PARSE_ERROR,
+        ARG_ERROR,
+        CAST_ERROR,
+        INTERNAL_ERROR,
+        MODELLING_ERROR,
+        NOT_YET_IMPLEMENTED,
+        DEVS_GRAPH_ERROR,
+        VPZ_ERROR,
+        SAX_PARSER_ERROR,
+        BAD_ALLOC,
+        STD_ERROR,
+        UNKNOWN_ERROR
+    };
+
+    /**
+     * @brief Get the type of an exception thrown by a task.
+     * @param e The exception.
+     * @return The ErrorType of the most derived known class of the
+     * exception.
+     */
+    static ErrorType errorType(const std::exception& e);
+
+    /**
+     * @brief Throw the exception of the failed task.
+     */
+    void rethrow() const;
+
+    /**
+     * @brief Stop and join the threads, then delete their EventPool.
+     */
+    void stop();
+
+    /**
+     * @brief The main loop of the worker threads.
+     * @param id The index of the thread into m_pools.
+     */
+    void work(std::size_t id);
+
+    /**
+     * @brief Take ranges of indices and execute the task on them until
+     * all the indices are taken.
+     */
+    void execute();
+
+    std::vector < boost::thread* >  m_threads;
+    std::vector < EventPool* >      m_pools;
+    boost::mutex                    m_mutex;
+    boost::condition_variable       m_start; /**< Wakes the workers. */
+    boost::condition_variable       m_done; /**< Wakes the caller. */
+    Task                           *m_task;
+    std::size_t                     m_size;
+    std::size_t                     m_next; /**< The next index to
+                                              execute. */
+    std::size_t                     m_chunk; /**< The size of the
+                                               ranges. */
+    std::size_t                     m_running; /**< The number of workers
+                                                 still executing. */
+    unsigned long                   m_generation; /**< Incremented by each
+                                                    run() call. */
+    bool                            m_stop;
+    std::size_t                     m_error; /**< The lowest index which
+                                               fails or m_size. */
+    ErrorType                       m_errorType; /**< The type of the
+                                                   exception of
+                                                   m_error. */
+    std::string                     m_message;
+};
+
+}} // namespace vle devs
+
+#endif
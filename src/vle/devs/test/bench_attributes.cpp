@@ -0,0 +1,134 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Allocation benchmark of a typical event exchange: a model sends an
+ * event with a real, an integer and a short string to three targets which
+ * read the attributes. The `legacy' exchange builds the attributes with
+ * the value::Value classes, the `scalar' exchange with the value::Scalar
+ * attributes. The events are allocated from a devs::EventPool, so the
+ * operator new calls counted are those of the attributes.
+ *
+ * Usage: bench_attributes [events]
+ */
+
+#include <vle/devs/ExternalEvent.hpp>
+#include <vle/devs/EventPool.hpp>
+#include <vle/devs/PortName.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/timer.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+using namespace vle;
+
+static std::size_t allocations = 0;
+
+void* operator new(std::size_t size) throw (std::bad_alloc)
+{
+    ++allocations;
+
+    void* ptr = std::malloc(size ? size : 1);
+    if (not ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void* ptr) throw ()
+{
+    std::free(ptr);
+}
+
+enum Mode { LEGACY, SCALAR };
+
+double exchange(Mode mode, std::size_t events)
+{
+    devs::PortName in1("in1"), in2("in2"), in3("in3");
+    double sum = 0.0;
+
+    for (std::size_t i = 0; i < events; ++i) {
+        devs::ExternalEvent* source = new devs::ExternalEvent("out");
+
+        if (mode == LEGACY) {
+            source->putAttribute("x", value::Double::create(i * 0.5));
+            source->putAttribute("id", value::Integer::create(i));
+            source->putAttribute("msg", value::String::create("move"));
+        } else {
+            source << devs::attribute("x", i * 0.5)
+                   << devs::attribute("id", static_cast < int >(i))
+                   << devs::attribute("msg", "move");
+        }
+
+        devs::ExternalEvent* targets[3] = {
+            new devs::ExternalEvent(*source, 0, in1),
+            new devs::ExternalEvent(*source, 0, in2),
+            new devs::ExternalEvent(*source, 0, in3) };
+        delete source;
+
+        for (int j = 0; j < 3; ++j) {
+            sum += targets[j]->getDoubleAttributeValue("x");
+            sum += targets[j]->getIntegerAttributeValue("id");
+            sum += targets[j]->getStringAttributeValue("msg").size();
+            delete targets[j];
+        }
+    }
+
+    return sum;
+}
+
+void run(Mode mode, std::size_t events)
+{
+    devs::EventPool pool;
+    devs::EventPool::Scope scope(pool);
+
+    exchange(mode, 16);
+
+    std::size_t before = allocations;
+    boost::timer timer;
+    double sum = exchange(mode, events);
+    double elapsed = timer.elapsed();
+
+    std::cout << (mode == LEGACY ? "legacy" : "scalar")
+              << ": " << static_cast < double >(allocations - before) / events
+              << " allocations per event, " << elapsed << " s"
+              << " (checksum " << sum << ")\n";
+}
+
+int main(int argc, char* argv[])
+{
+    std::size_t events = 1000000;
+
+    if (argc > 1) {
+        events = boost::lexical_cast < std::size_t >(argv[1]);
+    }
+
+    run(LEGACY, events);
+    run(SCALAR, events);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,683 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Throughput benchmarks of the DEVS kernel: the Coordinator, the
+ * EventTable and the routing of the events. The models are built with the
+ * vpz API and simulated by the dynamics of this file, without package:
+ *
+ * - li, hi, ho: the DEVStone models. A hierarchy of depth coupled models,
+ *   each one with width - 1 atomic models and the next coupled model. The
+ *   input of a coupled model is sent to all its children (li); the atomic
+ *   models are also chained (hi) and their outputs are also sent to the
+ *   output of their coupled model (ho). A generator sends an event into
+ *   the hierarchy at each time unit.
+ * - broadcast: a generator sends an event to width * depth receivers at
+ *   each time unit.
+ * - deep: an event goes down width * depth coupled models, from a relay to
+ *   the relay of the next coupled model, and goes up to the sink.
+ * - executive: an Executive moves the connections of width generators to
+ *   the next of depth receivers at each time unit, in a transaction.
+ * - observation: width * depth cells observed by a timed view at each
+ *   time unit.
+ *
+ * The results are written as tab separated values, a header and one line
+ * per benchmark. The events are the external events received by the
+ * models. The pool allocations and pool requests are the counters of the
+ * devs::EventPool: the chunks and large blocks requested to the system
+ * and the blocks requested to the pools, not the other heap allocations
+ * of the kernel. The peak RSS is the maximum resident set size of the process in
+ * kilobytes (run one benchmark per process to measure it).
+ *
+ * Usage: vle_bench [benchmark|all [width [depth [duration]]]]
+ */
+
+#include <vle/devs/Coordinator.hpp>
+#include <vle/devs/RootCoordinator.hpp>
+#include <vle/devs/Dynamics.hpp>
+#include <vle/devs/Executive.hpp>
+#include <vle/devs/StreamWriter.hpp>
+#include <vle/devs/View.hpp>
+#include <vle/devs/ViewEvent.hpp>
+#include <vle/oov/Plugin.hpp>
+#include <vle/vpz/CoupledModel.hpp>
+#include <vle/vpz/AtomicModel.hpp>
+#include <vle/vpz/Dynamics.hpp>
+#include <vle/vpz/Experiment.hpp>
+#include <vle/vpz/Classes.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/utils/ModuleManager.hpp>
+#include <vle/utils/PackageTable.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/lexical_cast.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+# include <sys/resource.h>
+#endif
+
+using namespace vle;
+
+struct Parameters
+{
+    int        width;
+    int        depth;
+    devs::Time duration;
+};
+
+/*
+ * The counters shared by all the dynamics of a benchmark.
+ */
+struct Counters
+{
+    Counters()
+        : transitions(0), events(0), observations(0)
+    {}
+
+    uint64_t transitions;
+    uint64_t events;
+    uint64_t observations;
+};
+
+/*
+ * Sends an event on its output port at each time unit.
+ */
+class Generator : public devs::Dynamics
+{
+public:
+    Generator(const devs::DynamicsInit& init,
+              const devs::InitEventList& events, Counters& counters)
+        : devs::Dynamics(init, events), m_counters(counters)
+    {}
+
+    virtual devs::Time init(const devs::Time& /* time */)
+    { return 1.0; }
+
+    virtual void output(const devs::Time& /* time */,
+                        devs::ExternalEventList& output) const
+    { output.push_back(new devs::ExternalEvent("out")); }
+
+    virtual devs::Time timeAdvance() const
+    { return 1.0; }
+
+    virtual void internalTransition(const devs::Time& /* time */)
+    { ++m_counters.transitions; }
+
+private:
+    Counters& m_counters;
+};
+
+/*
+ * The atomic model of DEVStone: sends an event on its output port
+ * immediately after each external transition.
+ */
+class Stone : public devs::Dynamics
+{
+public:
+    Stone(const devs::DynamicsInit& init, const devs::InitEventList& events,
+          Counters& counters)
+        : devs::Dynamics(init, events), m_counters(counters),
+        m_active(false)
+    {}
+
+    virtual devs::Time init(const devs::Time& /* time */)
+    { return devs::infinity; }
+
+    virtual void output(const devs::Time& /* time */,
+                        devs::ExternalEventList& output) const
+    { output.push_back(new devs::ExternalEvent("out")); }
+
+    virtual devs::Time timeAdvance() const
+    { return m_active ? 0.0 : devs::infinity; }
+
+    virtual void internalTransition(const devs::Time& /* time */)
+    {
+        ++m_counters.transitions;
+        m_active = false;
+    }
+
+    virtual void externalTransition(const devs::ExternalEventList& events,
+                                    const devs::Time& /* time */)
+    {
+        ++m_counters.transitions;
+        m_counters.events += events.size();
+        m_active = true;
+    }
+
+private:
+    Counters& m_counters;
+    bool      m_active;
+};
+
+/*
+ * Receives the events.
+ */
+class Sink : public devs::Dynamics
+{
+public:
+    Sink(const devs::DynamicsInit& init, const devs::InitEventList& events,
+         Counters& counters)
+        : devs::Dynamics(init, events), m_counters(counters)
+    {}
+
+    virtual void externalTransition(const devs::ExternalEventList& events,
+                                    const devs::Time& /* time */)
+    {
+        ++m_counters.transitions;
+        m_counters.events += events.size();
+    }
+
+private:
+    Counters& m_counters;
+};
+
+/*
+ * Changes its state at each time unit, observed on the port "value".
+ */
+class Cell : public devs::Dynamics
+{
+public:
+    Cell(const devs::DynamicsInit& init, const devs::InitEventList& events,
+         Counters& counters)
+        : devs::Dynamics(init, events), m_counters(counters), m_value(0.0)
+    {}
+
+    virtual devs::Time init(const devs::Time& /* time */)
+    { return 1.0; }
+
+    virtual devs::Time timeAdvance() const
+    { return 1.0; }
+
+    virtual void internalTransition(const devs::Time& time)
+    {
+        ++m_counters.transitions;
+        m_value = m_value * 0.5 + time;
+    }
+
+    virtual value::Value* observation(
+        const devs::ObservationEvent& /* event */) const
+    { return value::Double::create(m_value); }
+
+private:
+    Counters& m_counters;
+    double    m_value;
+};
+
+/*
+ * Moves the connection of each generator to the next receiver at each
+ * time unit.
+ */
+class Rewirer : public devs::Executive
+{
+public:
+    Rewirer(const devs::ExecutiveInit& init,
+            const devs::InitEventList& events, Counters& counters,
+            int generators, int receivers)
+        : devs::Executive(init, events), m_counters(counters),
+        m_positions(generators, 0), m_receivers(receivers)
+    {}
+
+    virtual devs::Time init(const devs::Time& /* time */)
+    { return 0.5; }
+
+    virtual devs::Time timeAdvance() const
+    { return 1.0; }
+
+    virtual void internalTransition(const devs::Time& /* time */)
+    {
+        ++m_counters.transitions;
+
+        Transaction transaction(*this);
+        for (std::vector < int >::size_type i = 0; i < m_positions.size();
+             ++i) {
+            int next = (m_positions[i] + 1) % m_receivers;
+
+            removeConnection(generator(i), "out",
+                             receiver(m_positions[i]), "in");
+            addConnection(generator(i), "out", receiver(next), "in");
+            m_positions[i] = next;
+        }
+        transaction.commit();
+    }
+
+    static std::string generator(int i)
+    { return "g" + boost::lexical_cast < std::string >(i); }
+
+    static std::string receiver(int i)
+    { return "r" + boost::lexical_cast < std::string >(i); }
+
+private:
+    Counters&           m_counters;
+    std::vector < int > m_positions;
+    int                 m_receivers;
+};
+
+/*
+ * Counts the values of the observation benchmark.
+ */
+class Recorder : public oov::Plugin
+{
+public:
+    Recorder(Counters& counters)
+        : oov::Plugin(std::string()), m_counters(counters)
+    {}
+
+    virtual std::string name() const
+    { return "recorder"; }
+
+    virtual void onParameter(const std::string& /* plugin */,
+                             const std::string& /* location */,
+                             const std::string& /* file */,
+                             value::Value* parameters,
+                             const double& /* time */)
+    { delete parameters; }
+
+    virtual void onNewObservable(const std::string& /* simulator */,
+                                 const std::string& /* parent */,
+                                 const std::string& /* port */,
+                                 const std::string& /* view */,
+                                 const double& /* time */)
+    {}
+
+    virtual void onDelObservable(const std::string& /* simulator */,
+                                 const std::string& /* parent */,
+                                 const std::string& /* port */,
+                                 const std::string& /* view */,
+                                 const double& /* time */)
+    {}
+
+    virtual void onValue(const std::string& /* simulator */,
+                         const std::string& /* parent */,
+                         const std::string& /* port */,
+                         const std::string& /* view */,
+                         const double& /* time */,
+                         value::Value* value)
+    {
+        ++m_counters.observations;
+        delete value;
+    }
+
+    virtual void onRow(oov::Row& row)
+    {
+        for (oov::Row::size_type i = 0; i < row.size(); ++i) {
+            if (row.type(i) == oov::Row::REAL) {
+                ++m_counters.observations;
+            }
+        }
+    }
+
+    virtual void close(const double& /* time */)
+    {}
+
+private:
+    Counters& m_counters;
+};
+
+/*
+ * The kind of dynamics of an atomic model.
+ */
+enum Kind { GENERATOR, STONE, SINK, CELL, REWIRER };
+
+struct Model
+{
+    Model(vpz::AtomicModel* atomic, Kind kind)
+        : atomic(atomic), kind(kind)
+    {}
+
+    vpz::AtomicModel* atomic;
+    Kind              kind;
+};
+
+typedef std::vector < Model > ModelList;
+
+static vpz::AtomicModel* addAtomic(vpz::CoupledModel* parent,
+                                   const std::string& name, Kind kind,
+                                   ModelList& models)
+{
+    vpz::AtomicModel* mdl = parent->addAtomicModel(name);
+    mdl->addInputPort("in");
+    mdl->addOutputPort("out");
+    models.push_back(Model(mdl, kind));
+    return mdl;
+}
+
+/*
+ * Builds the coupled model of a level of DEVStone and, recursively, the
+ * next levels.
+ */
+static vpz::CoupledModel* buildStone(vpz::CoupledModel* parent,
+                                     const std::string& type, int level,
+                                     const Parameters& params,
+                                     ModelList& models)
+{
+    vpz::CoupledModel* coupled = parent->addCoupledModel(
+        "c" + boost::lexical_cast < std::string >(level));
+    coupled->addInputPort("in");
+    coupled->addOutputPort("out");
+
+    if (level + 1 == params.depth) {
+        vpz::AtomicModel* mdl = addAtomic(coupled, "a0", STONE, models);
+        coupled->addInputConnection("in", mdl, "in");
+        coupled->addOutputConnection(mdl, "out", "out");
+        return coupled;
+    }
+
+    vpz::CoupledModel* child = buildStone(coupled, type, level + 1, params,
+                                          models);
+    coupled->addInputConnection("in", child, "in");
+    coupled->addOutputConnection(child, "out", "out");
+
+    vpz::AtomicModel* previous = 0;
+    for (int i = 1; i < params.width; ++i) {
+        vpz::AtomicModel* mdl = addAtomic(
+            coupled, "a" + boost::lexical_cast < std::string >(i), STONE,
+            models);
+        coupled->addInputConnection("in", mdl, "in");
+
+        if (type != "li" and previous) {
+            coupled->addInternalConnection(previous, "out", mdl, "in");
+        }
+        if (type == "ho") {
+            coupled->addOutputConnection(mdl, "out", "out");
+        }
+        previous = mdl;
+    }
+
+    return coupled;
+}
+
+/*
+ * Builds the models of a benchmark into the top model.
+ * @return false if the benchmark is unknown.
+ */
+static bool build(const std::string& type, const Parameters& params,
+                  vpz::CoupledModel* top, ModelList& models)
+{
+    if (type == "li" or type == "hi" or type == "ho") {
+        vpz::AtomicModel* gen = addAtomic(top, "generator", GENERATOR,
+                                          models);
+        vpz::AtomicModel* sink = addAtomic(top, "sink", SINK, models);
+        vpz::CoupledModel* stone = buildStone(top, type, 0, params, models);
+        top->addInternalConnection(gen, "out", stone, "in");
+        top->addInternalConnection(stone, "out", sink, "in");
+    } else if (type == "broadcast") {
+        vpz::AtomicModel* gen = addAtomic(top, "generator", GENERATOR,
+                                          models);
+        for (int i = 0; i < params.width * params.depth; ++i) {
+            vpz::AtomicModel* mdl = addAtomic(
+                top, "r" + boost::lexical_cast < std::string >(i), SINK,
+                models);
+            top->addInternalConnection(gen, "out", mdl, "in");
+        }
+    } else if (type == "deep") {
+        vpz::AtomicModel* gen = addAtomic(top, "generator", GENERATOR,
+                                          models);
+        vpz::AtomicModel* sink = addAtomic(top, "sink", SINK, models);
+        vpz::CoupledModel* parent = top;
+        vpz::BaseModel* previous = gen;
+        vpz::AtomicModel* relay = 0;
+
+        for (int i = 0; i < params.width * params.depth; ++i) {
+            vpz::CoupledModel* coupled = parent->addCoupledModel(
+                "c" + boost::lexical_cast < std::string >(i));
+            coupled->addInputPort("in");
+            coupled->addOutputPort("out");
+            if (parent == top) {
+                top->addInternalConnection(gen, "out", coupled, "in");
+                top->addInternalConnection(coupled, "out", sink, "in");
+            } else {
+                parent->addInternalConnection(previous, "out", coupled, "in");
+                parent->addOutputConnection(coupled, "out", "out");
+            }
+
+            relay = addAtomic(coupled, "relay", STONE, models);
+            coupled->addInputConnection("in", relay, "in");
+            parent = coupled;
+            previous = relay;
+        }
+        parent->addOutputConnection(relay, "out", "out");
+    } else if (type == "executive") {
+        addAtomic(top, "executive", REWIRER, models);
+        std::vector < vpz::AtomicModel* > receivers;
+        for (int i = 0; i < params.depth; ++i) {
+            receivers.push_back(addAtomic(top, Rewirer::receiver(i), SINK,
+                                          models));
+        }
+        for (int i = 0; i < params.width; ++i) {
+            vpz::AtomicModel* gen = addAtomic(top, Rewirer::generator(i),
+                                              GENERATOR, models);
+            top->addInternalConnection(gen, "out", receivers[0], "in");
+        }
+    } else if (type == "observation") {
+        for (int i = 0; i < params.width * params.depth; ++i) {
+            addAtomic(top, "cell" + boost::lexical_cast < std::string >(i),
+                      CELL, models);
+        }
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+static long peakResidentSetSize()
+{
+#ifndef _WIN32
+    struct rusage usage;
+    if (::getrusage(RUSAGE_SELF, &usage) == 0) {
+        return usage.ru_maxrss;
+    }
+#endif
+    return 0;
+}
+
+static uint64_t rate(uint64_t count, double elapsed)
+{
+    return elapsed > 0.0 ? static_cast < uint64_t >(count / elapsed) : 0;
+}
+
+/*
+ * Runs a benchmark and writes its line of results.
+ * @return false if the benchmark is unknown.
+ */
+static bool run(const std::string& type, const Parameters& params)
+{
+    utils::ModuleManager modules;
+    utils::PackageTable packages;
+    vpz::Dynamics dyns;
+    vpz::Classes classes;
+    vpz::Experiment expe;
+    vpz::CoupledModel* top = new vpz::CoupledModel("top", 0);
+    ModelList models;
+    Counters counters;
+
+    if (not build(type, params, top, models)) {
+        delete top;
+        return false;
+    }
+
+    double elapsed;
+    std::size_t poolAllocations, poolRequests;
+    devs::View* view = 0;
+
+    {
+        devs::RootCoordinator root(modules);
+        devs::Coordinator coord(modules, dyns, classes, expe, root);
+        vpz::AtomicModelVector atomics;
+
+        for (ModelList::iterator it = models.begin(); it != models.end();
+             ++it) {
+            devs::Simulator* sim = new devs::Simulator(it->atomic);
+            devs::InitEventList events;
+            devs::DynamicsInit init(*it->atomic, packages.get("bench"));
+
+            switch (it->kind) {
+            case GENERATOR:
+                sim->addDynamics(new Generator(init, events, counters));
+                break;
+            case STONE:
+                sim->addDynamics(new Stone(init, events, counters));
+                break;
+            case SINK:
+                sim->addDynamics(new Sink(init, events, counters));
+                break;
+            case CELL:
+                sim->addDynamics(new Cell(init, events, counters));
+                break;
+            case REWIRER:
+                sim->addDynamics(new Rewirer(
+                        devs::ExecutiveInit(*it->atomic,
+                                            packages.get("bench"), coord),
+                        events, counters, params.width, params.depth));
+                break;
+            }
+            coord.addModel(it->atomic, sim);
+            atomics.push_back(it->atomic);
+        }
+
+        coord.buildSimulatorsTarget(atomics);
+
+        for (ModelList::iterator it = models.begin(); it != models.end();
+             ++it) {
+            devs::Simulator* sim = coord.getModel(it->atomic);
+            devs::InternalEvent* event = sim->init(0.0);
+            if (event) {
+                coord.eventtable().putInternalEvent(event);
+            }
+        }
+
+        if (type == "observation") {
+            devs::StreamWriter* stream = new devs::StreamWriter(modules);
+            stream->open(oov::PluginPtr(new Recorder(counters)),
+                         std::string(), std::string(), 0, 0.0);
+            view = new devs::TimedView("view", stream, 1.0);
+            stream->setView(view);
+
+            for (ModelList::iterator it = models.begin();
+                 it != models.end(); ++it) {
+                view->addObservable(coord.getModel(it->atomic), "value",
+                                    0.0);
+            }
+            coord.eventtable().putObservationEvent(
+                new devs::ViewEvent(view, 0.0));
+        }
+
+        boost::posix_time::ptime start =
+            boost::posix_time::microsec_clock::universal_time();
+
+        while (coord.getNextTime() <= params.duration) {
+            coord.run();
+        }
+
+        elapsed = (boost::posix_time::microsec_clock::universal_time() -
+                   start).total_microseconds() / 1e6;
+
+        if (view) {
+            view->finish(params.duration);
+        }
+
+        poolAllocations = coord.eventAllocations();
+        poolRequests = coord.eventRequests();
+    }
+
+    delete view;
+    delete top;
+
+    std::cout << type << "\t" << params.width << "\t" << params.depth
+        << "\t" << params.duration << "\t" << models.size() << "\t"
+        << elapsed << "\t" << counters.transitions << "\t"
+        << counters.events << "\t" << counters.observations << "\t"
+        << rate(counters.transitions, elapsed) << "\t"
+        << rate(counters.events, elapsed) << "\t"
+        << poolAllocations << "\t" << poolRequests << "\t"
+        << peakResidentSetSize() << "\n";
+
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    const char* benchmarks[] = { "li", "hi", "ho", "broadcast", "deep",
+        "executive", "observation" };
+    const std::size_t size = sizeof(benchmarks) / sizeof(benchmarks[0]);
+
+    std::string type = "all";
+    Parameters params;
+    params.width = 20;
+    params.depth = 20;
+    params.duration = 1000.0;
+
+    try {
+        if (argc > 1) {
+            type = argv[1];
+        }
+        if (argc > 2) {
+            params.width = boost::lexical_cast < int >(argv[2]);
+        }
+        if (argc > 3) {
+            params.depth = boost::lexical_cast < int >(argv[3]);
+        }
+        if (argc > 4) {
+            params.duration = boost::lexical_cast < double >(argv[4]);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Usage: vle_bench [benchmark|all [width [depth "
+            "[duration]]]]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (params.width <= 0 or params.depth <= 0) {
+        std::cerr << "vle_bench: width and depth must be superior to 0"
+            << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "benchmark\twidth\tdepth\tduration\tmodels\tseconds\t"
+        "transitions\tevents\tobservations\ttransitions/s\tevents/s\t"
+        "pool_allocations\tpool_requests\tpeak_rss_kb\n";
+
+    try {
+        if (type == "all") {
+            for (std::size_t i = 0; i < size; ++i) {
+                run(benchmarks[i], params);
+            }
+        } else if (not run(type, params)) {
+            std::cerr << "vle_bench: unknown benchmark `" << type
+                << "', use li, hi, ho, broadcast, deep, executive,"
+                " observation or all" << std::endl;
+            return EXIT_FAILURE;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "vle_bench: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,168 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+/*
+ * Scaling benchmark of the parallel execution of the bags: a torus of
+ * cells where all the cells are imminent at each time unit. The same
+ * simulation is run with 1, 2, 4, ... threads; the checksum of the states
+ * of the cells must be the same for all the runs.
+ *
+ * Usage: bench_parallel [side [work [duration [max threads]]]]
+ */
+
+#include <vle/devs/test/torus.hpp>
+#include <vle/vpz/Dynamics.hpp>
+#include <vle/vpz/Classes.hpp>
+#include <vle/utils/ModuleManager.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace vle;
+
+struct Parameters
+{
+    int          side;
+    unsigned int work;
+    devs::Time   duration;
+    unsigned int threads;
+};
+
+static double run(const Parameters& params, unsigned int threads,
+                  uint32_t* checksum)
+{
+    utils::ModuleManager modules;
+    vpz::Dynamics dyns;
+    vpz::Classes classes;
+    vpz::Experiment expe;
+    expe.setThreads(threads);
+
+    torus::Options options;
+    options.work = params.work;
+
+    vpz::AtomicModelVector models;
+    vpz::CoupledModel* top = torus::build(params.side, models);
+    double elapsed;
+
+    {
+        devs::RootCoordinator root(modules);
+        devs::Coordinator coord(modules, dyns, classes, expe, root);
+        std::vector < torus::Cell* > cells = torus::attach(coord, root, expe,
+                                                           models, options);
+        torus::start(coord, models);
+
+        boost::posix_time::ptime start =
+            boost::posix_time::microsec_clock::universal_time();
+
+        torus::run(coord, params.duration);
+
+        elapsed = (boost::posix_time::microsec_clock::universal_time() -
+                   start).total_microseconds() / 1e6;
+
+        *checksum = 0;
+        for (std::vector < torus::Cell* >::iterator it = cells.begin();
+             it != cells.end(); ++it) {
+            *checksum = *checksum * 31 + (*it)->value();
+        }
+    }
+
+    delete top;
+    return elapsed;
+}
+
+int main(int argc, char *argv[])
+{
+    Parameters params;
+    params.side = 100;
+    params.work = 2000;
+    params.duration = 100.0;
+    params.threads = std::max(1u, boost::thread::hardware_concurrency());
+
+    try {
+        if (argc > 1) {
+            params.side = boost::lexical_cast < int >(argv[1]);
+        }
+        if (argc > 2) {
+            params.work = boost::lexical_cast < unsigned int >(argv[2]);
+        }
+        if (argc > 3) {
+            params.duration = boost::lexical_cast < double >(argv[3]);
+        }
+        if (argc > 4) {
+            params.threads = boost::lexical_cast < unsigned int >(argv[4]);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Usage: bench_parallel [side [work [duration "
+            "[max threads]]]]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (params.side <= 0 or params.threads == 0) {
+        std::cerr << "bench_parallel: side and max threads must be "
+            "superior to 0" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "threads\tcells\tseconds\tspeedup\tchecksum\n";
+
+    double reference = 0.0;
+    uint32_t expected = 0;
+    bool identical = true;
+
+    for (unsigned int threads = 1; threads <= params.threads;
+         threads = (threads * 2 > params.threads and threads <
+                    params.threads) ? params.threads : threads * 2) {
+        uint32_t checksum;
+        double elapsed = run(params, threads, &checksum);
+
+        if (threads == 1) {
+            reference = elapsed;
+            expected = checksum;
+        } else if (checksum != expected) {
+            identical = false;
+        }
+
+        std::cout << threads << "\t" << params.side * params.side << "\t"
+            << elapsed << "\t"
+            << (elapsed > 0.0 ? reference / elapsed : 0.0) << "\t"
+            << checksum << "\n";
+    }
+
+    if (not identical) {
+        std::cerr << "bench_parallel: the parallel runs differ from the "
+            "sequential run" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
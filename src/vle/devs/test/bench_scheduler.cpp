@@ -0,0 +1,281 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Micro benchmark of the devs::Scheduler: a hold model where the imminent
+ * model is rescheduled and where some external events cancel the
+ * internal event of an other model. The `legacy' scheduler reproduces the
+ * previous devs::EventTable: a binary heap with invalidated events and a
+ * std::map to find the internal event of a model.
+ *
+ * Usage: bench_scheduler [models [steps [external ratio]]]
+ */
+
+#include <vle/devs/Scheduler.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/exponential_distribution.hpp>
+#include <boost/random/uniform_real.hpp>
+#include <boost/random/uniform_int.hpp>
+#include <boost/random/variate_generator.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/timer.hpp>
+#include <boost/checked_delete.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <map>
+
+using namespace vle;
+
+typedef boost::variate_generator < boost::mt19937&,
+        boost::exponential_distribution < double > > ExpGenerator;
+typedef boost::variate_generator < boost::mt19937&,
+        boost::uniform_real < double > > RealGenerator;
+typedef boost::variate_generator < boost::mt19937&,
+        boost::uniform_int < std::size_t > > IntGenerator;
+
+struct Parameters
+{
+    std::size_t models;
+    std::size_t steps;
+    double      external;
+};
+
+inline bool legacyLessThan(const devs::InternalEvent* e1,
+                           const devs::InternalEvent* e2)
+{ return e1->getTime() > e2->getTime(); }
+
+/*
+ * The previous implementation of the devs::EventTable.
+ */
+class LegacyScheduler
+{
+public:
+    typedef std::map < devs::Simulator*, devs::InternalEvent* > Models;
+
+    ~LegacyScheduler()
+    {
+        std::for_each(m_heap.begin(), m_heap.end(),
+                      boost::checked_deleter < devs::InternalEvent >());
+    }
+
+    void put(devs::InternalEvent* event)
+    {
+        m_heap.push_back(event);
+        std::push_heap(m_heap.begin(), m_heap.end(), legacyLessThan);
+
+        if (m_models[event->getModel()]) {
+            m_models[event->getModel()]->invalidate();
+        }
+        m_models[event->getModel()] = event;
+    }
+
+    void cancel(devs::Simulator* model)
+    {
+        Models::iterator it = m_models.find(model);
+        if (it != m_models.end() and it->second) {
+            it->second->invalidate();
+            it->second = 0;
+        }
+    }
+
+    devs::InternalEvent* pop()
+    {
+        for (;;) {
+            devs::InternalEvent* event = m_heap.front();
+            std::pop_heap(m_heap.begin(), m_heap.end(), legacyLessThan);
+            m_heap.pop_back();
+
+            if (event->isValid()) {
+                m_models[event->getModel()] = 0;
+                return event;
+            }
+            delete event;
+        }
+    }
+
+    std::size_t size() const
+    { return m_heap.size(); }
+
+private:
+    std::vector < devs::InternalEvent* > m_heap;
+    Models m_models;
+};
+
+static devs::Simulator* model(std::size_t index)
+{
+    return reinterpret_cast < devs::Simulator* >(index + 1);
+}
+
+static std::size_t index(devs::Simulator* model)
+{
+    return reinterpret_cast < std::size_t >(model) - 1;
+}
+
+static double run_legacy(const Parameters& params, std::size_t* peak)
+{
+    boost::mt19937 gen(1234);
+    ExpGenerator delay(gen, boost::exponential_distribution < double >(1.0));
+    RealGenerator proba(gen, boost::uniform_real < double >(0.0, 1.0));
+    IntGenerator target(gen, boost::uniform_int < std::size_t >(
+            0, params.models - 1));
+    LegacyScheduler scheduler;
+
+    for (std::size_t i = 0; i < params.models; ++i) {
+        scheduler.put(new devs::InternalEvent(delay(), model(i)));
+    }
+
+    boost::timer timer;
+    *peak = 0;
+
+    for (std::size_t i = 0; i < params.steps; ++i) {
+        devs::InternalEvent* event = scheduler.pop();
+        devs::Time current = event->getTime();
+
+        if (proba() < params.external) {
+            devs::Simulator* mdl = model(target());
+            scheduler.cancel(mdl);
+            scheduler.put(new devs::InternalEvent(current + delay(), mdl));
+        }
+
+        scheduler.put(new devs::InternalEvent(current + delay(),
+                                              event->getModel()));
+        delete event;
+        *peak = std::max(*peak, scheduler.size());
+    }
+
+    return timer.elapsed();
+}
+
+static double run_scheduler(devs::Scheduler* scheduler,
+                            const Parameters& params, std::size_t* peak)
+{
+    boost::mt19937 gen(1234);
+    ExpGenerator delay(gen, boost::exponential_distribution < double >(1.0));
+    RealGenerator proba(gen, boost::uniform_real < double >(0.0, 1.0));
+    IntGenerator target(gen, boost::uniform_int < std::size_t >(
+            0, params.models - 1));
+    std::vector < devs::InternalEvent* > events(params.models);
+
+    for (std::size_t i = 0; i < params.models; ++i) {
+        events[i] = new devs::InternalEvent(delay(), model(i));
+        scheduler->insert(events[i]);
+    }
+
+    boost::timer timer;
+    *peak = 0;
+
+    for (std::size_t i = 0; i < params.steps; ++i) {
+        devs::InternalEvent* event = scheduler->pop();
+        devs::Time current = event->getTime();
+        events[index(event->getModel())] = 0;
+
+        if (proba() < params.external) {
+            std::size_t mdl = target();
+            if (events[mdl]) {
+                scheduler->update(events[mdl], current + delay());
+            } else {
+                events[mdl] = new devs::InternalEvent(current + delay(),
+                                                      model(mdl));
+                scheduler->insert(events[mdl]);
+            }
+        }
+
+        std::size_t mdl = index(event->getModel());
+        if (events[mdl]) {
+            scheduler->update(events[mdl], current + delay());
+        } else {
+            events[mdl] = new devs::InternalEvent(current + delay(),
+                                                  model(mdl));
+            scheduler->insert(events[mdl]);
+        }
+        delete event;
+        *peak = std::max(*peak, scheduler->size());
+    }
+
+    return timer.elapsed();
+}
+
+static void report(const std::string& name, const Parameters& params,
+                   double elapsed, std::size_t peak)
+{
+    std::cout << name << "\t" << params.models << "\t" << params.steps
+        << "\t" << elapsed << "\t"
+        << (elapsed > 0.0 ? params.steps / elapsed : 0.0) << "\t"
+        << peak << "\n";
+}
+
+int main(int argc, char *argv[])
+{
+    Parameters params;
+    params.models = 200000;
+    params.steps = 2000000;
+    params.external = 0.5;
+
+    try {
+        if (argc > 1) {
+            params.models = boost::lexical_cast < std::size_t >(argv[1]);
+        }
+        if (argc > 2) {
+            params.steps = boost::lexical_cast < std::size_t >(argv[2]);
+        }
+        if (argc > 3) {
+            params.external = boost::lexical_cast < double >(argv[3]);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Usage: bench_scheduler [models [steps [external ratio]]]"
+            << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (params.models == 0) {
+        std::cerr << "bench_scheduler: models must be superior to 0"
+            << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "scheduler\tmodels\tsteps\tseconds\tsteps/s\tpeak size\n";
+
+    std::size_t peak;
+    double elapsed = run_legacy(params, &peak);
+    report("legacy", params, elapsed, peak);
+
+    {
+        devs::HeapScheduler scheduler;
+        elapsed = run_scheduler(&scheduler, params, &peak);
+        report("heap", params, elapsed, peak);
+    }
+
+    {
+        devs::CalendarScheduler scheduler;
+        elapsed = run_scheduler(&scheduler, params, &peak);
+        report("calendar", params, elapsed, peak);
+    }
+
+    return EXIT_SUCCESS;
+}
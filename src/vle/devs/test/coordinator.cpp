@@ -33,19 +33,173 @@
 #include <boost/test/auto_unit_test.hpp>
 #include <boost/test/floating_point_comparison.hpp>
 #include <boost/lexical_cast.hpp>
+#include <boost/scoped_ptr.hpp>
 #include <stdexcept>
 #include <limits>
 #include <fstream>
 #include <vle/devs/Coordinator.hpp>
 #include <vle/devs/RootCoordinator.hpp>
+#include <vle/devs/Executive.hpp>
 #include <vle/vpz/CoupledModel.hpp>
 #include <vle/vpz/Dynamics.hpp>
 #include <vle/vpz/Experiment.hpp>
 #include <vle/vpz/Classes.hpp>
+#include <vle/vpz/Model.hpp>
 #include <vle/utils/ModuleManager.hpp>
+#include <vle/utils/PackageTable.hpp>
+#include <vle/utils/Exception.hpp>
 
 using namespace vle;
 
+/*
+ * Send an event on the port "out" each time unit.
+ */
+class Source : public devs::Dynamics
+{
+public:
+    Source(const devs::DynamicsInit& init, const devs::InitEventList& events)
+        : devs::Dynamics(init, events)
+    {}
+
+    virtual devs::Time init(const devs::Time& /* time */)
+    { return 1.0; }
+
+    virtual void output(const devs::Time& /* time */,
+                        devs::ExternalEventList& output) const
+    { output.push_back(new devs::ExternalEvent("out")); }
+
+    virtual devs::Time timeAdvance() const
+    { return 1.0; }
+};
+
+/*
+ * Count the received events.
+ */
+class Sink : public devs::Dynamics
+{
+public:
+    Sink(const devs::DynamicsInit& init, const devs::InitEventList& events)
+        : devs::Dynamics(init, events), received(0)
+    {}
+
+    virtual void externalTransition(const devs::ExternalEventList& events,
+                                    const devs::Time& /* time */)
+    { received += events.size(); }
+
+    std::size_t received;
+};
+
+/*
+ * At 0.5, connect the source to the sinks in a transaction, committed,
+ * never committed or in a Transaction destroyed without commit().
+ */
+enum RewireMode { REWIRE_COMMIT, REWIRE_BEGIN, REWIRE_SCOPED };
+
+class Rewire : public devs::Executive
+{
+public:
+    Rewire(const devs::ExecutiveInit& init, const devs::InitEventList& events,
+           RewireMode mode)
+        : devs::Executive(init, events), m_mode(mode)
+    {}
+
+    virtual devs::Time init(const devs::Time& /* time */)
+    { return 0.5; }
+
+    virtual void internalTransition(const devs::Time& /* time */)
+    {
+        if (m_mode == REWIRE_BEGIN) {
+            beginTransaction();
+            addConnection("src", "out", "dst1", "in");
+            addConnection("src", "out", "dst2", "in");
+        } else {
+            devs::Executive::Transaction transaction(*this);
+            addConnection("src", "out", "dst1", "in");
+            addConnection("src", "out", "dst2", "in");
+
+            if (m_mode == REWIRE_COMMIT) {
+                transaction.commit();
+            }
+        }
+    }
+
+private:
+    RewireMode m_mode;
+};
+
+/*
+ * Simulate the Rewire executive until 5 and return the number of events
+ * received by the sinks.
+ */
+std::size_t rewire(RewireMode mode)
+{
+    boost::scoped_ptr < vpz::CoupledModel > top(
+        new vpz::CoupledModel("top", 0));
+    utils::ModuleManager modules;
+    utils::PackageTable packages;
+    vpz::Dynamics dyns;
+    vpz::Classes classes;
+    vpz::Experiment expe;
+    vpz::Model empty;
+    devs::RootCoordinator root(modules);
+    devs::Coordinator coord(modules, dyns, classes, expe, root);
+    coord.init(empty, 0.0, 5.0);
+
+    vpz::AtomicModel* exe = top->addAtomicModel("exe");
+    vpz::AtomicModel* src = top->addAtomicModel("src");
+    vpz::AtomicModel* dst1 = top->addAtomicModel("dst1");
+    vpz::AtomicModel* dst2 = top->addAtomicModel("dst2");
+    src->addOutputPort("out");
+    dst1->addInputPort("in");
+    dst2->addInputPort("in");
+
+    devs::InitEventList events;
+    devs::Simulator* simexe = new devs::Simulator(exe);
+    simexe->addDynamics(new Rewire(
+            devs::ExecutiveInit(*exe, packages.get("test"), coord), events,
+            mode));
+    devs::Simulator* simsrc = new devs::Simulator(src);
+    simsrc->addDynamics(new Source(
+            devs::DynamicsInit(*src, packages.get("test")), events));
+    Sink* sink1 = new Sink(devs::DynamicsInit(*dst1, packages.get("test")),
+                           events);
+    devs::Simulator* simdst1 = new devs::Simulator(dst1);
+    simdst1->addDynamics(sink1);
+    Sink* sink2 = new Sink(devs::DynamicsInit(*dst2, packages.get("test")),
+                           events);
+    devs::Simulator* simdst2 = new devs::Simulator(dst2);
+    simdst2->addDynamics(sink2);
+
+    coord.addModel(exe, simexe);
+    coord.addModel(src, simsrc);
+    coord.addModel(dst1, simdst1);
+    coord.addModel(dst2, simdst2);
+
+    vpz::AtomicModelVector models;
+    vpz::BaseModel::getAtomicModelList(top.get(), models);
+    coord.buildSimulatorsTarget(models);
+
+    for (vpz::AtomicModelVector::iterator it = models.begin();
+         it != models.end(); ++it) {
+        devs::InternalEvent* evt = coord.getModel(*it)->init(0.0);
+        if (evt) {
+            coord.eventtable().putInternalEvent(evt);
+        }
+    }
+
+    try {
+        while (coord.getNextTime() <= 5.0) {
+            coord.run();
+        }
+    } catch (...) {
+        BOOST_REQUIRE(not coord.inTransaction());
+        throw;
+    }
+
+    BOOST_REQUIRE_EQUAL(sink1->received, sink2->received);
+    return sink1->received;
+}
+
 BOOST_AUTO_TEST_CASE(test_del_coupled_model)
 {
     utils::ModuleManager modules;
@@ -65,3 +219,52 @@ BOOST_AUTO_TEST_CASE(test_del_coupled_model)
     delete depth0;
     delete simdepth2;
 }
+
+BOOST_AUTO_TEST_CASE(test_model_name_index)
+{
+    utils::ModuleManager modules;
+    vpz::Dynamics dyns;
+    vpz::Classes classes;
+    vpz::Experiment expe;
+    devs::RootCoordinator root(modules);
+    devs::Coordinator coord(modules, dyns, classes, expe, root);
+    vpz::CoupledModel* top = new vpz::CoupledModel("top", 0);
+    vpz::AtomicModel* a = top->addAtomicModel("a");
+    vpz::AtomicModel* b = top->addAtomicModel("b");
+    devs::Simulator* sima = new devs::Simulator(a);
+    devs::Simulator* simb = new devs::Simulator(b);
+    coord.addModel(a, sima);
+    coord.addModel(b, simb);
+
+    BOOST_REQUIRE_EQUAL(coord.getModel("a"), sima);
+    BOOST_REQUIRE_EQUAL(coord.getModel("b"), simb);
+    BOOST_REQUIRE(coord.getModel("c") == 0);
+
+    vpz::BaseModel::rename(a, "c");
+    coord.renameModel(a, "a");
+    BOOST_REQUIRE(coord.getModel("a") == 0);
+    BOOST_REQUIRE_EQUAL(coord.getModel("c"), sima);
+
+    coord.delModel(top, "b");
+    BOOST_REQUIRE(coord.getModel("b") == 0);
+
+    BOOST_REQUIRE(not coord.inTransaction());
+    coord.beginTransaction();
+    coord.beginTransaction();
+    BOOST_REQUIRE(coord.inTransaction());
+    coord.commitTransaction();
+    BOOST_REQUIRE(coord.inTransaction());
+    coord.commitTransaction();
+    BOOST_REQUIRE(not coord.inTransaction());
+    BOOST_REQUIRE_THROW(coord.commitTransaction(), utils::InternalError);
+
+    delete top;
+    delete simb;
+}
+
+BOOST_AUTO_TEST_CASE(test_transaction_routing)
+{
+    BOOST_REQUIRE_EQUAL(rewire(REWIRE_COMMIT), 5u);
+    BOOST_REQUIRE_THROW(rewire(REWIRE_BEGIN), utils::ModellingError);
+    BOOST_REQUIRE_THROW(rewire(REWIRE_SCOPED), utils::ModellingError);
+}
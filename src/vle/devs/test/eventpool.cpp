@@ -0,0 +1,106 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#define BOOST_TEST_MAIN
+#define BOOST_AUTO_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE devseventpool_test
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+#include <vector>
+#include <vle/devs/EventPool.hpp>
+#include <vle/devs/InternalEvent.hpp>
+#include <vle/devs/ExternalEvent.hpp>
+#include <vle/value/Double.hpp>
+
+using namespace vle;
+
+BOOST_AUTO_TEST_CASE(pool_recycle)
+{
+    devs::Pool pool(sizeof(double), 4);
+
+    std::vector < void* > blocks;
+    for (int i = 0; i < 4; ++i) {
+        blocks.push_back(pool.allocate(sizeof(double)));
+    }
+
+    BOOST_REQUIRE_EQUAL(pool.allocations(), 1u);
+    BOOST_REQUIRE_EQUAL(pool.used(), 4u);
+
+    void* last = blocks.back();
+    devs::Pool::deallocate(last);
+    blocks.pop_back();
+    BOOST_REQUIRE_EQUAL(pool.used(), 3u);
+    BOOST_REQUIRE_EQUAL(pool.allocate(sizeof(double)), last);
+    BOOST_REQUIRE_EQUAL(pool.allocations(), 1u);
+    blocks.push_back(last);
+
+    blocks.push_back(pool.allocate(sizeof(double)));
+    BOOST_REQUIRE_EQUAL(pool.allocations(), 2u);
+    BOOST_REQUIRE_EQUAL(pool.requests(), 6u);
+
+    void* large = pool.allocate(16 * sizeof(double));
+    BOOST_REQUIRE_EQUAL(pool.allocations(), 3u);
+    BOOST_REQUIRE_EQUAL(pool.used(), 5u);
+    devs::Pool::deallocate(large);
+
+    for (std::vector < void* >::iterator it = blocks.begin();
+         it != blocks.end(); ++it) {
+        devs::Pool::deallocate(*it);
+    }
+    BOOST_REQUIRE_EQUAL(pool.used(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(eventpool_steady_state)
+{
+    devs::EventPool pool;
+
+    {
+        devs::EventPool::Scope scope(pool);
+        BOOST_REQUIRE_EQUAL(devs::EventPool::current(), &pool);
+
+        for (int i = 0; i < 1000; ++i) {
+            devs::InternalEvent* internal = new devs::InternalEvent(i, 0);
+            devs::ExternalEvent* external = new devs::ExternalEvent("out");
+            external << devs::attribute("x", i * 0.5);
+
+            devs::ExternalEvent* copy = new devs::ExternalEvent(*external, 0,
+                                                                "in");
+            BOOST_REQUIRE_EQUAL(copy->getDoubleAttributeValue("x"), i * 0.5);
+
+            delete external;
+            delete copy;
+            delete internal;
+        }
+    }
+
+    BOOST_REQUIRE(devs::EventPool::current() == 0);
+    BOOST_REQUIRE_EQUAL(pool.requests(), 4000u);
+    BOOST_REQUIRE_EQUAL(pool.allocations(), 3u);
+
+    devs::InternalEvent* system = new devs::InternalEvent(0.0, 0);
+    BOOST_REQUIRE_EQUAL(pool.requests(), 4000u);
+    delete system;
+}
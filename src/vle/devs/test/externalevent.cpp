@@ -0,0 +1,137 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#define BOOST_TEST_MAIN
+#define BOOST_AUTO_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE devsexternalevent_test
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+#include <vle/devs/ExternalEvent.hpp>
+#include <vle/devs/PortName.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Scalar.hpp>
+#include <vle/value/String.hpp>
+
+using namespace vle;
+
+BOOST_AUTO_TEST_CASE(portname_intern)
+{
+    devs::PortName a("in");
+    devs::PortName b(std::string("in"));
+    devs::PortName c("out");
+
+    BOOST_REQUIRE(a == b);
+    BOOST_REQUIRE(a != c);
+    BOOST_REQUIRE_EQUAL(&a.str(), &b.str());
+    BOOST_REQUIRE_EQUAL(c.str(), "out");
+    BOOST_REQUIRE(devs::PortName().empty());
+    BOOST_REQUIRE(devs::PortName() == devs::PortName(""));
+}
+
+BOOST_AUTO_TEST_CASE(externalevent_shared_payload)
+{
+    devs::ExternalEvent* source = new devs::ExternalEvent("out");
+    source << devs::attribute("x", 1.5) << devs::attribute("msg", "hello");
+
+    devs::PortName in1("in1");
+    devs::ExternalEvent* first = new devs::ExternalEvent(*source, 0, in1);
+    devs::ExternalEvent* second = new devs::ExternalEvent(*source, 0,
+                                                          std::string("in2"));
+
+    BOOST_REQUIRE_EQUAL(source->getPortName(), "out");
+    BOOST_REQUIRE_EQUAL(first->getPortName(), "in1");
+    BOOST_REQUIRE_EQUAL(&first->getPortName(), &in1.str());
+    BOOST_REQUIRE(second->onPort("in2"));
+    BOOST_REQUIRE_EQUAL(&second->getPortName(),
+                        &devs::PortName("in2").str());
+
+    BOOST_REQUIRE_EQUAL(&first->getAttributes(), &source->getAttributes());
+    BOOST_REQUIRE_EQUAL(&second->getAttributes(), &source->getAttributes());
+
+    delete source;
+
+    BOOST_REQUIRE_EQUAL(first->getDoubleAttributeValue("x"), 1.5);
+    BOOST_REQUIRE_EQUAL(second->getStringAttributeValue("msg"), "hello");
+
+    delete first;
+    BOOST_REQUIRE_EQUAL(second->getDoubleAttributeValue("x"), 1.5);
+    delete second;
+}
+
+BOOST_AUTO_TEST_CASE(externalevent_no_attribute)
+{
+    devs::ExternalEvent source("out");
+    devs::ExternalEvent target(source, 0, devs::PortName("in"));
+
+    BOOST_REQUIRE(not target.haveAttributes());
+    BOOST_REQUIRE(not target.existAttributeValue("x"));
+    BOOST_REQUIRE_THROW(target.getDoubleAttributeValue("x"),
+                        utils::ArgError);
+
+    source.putAttribute("x", new value::Double(2.0));
+    BOOST_REQUIRE(target.haveAttributes());
+    BOOST_REQUIRE_EQUAL(target.getDoubleAttributeValue("x"), 2.0);
+}
+
+BOOST_AUTO_TEST_CASE(externalevent_scalar_attributes)
+{
+    devs::ExternalEvent source("out");
+    source << devs::attribute("x", 1.5) << devs::attribute("n", 3)
+           << devs::attribute("ok", true) << devs::attribute("msg", "hi");
+
+    BOOST_REQUIRE(source.haveAttributes());
+    BOOST_REQUIRE(source.existAttributeValue("n"));
+    BOOST_REQUIRE(not source.existAttributeValue("y"));
+    BOOST_REQUIRE_EQUAL(source.getDoubleAttributeValue("x"), 1.5);
+    BOOST_REQUIRE_EQUAL(source.getIntegerAttributeValue("n"), 3);
+    BOOST_REQUIRE_EQUAL(source.getBooleanAttributeValue("ok"), true);
+    BOOST_REQUIRE_THROW(source.getDoubleAttributeValue("n"),
+                        utils::CastError);
+    BOOST_REQUIRE_THROW(source.getDoubleAttributeValue("y"),
+                        utils::ArgError);
+
+    const std::string& msg = source.getStringAttributeValue("msg");
+    BOOST_REQUIRE_EQUAL(msg, "hi");
+
+    devs::ExternalEvent* copy = source.copy(0, devs::PortName("in"));
+    source.putAttribute("x", value::Scalar(2.5));
+    BOOST_REQUIRE_EQUAL(source.getDoubleAttributeValue("x"), 2.5);
+    BOOST_REQUIRE_EQUAL(copy->getDoubleAttributeValue("x"), 1.5);
+    BOOST_REQUIRE_EQUAL(copy->getStringAttributeValue("msg"), "hi");
+    delete copy;
+
+    /* A fifth attribute builds the value::Map of attributes. */
+    source << devs::attribute("y", 4.0);
+    BOOST_REQUIRE_EQUAL(source.getAttributes().size(), 5u);
+    BOOST_REQUIRE_EQUAL(source.getAttributes().getDouble("x"), 2.5);
+    BOOST_REQUIRE_EQUAL(source.getDoubleAttributeValue("y"), 4.0);
+    BOOST_REQUIRE_EQUAL(msg, "hi");
+
+    devs::Attribute attr = devs::attribute("z", 1.0);
+    BOOST_REQUIRE(attr.second->isDouble());
+    source << attr;
+    BOOST_REQUIRE_EQUAL(source.getDoubleAttributeValue("z"), 1.0);
+}
@@ -0,0 +1,224 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE devsparallel_test
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <stdexcept>
+#include <vector>
+#include <vle/devs/WorkerPool.hpp>
+#include <vle/devs/test/torus.hpp>
+#include <vle/vpz/Dynamics.hpp>
+#include <vle/vpz/Classes.hpp>
+#include <vle/utils/ModuleManager.hpp>
+
+using namespace vle;
+
+/*
+ * Simulate a torus of side x side cells until the specified time and
+ * return the states of the cells. The cells mix a number of their random
+ * stream into their state.
+ */
+std::vector < uint32_t > simulate(int side, unsigned int threads,
+                                  const devs::Time& duration,
+                                  uint32_t seed = 0, bool scalars = false,
+                                  const devs::Time& failure = devs::infinity)
+{
+    utils::ModuleManager modules;
+    vpz::Dynamics dyns;
+    vpz::Classes classes;
+    vpz::Experiment expe;
+    expe.setThreads(threads);
+    expe.setSeed(seed);
+
+    torus::Options options;
+    options.random = true;
+    options.scalars = scalars;
+    options.failure = failure;
+
+    vpz::AtomicModelVector models;
+    boost::scoped_ptr < vpz::CoupledModel > top(torus::build(side, models));
+    std::vector < uint32_t > result;
+
+    {
+        devs::RootCoordinator root(modules);
+        devs::Coordinator coord(modules, dyns, classes, expe, root);
+        std::vector < torus::Cell* > cells = torus::attach(coord, root, expe,
+                                                           models, options);
+        torus::start(coord, models);
+        torus::run(coord, duration);
+        result = torus::values(cells);
+    }
+
+    return result;
+}
+
+class Count : public devs::WorkerPool::Task
+{
+public:
+    Count(std::vector < int >& counts)
+        : counts(counts)
+    {}
+
+    virtual void operator()(std::size_t index)
+    { counts[index]++; }
+
+    std::vector < int >& counts;
+};
+
+class Fail : public devs::WorkerPool::Task
+{
+public:
+    virtual void operator()(std::size_t index)
+    {
+        if (index == 100) {
+            throw utils::ArgError(boost::lexical_cast < std::string >(index));
+        } else if (index == 5000) {
+            throw utils::ModellingError("5000");
+        }
+    }
+};
+
+class FailStd : public devs::WorkerPool::Task
+{
+public:
+    virtual void operator()(std::size_t index)
+    {
+        if (index == 10) {
+            throw std::out_of_range("10");
+        }
+    }
+};
+
+BOOST_AUTO_TEST_CASE(workerpool_run)
+{
+    devs::WorkerPool pool(4);
+    BOOST_REQUIRE_EQUAL(pool.size(), 4u);
+
+    std::vector < int > counts(10000, 0);
+    Count task(counts);
+
+    pool.run(task, counts.size());
+    pool.run(task, counts.size());
+    pool.run(task, 3);
+
+    for (std::size_t i = 0; i < counts.size(); ++i) {
+        BOOST_REQUIRE_EQUAL(counts[i], i < 3 ? 3 : 2);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(workerpool_sequential)
+{
+    devs::WorkerPool pool(0);
+    BOOST_REQUIRE_EQUAL(pool.size(), 1u);
+
+    std::vector < int > counts(100, 0);
+    Count task(counts);
+    pool.run(task, counts.size());
+
+    for (std::size_t i = 0; i < counts.size(); ++i) {
+        BOOST_REQUIRE_EQUAL(counts[i], 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(workerpool_error)
+{
+    devs::WorkerPool pool(4);
+    Fail task;
+
+    try {
+        pool.run(task, 10000);
+        BOOST_FAIL("the task must fail");
+    } catch (const utils::ArgError& e) {
+        BOOST_REQUIRE_EQUAL(std::string(e.what()), "100");
+    }
+
+    FailStd other;
+    try {
+        pool.run(other, 100);
+        BOOST_FAIL("the task must fail");
+    } catch (const utils::BaseError& e) {
+        BOOST_FAIL("the error must not become an utils error");
+    } catch (const std::runtime_error& e) {
+        BOOST_REQUIRE_EQUAL(std::string(e.what()), "10");
+    }
+
+    std::vector < int > counts(1000, 0);
+    Count count(counts);
+    pool.run(count, counts.size());
+    BOOST_REQUIRE_EQUAL(counts[999], 1);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_bags)
+{
+    std::vector < uint32_t > sequential = simulate(20, 1, 50.0);
+    std::vector < uint32_t > parallel = simulate(20, 4, 50.0);
+
+    BOOST_REQUIRE_EQUAL(sequential.size(), parallel.size());
+    BOOST_REQUIRE(sequential == parallel);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_small_bags)
+{
+    std::vector < uint32_t > sequential = simulate(2, 1, 50.0);
+    std::vector < uint32_t > parallel = simulate(2, 8, 50.0);
+
+    BOOST_REQUIRE(sequential == parallel);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_random_streams)
+{
+    std::vector < uint32_t > sequential = simulate(10, 1, 20.0, 12345);
+    std::vector < uint32_t > parallel = simulate(10, 4, 20.0, 12345);
+    std::vector < uint32_t > other = simulate(10, 1, 20.0, 54321);
+
+    BOOST_REQUIRE(sequential == parallel);
+    BOOST_REQUIRE(sequential != other);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_shared_attributes)
+{
+    std::vector < uint32_t > sequential = simulate(20, 1, 30.0, 0, true);
+    std::vector < uint32_t > parallel = simulate(20, 4, 30.0, 0, true);
+    std::vector < uint32_t > composite = simulate(20, 4, 30.0, 0, false);
+
+    BOOST_REQUIRE(sequential == parallel);
+    BOOST_REQUIRE(sequential == composite);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_model_error)
+{
+    BOOST_REQUIRE_THROW(simulate(20, 0, 30.0, 0, false, 10.0),
+                        utils::ModellingError);
+    BOOST_REQUIRE_THROW(simulate(20, 4, 30.0, 0, false, 10.0),
+                        utils::ModellingError);
+}
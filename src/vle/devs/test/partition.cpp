@@ -0,0 +1,323 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE devspartition_test
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include <vle/devs/Partition.hpp>
+#include <vle/devs/test/torus.hpp>
+#include <vle/vpz/Dynamics.hpp>
+#include <vle/vpz/Classes.hpp>
+#include <vle/vpz/Model.hpp>
+#include <vle/utils/ModuleManager.hpp>
+#include <vle/utils/PackageTable.hpp>
+
+using namespace vle;
+
+/*
+ * The result of a simulation of the torus of rows.
+ * - built: the number of partitions built.
+ * - values: the states of the cells.
+ * - bags: for each cell and each external transition, the sorted indices
+ *   of the sources of the events, the content of the bags.
+ * - disorders: the number of external transitions where the events do not
+ *   come in the order of the sequential coordinator, by increasing source
+ *   Simulator.
+ */
+struct Result
+{
+    typedef std::vector < std::vector < int > > Bags;
+
+    std::size_t                 built;
+    std::vector < uint32_t >    values;
+    std::vector < Bags >        bags;
+    std::size_t                 disorders;
+};
+
+/*
+ * Simulate a torus of side x side cells, each row a coupled model, until
+ * the specified time.
+ */
+Result simulate(int side, unsigned int partitions,
+                const std::string& partitioning, const devs::Time& duration)
+{
+    utils::ModuleManager modules;
+    vpz::Dynamics dyns;
+    vpz::Classes classes;
+    vpz::Experiment expe;
+    expe.setPartitions(partitions);
+    if (not partitioning.empty()) {
+        expe.setPartitioning(partitioning);
+    }
+
+    torus::Options options;
+    options.sources = true;
+
+    vpz::AtomicModelVector models;
+    vpz::Model model;
+    model.setModel(torus::buildRows(side, models));
+    boost::scoped_ptr < vpz::BaseModel > top(model.model());
+    Result result;
+
+    {
+        devs::RootCoordinator root(modules);
+        devs::Coordinator coord(modules, dyns, classes, expe, root);
+        std::vector < torus::Cell* > cells = torus::attach(coord, root, expe,
+                                                           models, options);
+        torus::start(coord, models);
+        coord.buildPartitions(model);
+        result.built = coord.partitions().size();
+        torus::run(coord, duration);
+        result.values = torus::values(cells);
+        result.disorders = 0;
+
+        for (std::size_t i = 0; i < cells.size(); ++i) {
+            const std::vector < std::vector < int > >& sources =
+                cells[i]->sources();
+            result.bags.push_back(sources);
+
+            for (std::size_t j = 0; j < sources.size(); ++j) {
+                for (std::size_t k = 1; k < sources[j].size(); ++k) {
+                    if (std::less < devs::Simulator* >()(
+                            coord.getModel(models[sources[j][k]]),
+                            coord.getModel(models[sources[j][k - 1]]))) {
+                        result.disorders++;
+                        break;
+                    }
+                }
+                std::sort(result.bags.back()[j].begin(),
+                          result.bags.back()[j].end());
+            }
+        }
+    }
+
+    return result;
+}
+
+BOOST_AUTO_TEST_CASE(partition_balanced)
+{
+    Result sequential = simulate(12, 1, "", 20.0);
+    BOOST_REQUIRE_EQUAL(sequential.built, 0u);
+    BOOST_REQUIRE_EQUAL(sequential.disorders, 0u);
+
+    Result partitioned = simulate(12, 4, "", 20.0);
+    BOOST_REQUIRE_EQUAL(partitioned.built, 4u);
+    BOOST_REQUIRE_EQUAL(partitioned.disorders, 0u);
+    BOOST_REQUIRE(sequential.bags == partitioned.bags);
+    BOOST_REQUIRE(sequential.values == partitioned.values);
+}
+
+BOOST_AUTO_TEST_CASE(partition_roundrobin)
+{
+    Result sequential = simulate(12, 1, "", 20.0);
+    Result partitioned = simulate(12, 5, "roundrobin", 20.0);
+    BOOST_REQUIRE_EQUAL(partitioned.built, 5u);
+    BOOST_REQUIRE_EQUAL(partitioned.disorders, 0u);
+    BOOST_REQUIRE(sequential.bags == partitioned.bags);
+    BOOST_REQUIRE(sequential.values == partitioned.values);
+}
+
+BOOST_AUTO_TEST_CASE(partition_more_than_children)
+{
+    Result sequential = simulate(3, 1, "", 20.0);
+    Result partitioned = simulate(3, 8, "balanced", 20.0);
+    BOOST_REQUIRE_EQUAL(partitioned.built, 3u);
+    BOOST_REQUIRE_EQUAL(partitioned.disorders, 0u);
+    BOOST_REQUIRE(sequential.bags == partitioned.bags);
+    BOOST_REQUIRE(sequential.values == partitioned.values);
+}
+
+/*
+ * A model which waits until the date 2.5, or forever after an external
+ * transition, and counts its internal transitions.
+ */
+class Sleeper : public devs::Dynamics
+{
+public:
+    Sleeper(const devs::DynamicsInit& init, const devs::InitEventList& events)
+        : devs::Dynamics(init, events), m_sigma(2.5), m_internals(0)
+    {}
+
+    virtual devs::Time init(const devs::Time& /* time */)
+    { return m_sigma; }
+
+    virtual devs::Time timeAdvance() const
+    { return m_sigma; }
+
+    virtual void internalTransition(const devs::Time& /* time */)
+    {
+        m_internals++;
+        m_sigma = devs::infinity;
+    }
+
+    virtual void externalTransition(const devs::ExternalEventList& /* ev */,
+                                    const devs::Time& /* time */)
+    { m_sigma = devs::infinity; }
+
+    unsigned int internals() const
+    { return m_internals; }
+
+private:
+    devs::Time   m_sigma;
+    unsigned int m_internals;
+};
+
+/*
+ * A model which sends one event at the date 1.
+ */
+class Pulse : public devs::Dynamics
+{
+public:
+    Pulse(const devs::DynamicsInit& init, const devs::InitEventList& events)
+        : devs::Dynamics(init, events), m_sigma(1.0)
+    {}
+
+    virtual devs::Time init(const devs::Time& /* time */)
+    { return m_sigma; }
+
+    virtual devs::Time timeAdvance() const
+    { return m_sigma; }
+
+    virtual void output(const devs::Time& /* time */,
+                        devs::ExternalEventList& output) const
+    { output.push_back(new devs::ExternalEvent("out")); }
+
+    virtual void internalTransition(const devs::Time& /* time */)
+    { m_sigma = devs::infinity; }
+
+private:
+    devs::Time m_sigma;
+};
+
+/*
+ * Send a pulse at the date 1 to a sleeper of the same partition and to a
+ * sleeper of the other partition: the external transitions make them
+ * passive, their internal events at 2.5 must be dropped as by the
+ * sequential coordinator.
+ */
+std::vector < unsigned int > simulatePulse(unsigned int partitions)
+{
+    static utils::PackageTable packages;
+    utils::ModuleManager modules;
+    vpz::Dynamics dyns;
+    vpz::Classes classes;
+    vpz::Experiment expe;
+    expe.setPartitions(partitions);
+
+    vpz::CoupledModel* top = new vpz::CoupledModel("top", 0);
+    vpz::CoupledModel* first = top->addCoupledModel("first");
+    vpz::CoupledModel* second = top->addCoupledModel("second");
+    vpz::AtomicModel* pulse = first->addAtomicModel("pulse");
+    vpz::AtomicModel* near = first->addAtomicModel("near");
+    vpz::AtomicModel* far = second->addAtomicModel("far");
+    pulse->addOutputPort("out");
+    near->addInputPort("in");
+    far->addInputPort("in");
+    first->addOutputPort("out");
+    second->addInputPort("in");
+    first->addInternalConnection(pulse, "out", near, "in");
+    first->addOutputConnection(pulse, "out", "out");
+    second->addInputConnection("in", far, "in");
+    top->addInternalConnection(first, "out", second, "in");
+
+    vpz::Model model;
+    model.setModel(top);
+    boost::scoped_ptr < vpz::BaseModel > owner(model.model());
+
+    vpz::AtomicModelVector models;
+    models.push_back(pulse);
+    models.push_back(near);
+    models.push_back(far);
+    std::vector < unsigned int > result;
+
+    {
+        devs::RootCoordinator root(modules);
+        devs::Coordinator coord(modules, dyns, classes, expe, root);
+        std::vector < Sleeper* > sleepers;
+
+        for (std::size_t i = 0; i < models.size(); ++i) {
+            devs::Simulator* sim = new devs::Simulator(models[i]);
+            devs::DynamicsInit init(*models[i], packages.get("test"),
+                                    expe.seed(), root.replica());
+            devs::InitEventList events;
+
+            if (i == 0) {
+                sim->addDynamics(new Pulse(init, events));
+            } else {
+                Sleeper* sleeper = new Sleeper(init, events);
+                sim->addDynamics(sleeper);
+                sleepers.push_back(sleeper);
+            }
+            coord.addModel(models[i], sim);
+        }
+
+        coord.buildSimulatorsTarget(models);
+        torus::start(coord, models);
+        coord.buildPartitions(model);
+        result.push_back(coord.partitions().size());
+        torus::run(coord, 10.0);
+
+        for (std::size_t i = 0; i < sleepers.size(); ++i) {
+            result.push_back(sleepers[i]->internals());
+        }
+    }
+
+    return result;
+}
+
+BOOST_AUTO_TEST_CASE(partition_passive_target)
+{
+    std::vector < unsigned int > sequential = simulatePulse(1);
+    BOOST_REQUIRE_EQUAL(sequential.size(), 3u);
+    BOOST_REQUIRE_EQUAL(sequential[0], 0u);
+    BOOST_REQUIRE_EQUAL(sequential[1], 0u);
+    BOOST_REQUIRE_EQUAL(sequential[2], 0u);
+
+    std::vector < unsigned int > partitioned = simulatePulse(2);
+    BOOST_REQUIRE_EQUAL(partitioned.size(), 3u);
+    BOOST_REQUIRE_EQUAL(partitioned[0], 2u);
+    BOOST_REQUIRE_EQUAL(partitioned[1], 0u);
+    BOOST_REQUIRE_EQUAL(partitioned[2], 0u);
+}
+
+BOOST_AUTO_TEST_CASE(partition_experiment)
+{
+    vpz::Experiment expe;
+    BOOST_REQUIRE_EQUAL(expe.partitions(), 0u);
+    BOOST_REQUIRE(expe.partitioning().empty());
+
+    expe.setPartitioning("roundrobin");
+    BOOST_REQUIRE_EQUAL(expe.partitioning(), "roundrobin");
+    BOOST_REQUIRE_THROW(expe.setPartitioning("metis"), utils::ArgError);
+}
@@ -0,0 +1,134 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#define BOOST_TEST_MAIN
+#define BOOST_AUTO_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE devsprofile_test
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+#include <vle/devs/Profile.hpp>
+#include <sstream>
+
+using namespace vle;
+
+BOOST_AUTO_TEST_CASE(test_counter)
+{
+    devs::Profile::Counter a, b;
+
+    a.add(1.0);
+    a.add(3.0);
+    b.add(2.0);
+    BOOST_REQUIRE_EQUAL(a.calls, 2u);
+    BOOST_REQUIRE_CLOSE(a.total, 4.0, 1e-10);
+    BOOST_REQUIRE_CLOSE(a.max, 3.0, 1e-10);
+
+    b.merge(a);
+    BOOST_REQUIRE_EQUAL(b.calls, 3u);
+    BOOST_REQUIRE_CLOSE(b.total, 6.0, 1e-10);
+    BOOST_REQUIRE_CLOSE(b.max, 3.0, 1e-10);
+}
+
+BOOST_AUTO_TEST_CASE(test_timer)
+{
+    devs::Profile profile;
+    devs::Profile::Record* record = profile.attach("top,a", "dyn");
+
+    {
+        devs::Profile::Timer timer(record, devs::Profile::OUTPUT);
+    }
+    {
+        devs::Profile::Timer timer(0, devs::Profile::OUTPUT);
+    }
+
+    BOOST_REQUIRE_EQUAL(record->functions[devs::Profile::OUTPUT].calls, 1u);
+    BOOST_REQUIRE(record->functions[devs::Profile::OUTPUT].total >= 0.0);
+    BOOST_REQUIRE_EQUAL(record->functions[devs::Profile::INTERNAL].calls,
+                        0u);
+
+    record->route("out", 3);
+    record->route("out", 2);
+    BOOST_REQUIRE_EQUAL(record->ports["out"].events, 2u);
+    BOOST_REQUIRE_EQUAL(record->ports["out"].targets, 5u);
+}
+
+BOOST_AUTO_TEST_CASE(test_samples)
+{
+    devs::Profile profile;
+    const std::size_t bags = 3 * devs::Profile::SAMPLES + 17;
+
+    for (std::size_t i = 1; i <= bags; ++i) {
+        if (profile.bag()) {
+            profile.sample(static_cast < double >(i), i);
+        }
+    }
+
+    const devs::Profile::SampleList& samples(profile.samples());
+
+    BOOST_REQUIRE_EQUAL(profile.bags(), bags);
+    BOOST_REQUIRE(samples.size() <= devs::Profile::SAMPLES);
+    BOOST_REQUIRE(samples.size() >= devs::Profile::SAMPLES / 2);
+
+    /* The samples are regular: the period is the same between all the
+     * samples. */
+    std::size_t period = samples[0].size;
+    for (std::size_t i = 1; i < samples.size(); ++i) {
+        BOOST_REQUIRE_EQUAL(samples[i].size - samples[i - 1].size, period);
+    }
+    BOOST_REQUIRE_EQUAL(period, 4u);
+}
+
+BOOST_AUTO_TEST_CASE(test_write)
+{
+    devs::Profile profile;
+    devs::Profile::Record* a = profile.attach("top,a", "dyn");
+    devs::Profile::Record* b = profile.attach("top,b", "dyn");
+    profile.attach("top,c", "other");
+
+    a->functions[devs::Profile::INTERNAL].add(1.0);
+    b->functions[devs::Profile::INTERNAL].add(2.0);
+    a->route("out", 1);
+    profile.bag();
+    profile.sample(1.0, 12);
+
+    std::ostringstream out;
+    profile.write(out);
+
+    const std::string report(out.str());
+    BOOST_REQUIRE(report.find(
+            "<dynamic name=\"dyn\" models=\"2\" >\n"
+            "   <function name=\"internalTransition\" calls=\"2\""
+            " total=\"3\" max=\"2\" />") != std::string::npos);
+    BOOST_REQUIRE(report.find(
+            "<dynamic name=\"other\" models=\"1\" >\n"
+            "  </dynamic>") != std::string::npos);
+    BOOST_REQUIRE(report.find(
+            "<port name=\"out\" events=\"1\" targets=\"1\" />") !=
+        std::string::npos);
+    BOOST_REQUIRE(report.find(
+            "<sample time=\"1\" size=\"12\" />") != std::string::npos);
+}
@@ -0,0 +1,208 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#define BOOST_TEST_MAIN
+#define BOOST_AUTO_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE devsscheduler_test
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_real.hpp>
+#include <boost/random/uniform_int.hpp>
+#include <boost/random/variate_generator.hpp>
+#include <algorithm>
+#include <vector>
+#include <vle/devs/Scheduler.hpp>
+#include <vle/utils/Exception.hpp>
+
+using namespace vle;
+
+typedef boost::variate_generator < boost::mt19937&,
+        boost::uniform_real < double > > RealGenerator;
+
+/*
+ * Pop all the events of the scheduler and check the order with the sorted
+ * list of the expected times.
+ */
+static void check_pop(devs::Scheduler* scheduler,
+                      std::vector < devs::Time > expected)
+{
+    std::sort(expected.begin(), expected.end());
+
+    BOOST_REQUIRE_EQUAL(scheduler->size(), expected.size());
+
+    for (std::vector < devs::Time >::iterator it = expected.begin();
+         it != expected.end(); ++it) {
+        devs::InternalEvent* top = scheduler->top();
+        devs::InternalEvent* event = scheduler->pop();
+
+        BOOST_REQUIRE(event);
+        BOOST_REQUIRE_EQUAL(top, event);
+        BOOST_REQUIRE_EQUAL(event->getTime(), *it);
+        delete event;
+    }
+
+    BOOST_REQUIRE(scheduler->empty());
+    BOOST_REQUIRE(scheduler->top() == 0);
+    BOOST_REQUIRE(scheduler->pop() == 0);
+}
+
+static void check_insert(devs::Scheduler* scheduler)
+{
+    boost::mt19937 gen(123);
+    RealGenerator rnd(gen, boost::uniform_real < double >(0.0, 100.0));
+    std::vector < devs::Time > expected;
+
+    for (int i = 0; i < 10000; ++i) {
+        expected.push_back(rnd());
+        scheduler->insert(new devs::InternalEvent(expected.back(), 0));
+    }
+
+    check_pop(scheduler, expected);
+}
+
+static void check_erase_update(devs::Scheduler* scheduler)
+{
+    boost::mt19937 gen(456);
+    RealGenerator rnd(gen, boost::uniform_real < double >(-10.0, 1000.0));
+    std::vector < devs::InternalEvent* > events;
+
+    for (int i = 0; i < 5000; ++i) {
+        events.push_back(new devs::InternalEvent(rnd(), 0));
+        scheduler->insert(events.back());
+    }
+
+    for (int i = 0; i < 5000; i += 3) {
+        scheduler->erase(events[i]);
+        delete events[i];
+        events[i] = 0;
+    }
+
+    for (int i = 1; i < 5000; i += 3) {
+        scheduler->update(events[i], rnd());
+    }
+
+    std::vector < devs::Time > expected;
+    for (int i = 0; i < 5000; ++i) {
+        if (events[i]) {
+            expected.push_back(events[i]->getTime());
+        }
+    }
+
+    check_pop(scheduler, expected);
+}
+
+static void check_hold(devs::Scheduler* scheduler)
+{
+    boost::mt19937 gen(789);
+    RealGenerator rnd(gen, boost::uniform_real < double >(0.0, 1.0));
+    devs::Time current = 0.0;
+
+    for (int i = 0; i < 1000; ++i) {
+        scheduler->insert(new devs::InternalEvent(rnd(), 0));
+    }
+
+    for (int i = 0; i < 100000; ++i) {
+        devs::InternalEvent* event = scheduler->pop();
+
+        BOOST_REQUIRE(event);
+        BOOST_REQUIRE(event->getTime() >= current);
+        current = event->getTime();
+
+        /* A third of the events are simultaneous. */
+        if (i % 3) {
+            scheduler->insert(new devs::InternalEvent(current + rnd(), 0));
+        } else {
+            scheduler->insert(new devs::InternalEvent(current, 0));
+        }
+        delete event;
+    }
+
+    BOOST_REQUIRE_EQUAL(scheduler->size(), 1000u);
+}
+
+BOOST_AUTO_TEST_CASE(heap_scheduler)
+{
+    devs::HeapScheduler a;
+    check_insert(&a);
+
+    devs::HeapScheduler b;
+    check_erase_update(&b);
+
+    devs::HeapScheduler c;
+    check_hold(&c);
+}
+
+BOOST_AUTO_TEST_CASE(calendar_scheduler)
+{
+    devs::CalendarScheduler a;
+    check_insert(&a);
+
+    devs::CalendarScheduler b;
+    check_erase_update(&b);
+
+    devs::CalendarScheduler c;
+    check_hold(&c);
+}
+
+BOOST_AUTO_TEST_CASE(calendar_scheduler_simultaneous)
+{
+    devs::CalendarScheduler scheduler;
+    std::vector < devs::Time > expected;
+
+    for (int i = 0; i < 1000; ++i) {
+        expected.push_back(1.0);
+        scheduler.insert(new devs::InternalEvent(1.0, 0));
+        expected.push_back(1e6);
+        scheduler.insert(new devs::InternalEvent(1e6, 0));
+    }
+
+    devs::InternalEvent* early = new devs::InternalEvent(0.5, 0);
+    scheduler.insert(early);
+    BOOST_REQUIRE_EQUAL(scheduler.top(), early);
+    scheduler.update(early, 2.0);
+    expected.push_back(2.0);
+
+    check_pop(&scheduler, expected);
+}
+
+BOOST_AUTO_TEST_CASE(scheduler_build)
+{
+    devs::Scheduler* scheduler = 0;
+
+    scheduler = devs::Scheduler::build("");
+    BOOST_REQUIRE(dynamic_cast < devs::HeapScheduler* >(scheduler));
+    delete scheduler;
+
+    scheduler = devs::Scheduler::build("calendar");
+    BOOST_REQUIRE(dynamic_cast < devs::CalendarScheduler* >(scheduler));
+    scheduler->insert(new devs::InternalEvent(1.0, 0));
+    delete scheduler;
+
+    BOOST_REQUIRE_THROW(devs::Scheduler::build("ladder"), utils::ArgError);
+}
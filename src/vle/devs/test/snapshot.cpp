@@ -0,0 +1,251 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE devssnapshot_test
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <vector>
+#include <vle/devs/Snapshot.hpp>
+#include <vle/devs/test/torus.hpp>
+#include <vle/vpz/Dynamics.hpp>
+#include <vle/vpz/Classes.hpp>
+#include <vle/vpz/Vpz.hpp>
+#include <vle/utils/ModuleManager.hpp>
+
+using namespace vle;
+
+/*
+ * A model without snapshot support.
+ */
+class Passive : public devs::Dynamics
+{
+public:
+    Passive(const devs::DynamicsInit& init, const devs::InitEventList& events)
+        : devs::Dynamics(init, events)
+    {}
+};
+
+typedef std::map < std::string, uint32_t > States;
+
+/*
+ * Build a Cell, which mixes numbers of its random stream into its state,
+ * for each atomic model of the tree.
+ */
+std::vector < torus::Cell* > attach(devs::Coordinator& coord,
+                                    devs::RootCoordinator& root,
+                                    const vpz::Experiment& expe,
+                                    vpz::BaseModel* top)
+{
+    vpz::AtomicModelVector models;
+    vpz::BaseModel::getAtomicModelList(top, models);
+
+    torus::Options options;
+    options.random = true;
+    return torus::attach(coord, root, expe, models, options);
+}
+
+States states(const std::vector < torus::Cell* >& cells)
+{
+    States result;
+
+    for (std::vector < torus::Cell* >::const_iterator it = cells.begin();
+         it != cells.end(); ++it) {
+        result[(*it)->getModelName()] = (*it)->value();
+    }
+
+    return result;
+}
+
+BOOST_AUTO_TEST_CASE(snapshot_restore)
+{
+    const std::string filename("test_snapshot.snap");
+    utils::ModuleManager modules;
+    vpz::Dynamics dyns;
+    vpz::Classes classes;
+    vpz::Experiment expe;
+    expe.setName("torus");
+    expe.setSeed(42);
+
+    States expected;
+
+    {
+        vpz::AtomicModelVector models;
+        vpz::CoupledModel* top = torus::build(5, models);
+        devs::RootCoordinator root(modules);
+        devs::Coordinator coord(modules, dyns, classes, expe, root);
+        std::vector < torus::Cell* > cells = attach(coord, root, expe, top);
+
+        for (std::size_t i = 0; i < cells.size(); ++i) {
+            devs::Simulator* sim = coord.getModel(cells[i]->getModelName());
+            coord.eventtable().putInternalEvent(sim->init(0.0));
+        }
+
+        /* stop after the internal transitions at 5: the outputs of the
+         * cells are waiting for the next bag. */
+        while (coord.getNextTime() < 5.0) {
+            coord.run();
+        }
+        coord.run();
+
+        devs::Snapshot snapshot;
+        snapshot.capture(coord, top, root.rand(), root.replica(), 20.0);
+        BOOST_REQUIRE_EQUAL(snapshot.time(), 5.0);
+        snapshot.write(filename);
+
+        while (coord.getNextTime() <= 20.0) {
+            coord.run();
+        }
+
+        expected = states(cells);
+        BOOST_REQUIRE_EQUAL(expected.size(), 25u);
+
+        delete top;
+    }
+
+    {
+        devs::Snapshot snapshot;
+        snapshot.read(filename);
+        BOOST_REQUIRE_EQUAL(snapshot.time(), 5.0);
+        BOOST_REQUIRE_EQUAL(snapshot.end(), 20.0);
+
+        vpz::Vpz vpz;
+        snapshot.project(vpz);
+        BOOST_REQUIRE_EQUAL(vpz.project().experiment().name(), "torus");
+        BOOST_REQUIRE_EQUAL(vpz.project().experiment().seed(), 42u);
+
+        vpz::BaseModel* top = vpz.project().model().model();
+        BOOST_REQUIRE(top);
+
+        devs::RootCoordinator root(modules);
+        devs::Coordinator coord(modules, vpz.project().dynamics(),
+                                vpz.project().classes(),
+                                vpz.project().experiment(), root);
+        std::vector < torus::Cell* > cells = attach(coord, root,
+                                             vpz.project().experiment(),
+                                             top);
+
+        coord.eventtable().setCurrentTime(snapshot.time());
+        snapshot.restore(coord, top);
+        BOOST_REQUIRE_EQUAL(coord.getNextTime(), 5.0);
+
+        while (coord.getNextTime() <= 20.0) {
+            coord.run();
+        }
+
+        BOOST_REQUIRE(states(cells) == expected);
+
+        delete top;
+    }
+
+    std::remove(filename.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(snapshot_unsupported)
+{
+    utils::ModuleManager modules;
+    utils::PackageTable packages;
+    vpz::Dynamics dyns;
+    vpz::Classes classes;
+    vpz::Experiment expe;
+
+    vpz::CoupledModel* top = new vpz::CoupledModel("top", 0);
+    vpz::AtomicModel* mdl = top->addAtomicModel("passive");
+
+    {
+        devs::RootCoordinator root(modules);
+        devs::Coordinator coord(modules, dyns, classes, expe, root);
+
+        devs::Simulator* sim = new devs::Simulator(mdl);
+        devs::InitEventList events;
+        Passive* passive = new Passive(
+            devs::DynamicsInit(*mdl, packages.get("test")), events);
+        sim->addDynamics(passive);
+        coord.addModel(mdl, sim);
+
+        devs::Snapshot snapshot;
+        BOOST_REQUIRE_THROW(snapshot.capture(coord, top, root.rand(),
+                                             root.replica(), 1.0),
+                            utils::ModellingError);
+        BOOST_REQUIRE_THROW(passive->deserialize(value::Integer(0)),
+                            utils::ModellingError);
+    }
+
+    delete top;
+}
+
+BOOST_AUTO_TEST_CASE(snapshot_writer_error)
+{
+    const std::string filename("test_snapshot_missing/test.snap");
+    utils::ModuleManager modules;
+    vpz::Dynamics dyns;
+    vpz::Classes classes;
+    vpz::Experiment expe;
+
+    vpz::AtomicModelVector models;
+    vpz::CoupledModel* top = torus::build(2, models);
+
+    {
+        devs::RootCoordinator root(modules);
+        devs::Coordinator coord(modules, dyns, classes, expe, root);
+        attach(coord, root, expe, top);
+
+        devs::SnapshotWriter writer;
+        devs::Snapshot* snapshot = new devs::Snapshot();
+        snapshot->capture(coord, top, root.rand(), root.replica(), 1.0);
+        writer.write(snapshot, filename);
+        BOOST_REQUIRE_THROW(writer.wait(), utils::FileError);
+        BOOST_REQUIRE_NO_THROW(writer.wait());
+
+        /* the destructor reports the error of the last snapshot. */
+        snapshot = new devs::Snapshot();
+        snapshot->capture(coord, top, root.rand(), root.replica(), 1.0);
+        writer.write(snapshot, filename);
+    }
+
+    delete top;
+}
+
+BOOST_AUTO_TEST_CASE(snapshot_corrupted)
+{
+    const std::string filename("test_snapshot.bad");
+
+    {
+        std::ofstream out(filename.c_str(), std::ios::binary);
+        out << "VLESNAPS but not a snapshot";
+    }
+
+    devs::Snapshot snapshot;
+    BOOST_REQUIRE_THROW(snapshot.read(filename), utils::FileError);
+    BOOST_REQUIRE_THROW(snapshot.read("test_snapshot.none"),
+                        utils::FileError);
+
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,359 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * The torus of cells shared by the tests and the benchmarks of the
+ * parallel bags, the partitions and the snapshots.
+ */
+
+#ifndef VLE_DEVS_TEST_TORUS_HPP
+#define VLE_DEVS_TEST_TORUS_HPP
+
+#include <vle/devs/Coordinator.hpp>
+#include <vle/devs/RootCoordinator.hpp>
+#include <vle/devs/Dynamics.hpp>
+#include <vle/vpz/CoupledModel.hpp>
+#include <vle/vpz/AtomicModel.hpp>
+#include <vle/vpz/Experiment.hpp>
+#include <vle/value/Integer.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Set.hpp>
+#include <vle/utils/PackageTable.hpp>
+#include <vle/utils/Exception.hpp>
+#include <boost/lexical_cast.hpp>
+#include <string>
+#include <vector>
+
+namespace torus {
+
+using namespace vle;
+
+/*
+ * The options of the cells.
+ * - work: the number of xorshift rounds of an internal transition.
+ * - random: mix a number of the random stream of the model into the state.
+ * - scalars: send the state as a scalar attribute, read by the neighbours
+ *   from the map of attributes, so the targets share the payload.
+ * - sources: send the index of the cell and record, for each external
+ *   transition, the indices of the sources of the events.
+ * - failure: the date from which the internal transition of the cells 3,
+ *   10, 17... throws an utils::ModellingError.
+ */
+struct Options
+{
+    Options()
+        : work(64), random(false), scalars(false), sources(false),
+        failure(devs::infinity)
+    {}
+
+    unsigned int work;
+    bool         random;
+    bool         scalars;
+    bool         sources;
+    devs::Time   failure;
+};
+
+/*
+ * A cell of a torus: each time unit, the cell sends its state to its four
+ * neighbours and mixes its state with the sum of the received states. The
+ * state is stored into the snapshots.
+ */
+class Cell : public devs::Dynamics
+{
+public:
+    Cell(const devs::DynamicsInit& init, const devs::InitEventList& events,
+         int index, const Options& options)
+        : devs::Dynamics(init, events), m_value(index * 2654435761u),
+        m_sum(0), m_next(0.0), m_last(0.0), m_index(index),
+        m_options(options)
+    {
+        if (index % 7 != 3) {
+            m_options.failure = devs::infinity;
+        }
+    }
+
+    virtual devs::Time init(const devs::Time& time)
+    {
+        m_last = time;
+        m_next = time + 1.0;
+        return 1.0;
+    }
+
+    virtual void output(const devs::Time& /* time */,
+                        devs::ExternalEventList& output) const
+    {
+        devs::ExternalEvent* evt = new devs::ExternalEvent("out");
+        if (m_options.scalars) {
+            evt << devs::attribute("value", static_cast < int >(m_value));
+        } else {
+            evt->putAttribute("value", value::Integer::create(m_value));
+        }
+        if (m_options.sources) {
+            evt << devs::attribute("source", m_index);
+        }
+        output.push_back(evt);
+    }
+
+    virtual devs::Time timeAdvance() const
+    { return m_next - m_last; }
+
+    virtual void internalTransition(const devs::Time& time)
+    {
+        if (time >= m_options.failure) {
+            throw utils::ModellingError(getModelName());
+        }
+
+        uint32_t x = m_value ^ m_sum;
+        if (m_options.random) {
+            x ^= randStream().getInt();
+        }
+        for (unsigned int i = 0; i < m_options.work; ++i) {
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+        }
+        m_value = x;
+        m_sum = 0;
+        m_last = time;
+        m_next = time + 1.0;
+    }
+
+    virtual void externalTransition(const devs::ExternalEventList& events,
+                                    const devs::Time& time)
+    {
+        if (m_options.sources) {
+            m_sources.push_back(std::vector < int >());
+        }
+
+        for (devs::ExternalEventList::const_iterator it = events.begin();
+             it != events.end(); ++it) {
+            const devs::ExternalEvent& evt(*(*it));
+            if (m_options.scalars) {
+                m_sum += evt.getAttributes().getInt("value");
+            } else {
+                m_sum += evt.getIntegerAttributeValue("value");
+            }
+            if (m_options.sources) {
+                m_sources.back().push_back(
+                    evt.getIntegerAttributeValue("source"));
+            }
+        }
+        m_last = time;
+    }
+
+    virtual value::Value* serialize() const
+    {
+        value::Set* state = new value::Set();
+        state->add(value::Integer::create(m_value));
+        state->add(value::Integer::create(m_sum));
+        state->add(value::Double::create(m_next));
+        state->add(value::Double::create(m_last));
+        return state;
+    }
+
+    virtual void deserialize(const value::Value& state)
+    {
+        const value::Set& set(state.toSet());
+        m_value = set.getInt(0);
+        m_sum = set.getInt(1);
+        m_next = set.getDouble(2);
+        m_last = set.getDouble(3);
+    }
+
+    uint32_t value() const
+    { return m_value; }
+
+    /*
+     * The indices of the sources of the events of each external
+     * transition, in the order of the bag.
+     */
+    const std::vector < std::vector < int > >& sources() const
+    { return m_sources; }
+
+private:
+    uint32_t   m_value;
+    uint32_t   m_sum;
+    devs::Time m_next;
+    devs::Time m_last;
+    int        m_index;
+    Options    m_options;
+    std::vector < std::vector < int > > m_sources;
+};
+
+/*
+ * Build a torus of side x side atomic models, children of the top model.
+ * The models are appended to models, row by row.
+ */
+inline vpz::CoupledModel* build(int side, vpz::AtomicModelVector& models)
+{
+    vpz::CoupledModel* top = new vpz::CoupledModel("top", 0);
+    std::size_t first = models.size();
+
+    for (int i = 0; i < side * side; ++i) {
+        vpz::AtomicModel* mdl = top->addAtomicModel(
+            boost::lexical_cast < std::string >(i));
+        mdl->addInputPort("in");
+        mdl->addOutputPort("out");
+        models.push_back(mdl);
+    }
+
+    for (int i = 0; i < side * side; ++i) {
+        int x = i % side, y = i / side;
+        int neighbours[4] = { ((x + 1) % side) + y * side,
+            ((x + side - 1) % side) + y * side,
+            x + ((y + 1) % side) * side,
+            x + ((y + side - 1) % side) * side };
+
+        for (int j = 0; j < 4; ++j) {
+            top->addInternalConnection(models[first + i], "out",
+                                       models[first + neighbours[j]], "in");
+        }
+    }
+
+    return top;
+}
+
+/*
+ * Build the same torus where each row is a coupled model: the children of
+ * the top model are the rows, the units of the partitions.
+ */
+inline vpz::CoupledModel* buildRows(int side, vpz::AtomicModelVector& models)
+{
+    vpz::CoupledModel* top = new vpz::CoupledModel("top", 0);
+    std::vector < vpz::CoupledModel* > rows;
+    std::size_t first = models.size();
+
+    for (int y = 0; y < side; ++y) {
+        vpz::CoupledModel* row = top->addCoupledModel(
+            boost::lexical_cast < std::string >(y));
+        rows.push_back(row);
+
+        for (int x = 0; x < side; ++x) {
+            std::string port(boost::lexical_cast < std::string >(x));
+            vpz::AtomicModel* mdl = row->addAtomicModel(port);
+            mdl->addInputPort("in");
+            mdl->addOutputPort("out");
+            row->addInputPort("in" + port);
+            row->addOutputPort("out" + port);
+            models.push_back(mdl);
+        }
+    }
+
+    for (int y = 0; y < side; ++y) {
+        for (int x = 0; x < side; ++x) {
+            std::string port(boost::lexical_cast < std::string >(x));
+            vpz::AtomicModel* mdl = models[first + x + y * side];
+
+            rows[y]->addInternalConnection(
+                mdl, "out", models[first + (x + 1) % side + y * side], "in");
+            rows[y]->addInternalConnection(
+                mdl, "out", models[first + (x + side - 1) % side + y * side],
+                "in");
+            rows[y]->addOutputConnection(mdl, "out", "out" + port);
+            rows[y]->addInputConnection("in" + port, mdl, "in");
+
+            top->addInternalConnection(rows[y], "out" + port,
+                                       rows[(y + 1) % side], "in" + port);
+            top->addInternalConnection(rows[y], "out" + port,
+                                       rows[(y + side - 1) % side],
+                                       "in" + port);
+        }
+    }
+
+    return top;
+}
+
+/*
+ * Attach a Cell to each model, the index of a cell is its position in
+ * models, and build the targets of the simulators. The initial events are
+ * not scheduled, see start().
+ */
+inline std::vector < Cell* > attach(devs::Coordinator& coord,
+                                    devs::RootCoordinator& root,
+                                    const vpz::Experiment& expe,
+                                    const vpz::AtomicModelVector& models,
+                                    const Options& options = Options())
+{
+    static utils::PackageTable packages;
+    std::vector < Cell* > cells;
+
+    for (std::size_t i = 0; i < models.size(); ++i) {
+        devs::Simulator* sim = new devs::Simulator(models[i]);
+        devs::InitEventList events;
+        Cell* cell = new Cell(
+            devs::DynamicsInit(*models[i], packages.get("test"),
+                               expe.seed(), root.replica()),
+            events, i, options);
+        sim->addDynamics(cell);
+        cells.push_back(cell);
+        coord.addModel(models[i], sim);
+    }
+
+    coord.buildSimulatorsTarget(models);
+    return cells;
+}
+
+/*
+ * Schedule the initial events of the models at 0.
+ */
+inline void start(devs::Coordinator& coord,
+                  const vpz::AtomicModelVector& models)
+{
+    for (std::size_t i = 0; i < models.size(); ++i) {
+        devs::Simulator* sim = coord.getModel(models[i]);
+        coord.eventtable().putInternalEvent(sim->init(0.0));
+    }
+}
+
+/*
+ * Run the bags until the date.
+ */
+inline void run(devs::Coordinator& coord, const devs::Time& duration)
+{
+    while (coord.getNextTime() <= duration) {
+        coord.run();
+    }
+}
+
+/*
+ * Get the states of the cells.
+ */
+inline std::vector < uint32_t > values(const std::vector < Cell* >& cells)
+{
+    std::vector < uint32_t > result;
+
+    for (std::vector < Cell* >::const_iterator it = cells.begin();
+         it != cells.end(); ++it) {
+        result.push_back((*it)->value());
+    }
+
+    return result;
+}
+
+} // namespace torus
+
+#endif
@@ -0,0 +1,358 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#define BOOST_TEST_MAIN
+#define BOOST_AUTO_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE devsview_test
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+#include <vle/oov/Plugin.hpp>
+#include <vle/oov/Row.hpp>
+#include <vle/oov/Trace.hpp>
+#include <vle/utils/ModuleManager.hpp>
+#include <vle/value/Map.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Integer.hpp>
+#include <vle/value/String.hpp>
+#include <cstdio>
+#include <vector>
+
+using namespace vle;
+
+/*
+ * A plug-in which only implements the oov::Plugin::onValue function to
+ * check the default oov::Plugin::onRow adapter.
+ */
+class Recorder : public oov::Plugin
+{
+public:
+    Recorder()
+        : oov::Plugin(std::string())
+    {}
+
+    virtual ~Recorder()
+    {
+        for (std::vector < value::Value* >::iterator it = values.begin();
+             it != values.end(); ++it) {
+            delete *it;
+        }
+    }
+
+    virtual void onParameter(const std::string&, const std::string&,
+                             const std::string&, value::Value* parameters,
+                             const double&)
+    { delete parameters; }
+
+    virtual void onNewObservable(const std::string&, const std::string&,
+                                 const std::string&, const std::string&,
+                                 const double&)
+    {}
+
+    virtual void onDelObservable(const std::string&, const std::string&,
+                                 const std::string&, const std::string&,
+                                 const double&)
+    {}
+
+    virtual void onValue(const std::string& simulator,
+                         const std::string& /*parent*/,
+                         const std::string& port,
+                         const std::string& view,
+                         const double& time,
+                         value::Value* value)
+    {
+        names.push_back(view + ":" + simulator + "." + port);
+        times.push_back(time);
+        values.push_back(value);
+    }
+
+    virtual void close(const double&)
+    {}
+
+    std::vector < std::string > names;
+    std::vector < double > times;
+    std::vector < value::Value* > values;
+};
+
+BOOST_AUTO_TEST_CASE(row_lanes)
+{
+    oov::Row row("view");
+
+    oov::Row::size_type a = row.addColumn(oov::Column("a", "top", "x"));
+    oov::Row::size_type b = row.addColumn(oov::Column("b", "top", "y"));
+    oov::Row::size_type c = row.addColumn(oov::Column("c", "top", "z"));
+    oov::Row::size_type d = row.addColumn(oov::Column("d", "top", "w"));
+
+    BOOST_REQUIRE_EQUAL(row.size(), 4u);
+    BOOST_REQUIRE_EQUAL(row.used(), 4u);
+
+    row.reset(1.0);
+    row.put(a, value::Double::create(1.5));
+    row.put(b, value::Integer::create(7));
+    row.put(c, value::String::create("hello"));
+    row.putReal(d, 2.5);
+
+    BOOST_REQUIRE_EQUAL(row.time(), 1.0);
+    BOOST_REQUIRE_EQUAL(row.type(a), oov::Row::REAL);
+    BOOST_REQUIRE_EQUAL(row.getReal(a), 1.5);
+    BOOST_REQUIRE_EQUAL(row.type(b), oov::Row::INTEGER);
+    BOOST_REQUIRE_EQUAL(row.getInteger(b), 7);
+    BOOST_REQUIRE_EQUAL(row.type(c), oov::Row::VALUE);
+    BOOST_REQUIRE_EQUAL(value::toString(row.getValue(c)), "hello");
+    BOOST_REQUIRE_EQUAL(row.type(d), oov::Row::REAL);
+    BOOST_REQUIRE(not row.getValue(d));
+
+    value::Value* val = row.take(d);
+    BOOST_REQUIRE(val);
+    BOOST_REQUIRE_EQUAL(value::toDouble(val), 2.5);
+    delete val;
+
+    row.reset(2.0);
+    BOOST_REQUIRE_EQUAL(row.type(a), oov::Row::EMPTY);
+    BOOST_REQUIRE(not row.getValue(c));
+    BOOST_REQUIRE(not row.take(a));
+
+    row.delColumn(b);
+    BOOST_REQUIRE_EQUAL(row.type(b), oov::Row::NONE);
+    BOOST_REQUIRE_EQUAL(row.used(), 3u);
+    BOOST_REQUIRE_EQUAL(row.addColumn(oov::Column("e", "top", "v")), b);
+    BOOST_REQUIRE_EQUAL(row.column(b).simulator, "e");
+    BOOST_REQUIRE_EQUAL(row.size(), 4u);
+}
+
+BOOST_AUTO_TEST_CASE(plugin_row_adapter)
+{
+    oov::Row row("view");
+    Recorder plugin;
+
+    row.reset(0.0);
+    plugin.onRow(row);
+
+    BOOST_REQUIRE_EQUAL(plugin.names.size(), 1u);
+    BOOST_REQUIRE_EQUAL(plugin.names[0], "view:.");
+    BOOST_REQUIRE(not plugin.values[0]);
+
+    oov::Row::size_type a = row.addColumn(oov::Column("a", "top", "x"));
+    oov::Row::size_type b = row.addColumn(oov::Column("b", "top", "y"));
+    oov::Row::size_type c = row.addColumn(oov::Column("c", "top", "z"));
+    row.delColumn(a);
+
+    row.reset(3.0);
+    row.put(b, value::Integer::create(4));
+    row.put(c, 0);
+    plugin.onRow(row);
+
+    BOOST_REQUIRE_EQUAL(plugin.names.size(), 3u);
+    BOOST_REQUIRE_EQUAL(plugin.names[1], "view:b.y");
+    BOOST_REQUIRE_EQUAL(plugin.times[1], 3.0);
+    BOOST_REQUIRE_EQUAL(value::toInteger(plugin.values[1]), 4);
+    BOOST_REQUIRE_EQUAL(plugin.names[2], "view:c.z");
+    BOOST_REQUIRE(not plugin.values[2]);
+    BOOST_REQUIRE(not row.getValue(b));
+}
+
+BOOST_AUTO_TEST_CASE(row_swap_lanes)
+{
+    oov::Row producer("view");
+    oov::Row consumer("view");
+    oov::Row::Lanes lanes;
+
+    oov::Row::size_type a = producer.addColumn(oov::Column("a", "top", "x"));
+    oov::Row::size_type b = producer.addColumn(oov::Column("b", "top", "y"));
+    consumer.addColumn(oov::Column("a", "top", "x"));
+    consumer.addColumn(oov::Column("b", "top", "y"));
+
+    producer.reset(1.0);
+    producer.put(a, value::Double::create(0.5));
+    producer.put(b, value::String::create("msg"));
+    producer.swap(lanes);
+
+    BOOST_REQUIRE_EQUAL(lanes.time, 1.0);
+    BOOST_REQUIRE_EQUAL(lanes.values.size(), 2u);
+    BOOST_REQUIRE_EQUAL(producer.size(), 2u);
+
+    producer.reset(2.0);
+    BOOST_REQUIRE_EQUAL(producer.type(a), oov::Row::EMPTY);
+
+    consumer.swap(lanes);
+    BOOST_REQUIRE_EQUAL(consumer.time(), 1.0);
+    BOOST_REQUIRE_EQUAL(consumer.type(a), oov::Row::REAL);
+    BOOST_REQUIRE_EQUAL(consumer.getReal(a), 0.5);
+    BOOST_REQUIRE_EQUAL(value::toString(consumer.getValue(b)), "msg");
+
+    producer.delColumn(a);
+    producer.reset(3.0);
+    BOOST_REQUIRE_EQUAL(producer.type(a), oov::Row::NONE);
+    BOOST_REQUIRE_EQUAL(producer.type(b), oov::Row::EMPTY);
+
+    lanes.clear();
+}
+
+/*
+ * A trace reader which keeps the non numeric values replayed by
+ * oov::TraceReader::play instead of sending them to a plug-in.
+ */
+class TraceReplay : public oov::TraceReader
+{
+public:
+    TraceReplay(const utils::ModuleManager& modulemgr)
+        : oov::TraceReader(modulemgr)
+    {}
+
+    virtual ~TraceReplay()
+    {
+        for (std::vector < value::Value* >::iterator it = values.begin();
+             it != values.end(); ++it) {
+            delete *it;
+        }
+    }
+
+    virtual void onParameter(const std::string& /* plugin */,
+                             const std::string& /* package */,
+                             const std::string& /* location */,
+                             const std::string& /* file */,
+                             value::Value* parameters,
+                             const double& /* time */)
+    { delete parameters; }
+
+    virtual void onNewObservable(const std::string& /* simulator */,
+                                 const std::string& /* parent */,
+                                 const std::string& /* portname */,
+                                 const std::string& /* view */,
+                                 const double& /* time */)
+    {}
+
+    virtual void onDelObservable(const std::string& /* simulator */,
+                                 const std::string& /* parent */,
+                                 const std::string& /* portname */,
+                                 const std::string& /* view */,
+                                 const double& /* time */)
+    {}
+
+    virtual void onValue(const std::string& /* simulator */,
+                         const std::string& /* parent */,
+                         const std::string& /* port */,
+                         const std::string& /* view */,
+                         const double& /* time */,
+                         value::Value* value)
+    {
+        if (value and (value->isString() or value->isMap())) {
+            values.push_back(value);
+        } else {
+            delete value;
+        }
+    }
+
+    virtual void onClose(const double& /* time */)
+    {}
+
+    std::vector < value::Value* > values;
+};
+
+BOOST_AUTO_TEST_CASE(trace_roundtrip)
+{
+    {
+        oov::TracePlugin plugin(".");
+        value::Map* parameters = value::Map::create();
+        parameters->addInt("rows", 2);
+        plugin.onParameter("trace", ".", "trace_roundtrip", parameters, 0.0);
+        BOOST_REQUIRE_EQUAL(plugin.filename(), "./trace_roundtrip.trace");
+
+        oov::Row row("view");
+        oov::Row::size_type a = row.addColumn(oov::Column("a", "top", "x"));
+        oov::Row::size_type b = row.addColumn(oov::Column("b", "top", "y"));
+        plugin.onNewObservable("a", "top", "x", "view", 0.0);
+        plugin.onNewObservable("b", "top", "y", "view", 0.0);
+
+        for (int i = 0; i < 5; ++i) {
+            row.reset(i);
+            row.putReal(a, i * 0.5);
+            if (i % 2) {
+                row.putInteger(b, i);
+            } else if (i == 4) {
+                value::Map* map = value::Map::create();
+                map->addString("key", "msg");
+                row.put(b, map);
+            } else {
+                row.put(b, value::String::create("msg"));
+            }
+            plugin.onRow(row);
+        }
+
+        plugin.onDelObservable("a", "top", "x", "view", 5.0);
+        row.delColumn(a);
+        plugin.onNewObservable("c", "top", "z", "view", 5.0);
+        oov::Row::size_type c = row.addColumn(oov::Column("c", "top", "z"));
+        BOOST_REQUIRE_EQUAL(c, a);
+
+        row.reset(6.0);
+        row.putReal(c, 42.0);
+        plugin.onRow(row);
+        plugin.close(6.0);
+    }
+
+    utils::ModuleManager modulemgr;
+    oov::TraceReader reader(modulemgr);
+    reader.open("./trace_roundtrip.trace");
+
+    BOOST_REQUIRE_EQUAL(reader.columns().size(), 3u);
+    BOOST_REQUIRE_EQUAL(reader.columns()[0].column.simulator, "a");
+    BOOST_REQUIRE_EQUAL(reader.columns()[0].removed, 5.0);
+    BOOST_REQUIRE_EQUAL(reader.columns()[2].column.port, "z");
+    BOOST_REQUIRE_EQUAL(reader.columns()[2].id, reader.columns()[0].id);
+    BOOST_REQUIRE_EQUAL(reader.begin(), 0.0);
+    BOOST_REQUIRE_EQUAL(reader.end(), 6.0);
+
+    std::vector < double > dates, values;
+    BOOST_REQUIRE_EQUAL(reader.read(0, 1.0, 10.0, dates, values), 4u);
+    BOOST_REQUIRE_EQUAL(dates[0], 1.0);
+    BOOST_REQUIRE_EQUAL(values[3], 2.0);
+
+    dates.clear();
+    values.clear();
+    BOOST_REQUIRE_EQUAL(reader.read(1, 0.0, 10.0, dates, values), 2u);
+    BOOST_REQUIRE_EQUAL(dates[1], 3.0);
+    BOOST_REQUIRE_EQUAL(values[1], 3.0);
+
+    dates.clear();
+    values.clear();
+    BOOST_REQUIRE_EQUAL(reader.read(2, 0.0, 10.0, dates, values), 1u);
+    BOOST_REQUIRE_EQUAL(values[0], 42.0);
+
+    BOOST_REQUIRE_THROW(reader.read(3, 0.0, 1.0, dates, values),
+                        utils::ArgError);
+
+    TraceReplay replay(modulemgr);
+    replay.open("./trace_roundtrip.trace");
+    replay.play("dummy", "", ".", 0.0, 10.0);
+    BOOST_REQUIRE_EQUAL(replay.values.size(), 3u);
+    BOOST_REQUIRE_EQUAL(value::toString(replay.values[0]), "msg");
+    BOOST_REQUIRE_EQUAL(value::toString(replay.values[1]), "msg");
+    BOOST_REQUIRE_EQUAL(replay.values[2]->toMap().getString("key"), "msg");
+    BOOST_REQUIRE_THROW(reader.open("./trace_missing.trace"),
+                        utils::FileError);
+
+    std::remove("./trace_roundtrip.trace");
+}
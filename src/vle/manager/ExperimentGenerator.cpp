@@ -29,6 +29,8 @@
 #include <vle/vpz/Condition.hpp>
 #include <vle/vpz/Vpz.hpp>
 #include <vle/vpz/BaseModel.hpp>
+#include <algorithm>
+#include <limits>
 
 
 namespace vle { namespace manager {
@@ -42,47 +44,121 @@ class ExperimentGenerator::Pimpl
     Pimpl(const Pimpl& other);
     Pimpl& operator=(const Pimpl& other);
 
-    int computeMaximumValue()
+    enum Design { LINEAR, TOTAL, SAMPLED };
+
+    /**
+     * A factor of the experimental design: a port of a condition and its
+     * values.
+     */
+    struct Factor
+    {
+        std::string      condition;
+        std::string      port;
+        const value::Set *values;
+        uint32_t         radix; /**< total: product of the sizes of the
+                                  following factors. */
+    };
+
+    struct FactorCompare
     {
-        int result = 0;
+        bool operator()(const Factor& lhs,
+                        const std::pair < std::string, std::string >& rhs)
+            const
+        {
+            return lhs.condition < rhs.first or
+                (lhs.condition == rhs.first and lhs.port < rhs.second);
+        }
+    };
 
+    void buildFactors()
+    {
         const vpz::Conditions& cnds(mVpz.project().experiment().conditions());
 
-        vpz::ConditionList::const_iterator it = cnds.conditionlist().begin();
-        while (it != cnds.conditionlist().end()) {
-            const vpz::Condition& cnd(it->second);
-            vpz::ConditionValues::const_iterator jt;
-
-            if (not cnd.conditionvalues().empty()) {
-                for (jt = cnd.conditionvalues().begin(); jt !=
-                     cnd.conditionvalues().end(); ++jt) {
-
-                    int conditionsize = jt->second->size();
-
-                    if (result == 0 or result == 1) {
-                        result = conditionsize;
-                    } else {
-                        if (conditionsize != 0 and conditionsize != 1
-                            and result != conditionsize) {
-                            throw utils::InternalError(
-                                fmt(_("ExperimentGenerator: bad combination "
-                                      "size for the condition `%1%' port "
-                                      "`%2%': %3%")) % it->first % jt->first %
-                                conditionsize);
-                        }
-                    }
+        for (vpz::ConditionList::const_iterator it = cnds.begin();
+             it != cnds.end(); ++it) {
+            const vpz::ConditionValues& cnv(it->second.conditionvalues());
+
+            for (vpz::ConditionValues::const_iterator jt = cnv.begin();
+                 jt != cnv.end(); ++jt) {
+                Factor factor;
+
+                factor.condition = it->first;
+                factor.port = jt->first;
+                factor.values = jt->second;
+                factor.radix = 1;
+                mFactors.push_back(factor);
+            }
+        }
+    }
+
+    uint32_t computeLinearSize()
+    {
+        uint32_t result = 0;
+
+        for (std::vector < Factor >::const_iterator it = mFactors.begin();
+             it != mFactors.end(); ++it) {
+            uint32_t conditionsize = it->values->size();
+
+            if (result == 0 or result == 1) {
+                result = conditionsize;
+            } else {
+                if (conditionsize != 0 and conditionsize != 1
+                    and result != conditionsize) {
+                    throw utils::InternalError(
+                        fmt(_("ExperimentGenerator: bad combination "
+                              "size for the condition `%1%' port "
+                              "`%2%': %3%")) % it->condition % it->port %
+                        conditionsize);
                 }
-                ++it;
             }
         }
 
         return result;
     }
 
-    void computeRange()
+    uint32_t computeTotalSize()
+    {
+        uint64_t result = mFactors.empty() ? 0 : 1;
+
+        for (std::vector < Factor >::reverse_iterator it = mFactors.rbegin();
+             it != mFactors.rend(); ++it) {
+            it->radix = result;
+            result *= it->values->size();
+
+            if (result > std::numeric_limits < uint32_t >::max()) {
+                throw utils::InternalError(
+                    _("ExperimentGenerator: too many combinations in the "
+                      "total experimental design"));
+            }
+        }
+
+        return result;
+    }
+
+    void computeSize()
     {
-        mCompleteSize = computeMaximumValue();
+        const vpz::Experiment& exp(mVpz.project().experiment());
+
+        if (exp.combination() == "total") {
+            mDesign = TOTAL;
+            mCompleteSize = computeTotalSize();
+        } else if (exp.combination() == "sampled") {
+            if (exp.samples() == 0) {
+                throw utils::InternalError(
+                    _("ExperimentGenerator: the sampled experimental design "
+                      "needs a number of samples"));
+            }
 
+            mDesign = SAMPLED;
+            mCompleteSize = exp.samples();
+        } else {
+            mDesign = LINEAR;
+            mCompleteSize = computeLinearSize();
+        }
+    }
+
+    void computeRange()
+    {
         uint32_t number = mCompleteSize / mWorld;
 
         if (number > 0) {
@@ -103,6 +179,93 @@ class ExperimentGenerator::Pimpl
                 mMax = modulo;
             }
         }
+
+        if (mDistribution == STRIDED) {
+            mFirst = mRank;
+            mCount = mRank < mCompleteSize ?
+                (mCompleteSize - mRank - 1) / mWorld + 1 : 0;
+        } else {
+            uint32_t rest = mCompleteSize % mWorld;
+
+            mFirst = number * mRank + std::min(mRank, rest);
+            mCount = number + (mRank < rest ? 1 : 0);
+        }
+    }
+
+    static uint32_t hash(uint32_t x)
+    {
+        x ^= x >> 16;
+        x *= 0x85ebca6bU;
+        x ^= x >> 13;
+        x *= 0xc2b2ae35U;
+        x ^= x >> 16;
+
+        return x;
+    }
+
+    /**
+     * A pseudo-random permutation of [0, mCompleteSize): a four rounds
+     * Feistel network over the smallest even power of two greater or
+     * equal to the size, walked until the result falls into the range.
+     */
+    uint32_t permute(uint32_t index, uint32_t key) const
+    {
+        uint32_t half = 1;
+        while ((uint64_t)1 << (2 * half) < mCompleteSize) {
+            ++half;
+        }
+
+        const uint32_t mask = (1u << half) - 1;
+
+        do {
+            uint32_t left = index >> half;
+            uint32_t right = index & mask;
+
+            for (uint32_t round = 0; round < 4; ++round) {
+                uint32_t tmp = right;
+                right = left ^ (hash(right ^ hash(key * 4 + round)) & mask);
+                left = tmp;
+            }
+
+            index = (left << half) | right;
+        } while (index >= mCompleteSize);
+
+        return index;
+    }
+
+    uint32_t level(uint32_t index, std::size_t factor) const
+    {
+        const Factor& f(mFactors[factor]);
+        uint32_t size = f.values->size();
+
+        if (size == 1) {
+            return 0;
+        }
+
+        uint32_t result = index;
+
+        if (size > 0) {
+            switch (mDesign) {
+            case TOTAL:
+                result = (index / f.radix) % size;
+                break;
+            case SAMPLED:
+                result = ((uint64_t)permute(index, factor) * size) /
+                    mCompleteSize;
+                break;
+            case LINEAR:
+                break;
+            }
+        }
+
+        if (result >= size) {
+            throw utils::InternalError(fmt(
+                    _("ExperimentGenerator can not access to the index"
+                      " `%1%' of the condition `%2%' port `%3%' ")) %
+                index % f.condition % f.port);
+        }
+
+        return result;
     }
 
 public:
@@ -112,26 +275,39 @@ public:
     uint32_t mCompleteSize;
     uint32_t mMin;
     uint32_t mMax;
-
-    Pimpl(const std::string& filename, uint32_t rank, uint32_t size)
+    uint32_t mFirst;
+    uint32_t mCount;
+    Distribution mDistribution;
+    Design mDesign;
+    std::vector < Factor > mFactors;
+
+    Pimpl(const std::string& filename, uint32_t rank, uint32_t size,
+          Distribution distribution)
         : mVpz(filename), mRank(rank), mWorld(size), mCompleteSize(0), mMin(0),
-        mMax(0)
+        mMax(0), mFirst(0), mCount(0), mDistribution(distribution),
+        mDesign(LINEAR)
     {
         if (rank >= size) {
             throw utils::InternalError(_("Bad rank"));
         }
 
+        buildFactors();
+        computeSize();
         computeRange();
     }
 
-    Pimpl(const vpz::Vpz& vpz, uint32_t rank, uint32_t size)
+    Pimpl(const vpz::Vpz& vpz, uint32_t rank, uint32_t size,
+          Distribution distribution)
         : mVpz(vpz), mRank(rank), mWorld(size), mCompleteSize(0), mMin(0),
-        mMax(0)
+        mMax(0), mFirst(0), mCount(0), mDistribution(distribution),
+        mDesign(LINEAR)
     {
         if (rank >= size) {
             throw utils::InternalError(_("Bad rank"));
         }
 
+        buildFactors();
+        computeSize();
         computeRange();
     }
 
@@ -145,6 +321,7 @@ public:
         const vpz::Conditions& cnds(mVpz.project().experiment().conditions());
         conditions->deleteValueSet();
         vpz::ConditionList& cdldst(conditions->conditionlist());
+        std::size_t factor = 0;
 
         vpz::ConditionList::const_iterator it;
         for (it = cnds.begin(); it != cnds.end(); ++it) {
@@ -157,27 +334,44 @@ public:
             vpz::ConditionValues& cnvdst = r.first->second.conditionvalues();
 
             for (vpz::ConditionValues::const_iterator jt = cnvsrc.begin();
-                 jt != cnvsrc.end(); ++jt) {
+                 jt != cnvsrc.end(); ++jt, ++factor) {
 
                 value::Set *cpy = new value::Set();
-
-                if (jt->second->size() == 1) {
-                    cpy->add(jt->second->get(0)->clone());
-                } else if (jt->second->size() > 1 and jt->second->size() >
-                           index) {
-                    cpy->add(jt->second->get(index)->clone());
-                } else {
-                    throw utils::InternalError(fmt(
-                            _("ExperimentGenerator can not access to the index"
-                              " `%1%' of the condition `%2%' port `%3%' ")) %
-                        index % it->first % jt->first);
-                }
+                cpy->add(jt->second->get(level(index, factor))->clone());
 
                 delete cnvdst[jt->first];
                 cnvdst[jt->first] = cpy;
             }
         }
     }
+
+    const value::Value& get(uint32_t index, const std::string& condition,
+                            const std::string& port) const
+    {
+        std::pair < std::string, std::string > key(condition, port);
+        std::vector < Factor >::const_iterator it =
+            std::lower_bound(mFactors.begin(), mFactors.end(), key,
+                             FactorCompare());
+
+        if (it == mFactors.end() or it->condition != condition or
+            it->port != port) {
+            throw utils::ArgError(fmt(
+                    _("ExperimentGenerator: unknown condition `%1%' port "
+                      "`%2%'")) % condition % port);
+        }
+
+        const value::Value *result =
+            it->values->get(level(index, it - mFactors.begin()));
+
+        if (not result) {
+            throw utils::InternalError(fmt(
+                    _("ExperimentGenerator: null value at index `%1%' of the "
+                      "condition `%2%' port `%3%'")) % index % condition %
+                port);
+        }
+
+        return *result;
+    }
 };
 
 //
@@ -186,14 +380,16 @@ public:
 
 ExperimentGenerator::ExperimentGenerator(const std::string& vpz,
                                          uint32_t rank,
-                                         uint32_t size)
-    : mPimpl(new ExperimentGenerator::Pimpl(vpz, rank, size))
+                                         uint32_t size,
+                                         Distribution distribution)
+    : mPimpl(new ExperimentGenerator::Pimpl(vpz, rank, size, distribution))
 {
 }
 
 ExperimentGenerator::ExperimentGenerator(const vpz::Vpz& vpz, uint32_t rank,
-                                         uint32_t size)
-    : mPimpl(new ExperimentGenerator::Pimpl(vpz, rank, size))
+                                         uint32_t size,
+                                         Distribution distribution)
+    : mPimpl(new ExperimentGenerator::Pimpl(vpz, rank, size, distribution))
 {
 }
 
@@ -207,6 +403,33 @@ void ExperimentGenerator::get(uint32_t index, vpz::Conditions *conditions)
     mPimpl->get(index, conditions);
 }
 
+const value::Value& ExperimentGenerator::get(uint32_t index,
+                                             const std::string& condition,
+                                             const std::string& port) const
+{
+    return mPimpl->get(index, condition, port);
+}
+
+uint32_t ExperimentGenerator::count() const
+{
+    return mPimpl->mCount;
+}
+
+uint32_t ExperimentGenerator::at(uint32_t n) const
+{
+    if (n >= mPimpl->mCount) {
+        throw utils::ArgError(fmt(
+                _("ExperimentGenerator: experience `%1%' out of range "
+                  "(%2%)")) % n % mPimpl->mCount);
+    }
+
+    if (mPimpl->mDistribution == STRIDED) {
+        return mPimpl->mFirst + n * mPimpl->mWorld;
+    } else {
+        return mPimpl->mFirst + n;
+    }
+}
+
 uint32_t ExperimentGenerator::min() const
 {
     return mPimpl->mMin;
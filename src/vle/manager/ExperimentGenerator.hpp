@@ -39,6 +39,22 @@ namespace vle { namespace manager {
 /**
  * ExperimentGenerator build @e vpz::Conditions from an experimental frame.
  *
+ * Each port of the conditions is a factor of the experimental design and
+ * the values of the port are its levels. The combination attribute of the
+ * @e vpz::Experiment defines how an index is mapped to a level per factor:
+ * - @e linear (default): the factors with more than one value have the
+ *   same number of values N, the index @e i takes the @e i-th value of
+ *   each of them.
+ * - @e total: the full factorial design, the cartesian product of all the
+ *   factors. The last port of the last condition varies the fastest.
+ * - @e sampled: a Latin hypercube of @e samples points over the cartesian
+ *   product. Each factor gets a pseudo-random permutation of the points,
+ *   each value of a factor is taken by the same number of points (up to
+ *   one).
+ *
+ * The mapping is computed from the index, the sets of values are never
+ * expanded.
+ *
  * For example:
  * @code
  * ExperimentGenerator expgen("gens.vpz", 0, 10);
@@ -52,9 +68,9 @@ namespace vle { namespace manager {
  * assert(expgen.min() == 90);
  * assert(expgen.max() == 99);
  *
- * for (uint32_t i = expgen.min(); i < expgen.max(); ++i) {
+ * for (uint32_t i = 0; i < expgen.count(); ++i) {
  *   vpz::Conditions conds;
- *   expgen.get(i, &conds);
+ *   expgen.get(expgen.at(i), &conds);
  * }
  * @endcode
  *
@@ -64,16 +80,27 @@ namespace vle { namespace manager {
 class VLE_API ExperimentGenerator
 {
 public:
+    /**
+     * Defines how the combinations are distributed among the workers.
+     */
+    enum Distribution {
+        CONTIGUOUS, /**< A worker gets a block of consecutive indices. */
+        STRIDED     /**< The worker @e rank gets the indices @e rank, @e
+                     * rank + @e size, @e rank + 2 * @e size etc. */
+    };
+
     /**
      * Prepare the ExperimentGenerator to build @e vpz::Conditions.
      *
      * @param vpz The filename of a VPZ file.
      * @param rank The id of the worker.
      * @param size The number of workers for this experimental frame.
+     * @param distribution The distribution of the indices.
      *
      * @throw utils::Exception if the filename does not exist.
      */
-    ExperimentGenerator(const std::string& vpz, uint32_t rank, uint32_t size);
+    ExperimentGenerator(const std::string& vpz, uint32_t rank, uint32_t size,
+                        Distribution distribution = CONTIGUOUS);
 
     /**
      * Prepare the ExperimentGenerator to build @e vpz::Conditions.
@@ -81,22 +108,57 @@ public:
      * @param vpz A constant reference of a VPZ file (internally, cloned).
      * @param rank The id of the worker.
      * @param size The number of workers for this experimental frame.
+     * @param distribution The distribution of the indices.
      */
-    ExperimentGenerator(const vpz::Vpz& vpz, uint32_t rank, uint32_t size);
+    ExperimentGenerator(const vpz::Vpz& vpz, uint32_t rank, uint32_t size,
+                        Distribution distribution = CONTIGUOUS);
 
     ~ExperimentGenerator();
 
     /**
      * Get the conditions of the specified index.
      *
-     * The @e index parameter would be greater or equal to @e min() and lower
-     * the @e max().
+     * The @e index parameter would be lower than @e size().
      *
      * @param[in] index The index in the experiment generator table.
      * @param[out] conditions Conditions to fill with new conditions.
      */
     void get(uint32_t index, vpz::Conditions *conditions);
 
+    /**
+     * Get the value of a port of a condition for the specified index,
+     * without copy.
+     *
+     * @param index The index in the experiment generator table.
+     * @param condition The name of the condition.
+     * @param port The name of the port.
+     *
+     * @throw utils::ArgError if the port does not exist.
+     * @throw utils::InternalError if the port has no value for this index.
+     *
+     * @return A reference to the value stored in the experimental frame.
+     */
+    const value::Value& get(uint32_t index, const std::string& condition,
+                            const std::string& port) const;
+
+    /**
+     * The number of experiences produce by this worker.
+     *
+     * @return An integer lower or equal to @e size().
+     */
+    uint32_t count() const;
+
+    /**
+     * Get the index of the @e n-th experience produce by this worker.
+     *
+     * @param n An integer lower than @e count().
+     *
+     * @throw utils::ArgError if @e n is greater or equal to @e count().
+     *
+     * @return The index in the experiment generator table.
+     */
+    uint32_t at(uint32_t n) const;
+
     /**
      * The minimal index of experiences produce by the object.
      *
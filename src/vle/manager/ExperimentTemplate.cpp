@@ -0,0 +1,76 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <vle/manager/ExperimentTemplate.hpp>
+#include <vle/vpz/BaseModel.hpp>
+#include <vle/utils/Tools.hpp>
+
+namespace vle { namespace manager {
+
+ExperimentTemplate::ExperimentTemplate(const vpz::Vpz& vpz)
+    : mBase(new vpz::Vpz(vpz)), mName(vpz.project().experiment().name())
+{
+    mBase->project().dynamics().clear();
+    mBase->project().classes().clear();
+    mBase->project().experiment().conditions().deleteValueSet();
+}
+
+ExperimentTemplate::~ExperimentTemplate()
+{
+    delete mBase->project().model().model();
+    delete mBase;
+}
+
+vpz::Vpz * ExperimentTemplate::build(uint32_t index,
+                                     ExperimentGenerator& expgen) const
+{
+    vpz::Vpz *result = new vpz::Vpz(*mBase);
+
+    try {
+        result->project().setInstance(index);
+        result->project().experiment().setName(name(index));
+        expgen.get(index, &result->project().experiment().conditions());
+    } catch (...) {
+        delete result->project().model().model();
+        delete result;
+        throw;
+    }
+
+    return result;
+}
+
+std::string ExperimentTemplate::name(uint32_t index) const
+{
+    std::string result(mName);
+
+    result += '-';
+    result += utils::to < uint32_t >(index);
+
+    return result;
+}
+
+}} // namespace vle manager
@@ -0,0 +1,108 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef VLE_MANAGER_EXPERIMENTTEMPLATE_HPP
+#define VLE_MANAGER_EXPERIMENTTEMPLATE_HPP
+
+#include <vle/DllDefines.hpp>
+#include <vle/manager/ExperimentGenerator.hpp>
+#include <vle/vpz/Vpz.hpp>
+#include <string>
+
+namespace vle { namespace manager {
+
+/**
+ * ExperimentTemplate builds the experiments of the combinations of an
+ * experimental frame. It is used by the mono and threaded modes of the
+ * @e Manager and by mvle so that all of them name the experiments and
+ * number the replicas in the same way.
+ *
+ * The template is a copy of the experimental frame without dynamics,
+ * classes and condition values. The dynamics and the classes are read
+ * from the source project by the simulations (see @e Simulation::run())
+ * and the condition values of a combination are filled by the @e
+ * ExperimentGenerator. The model tree, the views and the experiment are
+ * still copied for each combination: the simulation owns its model tree.
+ *
+ * @code
+ * ExperimentGenerator expgen(vpz, 0, 1);
+ * ExperimentTemplate base(vpz);
+ *
+ * for (uint32_t i = 0; i < expgen.count(); ++i) {
+ *     Simulation sim(LOG_NONE, SIMULATION_NONE, NULL);
+ *     Error error;
+ *     value::Map *result = sim.run(base.build(expgen.at(i), expgen),
+ *                                  &vpz.project(), modulemgr, &error);
+ * }
+ * @endcode
+ */
+class VLE_API ExperimentTemplate
+{
+public:
+    /**
+     * Build the template of an experimental frame.
+     *
+     * @param vpz The experimental frame. It must outlive the template
+     * and the simulations of the combinations.
+     */
+    ExperimentTemplate(const vpz::Vpz& vpz);
+
+    ~ExperimentTemplate();
+
+    /**
+     * Build the experiment of a combination: a copy of the template
+     * named @e name-index, with the @e index as instance (the replica of
+     * the random streams of the models) and the condition values of the
+     * @e index. This function can be called by several threads.
+     *
+     * @param index The index of the combination.
+     * @param expgen The ExperimentGenerator of the experimental frame.
+     *
+     * @return A new @e vpz::Vpz, to give to @e Simulation::run().
+     */
+    vpz::Vpz * build(uint32_t index, ExperimentGenerator& expgen) const;
+
+    /**
+     * Get the name of the experiment of a combination.
+     *
+     * @param index The index of the combination.
+     *
+     * @return The name of the experimental frame, a dash and the index.
+     */
+    std::string name(uint32_t index) const;
+
+private:
+    ExperimentTemplate(const ExperimentTemplate& other);
+    ExperimentTemplate& operator=(const ExperimentTemplate& other);
+
+    vpz::Vpz    *mBase;
+    std::string  mName;
+};
+
+}} // namespace vle manager
+
+#endif
@@ -32,39 +32,19 @@
 
 #include <vle/manager/Manager.hpp>
 #include <vle/manager/ExperimentGenerator.hpp>
+#include <vle/manager/ExperimentTemplate.hpp>
 #include <vle/manager/Simulation.hpp>
 #include <vle/utils/Tools.hpp>
 #include <vle/utils/Trace.hpp>
 #include <vle/vpz/Vpz.hpp>
 #include <vle/vpz/BaseModel.hpp>
 #include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <algorithm>
 
 namespace vle { namespace manager {
 
-/**
- * Assign an new name to the experiment.
- *
- * This function assign a new name to the experiment file.
- *
- * @param destination The experiment where change the name.
- * @param name The base name of the experiment.
- * @param number The combination number.
- */
-static void setExperimentName(vpz::Vpz           *destination,
-                              const std::string&  name,
-                              uint32_t            number)
-{
-    std::string result(name.size() + 12, '-');
-
-    result.replace(0, name.size(), name);
-    result.replace(name.size() + 1, std::string::npos,
-                   utils::to < uint32_t >(number));
-
-
-    destination->project().setInstance(number);
-    destination->project().experiment().setName(result);
-}
-
 class Manager::Pimpl
 {
 public:
@@ -105,6 +85,74 @@ public:
         }
     }
 
+    /**
+     * The @c JobQueue is the list of the combinations shared by the
+     * threads. The combinations are sorted by decreasing cost hint and a
+     * free thread takes the next one. The mutex also protects the result
+     * matrix and the error.
+     */
+    struct JobQueue
+    {
+        std::vector < uint32_t > jobs;
+        std::size_t              next;
+        boost::mutex             mutex;
+
+        JobQueue()
+            : next(0)
+        {
+        }
+
+        bool pop(uint32_t *index)
+        {
+            boost::mutex::scoped_lock lock(mutex);
+
+            if (next == jobs.size()) {
+                return false;
+            }
+
+            *index = jobs[next++];
+            return true;
+        }
+    };
+
+    /**
+     * Sort combinations by decreasing cost, ties in index order.
+     */
+    struct CostCompare
+    {
+        const std::vector < double >& costs;
+
+        CostCompare(const std::vector < double >& costs)
+            : costs(costs)
+        {
+        }
+
+        double cost(uint32_t index) const
+        {
+            return index < costs.size() ? costs[index] : 0.0;
+        }
+
+        bool operator()(uint32_t lhs, uint32_t rhs) const
+        {
+            return cost(lhs) > cost(rhs);
+        }
+    };
+
+    /**
+     * Statistics of a thread: number of simulations run and time spent
+     * in them (in seconds).
+     */
+    struct ThreadStat
+    {
+        uint32_t runs;
+        double   busy;
+
+        ThreadStat()
+            : runs(0), busy(0.0)
+        {
+        }
+    };
+
     /**
      * The @c worker is a boost thread functor to execute threaded
      * source code.
@@ -112,28 +160,30 @@ public:
      */
     struct worker
     {
-        const vpz::Vpz       *vpz;
+        const ExperimentTemplate *base;
+        const vpz::Project   *shared;
         ExperimentGenerator  &expgen;
         utils::ModuleManager &modulemgr;
         LogOptions            mLogOption;
         SimulationOptions     mSimulationOption;
-        uint32_t              index;
-        uint32_t              threads;
+        JobQueue             &queue;
+        ThreadStat           &stat;
         value::Matrix        *result;
         Error                *error;
 
-        worker(const vpz::Vpz        *vpz,
+        worker(const ExperimentTemplate *base,
+               const vpz::Project    *shared,
                ExperimentGenerator&   expgen,
                utils::ModuleManager&  modulemgr,
                LogOptions             logoptions,
                SimulationOptions      simulationoptions,
-               uint32_t               index,
-               uint32_t               threads,
+               JobQueue&              queue,
+               ThreadStat&            stat,
                value::Matrix         *result,
                Error                 *error)
-            : vpz(vpz), expgen(expgen), modulemgr(modulemgr),
+            : base(base), shared(shared), expgen(expgen), modulemgr(modulemgr),
               mLogOption(logoptions), mSimulationOption(simulationoptions),
-              index(index), threads(threads), result(result), error(error)
+              queue(queue), stat(stat), result(result), error(error)
         {
         }
 
@@ -143,28 +193,37 @@ public:
 
         void operator()()
         {
-            std::string vpzname(vpz->project().experiment().name());
+            uint32_t i;
+
+            while (queue.pop(&i)) {
+                boost::posix_time::ptime start =
+                    boost::posix_time::microsec_clock::universal_time();
 
-            for (uint32_t i = expgen.min() + index; i <= expgen.max();
-                 i += threads) {
                 Simulation sim(mLogOption, mSimulationOption, NULL);
                 Error err;
-                vpz::Vpz *file = new vpz::Vpz(*vpz);
-                setExperimentName(file, vpzname, i);
-                expgen.get(i, &file->project().experiment().conditions());
+                value::Map *simresult = sim.run(base->build(i, expgen), shared,
+                                                modulemgr, &err);
 
-                value::Map *simresult = sim.run(file, modulemgr, &err);
+                {
+                    boost::mutex::scoped_lock lock(queue.mutex);
 
-                if (err.code) {
-                    // writeRunLog(err.message);
+                    if (err.code) {
+                        // writeRunLog(err.message);
 
-                    if (not error->code) {
-                        error->code = -1;
-                        error->message = _("Manager failure.");
+                        if (not error->code) {
+                            error->code = -1;
+                            error->message = _("Manager failure.");
+                        }
+                    } else {
+                        result->add(i, 0, simresult);
                     }
-                } else {
-                    result->add(i, 0, simresult);
                 }
+
+                boost::posix_time::ptime end =
+                    boost::posix_time::microsec_clock::universal_time();
+
+                stat.runs++;
+                stat.busy += (end - start).total_microseconds() / 1e6;
             }
         }
     };
@@ -177,22 +236,50 @@ public:
                                      Error                 *error)
     {
         ExperimentGenerator expgen(*vpz, rank, world);
-        std::string vpzname(vpz->project().experiment().name());
         boost::thread_group gp;
         value::Matrix *result = new value::Matrix(expgen.size(), 1, expgen.size(), 1);
+        ExperimentTemplate *base = new ExperimentTemplate(*vpz);
+        JobQueue queue;
+        std::vector < ThreadStat > stats(threads);
+
+        for (uint32_t n = 0; n < expgen.count(); ++n) {
+            queue.jobs.push_back(expgen.at(n));
+        }
+
+        std::stable_sort(queue.jobs.begin(), queue.jobs.end(),
+                         CostCompare(mCosts));
+
+        boost::posix_time::ptime start =
+            boost::posix_time::microsec_clock::universal_time();
 
         for (uint32_t i = 0; i < threads; ++i) {
-            gp.create_thread(worker(vpz, expgen, modulemgr,
+            gp.create_thread(worker(base, &vpz->project(), expgen, modulemgr,
                                     mLogOption, mSimulationOption,
-                                    i, threads, result, error));
+                                    queue, stats[i], result, error));
         }
 
         gp.join_all();
 
-         delete vpz->project().model().model();
-         delete vpz;
+        double elapsed = (boost::posix_time::microsec_clock::universal_time()
+                          - start).total_microseconds() / 1e6;
+
+        mUtilization.assign(threads, 0.0);
+        for (uint32_t i = 0; i < threads; ++i) {
+            if (elapsed > 0.0) {
+                mUtilization[i] = std::min(1.0, stats[i].busy / elapsed);
+            }
+
+            writeSummaryLog(fmt(_(" - Thread %1% .....................: "
+                                  "%2% simulation(s), %3%%% busy\n"))
+                            % i % stats[i].runs
+                            % (int)(mUtilization[i] * 100.0 + 0.5));
+        }
+
+        delete base;
+        delete vpz->project().model().model();
+        delete vpz;
 
-         return result;
+        return result;
     }
 
     value::Matrix * runManagerMono(vpz::Vpz             *vpz,
@@ -203,20 +290,19 @@ public:
     {
         Simulation sim(mLogOption, mSimulationOption, NULL);
         ExperimentGenerator expgen(*vpz, rank, world);
-        std::string vpzname(vpz->project().experiment().name());
         value::Matrix *result = 0;
+        ExperimentTemplate *base = new ExperimentTemplate(*vpz);
 
         error->code = 0;
         error->message.clear();
 
         if (mSimulationOption & manager::SIMULATION_NO_RETURN) {
-            for (uint32_t i = expgen.min(); i <= expgen.max(); ++i) {
+            for (uint32_t n = 0; n < expgen.count(); ++n) {
+                uint32_t i = expgen.at(n);
                 Error err;
-                vpz::Vpz *file = new vpz::Vpz(*vpz);
-                setExperimentName(file, vpzname, i);
-                expgen.get(i, &file->project().experiment().conditions());
 
-                sim.run(file, modulemgr, &err);
+                sim.run(base->build(i, expgen), &vpz->project(), modulemgr,
+                        &err);
 
                 if (err.code) {
                     writeRunLog(err.message);
@@ -230,13 +316,12 @@ public:
         } else {
             result = new value::Matrix(expgen.size(), 1, expgen.size(), 1);
 
-            for (uint32_t i = expgen.min(); i <= expgen.max(); ++i) {
+            for (uint32_t n = 0; n < expgen.count(); ++n) {
+                uint32_t i = expgen.at(n);
                 Error err;
-                vpz::Vpz *file = new vpz::Vpz(*vpz);
-                setExperimentName(file, vpzname, i);
-                expgen.get(i, &file->project().experiment().conditions());
-
-                value::Map *simresult = sim.run(file, modulemgr, &err);
+                value::Map *simresult = sim.run(base->build(i, expgen),
+                                                &vpz->project(), modulemgr,
+                                                &err);
 
                 if (err.code) {
                     writeRunLog(err.message);
@@ -251,6 +336,7 @@ public:
             }
         }
 
+        delete base;
         delete vpz->project().model().model();
         delete vpz;
 
@@ -262,6 +348,8 @@ public:
     std::ostream         *mOutputStream;
     uint32_t              mCurrentTime;
     uint32_t              mduration;
+    std::vector < double > mCosts;
+    std::vector < double > mUtilization;
 };
 
 Manager::Manager(LogOptions            logoptions,
@@ -309,6 +397,7 @@ value::Matrix * Manager::run(vpz::Vpz             *exp,
         result = mPimpl->runManagerThread(exp, modulemgr, thread, rank,
                                           world, error);
     } else {
+        mPimpl->mUtilization.assign(1, 1.0);
         result = mPimpl->runManagerMono(exp, modulemgr, rank, world, error);
     }
 
@@ -317,4 +406,14 @@ value::Matrix * Manager::run(vpz::Vpz             *exp,
     return result;
 }
 
+void Manager::setCostHints(const std::vector < double >& costs)
+{
+    mPimpl->mCosts = costs;
+}
+
+const std::vector < double >& Manager::utilization() const
+{
+    return mPimpl->mUtilization;
+}
+
 }} // namespace vle manager
@@ -32,6 +32,7 @@
 #include <vle/utils/ModuleManager.hpp>
 #include <vle/manager/Types.hpp>
 #include <vle/vpz/Vpz.hpp>
+#include <vector>
 
 namespace vle { namespace manager {
 
@@ -43,7 +44,14 @@ namespace vle { namespace manager {
  * manager::ExperimentGenerator. A cell of the @c value::Matrix is a
  * @c value::Map.  The key is the name of the @c devs::View and the
  * value is a @c value::Matrix or NULL if the @c value::Matrix is
- * empty.
+ * empty. With the @c SIMULATION_TYPED_RESULTS option, the views whose
+ * plug-in provides typed results store a @c value::ResultMatrix,
+ * without any conversion or copy.
+ *
+ * In multi-thread mode, the combinations are taken from a shared queue
+ * by the threads as soon as they are free. The queue is sorted by
+ * decreasing cost hint (see @c setCostHints()) so the longest
+ * simulations start first and the short ones fill the end of the run.
  *
  * @attention You are in charge to freed the manager result @c
  * value::Matrix.
@@ -82,6 +90,26 @@ public:
                         uint32_t              world,
                         Error                *error);
 
+    /**
+     * Assign an estimated cost to each combination of the experimental
+     * frame. The @e costs vector is indexed by the combination index
+     * of the @c manager::ExperimentGenerator, the unit does not
+     * matter. Combinations without hint get a null cost and are
+     * started last, in index order.
+     *
+     * @param costs The cost hints, an empty vector to clear them.
+     */
+    void setCostHints(const std::vector < double >& costs);
+
+    /**
+     * Get the utilization of the threads used by the last call to @c
+     * run(), ie. for each thread, the time spent in simulations divided
+     * by the wall time of the experimental frame.
+     *
+     * @return A vector with one value in [0, 1] per thread.
+     */
+    const std::vector < double >& utilization() const;
+
 private:
     Manager(const Manager& other);
     Manager& operator=(const Manager& other);
@@ -60,6 +60,26 @@ public:
     {
     }
 
+    void load(devs::RootCoordinator& root, const vpz::Vpz& vpz,
+              const vpz::Project *shared)
+    {
+        if (m_simulationoptions & manager::SIMULATION_PROFILE) {
+            std::string name(vpz.project().experiment().name());
+
+            root.setProfile((name.empty() ? std::string("simulation") :
+                             name) + ".profile");
+        }
+
+        if (shared) {
+            root.load(vpz, *shared);
+        } else {
+            root.load(vpz);
+        }
+
+        root.setTypedResults(m_simulationoptions &
+                             manager::SIMULATION_TYPED_RESULTS);
+    }
+
     template <typename T>
     void write(const T& t)
     {
@@ -71,6 +91,7 @@ public:
     }
 
     value::Map * runVerboseRun(vpz::Vpz                   *vpz,
+                               const vpz::Project         *shared,
                                const utils::ModuleManager &modulemgr,
                                Error                      *error)
     {
@@ -86,7 +107,7 @@ public:
             write(fmt(_("[%1%]\n")) % vpz->filename());
             write(_(" - Coordinator load models ......: "));
 
-            root.load(*vpz);
+            load(root, *vpz, shared);
 
             write(_("ok\n"));
 
@@ -120,6 +141,16 @@ public:
 
             result = root.outputs();
 
+            write(fmt(_(" - Event allocations ............: %1% for %2%"
+                        " events\n")) % root.allocations() % root.events());
+
+            if (root.outputQueues() > 0) {
+                write(fmt(_(" - Output queues ................: %1%, max"
+                            " depth %2%, %3% s stalled\n"))
+                      % root.outputQueues() % root.outputDepth()
+                      % root.outputStall());
+            }
+
             write(fmt(_(" - Time spent in kernel .........: %1% s"))
                   % timer.elapsed());
 
@@ -135,6 +166,7 @@ public:
     }
 
     value::Map * runVerboseSummary(vpz::Vpz                   *vpz,
+                                   const vpz::Project         *shared,
                                    const utils::ModuleManager &modulemgr,
                                    Error                      *error)
     {
@@ -147,7 +179,7 @@ public:
             write(fmt(_("[%1%]\n")) % vpz->filename());
             write(_(" - Coordinator load models ......: "));
 
-            root.load(*vpz);
+            load(root, *vpz, shared);
 
             write(_("ok\n"));
 
@@ -171,6 +203,16 @@ public:
 
             result = root.outputs();
 
+            write(fmt(_(" - Event allocations ............: %1% for %2%"
+                        " events\n")) % root.allocations() % root.events());
+
+            if (root.outputQueues() > 0) {
+                write(fmt(_(" - Output queues ................: %1%, max"
+                            " depth %2%, %3% s stalled\n"))
+                      % root.outputQueues() % root.outputDepth()
+                      % root.outputStall());
+            }
+
             write(fmt(_(" - Time spent in kernel .........: %1% s"))
                   % timer.elapsed());
 
@@ -186,6 +228,7 @@ public:
     }
 
     value::Map * runQuiet(vpz::Vpz                   *vpz,
+                          const vpz::Project         *shared,
                           const utils::ModuleManager &modulemgr,
                           Error                      *error)
     {
@@ -193,7 +236,7 @@ public:
 
         try {
             devs::RootCoordinator root(modulemgr);
-            root.load(*vpz);
+            load(root, *vpz, shared);
             vpz->clear();
             delete vpz;
 
@@ -230,19 +273,27 @@ Simulation::~Simulation()
 value::Map * Simulation::run(vpz::Vpz                   *vpz,
                              const utils::ModuleManager &modulemgr,
                              Error                      *error)
+{
+    return run(vpz, 0, modulemgr, error);
+}
+
+value::Map * Simulation::run(vpz::Vpz                   *vpz,
+                             const vpz::Project         *shared,
+                             const utils::ModuleManager &modulemgr,
+                             Error                      *error)
 {
     error->code = 0;
     value::Map *result = NULL;
 
     if (mPimpl->m_logoptions != manager::LOG_NONE) {
         if (mPimpl->m_logoptions & manager::LOG_RUN and mPimpl->m_out) {
-            result = mPimpl->runVerboseRun(vpz, modulemgr, error);
+            result = mPimpl->runVerboseRun(vpz, shared, modulemgr, error);
         } else {
-            result = mPimpl->runVerboseSummary(vpz, modulemgr, error);
+            result = mPimpl->runVerboseSummary(vpz, shared, modulemgr, error);
         }
 
     } else {
-        result = mPimpl->runQuiet(vpz, modulemgr, error);
+        result = mPimpl->runQuiet(vpz, shared, modulemgr, error);
     }
 
     if (mPimpl->m_simulationoptions & manager::SIMULATION_NO_RETURN) {
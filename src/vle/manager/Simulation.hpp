@@ -40,7 +40,9 @@ namespace vle { namespace manager {
  *
  * The @c manager::Simulation returns a @c value::Map. The key is the
  * name of the @c devs::View and the value is a @c value::Matrix or
- * NULL if the @c value::Matrix is empty.
+ * NULL if the @c value::Matrix is empty. With the @c
+ * SIMULATION_TYPED_RESULTS option, the views whose plug-in provides typed
+ * results return a @c value::ResultMatrix instead.
  *
  * @attention You are in charge to freed the simulation result @c
  * value::Map.
@@ -58,6 +60,25 @@ public:
                      const utils::ModuleManager &modulemgr,
                      Error                      *error);
 
+    /**
+     * Run a simulation whose dynamics and classes are read from a shared
+     * project instead of @e vpz. The @e vpz only needs the model and the
+     * experiment, the @e shared project is not modified and must outlive
+     * the call.
+     *
+     * @param vpz The simulation to run, deleted by the function.
+     * @param shared The project which provides dynamics and classes or
+     * NULL to use those of @e vpz.
+     * @param modulemgr The module manager.
+     * @param error The error reported by the simulation.
+     *
+     * @return A @c value::Map to freed.
+     */
+    value::Map * run(vpz::Vpz                   *vpz,
+                     const vpz::Project         *shared,
+                     const utils::ModuleManager &modulemgr,
+                     Error                      *error);
+
 private:
     Simulation(const Simulation &other);
     Simulation& operator=(const Simulation &other);
@@ -99,7 +99,14 @@ enum SimulationOptions {
     SIMULATION_NONE          = 0, /**< Default option. */
     SIMULATION_SPAWN_PROCESS = 1 << 0, /**< Launch the simulation in a
                                         * subprocess.  */
-    SIMULATION_NO_RETURN     = 1 << 1 /**< The simulation result are empty. */
+    SIMULATION_NO_RETURN     = 1 << 1, /**< The simulation result are empty. */
+    SIMULATION_TYPED_RESULTS = 1 << 2, /**< The plug-ins which provide
+                                        * typed results return a
+                                        * value::ResultMatrix instead of
+                                        * a value::Matrix. */
+    SIMULATION_PROFILE       = 1 << 3 /**< The simulation writes the
+                                        * profile of its models into the
+                                        * file experiment.profile. */
 };
 
 inline LogOptions operator|(LogOptions lhs, LogOptions rhs)
@@ -36,9 +36,11 @@
 #include <boost/lexical_cast.hpp>
 #include <stdexcept>
 #include <iostream>
+#include <set>
 #include <vle/vpz/Vpz.hpp>
 #include <vle/manager/Manager.hpp>
 #include <vle/manager/ExperimentGenerator.hpp>
+#include <vle/manager/ExperimentTemplate.hpp>
 #include <vle/vle.hpp>
 
 struct F
@@ -224,3 +226,169 @@ BOOST_AUTO_TEST_CASE(experimentgenerator_max_1_max_1)
     BOOST_CHECK_EQUAL(expgen1.max(), 6);
     BOOST_CHECK_EQUAL(expgen1.size(), 7);
 }
+
+BOOST_AUTO_TEST_CASE(experimentgenerator_count_at)
+{
+    vpz::Vpz vpz;
+    vpz.parseMemory(xml);
+
+    vpz::Conditions& cnds(vpz.project().experiment().conditions());
+    vpz::Condition& cnd1(cnds.get("cond1"));
+    cnd1.clearValueOfPort("init1");
+    cnd1.clearValueOfPort("init2");
+    for (int i = 0; i < 10; ++i) {
+        cnd1.addValueToPort("init1", new value::Integer(i));
+    }
+    cnd1.addValueToPort("init2", new value::Double(456.));
+
+    vpz::Condition& cnd2(cnds.get("cond2"));
+    cnd2.clearValueOfPort("init3");
+    cnd2.clearValueOfPort("init4");
+    cnd2.addValueToPort("init3", new value::Double(.123));
+    cnd2.addValueToPort("init4", new value::Double(.456));
+
+    uint32_t total = 0;
+    for (uint32_t rank = 0; rank < 3; ++rank) {
+        manager::ExperimentGenerator expgen(vpz, rank, 3);
+        BOOST_CHECK_EQUAL(expgen.size(), 10);
+        BOOST_CHECK_EQUAL(expgen.count(), rank == 0 ? 4 : 3);
+
+        for (uint32_t n = 0; n < expgen.count(); ++n) {
+            BOOST_CHECK_EQUAL(expgen.at(n), total + n);
+            BOOST_CHECK_EQUAL(value::toInteger(
+                    expgen.get(expgen.at(n), "cond1", "init1")),
+                (int)(total + n));
+        }
+        total += expgen.count();
+    }
+    BOOST_CHECK_EQUAL(total, 10);
+
+    manager::ExperimentGenerator strided(vpz, 1, 3,
+                                         manager::ExperimentGenerator::STRIDED);
+    BOOST_CHECK_EQUAL(strided.count(), 3);
+    BOOST_CHECK_EQUAL(strided.at(0), 1);
+    BOOST_CHECK_EQUAL(strided.at(1), 4);
+    BOOST_CHECK_EQUAL(strided.at(2), 7);
+    BOOST_CHECK_THROW(strided.at(3), utils::ArgError);
+
+    manager::ExperimentGenerator expgen(vpz, 0, 1);
+    BOOST_CHECK_EQUAL(value::toDouble(expgen.get(5, "cond2", "init4")), .456);
+    BOOST_CHECK_THROW(expgen.get(5, "cond2", "unknown"), utils::ArgError);
+}
+
+BOOST_AUTO_TEST_CASE(experimentgenerator_total)
+{
+    vpz::Vpz vpz;
+    vpz.parseMemory(xml);
+    vpz.project().experiment().setCombination("total");
+
+    vpz::Conditions& cnds(vpz.project().experiment().conditions());
+    vpz::Condition& cnd1(cnds.get("cond1"));
+    cnd1.clearValueOfPort("init1");
+    cnd1.clearValueOfPort("init2");
+    for (int i = 0; i < 3; ++i) {
+        cnd1.addValueToPort("init1", new value::Integer(i));
+    }
+    for (int i = 0; i < 5; ++i) {
+        cnd1.addValueToPort("init2", new value::Integer(i));
+    }
+
+    manager::ExperimentGenerator expgen(vpz, 0, 1);
+    BOOST_CHECK_EQUAL(expgen.size(), 3 * 5 * 2 * 2);
+
+    std::set < std::vector < int > > points;
+    for (uint32_t i = 0; i < expgen.size(); ++i) {
+        vpz::Conditions conds;
+        expgen.get(i, &conds);
+
+        std::vector < int > point;
+        point.push_back(value::toInteger(
+                conds.get("cond1").firstValue("init1")));
+        point.push_back(value::toInteger(
+                conds.get("cond1").firstValue("init2")));
+        point.push_back(
+            conds.get("cond2").firstValue("init3").isInteger());
+        point.push_back(
+            conds.get("cond2").firstValue("init4").isInteger());
+        points.insert(point);
+
+        BOOST_CHECK_EQUAL(value::toInteger(expgen.get(i, "cond1", "init2")),
+                          point[1]);
+    }
+    BOOST_CHECK_EQUAL(points.size(), expgen.size());
+}
+
+BOOST_AUTO_TEST_CASE(experimentgenerator_sampled)
+{
+    vpz::Vpz vpz;
+    vpz.parseMemory(xml);
+    vpz.project().experiment().setCombination("sampled");
+    vpz.project().experiment().setSamples(100);
+
+    vpz::Conditions& cnds(vpz.project().experiment().conditions());
+    vpz::Condition& cnd1(cnds.get("cond1"));
+    cnd1.clearValueOfPort("init1");
+    cnd1.clearValueOfPort("init2");
+    for (int i = 0; i < 100; ++i) {
+        cnd1.addValueToPort("init1", new value::Integer(i));
+    }
+    for (int i = 0; i < 10; ++i) {
+        cnd1.addValueToPort("init2", new value::Integer(i));
+    }
+
+    manager::ExperimentGenerator expgen(vpz, 0, 1);
+    BOOST_CHECK_EQUAL(expgen.size(), 100);
+
+    std::vector < int > init1(100, 0), init2(10, 0);
+    uint32_t diagonal = 0;
+    for (uint32_t i = 0; i < expgen.size(); ++i) {
+        int x = value::toInteger(expgen.get(i, "cond1", "init1"));
+        int y = value::toInteger(expgen.get(i, "cond1", "init2"));
+        init1[x]++;
+        init2[y]++;
+        if (x / 10 == y) {
+            diagonal++;
+        }
+    }
+
+    for (int i = 0; i < 100; ++i) {
+        BOOST_CHECK_EQUAL(init1[i], 1);
+    }
+    for (int i = 0; i < 10; ++i) {
+        BOOST_CHECK_EQUAL(init2[i], 10);
+    }
+    BOOST_CHECK(diagonal < 100);
+
+    vpz.project().experiment().setSamples(0);
+    BOOST_CHECK_THROW(manager::ExperimentGenerator(vpz, 0, 1),
+                      utils::InternalError);
+}
+
+BOOST_AUTO_TEST_CASE(experimenttemplate_build)
+{
+    vpz::Vpz vpz;
+    vpz.parseMemory(xml);
+
+    manager::ExperimentGenerator expgen(vpz, 0, 1);
+    manager::ExperimentTemplate base(vpz);
+    BOOST_REQUIRE_EQUAL(expgen.size(), 2);
+
+    for (uint32_t i = 0; i < expgen.size(); ++i) {
+        vpz::Vpz *file = base.build(i, expgen);
+        const vpz::Condition& cnd1(
+            file->project().experiment().conditions().get("cond1"));
+
+        BOOST_CHECK_EQUAL(file->project().experiment().name(), base.name(i));
+        BOOST_CHECK_EQUAL(file->project().instance(), (int)i);
+        BOOST_CHECK_EQUAL(cnd1.getSetValues("init1").size(), 1);
+        BOOST_CHECK_EQUAL(cnd1.firstValue("init1").writeToString(),
+                          expgen.get(i, "cond1", "init1").writeToString());
+
+        delete file->project().model().model();
+        delete file;
+    }
+
+    BOOST_CHECK_EQUAL(base.name(12), "test1-12");
+    BOOST_CHECK_EQUAL(vpz.project().experiment().conditions().get("cond1")
+                      .getSetValues("init1").size(), 2);
+}
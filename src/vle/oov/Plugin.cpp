@@ -27,10 +27,24 @@
 
 #include <vle/oov/Plugin.hpp>
 
-
-
 namespace vle { namespace oov {
 
-
+void Plugin::onRow(Row& row)
+{
+    if (row.used() == 0) {
+        onValue(std::string(), std::string(), std::string(), row.view(),
+                row.time(), 0);
+        return;
+    }
+
+    for (Row::size_type i = 0, e = row.size(); i != e; ++i) {
+        if (row.type(i) != Row::NONE) {
+            const Column& column = row.column(i);
+
+            onValue(column.simulator, column.parent, column.port,
+                    row.view(), row.time(), row.take(i));
+        }
+    }
+}
 
 }} // namespace vle oov
@@ -29,7 +29,9 @@
 #define VLE_OOV_PLUGIN_HPP
 
 #include <vle/DllDefines.hpp>
+#include <vle/oov/Row.hpp>
 #include <vle/value/Matrix.hpp>
+#include <vle/value/ResultMatrix.hpp>
 #include <vle/version.hpp>
 #include <boost/shared_ptr.hpp>
 #include <map>
@@ -111,6 +113,24 @@ public:
         return 0;
     }
 
+    /**
+     * Return a pointer to the \c value::ResultMatrix.
+     *
+     * A plug-in which stores its observations in typed columns returns
+     * them without building a \c value::Matrix. The kernel converts the
+     * \c value::ResultMatrix to a \c value::Matrix when the caller of
+     * the simulation does not ask for typed results. The default
+     * implementation returns NULL and the kernel uses the \c matrix
+     * function.
+     *
+     * @attention You are in charge of freeing the value::ResultMatrix
+     * after the end of the simulation.
+     */
+    virtual value::ResultMatrix * results() const
+    {
+        return 0;
+    }
+
     /**
      * Get the name of the Plugin class.
      *
@@ -178,6 +198,17 @@ public:
                          const double& time,
                          value::Value* value) = 0;
 
+    /**
+     * Call when a view observes all its observables at a date. The \c
+     * Row stores the value of each observable into typed lanes.
+     *
+     * The default implementation builds a \c value::Value for each used
+     * column and calls \c onValue, or calls \c onValue once with a null
+     * value if the view has no observable. Override this function to
+     * read the lanes directly without the per-value virtual calls.
+     */
+    virtual void onRow(Row& row);
+
     /**
      * Call when the simulation is finished.
      */
@@ -0,0 +1,177 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <vle/oov/ResultPlugin.hpp>
+#include <vle/value/Map.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/i18n.hpp>
+
+namespace vle { namespace oov {
+
+ResultPlugin::ResultPlugin(const std::string& location)
+    : Plugin(location), m_result(new value::ResultMatrix())
+{
+}
+
+ResultPlugin::~ResultPlugin()
+{
+    delete m_result;
+}
+
+value::Matrix * ResultPlugin::matrix() const
+{
+    return m_result ? m_result->buildMatrix() : 0;
+}
+
+value::ResultMatrix * ResultPlugin::results() const
+{
+    value::ResultMatrix* result = m_result;
+
+    m_result = 0;
+    return result;
+}
+
+void ResultPlugin::onParameter(const std::string& /*plugin*/,
+                               const std::string& /*location*/,
+                               const std::string& /*file*/,
+                               value::Value* parameters,
+                               const double& /*time*/)
+{
+    if (parameters and parameters->isMap()) {
+        const value::Map& map = parameters->toMap();
+
+        if (map.exist("rows") and map.getInt("rows") > 0) {
+            m_result->reserve(map.getInt("rows"));
+        }
+    }
+    delete parameters;
+}
+
+void ResultPlugin::onNewObservable(const std::string& simulator,
+                                   const std::string& parent,
+                                   const std::string& port,
+                                   const std::string& /*view*/,
+                                   const double& /*time*/)
+{
+    column(simulator, parent, port);
+    m_columns.clear();
+}
+
+void ResultPlugin::onDelObservable(const std::string& /*simulator*/,
+                                   const std::string& /*parent*/,
+                                   const std::string& /*port*/,
+                                   const std::string& /*view*/,
+                                   const double& /*time*/)
+{
+    m_columns.clear();
+}
+
+void ResultPlugin::onValue(const std::string& simulator,
+                           const std::string& parent,
+                           const std::string& port,
+                           const std::string& /*view*/,
+                           const double& time,
+                           value::Value* value)
+{
+    if (not m_result) {
+        delete value;
+        throw utils::InternalError(
+            _("ResultPlugin: results already given"));
+    }
+
+    size_type id = column(simulator, parent, port);
+
+    if (m_result->rows() == 0 or
+        m_result->time(m_result->rows() - 1) != time) {
+        m_result->addRow(time);
+    }
+
+    m_result->set(id, m_result->rows() - 1, value);
+}
+
+void ResultPlugin::onRow(Row& row)
+{
+    if (not m_result) {
+        throw utils::InternalError(
+            _("ResultPlugin: results already given"));
+    }
+
+    if (m_columns.size() != row.size()) {
+        m_columns.resize(row.size());
+
+        for (Row::size_type i = 0; i < row.size(); ++i) {
+            if (row.type(i) != Row::NONE) {
+                const Column& col = row.column(i);
+                m_columns[i] = column(col.simulator, col.parent, col.port);
+            }
+        }
+    }
+
+    size_type line = m_result->addRow(row.time());
+
+    for (Row::size_type i = 0, e = row.size(); i != e; ++i) {
+        switch (row.type(i)) {
+        case Row::REAL:
+            m_result->setReal(m_columns[i], line, row.getReal(i));
+            break;
+        case Row::INTEGER:
+            m_result->setInteger(m_columns[i], line, row.getInteger(i));
+            break;
+        case Row::VALUE:
+            m_result->set(m_columns[i], line, row.take(i));
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+void ResultPlugin::close(const double& /*time*/)
+{
+}
+
+ResultPlugin::size_type ResultPlugin::column(const std::string& simulator,
+                                             const std::string& parent,
+                                             const std::string& port)
+{
+    std::string name(parent);
+    name += ':';
+    name += simulator;
+    name += '.';
+    name += port;
+
+    std::map < std::string, size_type >::iterator it = m_names.find(name);
+    if (it == m_names.end()) {
+        it = m_names.insert(std::make_pair(
+                name, m_result->addColumn(name))).first;
+    }
+
+    return it->second;
+}
+
+}} // namespace vle oov
@@ -0,0 +1,119 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef VLE_OOV_RESULTPLUGIN_HPP
+#define VLE_OOV_RESULTPLUGIN_HPP
+
+#include <vle/DllDefines.hpp>
+#include <vle/oov/Plugin.hpp>
+#include <vle/value/ResultMatrix.hpp>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace vle { namespace oov {
+
+/**
+ * @brief The ResultPlugin stores the observations of a view into a \c
+ * value::ResultMatrix: the reals and the integers of the rows are copied
+ * into the typed lanes without building any \c value::Value. The columns
+ * are named \c parent:simulator.port like the storage plug-in.
+ *
+ * An optional integer \c rows in the \c value::Map of parameters reserves
+ * the memory of the rows. This class is built into the library; an
+ * output package exports it with:
+ * @code
+ * DECLARE_OOV_PLUGIN(vle::oov::ResultPlugin)
+ * @endcode
+ */
+class VLE_API ResultPlugin : public Plugin
+{
+public:
+    ResultPlugin(const std::string& location);
+
+    virtual ~ResultPlugin();
+
+    virtual std::string name() const
+    { return "results"; }
+
+    /**
+     * @brief Build a \c value::Matrix from the typed results.
+     */
+    virtual value::Matrix * matrix() const;
+
+    /**
+     * @brief Give the typed results to the caller.
+     */
+    virtual value::ResultMatrix * results() const;
+
+    virtual void onParameter(const std::string& plugin,
+                             const std::string& location,
+                             const std::string& file,
+                             value::Value* parameters,
+                             const double& time);
+
+    virtual void onNewObservable(const std::string& simulator,
+                                 const std::string& parent,
+                                 const std::string& port,
+                                 const std::string& view,
+                                 const double& time);
+
+    virtual void onDelObservable(const std::string& simulator,
+                                 const std::string& parent,
+                                 const std::string& port,
+                                 const std::string& view,
+                                 const double& time);
+
+    virtual void onValue(const std::string& simulator,
+                         const std::string& parent,
+                         const std::string& port,
+                         const std::string& view,
+                         const double& time,
+                         value::Value* value);
+
+    virtual void onRow(Row& row);
+
+    virtual void close(const double& time);
+
+private:
+    ResultPlugin(const ResultPlugin& other);
+    ResultPlugin& operator=(const ResultPlugin& other);
+
+    typedef value::ResultMatrix::size_type size_type;
+
+    size_type column(const std::string& simulator, const std::string& parent,
+                     const std::string& port);
+
+    mutable value::ResultMatrix*        m_result; /**< NULL once given. */
+    std::map < std::string, size_type > m_names;
+    std::vector < size_type >           m_columns; /**< Row id to column. */
+};
+
+}} // namespace vle oov
+
+#endif
@@ -0,0 +1,166 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <vle/oov/Row.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Integer.hpp>
+#include <algorithm>
+
+namespace vle { namespace oov {
+
+Row::size_type Row::addColumn(const Column& column)
+{
+    if (not m_released.empty()) {
+        size_type id = m_released.back();
+        m_released.pop_back();
+        m_columns[id] = column;
+        m_types[id] = EMPTY;
+
+        return id;
+    }
+
+    m_columns.push_back(column);
+    m_types.push_back(EMPTY);
+    m_reals.push_back(0.0);
+    m_integers.push_back(0);
+    m_values.push_back(0);
+
+    return m_columns.size() - 1;
+}
+
+void Row::delColumn(size_type id)
+{
+    delete m_values[id];
+    m_values[id] = 0;
+    m_types[id] = NONE;
+    m_columns[id] = Column();
+    m_released.push_back(id);
+}
+
+void Row::reset(double time)
+{
+    m_time = time;
+
+    for (size_type i = 0, e = m_columns.size(); i != e; ++i) {
+        if (m_values[i]) {
+            delete m_values[i];
+            m_values[i] = 0;
+        }
+
+        m_types[i] = EMPTY;
+    }
+
+    for (size_type i = 0, e = m_released.size(); i != e; ++i) {
+        m_types[m_released[i]] = NONE;
+    }
+}
+
+void Row::swap(Lanes& lanes)
+{
+    std::swap(m_time, lanes.time);
+    m_types.swap(lanes.types);
+    m_reals.swap(lanes.reals);
+    m_integers.swap(lanes.integers);
+    m_values.swap(lanes.values);
+
+    size_type size = m_columns.size();
+    if (m_types.size() < size) {
+        m_types.resize(size, EMPTY);
+        m_reals.resize(size, 0.0);
+        m_integers.resize(size, 0);
+        m_values.resize(size, 0);
+    }
+}
+
+void Row::put(size_type id, value::Value* value)
+{
+    delete m_values[id];
+    m_values[id] = value;
+
+    if (not value) {
+        m_types[id] = EMPTY;
+    } else if (value->isDouble()) {
+        m_types[id] = REAL;
+        m_reals[id] = value->toDouble().value();
+    } else if (value->isInteger()) {
+        m_types[id] = INTEGER;
+        m_integers[id] = value->toInteger().value();
+    } else {
+        m_types[id] = VALUE;
+    }
+}
+
+void Row::putReal(size_type id, double value)
+{
+    delete m_values[id];
+    m_values[id] = 0;
+    m_types[id] = REAL;
+    m_reals[id] = value;
+}
+
+void Row::putInteger(size_type id, int32_t value)
+{
+    delete m_values[id];
+    m_values[id] = 0;
+    m_types[id] = INTEGER;
+    m_integers[id] = value;
+}
+
+value::Value* Row::take(size_type id)
+{
+    value::Value* result = m_values[id];
+
+    if (result) {
+        m_values[id] = 0;
+    } else if (m_types[id] == REAL) {
+        result = value::Double::create(m_reals[id]);
+    } else if (m_types[id] == INTEGER) {
+        result = value::Integer::create(m_integers[id]);
+    }
+
+    return result;
+}
+
+void Row::clear()
+{
+    for (size_type i = 0, e = m_values.size(); i != e; ++i) {
+        delete m_values[i];
+    }
+
+    m_values.clear();
+}
+
+void Row::Lanes::clear()
+{
+    for (size_type i = 0, e = values.size(); i != e; ++i) {
+        delete values[i];
+        values[i] = 0;
+    }
+}
+
+}} // namespace vle oov
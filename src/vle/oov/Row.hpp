@@ -0,0 +1,245 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef VLE_OOV_ROW_HPP
+#define VLE_OOV_ROW_HPP
+
+#include <vle/DllDefines.hpp>
+#include <vle/value/Value.hpp>
+#include <string>
+#include <vector>
+
+namespace vle { namespace oov {
+
+/**
+ * @brief A \c Column describes an observable of a view: the simulator
+ * and the port observed. It is built once, when the observable is
+ * attached to the view.
+ */
+struct VLE_API Column
+{
+    Column()
+    {}
+
+    Column(const std::string& simulator, const std::string& parent,
+           const std::string& port)
+        : simulator(simulator), parent(parent), port(port)
+    {}
+
+    std::string simulator;
+    std::string parent;
+    std::string port;
+};
+
+/**
+ * @brief A \c Row stores all the values observed by a view at a date.
+ *
+ * Each observable of the view owns a column identifier, attributed by
+ * the view when the observable is attached. The values are stored into
+ * typed lanes: a real lane for \c value::Double, an integer lane for \c
+ * value::Integer and a lane of \c value::Value for the others
+ * types. Released columns (observables removed from the view) are kept
+ * with the type \c NONE and reused by the next observables.
+ *
+ * @code
+ * void MyPlugin::onRow(oov::Row& row)
+ * {
+ *     for (oov::Row::size_type i = 0; i < row.size(); ++i) {
+ *         switch (row.type(i)) {
+ *         case oov::Row::REAL:
+ *             write(row.column(i), row.time(), row.getReal(i));
+ *             break;
+ *         ...
+ *         }
+ *     }
+ * }
+ * @endcode
+ */
+class VLE_API Row
+{
+public:
+    typedef std::vector < Column >::size_type size_type;
+
+    /**
+     * @brief Define the lane used by a column.
+     */
+    enum Type {
+        NONE, /**< The column is not used or released. */
+        EMPTY, /**< The observation returns no value. */
+        REAL, /**< The value is stored into the real lane. */
+        INTEGER, /**< The value is stored into the integer lane. */
+        VALUE /**< The value is stored into the \c value::Value lane. */
+    };
+
+    /**
+     * @brief The date and the lanes of a row, without the columns. A row
+     * exchanges its values with a \c Lanes to hand them over to another
+     * thread without copying them.
+     */
+    struct VLE_API Lanes
+    {
+        Lanes()
+            : time(0.0)
+        {}
+
+        /**
+         * @brief Delete the values of the \c value::Value lane.
+         */
+        void clear();
+
+        double                          time;
+        std::vector < unsigned char >   types;
+        std::vector < double >          reals;
+        std::vector < int32_t >         integers;
+        std::vector < value::Value* >   values;
+    };
+
+    Row(const std::string& view)
+        : m_view(view), m_time(0.0)
+    {}
+
+    ~Row()
+    {
+        clear();
+    }
+
+    /**
+     * @brief Attach a new column to the row. A released column is reused
+     * if any.
+     * @param column the description of the observable.
+     * @return the identifier of the column.
+     */
+    size_type addColumn(const Column& column);
+
+    /**
+     * @brief Release the column. The identifier can be reused by the
+     * next call to \c addColumn.
+     * @param id the identifier of the column.
+     */
+    void delColumn(size_type id);
+
+    /**
+     * @brief Delete the values of the \c value::Value lane and mark all
+     * the used columns as \c EMPTY.
+     * @param time the date of the next values.
+     */
+    void reset(double time);
+
+    /**
+     * @brief Exchange the date and the lanes of the row with \c lanes.
+     * The lanes received are resized to the number of columns, their
+     * types and values are only meaningful after the next \c reset.
+     * @param lanes the lanes to exchange.
+     */
+    void swap(Lanes& lanes);
+
+    /**
+     * @brief Store the observation into the lane of its type. The \c
+     * value::Double and \c value::Integer are copied into the real and
+     * integer lanes. The row takes the ownership of the value until the
+     * next \c reset or \c take.
+     * @param id the identifier of the column.
+     * @param value the observation, may be null.
+     */
+    void put(size_type id, value::Value* value);
+
+    /**
+     * @brief Store a real without building a \c value::Double.
+     */
+    void putReal(size_type id, double value);
+
+    /**
+     * @brief Store an integer without building a \c value::Integer.
+     */
+    void putInteger(size_type id, int32_t value);
+
+    /**
+     * @brief Get the \c value::Value of the column, whatever its lane: a
+     * \c value::Double or a \c value::Integer is built if the column
+     * was filled by \c putReal or \c putInteger. The caller takes the
+     * ownership of the value.
+     * @param id the identifier of the column.
+     * @return the value or null if the column is empty.
+     */
+    value::Value* take(size_type id);
+
+    //
+    // Get functions
+    //
+
+    const std::string& view() const
+    { return m_view; }
+
+    double time() const
+    { return m_time; }
+
+    /**
+     * @brief The number of columns, the released columns included.
+     */
+    size_type size() const
+    { return m_columns.size(); }
+
+    /**
+     * @brief The number of columns used by an observable.
+     */
+    size_type used() const
+    { return m_columns.size() - m_released.size(); }
+
+    const Column& column(size_type id) const
+    { return m_columns[id]; }
+
+    Type type(size_type id) const
+    { return static_cast < Type >(m_types[id]); }
+
+    double getReal(size_type id) const
+    { return m_reals[id]; }
+
+    int32_t getInteger(size_type id) const
+    { return m_integers[id]; }
+
+    const value::Value* getValue(size_type id) const
+    { return m_values[id]; }
+
+private:
+    Row(const Row& other);
+    Row& operator=(const Row& other);
+
+    void clear();
+
+    std::string                     m_view;
+    double                          m_time;
+    std::vector < Column >          m_columns;
+    std::vector < unsigned char >   m_types;
+    std::vector < double >          m_reals;
+    std::vector < int32_t >         m_integers;
+    std::vector < value::Value* >   m_values;
+    std::vector < size_type >       m_released;
+};
+
+}} // namespace vle oov
+
+#endif
@@ -0,0 +1,938 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <vle/oov/Trace.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Integer.hpp>
+#include <vle/value/Binary.hpp>
+#include <vle/value/Map.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/i18n.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+namespace vle { namespace oov {
+
+namespace {
+
+/*
+ * Append the binary representation of a number to a chunk payload.
+ */
+template < typename T >
+void put(std::string& out, const T& value)
+{
+    out.append(reinterpret_cast < const char* >(&value), sizeof(T));
+}
+
+void putString(std::string& out, const std::string& str)
+{
+    put(out, static_cast < uint32_t >(str.size()));
+    out.append(str);
+}
+
+template < typename T >
+void putArray(std::string& out, const std::vector < T >& values)
+{
+    if (not values.empty()) {
+        out.append(reinterpret_cast < const char* >(&values[0]),
+                   values.size() * sizeof(T));
+    }
+}
+
+void pad(std::string& out)
+{
+    out.append((8 - out.size() % 8) % 8, '\0');
+}
+
+std::string key(const std::string& simulator, const std::string& parent,
+                const std::string& port)
+{
+    std::string result(parent);
+    result += '\n';
+    result += simulator;
+    result += '\n';
+    result += port;
+    return result;
+}
+
+/*
+ * A cursor on the mapped file. Each read checks the bounds of the
+ * chunk to detect truncated or corrupted files.
+ */
+class Cursor
+{
+public:
+    Cursor(const char* begin, const char* end)
+        : m_pos(begin), m_end(end)
+    {}
+
+    template < typename T >
+    T get()
+    {
+        T result;
+        std::memcpy(&result, take(sizeof(T)), sizeof(T));
+        return result;
+    }
+
+    std::string getString()
+    {
+        uint32_t size = get < uint32_t >();
+        const char* str = take(size);
+        return std::string(str, size);
+    }
+
+    const char* take(std::size_t size)
+    {
+        if (static_cast < std::size_t >(m_end - m_pos) < size) {
+            throw utils::FileError(_("Trace: truncated or corrupted file"));
+        }
+
+        const char* result = m_pos;
+        m_pos += size;
+        return result;
+    }
+
+    void align(const char* origin)
+    {
+        take((8 - (m_pos - origin) % 8) % 8);
+    }
+
+    const char* pos() const
+    { return m_pos; }
+
+private:
+    const char* m_pos;
+    const char* m_end;
+};
+
+const std::size_t HEADER_SIZE = 16;
+const std::size_t CHUNK_HEADER_SIZE = 16;
+const std::size_t TRAILER_SIZE = 16;
+
+} // anonymous namespace
+
+//
+// TracePlugin
+//
+
+TracePlugin::TracePlugin(const std::string& location)
+    : Plugin(location), m_rows(1024), m_row(std::string()), m_pending(false),
+    m_added(0), m_addedTime(0.0), m_removed(0), m_removedTime(0.0),
+    m_offset(0)
+{
+}
+
+TracePlugin::~TracePlugin()
+{
+}
+
+void TracePlugin::onParameter(const std::string& /*plugin*/,
+                              const std::string& location,
+                              const std::string& file,
+                              value::Value* parameters,
+                              const double& /*time*/)
+{
+    if (parameters and parameters->isMap()) {
+        const value::Map& map = parameters->toMap();
+
+        if (map.exist("rows")) {
+            m_rows = std::max(1, map.getInt("rows"));
+        }
+    }
+    delete parameters;
+
+    m_filename = location.empty() ? file + ".trace" :
+        location + "/" + file + ".trace";
+
+    m_file.open(m_filename.c_str(), std::ios::out | std::ios::binary |
+                std::ios::trunc);
+
+    if (not m_file.is_open()) {
+        throw utils::FileError(fmt(
+                _("Trace: cannot open file '%1%'")) % m_filename);
+    }
+
+    std::string header(trace::MAGIC, 8);
+    put(header, trace::VERSION);
+    put(header, trace::ENDIANNESS);
+    m_file.write(header.data(), header.size());
+    m_offset = header.size();
+}
+
+void TracePlugin::onNewObservable(const std::string& simulator,
+                                  const std::string& parent,
+                                  const std::string& port,
+                                  const std::string& view,
+                                  const double& time)
+{
+    flushValues();
+    flushData();
+    flushRemoves();
+
+    Row::size_type id = m_row.addColumn(Column(simulator, parent, port));
+    m_ids[key(simulator, parent, port)] = id;
+
+    put(m_columns, static_cast < uint32_t >(id));
+    put(m_columns, static_cast < uint32_t >(0));
+    put(m_columns, time);
+    putString(m_columns, view);
+    putString(m_columns, simulator);
+    putString(m_columns, parent);
+    putString(m_columns, port);
+
+    if (m_added == 0) {
+        m_addedTime = time;
+    }
+    ++m_added;
+}
+
+void TracePlugin::onDelObservable(const std::string& simulator,
+                                  const std::string& parent,
+                                  const std::string& port,
+                                  const std::string& /*view*/,
+                                  const double& time)
+{
+    std::map < std::string, Row::size_type >::iterator it =
+        m_ids.find(key(simulator, parent, port));
+
+    if (it == m_ids.end()) {
+        return;
+    }
+
+    flushValues();
+    flushData();
+    flushColumns();
+
+    put(m_removes, static_cast < uint32_t >(it->second));
+    put(m_removes, static_cast < uint32_t >(0));
+    put(m_removes, time);
+
+    if (m_removed == 0) {
+        m_removedTime = time;
+    }
+    ++m_removed;
+
+    m_row.delColumn(it->second);
+    m_ids.erase(it);
+}
+
+void TracePlugin::onValue(const std::string& simulator,
+                          const std::string& parent,
+                          const std::string& port,
+                          const std::string& /*view*/,
+                          const double& time,
+                          value::Value* value)
+{
+    if (m_pending and time != m_row.time()) {
+        flushValues();
+    }
+
+    if (not m_pending) {
+        m_row.reset(time);
+        m_pending = true;
+    }
+
+    std::map < std::string, Row::size_type >::iterator it =
+        m_ids.find(key(simulator, parent, port));
+
+    if (it == m_ids.end()) {
+        delete value;
+    } else {
+        m_row.put(it->second, value);
+    }
+}
+
+void TracePlugin::onRow(Row& row)
+{
+    flushValues();
+    append(row);
+}
+
+void TracePlugin::close(const double& /*time*/)
+{
+    if (not m_file.is_open()) {
+        return;
+    }
+
+    flushValues();
+    flushData();
+    flushColumns();
+    flushRemoves();
+
+    std::string payload;
+    for (std::vector < Entry >::const_iterator it = m_index.begin();
+         it != m_index.end(); ++it) {
+        put(payload, it->kind);
+        put(payload, it->count);
+        put(payload, it->offset);
+        put(payload, it->begin);
+        put(payload, it->end);
+    }
+
+    uint64_t offset = m_offset;
+    writeChunk(trace::INDEX, m_index.size(), payload, 0.0, 0.0);
+
+    std::string trailer;
+    put(trailer, offset);
+    trailer.append(trace::INDEX_MAGIC, 8);
+    m_file.write(trailer.data(), trailer.size());
+    m_file.close();
+
+    if (m_file.fail()) {
+        throw utils::FileError(fmt(
+                _("Trace: cannot write file '%1%'")) % m_filename);
+    }
+}
+
+void TracePlugin::append(const Row& row)
+{
+    flushColumns();
+    flushRemoves();
+
+    if (m_buffers.size() != row.size()) {
+        flushData();
+        m_buffers.resize(row.size());
+    }
+
+    m_times.push_back(row.time());
+
+    for (Row::size_type i = 0, e = row.size(); i != e; ++i) {
+        Buffer& buffer = m_buffers[i];
+        Row::Type type = row.type(i);
+
+        buffer.types.push_back(type);
+        buffer.reals.push_back(type == Row::REAL ? row.getReal(i) : 0.0);
+        buffer.integers.push_back(type == Row::INTEGER ?
+                                  row.getInteger(i) : 0);
+
+        if (type == Row::VALUE) {
+            std::ostringstream out;
+            value::BinaryWriter writer(out);
+            writer.write(row.getValue(i));
+            buffer.values.push_back(out.str());
+        }
+    }
+
+    if (m_times.size() >= m_rows) {
+        flushData();
+    }
+}
+
+void TracePlugin::flushValues()
+{
+    if (m_pending) {
+        m_pending = false;
+        append(m_row);
+        m_row.reset(m_row.time());
+    }
+}
+
+void TracePlugin::flushColumns()
+{
+    if (m_added > 0) {
+        writeChunk(trace::COLUMNS, m_added, m_columns, m_addedTime,
+                   m_addedTime);
+        m_columns.clear();
+        m_added = 0;
+    }
+}
+
+void TracePlugin::flushRemoves()
+{
+    if (m_removed > 0) {
+        writeChunk(trace::REMOVES, m_removed, m_removes, m_removedTime,
+                   m_removedTime);
+        m_removes.clear();
+        m_removed = 0;
+    }
+}
+
+void TracePlugin::flushData()
+{
+    if (m_times.empty()) {
+        return;
+    }
+
+    const std::size_t rows = m_times.size();
+    const std::size_t columns = m_buffers.size();
+    std::string payload;
+
+    put(payload, static_cast < uint32_t >(columns));
+    put(payload, static_cast < uint32_t >(0));
+    putArray(payload, m_times);
+
+    std::size_t table = payload.size();
+    payload.append(columns * sizeof(uint64_t), '\0');
+
+    for (std::size_t i = 0; i < columns; ++i) {
+        Buffer& buffer = m_buffers[i];
+        uint32_t lanes = 0;
+
+        for (std::size_t j = 0; j < rows; ++j) {
+            switch (buffer.types[j]) {
+            case Row::REAL:
+                lanes |= 1;
+                break;
+            case Row::INTEGER:
+                lanes |= 2;
+                break;
+            case Row::VALUE:
+                lanes |= 4;
+                break;
+            default:
+                break;
+            }
+        }
+
+        uint64_t offset = payload.size();
+        std::memcpy(&payload[table + i * sizeof(uint64_t)], &offset,
+                    sizeof(uint64_t));
+
+        put(payload, lanes);
+        put(payload, static_cast < uint32_t >(0));
+        putArray(payload, buffer.types);
+        pad(payload);
+
+        if (lanes & 1) {
+            putArray(payload, buffer.reals);
+        }
+
+        if (lanes & 2) {
+            putArray(payload, buffer.integers);
+            pad(payload);
+        }
+
+        if (lanes & 4) {
+            for (std::size_t j = 0; j < buffer.values.size(); ++j) {
+                putString(payload, buffer.values[j]);
+            }
+            pad(payload);
+        }
+
+        buffer.types.clear();
+        buffer.reals.clear();
+        buffer.integers.clear();
+        buffer.values.clear();
+    }
+
+    writeChunk(trace::DATA, rows, payload, m_times.front(), m_times.back());
+    m_times.clear();
+}
+
+void TracePlugin::writeChunk(uint32_t kind, uint32_t count,
+                             const std::string& payload, double begin,
+                             double end)
+{
+    if (kind != trace::INDEX) {
+        Entry entry = { kind, count, m_offset, begin, end };
+        m_index.push_back(entry);
+    }
+
+    std::string header;
+    put(header, kind);
+    put(header, count);
+    put(header, static_cast < uint64_t >(payload.size() +
+                                         (8 - payload.size() % 8) % 8));
+
+    m_file.write(header.data(), header.size());
+    m_file.write(payload.data(), payload.size());
+    m_file.write("\0\0\0\0\0\0\0", (8 - payload.size() % 8) % 8);
+
+    m_offset += header.size() + payload.size() + (8 - payload.size() % 8) % 8;
+}
+
+//
+// TraceReader
+//
+
+class TraceReader::Pimpl
+{
+public:
+    struct Chunk
+    {
+        uint32_t    kind;
+        uint32_t    count;
+        const char* payload;
+        uint64_t    size;
+        double      begin;
+        double      end;
+    };
+
+    Pimpl(const std::string& filename)
+        : m_filename(filename)
+    {
+        try {
+            boost::interprocess::file_mapping file(
+                filename.c_str(), boost::interprocess::read_only);
+            boost::interprocess::mapped_region region(
+                file, boost::interprocess::read_only);
+            m_region.swap(region);
+        } catch (const std::exception& e) {
+            throw utils::FileError(fmt(
+                    _("Trace: cannot map file '%1%': %2%")) % filename %
+                e.what());
+        }
+
+        m_begin = static_cast < const char* >(m_region.get_address());
+        m_end = m_begin + m_region.get_size();
+
+        Cursor cursor(m_begin, m_end);
+        if (std::memcmp(cursor.take(8), trace::MAGIC, 8) != 0) {
+            throw utils::FileError(fmt(
+                    _("Trace: '%1%' is not a trace file")) % filename);
+        }
+
+        if (cursor.get < uint32_t >() != trace::VERSION or
+            cursor.get < uint32_t >() != trace::ENDIANNESS) {
+            throw utils::FileError(fmt(
+                    _("Trace: '%1%' uses an unknown version or byte"
+                      " order")) % filename);
+        }
+
+        if (not readIndex()) {
+            scan();
+        }
+    }
+
+    /*
+     * Read the index at the end of the file.
+     */
+    bool readIndex()
+    {
+        if (static_cast < std::size_t >(m_end - m_begin) <
+            HEADER_SIZE + CHUNK_HEADER_SIZE + TRAILER_SIZE) {
+            return false;
+        }
+
+        Cursor trailer(m_end - TRAILER_SIZE, m_end);
+        uint64_t offset = trailer.get < uint64_t >();
+        if (std::memcmp(trailer.take(8), trace::INDEX_MAGIC, 8) != 0 or
+            offset >= static_cast < uint64_t >(m_end - m_begin)) {
+            return false;
+        }
+
+        Cursor cursor(m_begin + offset, m_end - TRAILER_SIZE);
+        if (cursor.get < uint32_t >() != trace::INDEX) {
+            return false;
+        }
+
+        uint32_t count = cursor.get < uint32_t >();
+        cursor.get < uint64_t >();
+
+        for (uint32_t i = 0; i < count; ++i) {
+            Chunk chunk;
+            chunk.kind = cursor.get < uint32_t >();
+            chunk.count = cursor.get < uint32_t >();
+            uint64_t position = cursor.get < uint64_t >();
+            chunk.begin = cursor.get < double >();
+            chunk.end = cursor.get < double >();
+
+            Cursor header(m_begin + position, m_end);
+            header.take(8);
+            chunk.size = header.get < uint64_t >();
+            chunk.payload = header.take(chunk.size);
+            m_chunks.push_back(chunk);
+        }
+
+        return true;
+    }
+
+    /*
+     * Rebuild the index from the chunk headers when the file has no
+     * index, for instance if the simulation was interrupted.
+     */
+    void scan()
+    {
+        Cursor cursor(m_begin + HEADER_SIZE, m_end);
+
+        while (static_cast < std::size_t >(m_end - cursor.pos()) >=
+               CHUNK_HEADER_SIZE) {
+            Chunk chunk;
+            chunk.kind = cursor.get < uint32_t >();
+            chunk.count = cursor.get < uint32_t >();
+            chunk.size = cursor.get < uint64_t >();
+
+            if (static_cast < uint64_t >(m_end - cursor.pos()) <
+                chunk.size) {
+                break;
+            }
+
+            chunk.payload = cursor.take(chunk.size);
+            chunk.begin = chunk.end = 0.0;
+
+            if (chunk.kind == trace::INDEX) {
+                break;
+            } else if (chunk.kind == trace::DATA) {
+                if (chunk.count > 0) {
+                    const double* dates = times(chunk);
+                    chunk.begin = dates[0];
+                    chunk.end = dates[chunk.count - 1];
+                }
+            } else if (chunk.count > 0) {
+                Cursor data(chunk.payload, chunk.payload + chunk.size);
+                data.take(8);
+                chunk.begin = chunk.end = data.get < double >();
+            }
+
+            m_chunks.push_back(chunk);
+        }
+    }
+
+    /*
+     * Build the list of the columns from the COLUMNS and REMOVES chunks.
+     */
+    void columns(std::vector < TraceColumn >& result) const
+    {
+        std::vector < std::size_t > ids;
+
+        for (std::size_t i = 0; i < m_chunks.size(); ++i) {
+            const Chunk& chunk = m_chunks[i];
+            Cursor cursor(chunk.payload, chunk.payload + chunk.size);
+
+            if (chunk.kind == trace::COLUMNS) {
+                for (uint32_t j = 0; j < chunk.count; ++j) {
+                    TraceColumn column;
+                    column.id = cursor.get < uint32_t >();
+                    cursor.get < uint32_t >();
+                    column.added = cursor.get < double >();
+                    column.view = cursor.getString();
+                    column.column.simulator = cursor.getString();
+                    column.column.parent = cursor.getString();
+                    column.column.port = cursor.getString();
+                    column.removed = HUGE_VAL;
+                    column.first = i;
+                    column.last = m_chunks.size();
+
+                    if (column.id >= ids.size()) {
+                        ids.resize(column.id + 1, result.size());
+                    }
+                    ids[column.id] = result.size();
+                    result.push_back(column);
+                }
+            } else if (chunk.kind == trace::REMOVES) {
+                for (uint32_t j = 0; j < chunk.count; ++j) {
+                    uint32_t id = cursor.get < uint32_t >();
+                    cursor.get < uint32_t >();
+                    double time = cursor.get < double >();
+
+                    if (id < ids.size() and ids[id] < result.size()) {
+                        result[ids[id]].removed = time;
+                        result[ids[id]].last = i;
+                    }
+                }
+            }
+        }
+    }
+
+    /*
+     * A view on a column block of a DATA chunk.
+     */
+    struct Block
+    {
+        uint32_t             lanes;
+        const unsigned char* types;
+        const double*        reals;
+        const int32_t*       integers;
+        const char*          values;
+        const char*          end;
+    };
+
+    const double* times(const Chunk& chunk) const
+    {
+        Cursor cursor(chunk.payload, chunk.payload + chunk.size);
+        cursor.take(8);
+        return reinterpret_cast < const double* >(
+            cursor.take(chunk.count * sizeof(double)));
+    }
+
+    bool block(const Chunk& chunk, std::size_t column, Block& result) const
+    {
+        const char* end = chunk.payload + chunk.size;
+        Cursor cursor(chunk.payload, end);
+        uint32_t columns = cursor.get < uint32_t >();
+
+        if (column >= columns) {
+            return false;
+        }
+
+        cursor.take(4 + chunk.count * sizeof(double) + column *
+                    sizeof(uint64_t));
+        uint64_t offset = cursor.get < uint64_t >();
+
+        if (offset >= chunk.size) {
+            throw utils::FileError(_("Trace: truncated or corrupted file"));
+        }
+
+        Cursor data(chunk.payload + offset, end);
+        result.lanes = data.get < uint32_t >();
+        data.take(4);
+        result.types = reinterpret_cast < const unsigned char* >(
+            data.take(chunk.count));
+        data.align(chunk.payload);
+
+        result.reals = 0;
+        if (result.lanes & 1) {
+            result.reals = reinterpret_cast < const double* >(
+                data.take(chunk.count * sizeof(double)));
+        }
+
+        result.integers = 0;
+        if (result.lanes & 2) {
+            result.integers = reinterpret_cast < const int32_t* >(
+                data.take(chunk.count * sizeof(int32_t)));
+            data.align(chunk.payload);
+        }
+
+        result.values = data.pos();
+        result.end = end;
+        return true;
+    }
+
+    std::string                         m_filename;
+    boost::interprocess::mapped_region  m_region;
+    const char*                         m_begin;
+    const char*                         m_end;
+    std::vector < Chunk >               m_chunks;
+};
+
+TraceReader::TraceReader(const utils::ModuleManager& modulemgr)
+    : StreamReader(modulemgr), mPimpl(0)
+{
+}
+
+TraceReader::~TraceReader()
+{
+    delete mPimpl;
+}
+
+void TraceReader::open(const std::string& filename)
+{
+    Pimpl* pimpl = new Pimpl(filename);
+    std::vector < TraceColumn > columns;
+
+    try {
+        pimpl->columns(columns);
+    } catch (...) {
+        delete pimpl;
+        throw;
+    }
+
+    delete mPimpl;
+    mPimpl = pimpl;
+    m_columns.swap(columns);
+}
+
+double TraceReader::begin() const
+{
+    if (mPimpl) {
+        for (std::size_t i = 0; i < mPimpl->m_chunks.size(); ++i) {
+            if (mPimpl->m_chunks[i].kind == trace::DATA) {
+                return mPimpl->m_chunks[i].begin;
+            }
+        }
+    }
+
+    return 0.0;
+}
+
+double TraceReader::end() const
+{
+    if (mPimpl) {
+        for (std::size_t i = mPimpl->m_chunks.size(); i > 0; --i) {
+            if (mPimpl->m_chunks[i - 1].kind == trace::DATA) {
+                return mPimpl->m_chunks[i - 1].end;
+            }
+        }
+    }
+
+    return 0.0;
+}
+
+std::size_t TraceReader::read(std::size_t column, double begin, double end,
+                              std::vector < double >& dates,
+                              std::vector < double >& values) const
+{
+    if (not mPimpl or column >= m_columns.size()) {
+        throw utils::ArgError(fmt(
+                _("Trace: unknown column %1%")) % column);
+    }
+
+    const TraceColumn& col = m_columns[column];
+    std::size_t result = 0;
+
+    for (std::size_t i = col.first + 1; i < col.last and
+         i < mPimpl->m_chunks.size(); ++i) {
+        const Pimpl::Chunk& chunk = mPimpl->m_chunks[i];
+        Pimpl::Block block;
+
+        if (chunk.kind != trace::DATA or chunk.end < begin or
+            chunk.begin > end or not mPimpl->block(chunk, col.id, block)) {
+            continue;
+        }
+
+        const double* times = mPimpl->times(chunk);
+        for (uint32_t j = 0; j < chunk.count; ++j) {
+            if (times[j] < begin or times[j] > end) {
+                continue;
+            }
+
+            if (block.types[j] == Row::REAL) {
+                dates.push_back(times[j]);
+                values.push_back(block.reals[j]);
+                ++result;
+            } else if (block.types[j] == Row::INTEGER) {
+                dates.push_back(times[j]);
+                values.push_back(block.integers[j]);
+                ++result;
+            }
+        }
+    }
+
+    return result;
+}
+
+void TraceReader::play(const std::string& plugin,
+                       const std::string& package,
+                       const std::string& location,
+                       double begin, double end)
+{
+    if (not mPimpl) {
+        throw utils::ArgError(_("Trace: no file opened"));
+    }
+
+    std::string file(mPimpl->m_filename);
+    std::string::size_type slash = file.find_last_of("/\\");
+    if (slash != std::string::npos) {
+        file.erase(0, slash + 1);
+    }
+    if (file.size() > 6 and file.compare(file.size() - 6, 6, ".trace") == 0) {
+        file.erase(file.size() - 6);
+    }
+
+    onParameter(plugin, package, location, file, 0, begin);
+
+    std::vector < std::size_t > active;
+    std::size_t next = 0;
+
+    for (std::size_t i = 0; i < mPimpl->m_chunks.size(); ++i) {
+        const Pimpl::Chunk& chunk = mPimpl->m_chunks[i];
+
+        if (chunk.kind == trace::COLUMNS) {
+            for (; next < m_columns.size() and m_columns[next].first == i;
+                 ++next) {
+                const TraceColumn& col = m_columns[next];
+
+                if (col.id >= active.size()) {
+                    active.resize(col.id + 1, m_columns.size());
+                }
+                active[col.id] = next;
+
+                if (col.added <= end and col.removed >= begin) {
+                    onNewObservable(col.column.simulator, col.column.parent,
+                                    col.column.port, col.view,
+                                    std::max(col.added, begin));
+                }
+            }
+        } else if (chunk.kind == trace::REMOVES) {
+            for (std::size_t j = 0; j < active.size(); ++j) {
+                if (active[j] < m_columns.size() and
+                    m_columns[active[j]].last == i) {
+                    const TraceColumn& col = m_columns[active[j]];
+
+                    if (col.removed >= begin and col.removed <= end) {
+                        onDelObservable(col.column.simulator,
+                                        col.column.parent, col.column.port,
+                                        col.view, col.removed);
+                    }
+                    active[j] = m_columns.size();
+                }
+            }
+        } else if (chunk.kind == trace::DATA and chunk.end >= begin and
+                   chunk.begin <= end) {
+            const double* times = mPimpl->times(chunk);
+            std::vector < Pimpl::Block > blocks(active.size());
+            std::vector < bool > present(active.size(), false);
+            std::vector < Cursor > values;
+
+            for (std::size_t j = 0; j < active.size(); ++j) {
+                if (active[j] < m_columns.size() and
+                    mPimpl->block(chunk, j, blocks[j])) {
+                    present[j] = true;
+                } else {
+                    blocks[j].values = blocks[j].end = 0;
+                }
+                values.push_back(Cursor(blocks[j].values, blocks[j].end));
+            }
+
+            for (uint32_t k = 0; k < chunk.count; ++k) {
+                for (std::size_t j = 0; j < active.size(); ++j) {
+                    if (not present[j]) {
+                        continue;
+                    }
+
+                    const Pimpl::Block& block = blocks[j];
+                    value::Value* val = 0;
+
+                    switch (block.types[k]) {
+                    case Row::NONE:
+                        continue;
+                    case Row::REAL:
+                        val = value::Double::create(block.reals[k]);
+                        break;
+                    case Row::INTEGER:
+                        val = value::Integer::create(block.integers[k]);
+                        break;
+                    case Row::VALUE: {
+                        std::string str(values[j].getString());
+                        value::BinaryReader reader(str.data(), str.size());
+                        val = reader.read();
+                        break;
+                    }
+                    default:
+                        break;
+                    }
+
+                    if (times[k] < begin or times[k] > end) {
+                        delete val;
+                    } else {
+                        const TraceColumn& col = m_columns[active[j]];
+                        onValue(col.column.simulator, col.column.parent,
+                                col.column.port, col.view, times[k], val);
+                    }
+                }
+            }
+        }
+    }
+
+    onClose(std::min(end, this->end()));
+}
+
+}} // namespace vle oov
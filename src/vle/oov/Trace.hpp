@@ -0,0 +1,283 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef VLE_OOV_TRACE_HPP
+#define VLE_OOV_TRACE_HPP
+
+#include <vle/DllDefines.hpp>
+#include <vle/oov/Plugin.hpp>
+#include <vle/oov/Row.hpp>
+#include <vle/oov/StreamReader.hpp>
+#include <vle/utils/Types.hpp>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace vle { namespace oov {
+
+/**
+ * @brief The binary trace format, written by the TracePlugin and read by
+ * the TraceReader.
+ *
+ * A trace file is a header followed by chunks. Each chunk starts with a
+ * 16 bytes header (uint32 kind, uint32 count, uint64 size of the
+ * payload) and its payload is padded to 8 bytes, so the lanes of a
+ * mapped file are aligned. The numbers use the byte order of the
+ * writer, checked by the reader.
+ *
+ * - \c COLUMNS: \c count new observables (uint32 id, double date, the
+ *   view, simulator, parent and port names).
+ * - \c REMOVES: \c count observables removed (uint32 id, double date).
+ * - \c DATA: \c count rows. The payload stores the number of columns,
+ *   the dates of the rows and a block for each column: the type of each
+ *   row (oov::Row::Type), then the real, integer and value lanes used by
+ *   the column. Each value is stored as a string holding its
+ *   value::BinaryWriter stream.
+ * - \c INDEX: the kind, number of rows, offset and dates of all the
+ *   chunks. The file ends with the offset of the index and the magic
+ *   string \c VLEINDEX.
+ *
+ * A trace file without index (simulation interrupted) is still readable:
+ * the reader rebuilds the index from the chunk headers.
+ */
+namespace trace {
+
+enum ChunkKind { COLUMNS = 1, REMOVES = 2, DATA = 3, INDEX = 4 };
+
+const char MAGIC[] = "VLETRACE";
+const char INDEX_MAGIC[] = "VLEINDEX";
+const uint32_t VERSION = 2;
+const uint32_t ENDIANNESS = 0x01020304;
+
+} // namespace trace
+
+/**
+ * @brief The TracePlugin writes the observations of a view into a binary
+ * trace file \c location/file.trace.
+ *
+ * The rows are buffered by column and written in \c DATA chunks of \c
+ * rows rows (1024 by default, set by an integer \c rows in the \c
+ * value::Map of parameters). This class is built into the library; an
+ * output package exports it with:
+ * @code
+ * DECLARE_OOV_PLUGIN(vle::oov::TracePlugin)
+ * @endcode
+ */
+class VLE_API TracePlugin : public Plugin
+{
+public:
+    TracePlugin(const std::string& location);
+
+    virtual ~TracePlugin();
+
+    virtual std::string name() const
+    { return "trace"; }
+
+    virtual void onParameter(const std::string& plugin,
+                             const std::string& location,
+                             const std::string& file,
+                             value::Value* parameters,
+                             const double& time);
+
+    virtual void onNewObservable(const std::string& simulator,
+                                 const std::string& parent,
+                                 const std::string& port,
+                                 const std::string& view,
+                                 const double& time);
+
+    virtual void onDelObservable(const std::string& simulator,
+                                 const std::string& parent,
+                                 const std::string& port,
+                                 const std::string& view,
+                                 const double& time);
+
+    virtual void onValue(const std::string& simulator,
+                         const std::string& parent,
+                         const std::string& port,
+                         const std::string& view,
+                         const double& time,
+                         value::Value* value);
+
+    virtual void onRow(Row& row);
+
+    virtual void close(const double& time);
+
+    /**
+     * @brief Get the name of the trace file.
+     */
+    const std::string& filename() const
+    { return m_filename; }
+
+private:
+    TracePlugin(const TracePlugin& other);
+    TracePlugin& operator=(const TracePlugin& other);
+
+    struct Buffer
+    {
+        std::vector < unsigned char >   types;
+        std::vector < double >          reals;
+        std::vector < int32_t >         integers;
+        std::vector < std::string >     values;
+    };
+
+    struct Entry
+    {
+        uint32_t kind;
+        uint32_t count;
+        uint64_t offset;
+        double   begin;
+        double   end;
+    };
+
+    void append(const Row& row);
+    void flushColumns();
+    void flushRemoves();
+    void flushData();
+    void flushValues();
+    void writeChunk(uint32_t kind, uint32_t count,
+                    const std::string& payload, double begin, double end);
+
+    std::string                         m_filename;
+    std::ofstream                       m_file;
+    std::size_t                         m_rows;
+    Row                                 m_row;
+    std::map < std::string, Row::size_type > m_ids;
+    bool                                m_pending;
+
+    std::vector < Buffer >              m_buffers;
+    std::vector < double >              m_times;
+
+    std::string                         m_columns;
+    uint32_t                            m_added;
+    double                              m_addedTime;
+    std::string                         m_removes;
+    uint32_t                            m_removed;
+    double                              m_removedTime;
+
+    std::vector < Entry >               m_index;
+    uint64_t                            m_offset;
+};
+
+/**
+ * @brief An observable of a trace file.
+ */
+struct VLE_API TraceColumn
+{
+    Column              column;
+    std::string         view;
+    Row::size_type      id; /**< The column in the DATA chunks. */
+    double              added;
+    double              removed; /**< infinity if never removed. */
+    std::size_t         first; /**< The first chunk of the column. */
+    std::size_t         last; /**< The chunk which removes the column. */
+};
+
+/**
+ * @brief The TraceReader maps a trace file into memory and reads the
+ * observations of a date range, using the index of the file to skip the
+ * chunks outside the range.
+ *
+ * @code
+ * oov::TraceReader reader(modulemgr);
+ * reader.open("exp_view.trace");
+ *
+ * std::vector < double > dates, values;
+ * reader.read(0, 100.0, 200.0, dates, values);
+ *
+ * // or replay the observations into an output plug-in.
+ * reader.play("storage", "vle.output", "", 100.0, 200.0);
+ * @endcode
+ */
+class VLE_API TraceReader : public StreamReader
+{
+public:
+    TraceReader(const utils::ModuleManager& modulemgr);
+
+    virtual ~TraceReader();
+
+    /**
+     * @brief Map the trace file and read its index.
+     * @param filename the trace file.
+     * @throw utils::FileError if the file is not a trace file.
+     */
+    void open(const std::string& filename);
+
+    /**
+     * @brief Get the observables of the trace file, in the order of
+     * their creation.
+     */
+    const std::vector < TraceColumn >& columns() const
+    { return m_columns; }
+
+    /**
+     * @brief Get the date of the first row.
+     */
+    double begin() const;
+
+    /**
+     * @brief Get the date of the last row.
+     */
+    double end() const;
+
+    /**
+     * @brief Read the real and integer values of an observable between
+     * two dates, without building \c value::Value. The empty and non
+     * numeric values are skipped.
+     * @param column the index of the observable in \c columns().
+     * @param begin the first date.
+     * @param end the last date.
+     * @param[out] dates the dates of the values.
+     * @param[out] values the values.
+     * @return the number of values read.
+     */
+    std::size_t read(std::size_t column, double begin, double end,
+                     std::vector < double >& dates,
+                     std::vector < double >& values) const;
+
+    /**
+     * @brief Send the observations between two dates to an output
+     * plug-in, using the StreamReader callbacks.
+     * @param plugin the name of the plug-in.
+     * @param package the package of the plug-in.
+     * @param location the location of the plug-in.
+     * @param begin the first date.
+     * @param end the last date.
+     */
+    void play(const std::string& plugin, const std::string& package,
+              const std::string& location, double begin, double end);
+
+private:
+    class Pimpl;
+    Pimpl* mPimpl;
+
+    std::vector < TraceColumn > m_columns;
+};
+
+}} // namespace vle oov
+
+#endif
@@ -31,8 +31,15 @@
 
 #ifdef G_OS_WIN32
 #include <io.h>
+#include <process.h>
+#include <windows.h>
+#else
+#include <unistd.h>
 #endif
 
+#include <fcntl.h>
+#include <cstdio>
+
 #include <vle/utils/Path.hpp>
 //#include <vle/utils/Package.hpp>
 #include <vle/utils/Exception.hpp>
@@ -454,6 +461,68 @@ std::string Path::writeToTemp(const std::string& prefix,
     return filename;
 }
 
+void Path::writeAtomic(const std::string& filename,
+                       const std::string& buffer)
+{
+#ifdef G_OS_WIN32
+    std::string tmp = (fmt("%1%.%2%") % filename % ::_getpid()).str();
+    int fd = ::_open(tmp.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC |
+                     _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    std::string tmp = (fmt("%1%.%2%") % filename % ::getpid()).str();
+    int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+#endif
+
+    if (fd == -1) {
+        throw utils::FileError(fmt(_("Cannot open file '%1%'")) % tmp);
+    }
+
+    const char* data = buffer.data();
+    std::size_t size = buffer.size();
+    bool success = true;
+
+    while (success and size > 0) {
+#ifdef G_OS_WIN32
+        int sz = ::_write(fd, data, static_cast < unsigned int >(size));
+#else
+        ssize_t sz = ::write(fd, data, size);
+#endif
+        if (sz <= 0) {
+            success = false;
+        } else {
+            data += sz;
+            size -= sz;
+        }
+    }
+
+#ifdef G_OS_WIN32
+    success = success and ::_commit(fd) == 0;
+    success = ::_close(fd) == 0 and success;
+#else
+    success = success and ::fsync(fd) == 0;
+    success = ::close(fd) == 0 and success;
+#endif
+
+    if (not success) {
+        std::remove(tmp.c_str());
+        throw utils::FileError(fmt(_("Cannot write file '%1%'")) % tmp);
+    }
+
+#ifdef G_OS_WIN32
+    success = ::MoveFileExA(tmp.c_str(), filename.c_str(),
+                            MOVEFILE_REPLACE_EXISTING |
+                            MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    success = std::rename(tmp.c_str(), filename.c_str()) == 0;
+#endif
+
+    if (not success) {
+        std::remove(tmp.c_str());
+        throw utils::FileError(fmt(
+                _("Cannot rename '%1%' into '%2%'")) % tmp % filename);
+    }
+}
+
 
 std::string Path::buildFilename(const std::string& dir,
                                 const std::string& file)
@@ -372,6 +372,18 @@ public:
     static std::string writeToTemp(const std::string& prefix,
                                    const std::string& buffer);
 
+    /**
+     * Replace the file \c filename by the buffer. The buffer is written
+     * and synchronized to a temporary file beside \c filename, which is
+     * then renamed over it: a reader sees the old or the new content,
+     * never a partial file.
+     * @param filename the file to write.
+     * @param buffer buffer to write.
+     * @throw utils::FileError if the file cannot be written or renamed.
+     */
+    static void writeAtomic(const std::string& filename,
+                            const std::string& buffer);
+
     static std::string buildFilename(const std::string& dir,
                                      const std::string& file);
     static std::string buildFilename(const std::string& dir1,
@@ -25,11 +25,218 @@
  */
 
 
-#include <cmath>
 #include <vle/utils/Rand.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/i18n.hpp>
+#include <algorithm>
+#include <cmath>
 
 namespace vle { namespace utils {
 
+namespace {
+
+const uint32_t PHILOX_M0 = 0xD2511F53;
+const uint32_t PHILOX_M1 = 0xCD9E8D57;
+const uint32_t PHILOX_W0 = 0x9E3779B9;
+const uint32_t PHILOX_W1 = 0xBB67AE85;
+
+/**
+ * @brief The 64 bits FNV-1a hash of a string.
+ */
+uint64_t hash(const std::string& str)
+{
+    const uint64_t prime = (static_cast < uint64_t >(0x100) << 32) | 0x1b3;
+    uint64_t result = (static_cast < uint64_t >(0xcbf29ce4) << 32) |
+        0x84222325;
+
+    for (std::string::const_iterator it = str.begin(); it != str.end();
+         ++it) {
+        result ^= static_cast < unsigned char >(*it);
+        result *= prime;
+    }
+
+    return result;
+}
+
+inline void mulhilo(uint32_t a, uint32_t b, uint32_t& hi, uint32_t& lo)
+{
+    uint64_t product = static_cast < uint64_t >(a) * b;
+
+    hi = static_cast < uint32_t >(product >> 32);
+    lo = static_cast < uint32_t >(product);
+}
+
+/**
+ * @brief Convert two numbers of a stream into a real [0, 1) of 53 bits.
+ */
+inline double toDouble(uint32_t a, uint32_t b)
+{
+    return ((a >> 5) * 67108864.0 + (b >> 6)) * (1.0 / 9007199254740992.0);
+}
+
+} // anonymous namespace
+
+void Philox::seed(uint32_t seed, uint32_t replica, const std::string& path)
+{
+    uint64_t h = hash(path);
+
+    m_key[0] = seed;
+    m_key[1] = replica;
+    m_counter[0] = 0;
+    m_counter[1] = 0;
+    m_counter[2] = static_cast < uint32_t >(h);
+    m_counter[3] = static_cast < uint32_t >(h >> 32);
+    m_index = 4;
+}
+
+void Philox::encrypt(const uint32_t counter[4], const uint32_t key[2],
+                     uint32_t out[4])
+{
+    uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2],
+             c3 = counter[3];
+    uint32_t k0 = key[0], k1 = key[1];
+
+    for (int round = 0; round < 10; ++round) {
+        uint32_t hi0, lo0, hi1, lo1;
+
+        if (round > 0) {
+            k0 += PHILOX_W0;
+            k1 += PHILOX_W1;
+        }
+
+        mulhilo(PHILOX_M0, c0, hi0, lo0);
+        mulhilo(PHILOX_M1, c2, hi1, lo1);
+
+        c0 = hi1 ^ c1 ^ k0;
+        c1 = lo1;
+        c2 = hi0 ^ c3 ^ k1;
+        c3 = lo0;
+    }
+
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+}
+
+void Philox::refill()
+{
+    encrypt(m_counter, m_key, m_block);
+
+    if (++m_counter[0] == 0) {
+        ++m_counter[1];
+    }
+
+    m_index = 0;
+}
+
+void Philox::save(uint32_t state[STATE]) const
+{
+    std::copy(m_key, m_key + 2, state);
+    std::copy(m_counter, m_counter + 4, state + 2);
+    std::copy(m_block, m_block + 4, state + 6);
+    state[10] = m_index;
+}
+
+void Philox::load(const uint32_t state[STATE])
+{
+    if (state[10] > 4) {
+        throw utils::ArgError(_("Philox: bad state of the stream"));
+    }
+
+    std::copy(state, state + 2, m_key);
+    std::copy(state + 2, state + 6, m_counter);
+    std::copy(state + 6, state + 10, m_block);
+    m_index = state[10];
+}
+
+void Philox::discard(uint64_t n)
+{
+    uint64_t buffered = 4 - m_index;
+
+    if (n <= buffered) {
+        m_index += static_cast < unsigned int >(n);
+        return;
+    }
+
+    n -= buffered;
+
+    uint64_t counter = (static_cast < uint64_t >(m_counter[1]) << 32) |
+        m_counter[0];
+
+    counter += n / 4;
+    m_counter[0] = static_cast < uint32_t >(counter);
+    m_counter[1] = static_cast < uint32_t >(counter >> 32);
+
+    refill();
+    m_index = static_cast < unsigned int >(n % 4);
+}
+
+void Philox::generate(uint32_t* out, std::size_t n)
+{
+    while (n > 0 and m_index < 4) {
+        *out++ = m_block[m_index++];
+        --n;
+    }
+
+    while (n >= 4) {
+        encrypt(m_counter, m_key, out);
+
+        if (++m_counter[0] == 0) {
+            ++m_counter[1];
+        }
+
+        out += 4;
+        n -= 4;
+    }
+
+    if (n > 0) {
+        refill();
+        std::copy(m_block, m_block + n, out);
+        m_index = static_cast < unsigned int >(n);
+    }
+}
+
+void Philox::uniform(double* out, std::size_t n)
+{
+    uint32_t buffer[512];
+
+    while (n > 0) {
+        std::size_t size = std::min(n, static_cast < std::size_t >(256));
+
+        generate(buffer, 2 * size);
+        for (std::size_t i = 0; i < size; ++i) {
+            out[i] = toDouble(buffer[2 * i], buffer[2 * i + 1]);
+        }
+
+        out += size;
+        n -= size;
+    }
+}
+
+void Philox::normal(double* out, std::size_t n, double mean, double sigma)
+{
+    const double pi2 = 2.0 * M_PI;
+    std::size_t pairs = n / 2;
+
+    uniform(out, 2 * pairs);
+    for (std::size_t i = 0; i < 2 * pairs; i += 2) {
+        double r = sigma * std::sqrt(-2.0 * std::log(1.0 - out[i]));
+        double theta = pi2 * out[i + 1];
+
+        out[i] = mean + r * std::cos(theta);
+        out[i + 1] = mean + r * std::sin(theta);
+    }
+
+    if (n % 2) {
+        double u[2];
+
+        uniform(u, 2);
+        out[n - 1] = mean + sigma * std::sqrt(-2.0 * std::log(1.0 - u[0])) *
+            std::cos(pi2 * u[1]);
+    }
+}
+
 double Rand::vonMises(const double kappa, const double mu)
 {
     // FIXME: get_double_included instead of getDouble()
@@ -83,4 +290,57 @@ double Rand::weibull3(const double a, const double b, const double c)
     return c + b * x;
 }
 
+double RandStream::vonMises(const double kappa, const double mu)
+{
+    // FIXME: get_double_included instead of getDouble()
+    if (kappa <= 1e-6){
+        return 2. * M_PI * getDouble();
+    }
+
+    double a = 1.0 + sqrt(1.0 + 4.0 * kappa * kappa);
+    double b = (a  - sqrt(2.0 * a))/(2.0 * kappa);
+    double r = (1.0 + b * b)/(2.0 * b);
+    double f;
+
+    for (;;) {
+        double u1 = getDouble();
+        double z = cos(M_PI * u1);
+
+        f = (1.0 + r * z)/(r + z);
+        double c = kappa * (r - f);
+        double u2 = getDouble();
+
+        if (not (u2 >= c * (2.0 - c) and u2 > c * exp(1.0 - c)))
+            break;
+    }
+    double u3 = getDouble();
+
+    return (u3 > 0.5) ? mu + acos(f) : mu - acos(f);
+}
+
+double RandStream::getDoubleExcluded()
+{
+    double x ;
+    do {
+        x = getDouble();
+    }
+    while (x == 0);
+
+    return x ;
+}
+
+double RandStream::weibull(const double a, const double b)
+{
+    double x = pow(-log(getDoubleExcluded()), 1.0 / a);
+
+    return b * x;
+}
+
+double RandStream::weibull3(const double a, const double b, const double c)
+{
+    double x = pow(-log(getDoubleExcluded()), 1.0 / a);
+
+    return c + b * x;
+}
+
 }} // namespace vle utils
@@ -42,10 +42,176 @@
 #include <boost/random/geometric_distribution.hpp>
 #include <boost/random/cauchy_distribution.hpp>
 #include <boost/random/triangle_distribution.hpp>
+#include <boost/config.hpp>
 #include <vle/DllDefines.hpp>
+#include <vle/utils/Types.hpp>
+#include <string>
 
 namespace vle { namespace utils {
 
+    /**
+     * @brief vle::utils::Philox is the counter-based pseudo-random number
+     * generator Philox4x32-10: the n-th block of four numbers of a stream
+     * is the encryption of the counter n by the key of the stream. A
+     * stream is cheap to build, independent of the other streams and
+     * reproducible whatever the order in which the streams are used.
+     *
+     * The key is the seed and the replica of the stream, the high words
+     * of the counter a hash of its path (the complete name of a model), so
+     * each stream has 2^64 blocks.
+     *
+     * @note "Parallel random numbers: as easy as 1, 2, 3", John K. Salmon,
+     * Mark A. Moraes, Ron O. Dror and David E. Shaw, Proceedings of the
+     * International Conference for High Performance Computing, Networking,
+     * Storage and Analysis (SC11), 2011.
+     *
+     * @code
+     * vle::utils::Philox p(12345, 0, "top:model");
+     * uint32_t x = p();
+     *
+     * std::vector < double > u(1024);
+     * p.uniform(&u[0], u.size()); // [0.0, 1.0)
+     * @endcode
+     */
+    class VLE_API Philox
+    {
+    public:
+        typedef uint32_t result_type;
+
+        BOOST_STATIC_CONSTANT(bool, has_fixed_range = false);
+
+        /**
+         * @brief Build the stream of the seed 0, replica 0 and an empty
+         * path.
+         */
+        Philox()
+        { seed(0, 0, std::string()); }
+
+        /**
+         * @brief Build the stream of the seed, replica 0 and an empty path.
+         * @param seed The seed of the stream.
+         */
+        explicit Philox(result_type seed)
+        { this->seed(seed, 0, std::string()); }
+
+        /**
+         * @brief Build the stream of a seed, a replica and a path.
+         * @param seed The seed of the experiment.
+         * @param replica The replica of the experiment.
+         * @param path The path of the stream.
+         */
+        Philox(uint32_t seed, uint32_t replica, const std::string& path)
+        { this->seed(seed, replica, path); }
+
+        /**
+         * @brief Restart the stream of the seed, replica 0 and an empty
+         * path.
+         * @param seed The seed of the stream.
+         */
+        void seed(result_type seed)
+        { this->seed(seed, 0, std::string()); }
+
+        /**
+         * @brief Restart the stream of a seed, a replica and a path.
+         * @param seed The seed of the experiment.
+         * @param replica The replica of the experiment.
+         * @param path The path of the stream.
+         */
+        void seed(uint32_t seed, uint32_t replica, const std::string& path);
+
+        result_type min BOOST_PREVENT_MACRO_SUBSTITUTION () const
+        { return 0; }
+
+        result_type max BOOST_PREVENT_MACRO_SUBSTITUTION () const
+        { return 0xffffffff; }
+
+        /**
+         * @brief Get the next number of the stream.
+         * @return a random unsigned int [0..2^32-1].
+         */
+        result_type operator()()
+        {
+            if (m_index == 4) {
+                refill();
+            }
+
+            return m_block[m_index++];
+        }
+
+        /**
+         * @brief Skip numbers of the stream.
+         * @param n The number of numbers to skip.
+         */
+        void discard(uint64_t n);
+
+        /**
+         * @brief Fill an array with the next numbers of the stream, the
+         * same numbers as \c n calls of operator().
+         * @param out The array.
+         * @param n The size of the array.
+         */
+        void generate(uint32_t* out, std::size_t n);
+
+        /**
+         * @brief Fill an array with reals [0, 1), each made of 53 bits of
+         * two numbers of the stream.
+         * @param out The array.
+         * @param n The size of the array.
+         */
+        void uniform(double* out, std::size_t n);
+
+        /**
+         * @brief Fill an array with reals of the normal law, using the
+         * Box-Muller transform of pairs of uniform reals. An odd \c n
+         * uses a full pair for the last real.
+         * @param out The array.
+         * @param n The size of the array.
+         * @param mean The mean of the law.
+         * @param sigma The standard deviation of the law.
+         */
+        void normal(double* out, std::size_t n, double mean, double sigma);
+
+        /**
+         * @brief Encrypt a counter with a key, the ten rounds of Philox.
+         * @param counter The counter.
+         * @param key The key.
+         * @param[out] out The block of four numbers.
+         */
+        static void encrypt(const uint32_t counter[4], const uint32_t key[2],
+                            uint32_t out[4]);
+
+        /**
+         * @brief The size of the state of the stream: the key, the
+         * counter, the current block and the index into the block.
+         */
+        BOOST_STATIC_CONSTANT(std::size_t, STATE = 11);
+
+        /**
+         * @brief Copy the state of the stream, to continue it later with
+         * load().
+         * @param[out] state The state.
+         */
+        void save(uint32_t state[STATE]) const;
+
+        /**
+         * @brief Restore a state copied by save(). The stream continues
+         * with the numbers which followed the save().
+         * @param state The state.
+         * @throw utils::ArgError if the state is corrupted.
+         */
+        void load(const uint32_t state[STATE]);
+
+    private:
+        void refill();
+
+        uint32_t        m_key[2];
+        uint32_t        m_counter[4]; /**< The counter of the next block,
+                                        m_counter[0] is the low word. */
+        uint32_t        m_block[4];
+        unsigned int    m_index; /**< The next number of m_block, 4 if
+                                   m_block is consumed. */
+    };
+
     /**
      * @brief vle::utils::Rand is a pseudo-random number generator based on
      * boost random packages. vle::utils::Rand uses the mersene_twister PRNG.
@@ -371,6 +537,347 @@ namespace vle { namespace utils {
         boost::mt19937  m_rand;
     };
 
+    /**
+     * @brief vle::utils::RandStream provides the distributions of
+     * vle::utils::Rand on top of a vle::utils::Philox stream. The stream of
+     * a model only depends on the seed and the replica of the experiment
+     * and on the complete name of the model, so a simulation draws the same
+     * numbers whatever the order or the thread of the transitions of its
+     * models.
+     *
+     * @code
+     * vle::utils::RandStream r(12345, 0, "top:model");
+     * r.normal(0.0, 1.0);
+     *
+     * std::vector < double > n(1024);
+     * r.normal(&n[0], n.size(), 0.0, 1.0);
+     * @endcode
+     */
+    class VLE_API RandStream
+    {
+    public:
+        typedef Philox::result_type result_type;
+
+        /**
+         * @brief Create the stream of the seed 0, replica 0 and an empty
+         * path.
+         */
+        RandStream() {}
+
+        /**
+         * @brief Create the stream of a seed, a replica and a path.
+         * @param seed The seed of the experiment.
+         * @param replica The replica of the experiment.
+         * @param path The path of the stream.
+         */
+        RandStream(uint32_t seed, uint32_t replica, const std::string& path)
+            : m_rand(seed, replica, path)
+        {}
+
+        /**
+         * @brief Restart the stream of the seed, replica 0 and an empty
+         * path.
+         * @param seed The seed of the stream.
+         */
+        void seed(result_type seed)
+        { m_rand.seed(seed); }
+
+        /**
+         * @brief Restart the stream of a seed, a replica and a path.
+         * @param seed The seed of the experiment.
+         * @param replica The replica of the experiment.
+         * @param path The path of the stream.
+         */
+        void seed(uint32_t seed, uint32_t replica, const std::string& path)
+        { m_rand.seed(seed, replica, path); }
+
+        /**
+         * @brief Generate a boolean value [true, false] using the Bernoulli
+         * distribition where p = 0.5. (P(true) = p, P(false) = 1 - p).
+         * @return a random true or false boolean.
+         */
+        inline bool getBool()
+        {
+            boost::bernoulli_distribution < > distrib(0.5);
+            boost::variate_generator < Philox&,
+                boost::bernoulli_distribution < > >gen(m_rand, distrib);
+
+            return gen();
+        }
+
+        /**
+         * @brief Gererate an unsigned int value [0..2^32-1].
+         * @return a random unsigned int
+         */
+        inline result_type getInt()
+        {
+            return m_rand();
+        }
+
+        /**
+         * @brief Generate an integer from begin to end [begin..end].
+         * @param begin The minimum value include.
+         * @param end The limit of the range.
+         * @return a random integer.
+         */
+        inline int getInt(int begin, int end)
+        {
+            boost::uniform_int < > distrib(begin, end);
+            boost::variate_generator < Philox&,
+                boost::uniform_int < > > gen(m_rand, distrib);
+
+            return gen();
+        }
+
+        /**
+         * @brief Generate a real value [0, 1)
+         * @return a random real.
+         */
+        inline double getDouble()
+        {
+            boost::uniform_real < > distrib(0.0, 1.0);
+            boost::variate_generator < Philox&,
+                boost::uniform_real < > > gen(m_rand, distrib);
+
+            return gen();
+        }
+
+        /**
+         * @brief Generate a real from begin to end [begin..end).
+         * @param begin The minimum value.
+         * @param end The limit (exclude) of the range.
+         * @return a random real.
+         */
+        inline double getDouble(double begin, double end)
+        {
+            boost::uniform_real < > distrib(begin, end);
+            boost::variate_generator < Philox&,
+                boost::uniform_real < > > gen(m_rand, distrib);
+
+            return gen();
+        }
+
+        /**
+         * @brief Generate a real value (0, 1);
+         * 0 and 1 are excluded from the generated values.
+         * @return a random real.
+         */
+        double getDoubleExcluded();
+
+        /**
+         * @brief Generate a real using the normal law.
+         * @param mean
+         * @param sigma
+         * @return a real.
+         */
+        double normal(double mean, double sigma)
+        {
+            boost::normal_distribution < > distrib(mean, sigma);
+            boost::variate_generator < Philox&,
+                boost::normal_distribution < > > gen(m_rand, distrib);
+
+            return gen();
+        }
+
+        /**
+         * @brief Generate a real using the Log Normal law.
+         * @param mean
+         * @param sigma
+         * @return a real.
+         */
+        double logNormal(double mean, double sigma)
+        {
+            boost::lognormal_distribution < > distrib(mean, sigma);
+            boost::variate_generator < Philox&,
+                boost::lognormal_distribution < > > gen(m_rand, distrib);
+
+            return gen();
+        }
+
+        /**
+         * @brief Generate a real using an exponential distribution.
+         * @param rate
+         * @return a real between 0 and infinite.
+         */
+        double exponential(double rate)
+        {
+            boost::exponential_distribution < > distrib(rate);
+            boost::variate_generator < Philox&,
+                boost::exponential_distribution < > > gen(m_rand, distrib);
+
+            return gen();
+        }
+
+        /**
+         * @brief Generate a random number between 0 and 2*PI using the von
+         * Mises law [0..2*PI]. mu is the mean angle, expressed in radians
+         * between 0 and 2*pi, and kappa is the concentration parameter, which
+         * must be greater than or equal to zero. If kappa is equal to zero,
+         * this distribution reduces to a uniform random angle over the range 0
+         * to 2*pi.angle, expressed in radians between 0 and 2*pi, and kappa is
+         * the concentration parameter, which must be greater than or equal to
+         * zero.  If kappa is equal to zero, this distribution reduces to a
+         * uniform random angle over the range 0 to 2*pi.
+         * @param kappa
+         * @param mu
+         * @return a random number [0,2PI]
+         */
+        double vonMises(double kappa, double mu);
+
+        /**
+         * @brief Generate a real using the Poisson distribution.
+         * @param mean
+         * @return a real.
+         */
+        double poisson(double mean)
+        {
+            boost::poisson_distribution < > distrib(mean);
+            boost::variate_generator < Philox&,
+                boost::poisson_distribution < > > gen(m_rand, distrib);
+
+            return gen();
+        }
+
+        /**
+         * @brief Generate a real using the Gamma distribution.
+         * @param alpha
+         * @return a real.
+         */
+        double gamma(double alpha)
+        {
+            boost::gamma_distribution < > distrib(alpha);
+            boost::variate_generator < Philox&,
+                boost::gamma_distribution < > > gen(m_rand, distrib);
+
+            return gen();
+        }
+
+        /**
+         * @brief Generate a real using the Binomial distribution.
+         * @param t
+         * @param p
+         * @return a real.
+         */
+        double binomial(int t, double p)
+        {
+            boost::binomial_distribution < > distrib(t, p);
+            boost::variate_generator < Philox&,
+                boost::binomial_distribution < > > gen(m_rand, distrib);
+
+            return gen();
+        }
+
+        /**
+         * @brief Generate a real using the Geometric distribution.
+         * @param p
+         * @return a real.
+         */
+        double geometric(double p)
+        {
+            boost::geometric_distribution < > distrib(p);
+            boost::variate_generator < Philox&,
+                boost::geometric_distribution < > > gen(m_rand, distrib);
+
+            return gen();
+        }
+
+        /**
+         * @brief Generate a real using the Cauchy law.
+         * @param median
+         * @param sigma
+         * @return a real.
+         */
+        double cauchy(double median, double sigma)
+        {
+            boost::cauchy_distribution < > distrib(median, sigma);
+            boost::variate_generator < Philox&,
+                boost::cauchy_distribution < > > gen(m_rand, distrib);
+
+            return gen();
+        }
+
+        /**
+         * @brief Generate a real using the triangular law.
+         * @param a
+         * @param b
+         * @param c
+         * @return a real.
+         */
+        double triangle(double a, double b, double c)
+        {
+            boost::triangle_distribution < > distrib(a, b, c);
+            boost::variate_generator < Philox&,
+                boost::triangle_distribution < > > gen(m_rand, distrib);
+
+            return gen();
+        }
+
+        /**
+         * @brief Generate a real using the Weibull law. This version is a
+         * two-parameter Weibull distribution (where c or gamma = 0)
+         * @param a continuous shape parameter (beta > 0)
+         * @param b continuous scale parameter (alpha > 0)
+         * @return a real.
+         *
+         * @note: Several notations exist where:
+         * a = beta = k to represent the shape;
+         * b = alpha = lambda to represent the scale.
+         */
+        double weibull(const double a, const double b);
+
+        /**
+         * @brief Generate a real using the Weibull law. This version is a
+         * three-parameter Weibull distribution
+         * @param a continuous shape parameter (beta > 0)
+         * @param b continuous scale parameter (alpha > 0)
+         * @param c continuous location parameter (gamma > 0)
+         * @return a real.
+         *
+         * @note: Several notations exist where:
+         * a = beta = k to represent the shape;
+         * b = alpha = lambda to represent the scale;
+         * c = gamma to represent the location.
+         */
+        double weibull3(const double a, const double b, const double c);
+
+        /**
+         * @brief Get a reference to the Mersenne Twister PRNG.
+         * @code
+         * vle::utils::RandStream r(123456789, 0, "top:model");
+         * boost::uniform_real < > d(0., 100.); // [0., 100.)
+         * boost::variate_generator < Philox&,
+         *                            boost::uniform_real < > > gen(r, d);
+         * std::cout << gen() << "\n";
+         *
+         * std::vector < uint32_t > vec(1000);
+         * vle::utils::generate(vec.begin(), vec.end(), gen);
+         * @endcode
+         * @return A reference to the PRNG.
+         */
+        Philox& gen() { return m_rand; }
+
+        /**
+         * @brief Fill an array with reals [0, 1).
+         * @param out The array.
+         * @param n The size of the array.
+         */
+        void getDouble(double* out, std::size_t n)
+        { m_rand.uniform(out, n); }
+
+        /**
+         * @brief Fill an array with reals of the normal law.
+         * @param out The array.
+         * @param n The size of the array.
+         * @param mean The mean of the law.
+         * @param sigma The standard deviation of the law.
+         */
+        void normal(double* out, std::size_t n, double mean, double sigma)
+        { m_rand.normal(out, n, mean, sigma); }
+
+    private:
+        Philox  m_rand;
+    };
+
 }} // namespace vle utils
 
 #endif
@@ -44,8 +44,10 @@
 #include <iostream>
 #include <sstream>
 #include <numeric>
+#include <algorithm>
 #include <vle/utils/Algo.hpp>
 #include <vle/utils/DateTime.hpp>
+#include <vle/utils/Exception.hpp>
 #include <vle/utils/Package.hpp>
 #include <vle/utils/Path.hpp>
 #include <vle/utils/Rand.hpp>
@@ -248,6 +250,107 @@ BOOST_AUTO_TEST_CASE(test_normal)
                         (double)szmax, 1.0, 10);
 }
 
+BOOST_AUTO_TEST_CASE(test_philox)
+{
+    using vle::uint32_t;
+
+    uint32_t counter[4] = { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 };
+    uint32_t key[2] = { 0xa4093822, 0x299f31d0 };
+    uint32_t block[4];
+
+    vle::utils::Philox::encrypt(counter, key, block);
+    BOOST_REQUIRE_EQUAL(block[0], 0xd16cfe09u);
+    BOOST_REQUIRE_EQUAL(block[1], 0x94fdccebu);
+    BOOST_REQUIRE_EQUAL(block[2], 0x5001e420u);
+    BOOST_REQUIRE_EQUAL(block[3], 0x24126ea1u);
+
+    vle::utils::Philox p1(123, 4, "top:a"), p2(123, 4, "top:a");
+    vle::utils::Philox p3(123, 4, "top:b"), p4(123, 5, "top:a");
+
+    std::vector < uint32_t > v1(1001), v2(1001);
+    for (std::size_t i = 0; i < v1.size(); ++i) {
+        v1[i] = p1();
+    }
+
+    p2();
+    p2.generate(&v2[0], 3);
+    p2.generate(&v2[3], 998);
+    BOOST_REQUIRE_EQUAL(v2[0], v1[1]);
+    BOOST_REQUIRE(std::equal(v2.begin(), v2.end() - 1, v1.begin() + 1));
+
+    p2.seed(123, 4, "top:a");
+    p2.discard(537);
+    BOOST_REQUIRE_EQUAL(p2(), v1[537]);
+
+    std::size_t same3 = 0, same4 = 0;
+    for (std::size_t i = 0; i < v1.size(); ++i) {
+        same3 += p3() == v1[i];
+        same4 += p4() == v1[i];
+    }
+    BOOST_REQUIRE(same3 < 2);
+    BOOST_REQUIRE(same4 < 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_philox_state)
+{
+    using vle::uint32_t;
+
+    vle::utils::Philox p1(7, 1, "top:a"), p2;
+    uint32_t state[vle::utils::Philox::STATE];
+
+    p1.discard(6);
+    p1.save(state);
+    p2.load(state);
+
+    for (std::size_t i = 0; i < 100; ++i) {
+        BOOST_REQUIRE_EQUAL(p1(), p2());
+    }
+
+    state[10] = 5;
+    BOOST_REQUIRE_THROW(p2.load(state), vle::utils::ArgError);
+}
+
+BOOST_AUTO_TEST_CASE(test_randstream)
+{
+    const std::size_t szmax(10000);
+    std::vector < double > u1(szmax), u2(szmax), n(szmax + 1);
+
+    vle::utils::RandStream r1(42, 0, "top:model");
+    vle::utils::RandStream r2(42, 0, "top:model");
+
+    r1.getDouble(&u1[0], szmax);
+    for (std::size_t i = 0; i < szmax; ++i) {
+        vle::uint32_t a = r2.getInt(), b = r2.getInt();
+        u2[i] = ((a >> 5) * 67108864.0 + (b >> 6)) / 9007199254740992.0;
+    }
+    BOOST_REQUIRE(u1 == u2);
+    BOOST_REQUIRE(*std::min_element(u1.begin(), u1.end()) >= 0.0);
+    BOOST_REQUIRE(*std::max_element(u1.begin(), u1.end()) < 1.0);
+    BOOST_REQUIRE_CLOSE(std::accumulate(u1.begin(), u1.end(), 0.0) /
+                        (double)szmax, 0.5, 2);
+
+    r1.normal(&n[0], n.size(), 1.0, 2.0);
+    double mean = std::accumulate(n.begin(), n.end(), 0.0) / n.size();
+    double var = 0.0;
+    for (std::size_t i = 0; i < n.size(); ++i) {
+        var += (n[i] - mean) * (n[i] - mean);
+    }
+    var /= n.size();
+    BOOST_REQUIRE_CLOSE(mean, 1.0, 5);
+    BOOST_REQUIRE_CLOSE(var, 4.0, 5);
+
+    double x = r1.normal(1.0, 2.0);
+    r2.seed(42, 0, "top:model");
+    r2.getDouble(&u2[0], szmax);
+    r2.normal(&n[0], n.size(), 1.0, 2.0);
+    BOOST_REQUIRE_EQUAL(r2.normal(1.0, 2.0), x);
+
+    r1.getBool();
+    r1.getInt(-100, 100);
+    r1.getDouble(-1.0, 1.0);
+    r1.weibull(1.0, 1.0);
+}
+
 BOOST_AUTO_TEST_CASE(date_time)
 {
     BOOST_REQUIRE_EQUAL(vle::utils::DateTime::year((2451545)),
@@ -0,0 +1,594 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <vle/value/Binary.hpp>
+#include <vle/value/Boolean.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Integer.hpp>
+#include <vle/value/Map.hpp>
+#include <vle/value/Matrix.hpp>
+#include <vle/value/Null.hpp>
+#include <vle/value/ResultMatrix.hpp>
+#include <vle/value/Set.hpp>
+#include <vle/value/String.hpp>
+#include <vle/value/Table.hpp>
+#include <vle/value/Tuple.hpp>
+#include <vle/value/XML.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/i18n.hpp>
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
+namespace vle { namespace value {
+
+BinaryWriter::BinaryWriter(std::ostream& out)
+    : m_out(out), m_offset(0)
+{
+    put(binary::MAGIC, sizeof(binary::MAGIC) - 1);
+    putNumber(binary::VERSION);
+    putNumber(binary::ENDIANNESS);
+}
+
+void BinaryWriter::write(const Value& value)
+{
+    write(&value);
+}
+
+void BinaryWriter::write(const Value* value)
+{
+    if (not value) {
+        writeTag(binary::NONE);
+        return;
+    }
+
+    switch (value->getType()) {
+    case Value::BOOLEAN:
+        writeTag(Value::BOOLEAN);
+        putNumber < unsigned char >(value->toBoolean().value() ? 1 : 0);
+        break;
+    case Value::INTEGER:
+        writeTag(Value::INTEGER);
+        putNumber < int32_t >(value->toInteger().value());
+        break;
+    case Value::DOUBLE:
+        writeTag(Value::DOUBLE);
+        putNumber < double >(value->toDouble().value());
+        break;
+    case Value::STRING:
+        writeTag(Value::STRING);
+        writeString(value->toString().value());
+        break;
+    case Value::XMLTYPE:
+        writeTag(Value::XMLTYPE);
+        writeString(value->toXml().value());
+        break;
+    case Value::SET: {
+        const Set& set = value->toSet();
+
+        writeTag(Value::SET);
+        writeSize(set.size());
+        for (Set::const_iterator it = set.begin(); it != set.end(); ++it) {
+            write(*it);
+        }
+        break;
+    }
+    case Value::MAP: {
+        const Map& map = value->toMap();
+
+        writeTag(Value::MAP);
+        writeSize(map.size());
+        for (Map::const_iterator it = map.begin(); it != map.end(); ++it) {
+            writeString(it->first);
+            write(it->second);
+        }
+        break;
+    }
+    case Value::TUPLE: {
+        const TupleValue& tuple = value->toTuple().value();
+
+        writeTag(Value::TUPLE);
+        writeSize(tuple.size());
+        writeArray(tuple.empty() ? 0 : &tuple[0],
+                   tuple.size() * sizeof(double));
+        break;
+    }
+    case Value::TABLE: {
+        const Table& table = value->toTable();
+
+        writeTag(Value::TABLE);
+        writeSize(table.width());
+        writeSize(table.height());
+        writeArray(table.value().data(),
+                   table.value().num_elements() * sizeof(double));
+        break;
+    }
+    case Value::MATRIX: {
+        const Matrix& matrix = value->toMatrix();
+
+        writeTag(Value::MATRIX);
+        writeSize(matrix.columns());
+        writeSize(matrix.rows());
+        writeSize(matrix.matrix().shape()[0]);
+        writeSize(matrix.matrix().shape()[1]);
+        writeSize(matrix.resizeColumn());
+        writeSize(matrix.resizeRow());
+        for (Matrix::size_type j = 0; j < matrix.rows(); ++j) {
+            for (Matrix::size_type i = 0; i < matrix.columns(); ++i) {
+                write(matrix.get(i, j));
+            }
+        }
+        break;
+    }
+    case Value::RESULTMATRIX: {
+        const ResultMatrix& result = value->toResultMatrix();
+        const ResultMatrix::size_type rows = result.rows();
+        std::vector < uint32_t > valid((rows + 31) / 32);
+
+        writeTag(Value::RESULTMATRIX);
+        writeSize(result.columns());
+        writeSize(rows);
+        writeArray(rows ? &result.times()[0] : 0, rows * sizeof(double));
+
+        for (ResultMatrix::size_type i = 0; i < result.columns(); ++i) {
+            writeString(result.name(i));
+            putNumber < unsigned char >(result.type(i));
+
+            std::fill(valid.begin(), valid.end(), 0);
+            for (ResultMatrix::size_type j = 0; j < rows; ++j) {
+                if (not result.isNull(i, j)) {
+                    valid[j / 32] |= static_cast < uint32_t >(1) << (j % 32);
+                }
+            }
+            writeArray(valid.empty() ? 0 : &valid[0],
+                       valid.size() * sizeof(uint32_t));
+
+            switch (result.type(i)) {
+            case ResultMatrix::REAL:
+                writeArray(rows ? &result.reals(i)[0] : 0,
+                           rows * sizeof(double));
+                break;
+            case ResultMatrix::INTEGER:
+                writeArray(rows ? &result.integers(i)[0] : 0,
+                           rows * sizeof(int64_t));
+                break;
+            case ResultMatrix::VALUE:
+                for (ResultMatrix::size_type j = 0; j < rows; ++j) {
+                    if (not result.isNull(i, j)) {
+                        write(result.getValue(i, j));
+                    }
+                }
+                break;
+            default:
+                break;
+            }
+        }
+        break;
+    }
+    case Value::NIL:
+        writeTag(Value::NIL);
+        break;
+    default:
+        throw utils::ArgError(fmt(_(
+                "Binary value: can not write the value type %1%")) %
+            value->getType());
+    }
+}
+
+void BinaryWriter::writeTag(unsigned char tag)
+{
+    putNumber(tag);
+}
+
+void BinaryWriter::writeSize(std::size_t size)
+{
+    if (size > std::numeric_limits < uint32_t >::max()) {
+        throw utils::ArgError(fmt(_(
+                "Binary value: size %1% too large")) % size);
+    }
+
+    putNumber(static_cast < uint32_t >(size));
+}
+
+void BinaryWriter::writeString(const std::string& str)
+{
+    writeSize(str.size());
+    put(str.data(), str.size());
+}
+
+void BinaryWriter::writeArray(const void* data, std::size_t size)
+{
+    static const char zeros[sizeof(double)] = { 0 };
+
+    put(zeros, (sizeof(double) - m_offset % sizeof(double)) % sizeof(double));
+    put(data, size);
+}
+
+void BinaryWriter::put(const void* data, std::size_t size)
+{
+    if (size) {
+        m_out.write(static_cast < const char* >(data), size);
+        m_offset += size;
+    }
+}
+
+                       /* - - - - - - - - - -*/
+
+BinaryReader::BinaryReader(std::istream& in)
+    : m_in(&in), m_data(0), m_size(0), m_offset(0)
+{
+    readHeader();
+}
+
+BinaryReader::BinaryReader(const void* data, std::size_t size)
+    : m_in(0), m_data(static_cast < const char* >(data)), m_size(size),
+    m_offset(0)
+{
+    readHeader();
+}
+
+bool BinaryReader::eof() const
+{
+    if (m_in) {
+        return m_in->peek() == std::istream::traits_type::eof();
+    }
+
+    return m_offset == m_size;
+}
+
+unsigned char BinaryReader::next() const
+{
+    if (eof()) {
+        throw utils::ParseError(_("Binary value: no more value"));
+    }
+
+    if (m_in) {
+        return static_cast < unsigned char >(m_in->peek());
+    }
+
+    return static_cast < unsigned char >(m_data[m_offset]);
+}
+
+Value* BinaryReader::read()
+{
+    return readValue(readTag());
+}
+
+void BinaryReader::readTuple(TupleView& view)
+{
+    if (readTag() != Value::TUPLE) {
+        throw utils::ParseError(_("Binary value: the value is not a tuple"));
+    }
+
+    view.size = readSize();
+    view.data = static_cast < const double* >(
+        readArray(view.size * sizeof(double)));
+}
+
+void BinaryReader::readTable(TableView& view)
+{
+    if (readTag() != Value::TABLE) {
+        throw utils::ParseError(_("Binary value: the value is not a table"));
+    }
+
+    view.width = readSize();
+    view.height = readSize();
+    view.data = static_cast < const double* >(
+        readArray(view.width * view.height * sizeof(double)));
+}
+
+void BinaryReader::readHeader()
+{
+    if (std::memcmp(get(sizeof(binary::MAGIC) - 1), binary::MAGIC,
+                    sizeof(binary::MAGIC) - 1)) {
+        throw utils::ParseError(_("Binary value: bad magic string"));
+    }
+
+    uint32_t version = getNumber < uint32_t >();
+    uint32_t endianness = getNumber < uint32_t >();
+
+    if (endianness != binary::ENDIANNESS) {
+        throw utils::ParseError(_("Binary value: bad byte order"));
+    }
+
+    if (version != binary::VERSION) {
+        throw utils::ParseError(fmt(_(
+                "Binary value: version %1% not supported")) % version);
+    }
+}
+
+Value* BinaryReader::readValue(unsigned char tag)
+{
+    switch (tag) {
+    case binary::NONE:
+        return 0;
+    case Value::BOOLEAN:
+        return Boolean::create(getNumber < unsigned char >() != 0);
+    case Value::INTEGER:
+        return Integer::create(getNumber < int32_t >());
+    case Value::DOUBLE:
+        return Double::create(getNumber < double >());
+    case Value::STRING:
+        return String::create(readString());
+    case Value::XMLTYPE:
+        return Xml::create(readString());
+    case Value::SET: {
+        Set* set = new Set();
+
+        try {
+            uint32_t size = readSize();
+
+            for (uint32_t i = 0; i < size; ++i) {
+                set->value().push_back(0);
+                set->value().back() = readValue(readTag());
+            }
+        } catch (...) {
+            delete set;
+            throw;
+        }
+        return set;
+    }
+    case Value::MAP: {
+        Map* map = new Map();
+
+        try {
+            uint32_t size = readSize();
+
+            for (uint32_t i = 0; i < size; ++i) {
+                std::string key = readString();
+                Value* value = readValue(readTag());
+
+                MapValue::iterator it = map->value().lower_bound(key);
+                if (it != map->end() and it->first == key) {
+                    delete value;
+                    throw utils::ParseError(fmt(_(
+                            "Binary value: duplicated key '%1%'")) % key);
+                }
+                map->value().insert(it, MapValue::value_type(key, value));
+            }
+        } catch (...) {
+            delete map;
+            throw;
+        }
+        return map;
+    }
+    case Value::TUPLE: {
+        uint32_t size = readSize();
+        const double* data = static_cast < const double* >(
+            readArray(size * sizeof(double)));
+        Tuple* tuple = new Tuple();
+
+        tuple->value().assign(data, data + size);
+        return tuple;
+    }
+    case Value::TABLE: {
+        uint32_t width = readSize();
+        uint32_t height = readSize();
+        std::size_t size = static_cast < std::size_t >(width) * height;
+        const double* data = static_cast < const double* >(
+            readArray(size * sizeof(double)));
+        Table* table = new Table(width, height);
+
+        std::copy(data, data + size, table->value().data());
+        return table;
+    }
+    case Value::MATRIX: {
+        uint32_t columns = readSize();
+        uint32_t rows = readSize();
+        uint32_t columnmax = readSize();
+        uint32_t rowmax = readSize();
+        uint32_t columnstep = readSize();
+        uint32_t rowstep = readSize();
+        Matrix* matrix = new Matrix(columns, rows, columnmax, rowmax,
+                                    columnstep, rowstep);
+
+        try {
+            for (uint32_t j = 0; j < rows; ++j) {
+                for (uint32_t i = 0; i < columns; ++i) {
+                    matrix->set(i, j, readValue(readTag()));
+                }
+            }
+        } catch (...) {
+            delete matrix;
+            throw;
+        }
+        return matrix;
+    }
+    case Value::RESULTMATRIX: {
+        ResultMatrix* result = new ResultMatrix();
+
+        try {
+            readResultMatrix(*result);
+        } catch (...) {
+            delete result;
+            throw;
+        }
+        return result;
+    }
+    case Value::NIL:
+        return Null::create();
+    default:
+        throw utils::ParseError(fmt(_(
+                "Binary value: unknown value type %1%")) %
+            static_cast < int >(tag));
+    }
+}
+
+void BinaryReader::readResultMatrix(ResultMatrix& result)
+{
+    uint32_t columns = readSize();
+    uint32_t rows = readSize();
+    const double* times = static_cast < const double* >(
+        readArray(rows * sizeof(double)));
+
+    result.reserve(rows);
+    for (uint32_t j = 0; j < rows; ++j) {
+        result.addRow(times[j]);
+    }
+
+    for (uint32_t i = 0; i < columns; ++i) {
+        ResultMatrix::size_type id = result.addColumn(readString());
+        unsigned char type = getNumber < unsigned char >();
+        const uint32_t* words = static_cast < const uint32_t* >(
+            readArray(((rows + 31) / 32) * sizeof(uint32_t)));
+        std::vector < uint32_t > valid(words, words + (rows + 31) / 32);
+
+        switch (type) {
+        case ResultMatrix::EMPTY:
+            break;
+        case ResultMatrix::REAL: {
+            const double* reals = static_cast < const double* >(
+                readArray(rows * sizeof(double)));
+            for (uint32_t j = 0; j < rows; ++j) {
+                if (valid[j / 32] & (static_cast < uint32_t >(1) <<
+                                     (j % 32))) {
+                    result.setReal(id, j, reals[j]);
+                }
+            }
+            break;
+        }
+        case ResultMatrix::INTEGER: {
+            const int64_t* integers = static_cast < const int64_t* >(
+                readArray(rows * sizeof(int64_t)));
+            for (uint32_t j = 0; j < rows; ++j) {
+                if (valid[j / 32] & (static_cast < uint32_t >(1) <<
+                                     (j % 32))) {
+                    result.setInteger(id, j, integers[j]);
+                }
+            }
+            break;
+        }
+        case ResultMatrix::VALUE:
+            for (uint32_t j = 0; j < rows; ++j) {
+                if (valid[j / 32] & (static_cast < uint32_t >(1) <<
+                                     (j % 32))) {
+                    Value* value = readValue(readTag());
+                    if (value) {
+                        result.set(id, j, value);
+                    }
+                }
+            }
+            break;
+        default:
+            throw utils::ParseError(fmt(_(
+                    "Binary value: unknown column type %1%")) %
+                static_cast < int >(type));
+        }
+    }
+}
+
+unsigned char BinaryReader::readTag()
+{
+    return getNumber < unsigned char >();
+}
+
+uint32_t BinaryReader::readSize()
+{
+    return getNumber < uint32_t >();
+}
+
+std::string BinaryReader::readString()
+{
+    uint32_t size = readSize();
+
+    return std::string(get(size), size);
+}
+
+const void* BinaryReader::readArray(std::size_t size)
+{
+    get((sizeof(double) - m_offset % sizeof(double)) % sizeof(double));
+
+    if (size == 0) {
+        return 0;
+    }
+
+    if (m_data) {
+        const char* data = get(size);
+
+        if (reinterpret_cast < std::size_t >(data) % sizeof(double) == 0) {
+            return data;
+        }
+
+        m_array.resize((size + sizeof(double) - 1) / sizeof(double));
+        std::memcpy(&m_array[0], data, size);
+        return &m_array[0];
+    }
+
+    m_array.resize((size + sizeof(double) - 1) / sizeof(double));
+    m_in->read(reinterpret_cast < char* >(&m_array[0]), size);
+    if (static_cast < std::size_t >(m_in->gcount()) != size) {
+        throw utils::ParseError(_("Binary value: unexpected end of stream"));
+    }
+    m_offset += size;
+
+    return &m_array[0];
+}
+
+const char* BinaryReader::get(std::size_t size)
+{
+    if (m_data) {
+        if (size > m_size - m_offset) {
+            throw utils::ParseError(_(
+                    "Binary value: unexpected end of buffer"));
+        }
+
+        const char* data = m_data + m_offset;
+        m_offset += size;
+        return data;
+    }
+
+    m_buffer.resize(size + 1);
+    if (size) {
+        m_in->read(&m_buffer[0], size);
+        if (static_cast < std::size_t >(m_in->gcount()) != size) {
+            throw utils::ParseError(_(
+                    "Binary value: unexpected end of stream"));
+        }
+        m_offset += size;
+    }
+    return &m_buffer[0];
+}
+
+                       /* - - - - - - - - - -*/
+
+std::string toBinary(const Value& value)
+{
+    std::ostringstream out;
+    BinaryWriter writer(out);
+
+    writer.write(value);
+    return out.str();
+}
+
+Value* fromBinary(const std::string& buffer)
+{
+    BinaryReader reader(buffer.data(), buffer.size());
+
+    return reader.read();
+}
+
+}} // namespace vle value
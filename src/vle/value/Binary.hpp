@@ -0,0 +1,280 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef VLE_VALUE_BINARY_HPP
+#define VLE_VALUE_BINARY_HPP 1
+
+#include <vle/value/Value.hpp>
+#include <vle/utils/Types.hpp>
+#include <vle/DllDefines.hpp>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace vle { namespace value {
+
+/**
+ * @brief The binary encoding of the \c value::Value, written by the
+ * BinaryWriter and read by the BinaryReader.
+ *
+ * A stream starts with a 16 bytes header: the magic string \c VLEVALUE,
+ * the version and a number to check the byte order (the numbers use the
+ * byte order of the writer). Each value is a one byte tag, the \c
+ * Value::type or \c NONE for a null pointer, followed by its payload:
+ *
+ * - \c BOOLEAN: one byte; \c INTEGER: int32; \c DOUBLE: double.
+ * - \c STRING, \c XMLTYPE: uint32 size and the characters.
+ * - \c SET: uint32 size and the values.
+ * - \c MAP: uint32 size and, for each pair in the order of the keys, the
+ *   key as a string and the value.
+ * - \c TUPLE: uint32 size and the array of doubles.
+ * - \c TABLE: uint32 width, uint32 height and the array of doubles in
+ *   the storage order of \c value::TableValue (\c data[x * height + y]).
+ * - \c MATRIX: uint32 columns, rows, columnmax, rowmax, columnstep,
+ *   rowstep and the \c rows x \c columns values, row by row.
+ * - \c RESULTMATRIX: uint32 columns, uint32 rows, the array of dates and,
+ *   for each column, the name, the \c ColumnType, the bitmap of the
+ *   cells with value (uint32 words) and the lane: an array of doubles,
+ *   an array of int64 or the values of the cells.
+ * - \c NIL: no payload.
+ *
+ * The arrays are padded to 8 bytes from the start of the stream, so the
+ * BinaryReader can return a pointer into an aligned memory buffer instead
+ * of copying the doubles.
+ */
+namespace binary {
+
+const char MAGIC[] = "VLEVALUE";
+const uint32_t VERSION = 1;
+const uint32_t ENDIANNESS = 0x01020304;
+const unsigned char NONE = 0xff;
+
+} // namespace binary
+
+/**
+ * @brief A read-only view of the doubles of a \c value::Tuple.
+ */
+struct VLE_API TupleView
+{
+    TupleView()
+        : data(0), size(0)
+    {}
+
+    double operator[](std::size_t i) const
+    { return data[i]; }
+
+    const double* data;
+    std::size_t size;
+};
+
+/**
+ * @brief A read-only view of the doubles of a \c value::Table.
+ */
+struct VLE_API TableView
+{
+    TableView()
+        : data(0), width(0), height(0)
+    {}
+
+    double operator()(std::size_t x, std::size_t y) const
+    { return data[x * height + y]; }
+
+    const double* data;
+    std::size_t width;
+    std::size_t height;
+};
+
+/**
+ * @brief Write the binary encoding of \c value::Value into a stream. The
+ * header is written by the constructor, then the values are appended one
+ * after the other.
+ *
+ * @code
+ * std::ofstream file("values.bin", std::ios::binary);
+ * value::BinaryWriter writer(file);
+ * writer.write(map);
+ * writer.write(table);
+ * @endcode
+ */
+class VLE_API BinaryWriter
+{
+public:
+    BinaryWriter(std::ostream& out);
+
+    /**
+     * @brief Append a value.
+     * @param value the value to write.
+     * @throw utils::ArgError if the value (or a value of a container) is
+     * not a type of the library.
+     */
+    void write(const Value& value);
+
+    /**
+     * @brief Append a value which may be null.
+     */
+    void write(const Value* value);
+
+    /**
+     * @brief Get the number of bytes written.
+     */
+    uint64_t size() const
+    { return m_offset; }
+
+private:
+    BinaryWriter(const BinaryWriter& other);
+    BinaryWriter& operator=(const BinaryWriter& other);
+
+    void writeTag(unsigned char tag);
+    void writeSize(std::size_t size);
+    void writeString(const std::string& str);
+    void writeArray(const void* data, std::size_t size);
+    void put(const void* data, std::size_t size);
+
+    template < typename T >
+    void putNumber(T value)
+    { put(&value, sizeof(T)); }
+
+    std::ostream& m_out;
+    uint64_t      m_offset;
+};
+
+/**
+ * @brief Read the values written by a BinaryWriter, from a stream or from
+ * a memory buffer.
+ *
+ * With a memory buffer, the \c readTuple and \c readTable functions do
+ * not copy the doubles: the views point into the buffer, which must live
+ * as long as the views. If the buffer is not aligned on 8 bytes, or with
+ * a stream, the doubles are copied into the reader and the view is valid
+ * until the next read.
+ *
+ * @code
+ * value::BinaryReader reader(buffer.data(), buffer.size());
+ * while (not reader.eof()) {
+ *     if (reader.next() == value::Value::TABLE) {
+ *         value::TableView table;
+ *         reader.readTable(table);
+ *         ...
+ *     } else {
+ *         delete reader.read();
+ *     }
+ * }
+ * @endcode
+ */
+class VLE_API BinaryReader
+{
+public:
+    /**
+     * @brief Read the header from a stream.
+     * @throw utils::ParseError if the stream is not a binary stream of
+     * values.
+     */
+    BinaryReader(std::istream& in);
+
+    /**
+     * @brief Read the header from a memory buffer.
+     * @throw utils::ParseError if the buffer is not a binary stream of
+     * values.
+     */
+    BinaryReader(const void* data, std::size_t size);
+
+    /**
+     * @brief Test if all the values are read.
+     */
+    bool eof() const;
+
+    /**
+     * @brief Get the tag of the next value: a \c Value::type or \c
+     * binary::NONE.
+     * @throw utils::ParseError if there is no more value.
+     */
+    unsigned char next() const;
+
+    /**
+     * @brief Read the next value.
+     * @return A new value or null if a null pointer was written.
+     * @throw utils::ParseError if the data is corrupted.
+     */
+    Value* read();
+
+    /**
+     * @brief Read the next value, a \c value::Tuple, without building it.
+     * @throw utils::ParseError if the next value is not a tuple.
+     */
+    void readTuple(TupleView& view);
+
+    /**
+     * @brief Read the next value, a \c value::Table, without building it.
+     * @throw utils::ParseError if the next value is not a table.
+     */
+    void readTable(TableView& view);
+
+private:
+    BinaryReader(const BinaryReader& other);
+    BinaryReader& operator=(const BinaryReader& other);
+
+    void readHeader();
+    Value* readValue(unsigned char tag);
+    void readResultMatrix(ResultMatrix& result);
+    unsigned char readTag();
+    uint32_t readSize();
+    std::string readString();
+    const void* readArray(std::size_t size);
+    const char* get(std::size_t size);
+
+    template < typename T >
+    T getNumber()
+    {
+        T value;
+        std::memcpy(&value, get(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    std::istream*           m_in;
+    const char*             m_data;
+    std::size_t             m_size;
+    uint64_t                m_offset;
+    std::vector < char >    m_buffer;
+    std::vector < double >  m_array;
+};
+
+/**
+ * @brief Build the binary encoding of a value, header included.
+ */
+VLE_API std::string toBinary(const Value& value);
+
+/**
+ * @brief Build the value of a binary encoding built by \c toBinary.
+ * @throw utils::ParseError if the buffer is corrupted.
+ */
+VLE_API Value* fromBinary(const std::string& buffer);
+
+}} // namespace vle value
+
+#endif
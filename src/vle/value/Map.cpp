@@ -30,18 +30,122 @@
 #include <vle/value/Matrix.hpp>
 #include <vle/utils/Algo.hpp>
 #include <boost/checked_delete.hpp>
+#include <algorithm>
 
 namespace vle { namespace value {
 
+struct MapValueKeyLess
+{
+    bool operator()(const MapValue::value_type& x, const std::string& y) const
+    { return x.first < y; }
+};
+
+MapValue::iterator MapValue::find(const std::string& key)
+{
+    if (m_values.size() <= LINEAR) {
+        for (iterator it = m_values.begin(); it != m_values.end(); ++it) {
+            if (it->first == key) {
+                return it;
+            }
+        }
+        return m_values.end();
+    }
+
+    iterator it = lower_bound(key);
+
+    return it != m_values.end() and it->first == key ? it : m_values.end();
+}
+
+MapValue::const_iterator MapValue::find(const std::string& key) const
+{
+    return const_cast < MapValue* >(this)->find(key);
+}
+
+MapValue::iterator MapValue::lower_bound(const std::string& key)
+{
+    return std::lower_bound(m_values.begin(), m_values.end(), key,
+                            MapValueKeyLess());
+}
+
+MapValue::const_iterator MapValue::lower_bound(const std::string& key) const
+{
+    return std::lower_bound(m_values.begin(), m_values.end(), key,
+                            MapValueKeyLess());
+}
+
+std::pair < MapValue::iterator, bool > MapValue::insert(
+    const value_type& value)
+{
+    iterator it = lower_bound(value.first);
+
+    if (it != m_values.end() and it->first == value.first) {
+        return std::make_pair(it, false);
+    }
+
+    return std::make_pair(insertAt(it, value), true);
+}
+
+MapValue::iterator MapValue::insert(iterator position,
+                                    const value_type& value)
+{
+    if ((position != m_values.begin() and
+         not ((position - 1)->first < value.first)) or
+        (position != m_values.end() and
+         not (value.first < position->first))) {
+        return insert(value).first;
+    }
+
+    return insertAt(position, value);
+}
+
+Value*& MapValue::operator[](const std::string& key)
+{
+    iterator it = lower_bound(key);
+
+    if (it == m_values.end() or it->first != key) {
+        it = insertAt(it, value_type(key, (Value*)0));
+    }
+
+    return it->second;
+}
+
+MapValue::size_type MapValue::erase(const std::string& key)
+{
+    iterator it = find(key);
+
+    if (it == m_values.end()) {
+        return 0;
+    }
+
+    m_values.erase(it);
+    return 1;
+}
+
+MapValue::iterator MapValue::insertAt(iterator position,
+                                      const value_type& value)
+{
+    if (m_values.capacity() == 0) {
+        m_values.reserve(RESERVE);
+        position = m_values.begin();
+    }
+
+    return m_values.insert(position, value);
+}
+
+                       /* - - - - - - - - - -*/
+
 Map::Map(const Map& orig)
     : Value(orig)
 {
+    m_value.reserve(orig.size());
+
     for (const_iterator it = orig.begin(); it != orig.end(); ++it) {
         if ((*it).second) {
-            m_value.insert(std::make_pair((*it).first,
-                                          ((*it).second)->clone()));
+            m_value.insert(m_value.end(),
+                           value_type((*it).first, ((*it).second)->clone()));
         } else {
-            m_value.insert(std::make_pair((*it).first, (value::Value*)0));
+            m_value.insert(m_value.end(),
+                           value_type((*it).first, (value::Value*)0));
         }
     }
 }
@@ -33,19 +33,126 @@
 #include <vle/value/Double.hpp>
 #include <vle/value/Integer.hpp>
 #include <vle/value/Null.hpp>
+#include <vle/value/Scalar.hpp>
 #include <vle/value/String.hpp>
 #include <vle/value/Table.hpp>
 #include <vle/value/Tuple.hpp>
 #include <vle/value/XML.hpp>
 #include <vle/DllDefines.hpp>
 #include <map>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace vle { namespace value {
 
 /**
  * @brief Define a list of Value in a dictionnary.
+ *
+ * The pairs are stored into a vector sorted by key, so they are iterated
+ * in the order of a std::map < std::string, Value* >. The small maps (the
+ * attributes of the events, the conditions of a model) are built with a
+ * single allocation and searched with a linear scan; the large maps use
+ * a binary search. MapValue provides the subset of the std::map interface
+ * used by VLE but, like a std::vector, the insertion and the removal of a
+ * key invalidate the iterators.
  */
-typedef std::map < std::string, Value* > MapValue;
+class VLE_API MapValue
+{
+public:
+    typedef std::string key_type;
+    typedef Value* mapped_type;
+    typedef std::pair < std::string, Value* > value_type;
+    typedef std::vector < value_type >::size_type size_type;
+    typedef std::vector < value_type >::iterator iterator;
+    typedef std::vector < value_type >::const_iterator const_iterator;
+
+    bool empty() const
+    { return m_values.empty(); }
+
+    size_type size() const
+    { return m_values.size(); }
+
+    void clear()
+    { m_values.clear(); }
+
+    /**
+     * @brief Reserve the memory for \c size pairs.
+     */
+    void reserve(size_type size)
+    { m_values.reserve(size); }
+
+    void swap(MapValue& other)
+    { m_values.swap(other.m_values); }
+
+    iterator begin()
+    { return m_values.begin(); }
+
+    iterator end()
+    { return m_values.end(); }
+
+    const_iterator begin() const
+    { return m_values.begin(); }
+
+    const_iterator end() const
+    { return m_values.end(); }
+
+    iterator find(const std::string& key);
+
+    const_iterator find(const std::string& key) const;
+
+    size_type count(const std::string& key) const
+    { return find(key) == end() ? 0 : 1; }
+
+    /**
+     * @brief Get the first pair whose key is not less than \c key.
+     */
+    iterator lower_bound(const std::string& key);
+
+    const_iterator lower_bound(const std::string& key) const;
+
+    /**
+     * @brief Insert a pair if its key does not exist.
+     * @return The pair of the key and true if the pair is inserted.
+     */
+    std::pair < iterator, bool > insert(const value_type& value);
+
+    /**
+     * @brief Insert a pair if its key does not exist, using the position
+     * returned by \c lower_bound to avoid a second search.
+     * @return The pair of the key.
+     */
+    iterator insert(iterator position, const value_type& value);
+
+    /**
+     * @brief Get the value of a key, a null value is inserted if the key
+     * does not exist.
+     */
+    Value*& operator[](const std::string& key);
+
+    void erase(iterator position)
+    { m_values.erase(position); }
+
+    size_type erase(const std::string& key);
+
+private:
+    /**
+     * Under this number of pairs, a linear scan compares fewer strings
+     * than a binary search: std::string::operator== tests the sizes
+     * before the characters.
+     */
+    enum { LINEAR = 8 };
+
+    /**
+     * The capacity reserved by the first insertion: the maps of the
+     * events hold a few attributes.
+     */
+    enum { RESERVE = 4 };
+
+    iterator insertAt(iterator position, const value_type& value);
+
+    std::vector < value_type > m_values;
+};
 
 /**
  * @brief Map Value a container to a pair of std::string, Value pointer. The
@@ -183,6 +290,18 @@ public:
         set(name, value);
     }
 
+    /**
+     * @brief Add a scalar into the map, converted into its \c
+     * value::Value. If a value already exists with the same name it will
+     * be replaced.
+     * @param name the name of Value to add.
+     * @param value the Scalar to add.
+     */
+    void add(const std::string& name, const Scalar& value)
+    {
+        set(name, value.toValue());
+    }
+
     /**
      * @brief Set a value into the map. Be carrefull, the data is not
      * cloned. Don't delete buffer after. If a value already exist with the
@@ -193,13 +312,13 @@ public:
      */
     void set(const std::string& name, Value* value)
     {
-        iterator it = find(name);
+        iterator it = m_value.lower_bound(name);
 
-        if (it != end()) {
+        if (it != end() and it->first == name) {
             delete it->second;
             it->second = value;
         } else {
-            m_value.insert(std::make_pair(name, value));
+            m_value.insert(it, value_type(name, value));
         }
     }
 
@@ -213,13 +332,13 @@ public:
     void set(const std::string& name, const Value* value)
     {
         Value* clone = (value) ? value->clone() : (value::Value*)0;
-        iterator it = find(name);
+        iterator it = m_value.lower_bound(name);
 
-        if (it != end()) {
+        if (it != end() and it->first == name) {
             delete it->second;
             it->second = clone;
         } else {
-            m_value.insert(std::make_pair(name, clone));
+            m_value.insert(it, value_type(name, clone));
         }
     }
 
@@ -231,13 +350,13 @@ public:
      */
     void set(const std::string& name, const Value& value)
     {
-        iterator it = find(name);
+        iterator it = m_value.lower_bound(name);
 
-        if (it != end()) {
+        if (it != end() and it->first == name) {
             delete it->second;
             it->second = value.clone();
         } else {
-            m_value.insert(std::make_pair(name, value.clone()));
+            m_value.insert(it, value_type(name, value.clone()));
         }
     }
 
@@ -312,15 +431,15 @@ public:
     Value* give(const std::string& name);
 
     /**
-     * @brief Get an access to the std::map.
-     * @return a reference to the set::map.
+     * @brief Get an access to the MapValue.
+     * @return a reference to the MapValue.
      */
     inline MapValue& value()
     { return m_value; }
 
     /**
-     * @brief Get a constant access to the std::map.
-     * @return a reference to the const std::map.
+     * @brief Get a constant access to the MapValue.
+     * @return a reference to the const MapValue.
      */
     inline const MapValue& value() const
     { return m_value; }
@@ -338,7 +457,7 @@ public:
     { return m_value.empty(); }
 
     /**
-     * Return the number of element in the @c std::map.
+     * Return the number of element in the @c MapValue.
      *
      * @return An integer [0..MAX_SIZE_T];
      */
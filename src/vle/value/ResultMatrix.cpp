@@ -0,0 +1,380 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <vle/value/ResultMatrix.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Integer.hpp>
+#include <vle/value/Matrix.hpp>
+#include <vle/value/String.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/i18n.hpp>
+#include <boost/scoped_ptr.hpp>
+
+namespace vle { namespace value {
+
+ResultMatrix::ResultMatrix(const ResultMatrix& value)
+    : Value(value), m_times(value.m_times), m_columns(value.m_columns)
+{
+    for (std::vector < Column >::iterator it = m_columns.begin();
+         it != m_columns.end(); ++it) {
+        for (std::vector < Value* >::iterator jt = it->values.begin();
+             jt != it->values.end(); ++jt) {
+            if (*jt) {
+                *jt = (*jt)->clone();
+            }
+        }
+    }
+}
+
+ResultMatrix::~ResultMatrix()
+{
+    for (std::vector < Column >::iterator it = m_columns.begin();
+         it != m_columns.end(); ++it) {
+        for (std::vector < Value* >::iterator jt = it->values.begin();
+             jt != it->values.end(); ++jt) {
+            delete *jt;
+        }
+    }
+}
+
+void ResultMatrix::writeFile(std::ostream& out) const
+{
+    out << "time";
+    for (size_type i = 0; i < m_columns.size(); ++i) {
+        out << " " << m_columns[i].name;
+    }
+    out << "\n";
+
+    for (size_type j = 0; j < m_times.size(); ++j) {
+        out << m_times[j];
+        for (size_type i = 0; i < m_columns.size(); ++i) {
+            out << " ";
+            if (isNull(i, j)) {
+                out << "NA";
+            } else {
+                switch (m_columns[i].type) {
+                case REAL:
+                    out << m_columns[i].reals[j];
+                    break;
+                case INTEGER:
+                    out << m_columns[i].integers[j];
+                    break;
+                default:
+                    m_columns[i].values[j]->writeFile(out);
+                    break;
+                }
+            }
+        }
+        out << "\n";
+    }
+}
+
+void ResultMatrix::writeString(std::ostream& out) const
+{
+    writeFile(out);
+}
+
+void ResultMatrix::writeXml(std::ostream& out) const
+{
+    boost::scoped_ptr < Matrix > matrix(buildMatrix());
+
+    matrix->writeXml(out);
+}
+
+ResultMatrix::size_type ResultMatrix::addColumn(const std::string& name)
+{
+    m_columns.push_back(Column(name));
+    m_columns.back().valid.resize((m_times.size() + 31) / 32, 0);
+
+    return m_columns.size() - 1;
+}
+
+ResultMatrix::size_type ResultMatrix::addRow(double time)
+{
+    size_type row = m_times.size();
+
+    m_times.push_back(time);
+
+    for (std::vector < Column >::iterator it = m_columns.begin();
+         it != m_columns.end(); ++it) {
+        switch (it->type) {
+        case REAL:
+            it->reals.push_back(0.0);
+            break;
+        case INTEGER:
+            it->integers.push_back(0);
+            break;
+        case VALUE:
+            it->values.push_back(0);
+            break;
+        default:
+            break;
+        }
+
+        if (row % 32 == 0) {
+            it->valid.push_back(0);
+        }
+    }
+
+    return row;
+}
+
+void ResultMatrix::reserve(size_type rows)
+{
+    m_times.reserve(rows);
+
+    for (std::vector < Column >::iterator it = m_columns.begin();
+         it != m_columns.end(); ++it) {
+        switch (it->type) {
+        case REAL:
+            it->reals.reserve(rows);
+            break;
+        case INTEGER:
+            it->integers.reserve(rows);
+            break;
+        case VALUE:
+            it->values.reserve(rows);
+            break;
+        default:
+            break;
+        }
+        it->valid.reserve((rows + 31) / 32);
+    }
+}
+
+void ResultMatrix::setReal(size_type column, size_type row, double value)
+{
+    check(column, row);
+    Column& col = m_columns[column];
+
+    if (col.type == EMPTY or col.type == INTEGER) {
+        promote(col, REAL);
+    }
+
+    if (col.type == REAL) {
+        col.reals[row] = value;
+    } else {
+        delete col.values[row];
+        col.values[row] = Double::create(value);
+    }
+    validate(col, row);
+}
+
+void ResultMatrix::setInteger(size_type column, size_type row, int64_t value)
+{
+    check(column, row);
+    Column& col = m_columns[column];
+
+    if (col.type == EMPTY) {
+        promote(col, INTEGER);
+    }
+
+    switch (col.type) {
+    case REAL:
+        col.reals[row] = value;
+        break;
+    case INTEGER:
+        col.integers[row] = value;
+        break;
+    default:
+        delete col.values[row];
+        col.values[row] = Integer::create(value);
+        break;
+    }
+    validate(col, row);
+}
+
+void ResultMatrix::set(size_type column, size_type row, const Value& value)
+{
+    switch (value.getType()) {
+    case Value::DOUBLE:
+        setReal(column, row, value.toDouble().value());
+        break;
+    case Value::INTEGER:
+        setInteger(column, row, value.toInteger().value());
+        break;
+    default:
+        set(column, row, value.clone());
+        break;
+    }
+}
+
+void ResultMatrix::set(size_type column, size_type row, Value* value)
+{
+    if (not value) {
+        check(column, row);
+        return;
+    }
+
+    if (value->isDouble() or value->isInteger()) {
+        boost::scoped_ptr < Value > owner(value);
+        set(column, row, *value);
+        return;
+    }
+
+    check(column, row);
+    Column& col = m_columns[column];
+
+    promote(col, VALUE);
+    delete col.values[row];
+    col.values[row] = value;
+    validate(col, row);
+}
+
+double ResultMatrix::getReal(size_type column, size_type row) const
+{
+    check(column, row);
+
+    if (not isNull(column, row)) {
+        const Column& col = m_columns[column];
+
+        if (col.type == REAL) {
+            return col.reals[row];
+        } else if (col.type == INTEGER) {
+            return col.integers[row];
+        }
+    }
+
+    throw utils::ArgError(fmt(
+            _("ResultMatrix: cell (%1%, %2%) is not a real")) % column % row);
+}
+
+int64_t ResultMatrix::getInteger(size_type column, size_type row) const
+{
+    check(column, row);
+
+    if (not isNull(column, row) and m_columns[column].type == INTEGER) {
+        return m_columns[column].integers[row];
+    }
+
+    throw utils::ArgError(fmt(
+            _("ResultMatrix: cell (%1%, %2%) is not an integer")) % column %
+        row);
+}
+
+const Value* ResultMatrix::getValue(size_type column, size_type row) const
+{
+    check(column, row);
+
+    return m_columns[column].type == VALUE ? m_columns[column].values[row]
+        : 0;
+}
+
+Value* ResultMatrix::get(size_type column, size_type row) const
+{
+    check(column, row);
+
+    if (isNull(column, row)) {
+        return 0;
+    }
+
+    const Column& col = m_columns[column];
+    switch (col.type) {
+    case REAL:
+        return Double::create(col.reals[row]);
+    case INTEGER:
+        return Integer::create(col.integers[row]);
+    default:
+        return col.values[row]->clone();
+    }
+}
+
+Matrix* ResultMatrix::buildMatrix() const
+{
+    size_type columns = m_columns.size() + 1;
+    size_type rows = m_times.size() + 1;
+    Matrix* matrix = new Matrix(columns, rows, columns, rows, columns, 1);
+
+    matrix->add(0, 0, String::create("time"));
+    for (size_type i = 0; i < m_columns.size(); ++i) {
+        matrix->add(i + 1, 0, String::create(m_columns[i].name));
+    }
+
+    for (size_type j = 0; j < m_times.size(); ++j) {
+        matrix->add(0, j + 1, Double::create(m_times[j]));
+        for (size_type i = 0; i < m_columns.size(); ++i) {
+            Value* cell = get(i, j);
+
+            if (cell) {
+                matrix->add(i + 1, j + 1, cell);
+            }
+        }
+    }
+
+    return matrix;
+}
+
+void ResultMatrix::check(size_type column, size_type row) const
+{
+    if (column >= m_columns.size() or row >= m_times.size()) {
+        throw utils::ArgError(fmt(
+                _("ResultMatrix: bad access (%1%, %2%)")) % column % row);
+    }
+}
+
+void ResultMatrix::promote(Column& column, ColumnType type)
+{
+    if (column.type == type) {
+        return;
+    }
+
+    size_type rows = m_times.size();
+
+    switch (type) {
+    case REAL:
+        column.reals.resize(rows, 0.0);
+        for (size_type j = 0; j < column.integers.size(); ++j) {
+            column.reals[j] = column.integers[j];
+        }
+        std::vector < int64_t >().swap(column.integers);
+        break;
+    case INTEGER:
+        column.integers.resize(rows, 0);
+        break;
+    case VALUE:
+        column.values.resize(rows, 0);
+        for (size_type j = 0; j < rows; ++j) {
+            if (isValid(column, j)) {
+                if (column.type == REAL) {
+                    column.values[j] = Double::create(column.reals[j]);
+                } else if (column.type == INTEGER) {
+                    column.values[j] = Integer::create(column.integers[j]);
+                }
+            }
+        }
+        std::vector < double >().swap(column.reals);
+        std::vector < int64_t >().swap(column.integers);
+        break;
+    default:
+        break;
+    }
+
+    column.type = type;
+}
+
+}} // namespace vle value
@@ -0,0 +1,296 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef VLE_VALUE_RESULTMATRIX_HPP
+#define VLE_VALUE_RESULTMATRIX_HPP 1
+
+#include <vle/value/Value.hpp>
+#include <vle/DllDefines.hpp>
+#include <vle/utils/Types.hpp>
+#include <string>
+#include <vector>
+
+namespace vle { namespace value {
+
+/**
+ * @brief A ResultMatrix stores the observations of a view in typed
+ * columns: the dates are stored in their own column and each observable
+ * uses a contiguous lane of reals, a lane of 64 bits integers or a lane
+ * of \c value::Value, chosen by the values received. A bitmap marks the
+ * cells without value. Unlike \c value::Matrix, a real or an integer
+ * costs no allocation.
+ *
+ * The \c buildMatrix function converts the result to the \c
+ * value::Matrix returned by the storage plug-ins: the first row stores
+ * the names of the columns and the first column the dates.
+ *
+ * @code
+ * value::ResultMatrix result;
+ * value::ResultMatrix::size_type x = result.addColumn("top:a.x");
+ * value::ResultMatrix::size_type row = result.addRow(0.0);
+ * result.setReal(x, row, 1.5);
+ *
+ * const std::vector < double >& dates = result.times();
+ * const std::vector < double >& values = result.reals(x);
+ * @endcode
+ */
+class VLE_API ResultMatrix : public Value
+{
+public:
+    typedef std::vector < double >::size_type size_type;
+
+    /**
+     * @brief Define the lane used by a column.
+     */
+    enum ColumnType {
+        EMPTY, /**< No value received, no lane. */
+        REAL, /**< The values are stored into the real lane. */
+        INTEGER, /**< The values are stored into the integer lane. */
+        VALUE /**< The values are stored into the \c value::Value lane. */
+    };
+
+    ResultMatrix()
+    {}
+
+    ResultMatrix(const ResultMatrix& value);
+
+    virtual ~ResultMatrix();
+
+    static ResultMatrix* create()
+    { return new ResultMatrix(); }
+
+    virtual Value* clone() const
+    { return new ResultMatrix(*this); }
+
+    /**
+     * @brief Get the type of this class.
+     * @return Value::RESULTMATRIX.
+     */
+    virtual Value::type getType() const
+    { return Value::RESULTMATRIX; }
+
+    /**
+     * @brief Write the result like the \c value::Matrix returned by \c
+     * buildMatrix.
+     */
+    virtual void writeFile(std::ostream& out) const;
+
+    virtual void writeString(std::ostream& out) const;
+
+    /**
+     * @brief Write the XML of the \c value::Matrix returned by \c
+     * buildMatrix. The column types are not kept.
+     */
+    virtual void writeXml(std::ostream& out) const;
+
+    ///
+    //// Build the result
+    ///
+
+    /**
+     * @brief Add a column without value.
+     * @param name the name of the column.
+     * @return the index of the column.
+     */
+    size_type addColumn(const std::string& name);
+
+    /**
+     * @brief Add a row without value.
+     * @param time the date of the row.
+     * @return the index of the row.
+     */
+    size_type addRow(double time);
+
+    /**
+     * @brief Reserve the memory of the lanes for \c rows rows.
+     */
+    void reserve(size_type rows);
+
+    /**
+     * @brief Assign a real to a cell. An integer column is converted to
+     * a real column, a \c VALUE column stores a \c value::Double.
+     */
+    void setReal(size_type column, size_type row, double value);
+
+    /**
+     * @brief Assign an integer to a cell. A real column stores the
+     * integer as a real, a \c VALUE column stores a \c value::Integer.
+     */
+    void setInteger(size_type column, size_type row, int64_t value);
+
+    /**
+     * @brief Assign a value to a cell. The \c value::Double and the \c
+     * value::Integer are copied into their lane, the other values
+     * convert the column into a \c VALUE column.
+     * @param value the value, cloned if needed.
+     */
+    void set(size_type column, size_type row, const Value& value);
+
+    /**
+     * @brief Assign a value to a cell and take its ownership.
+     * @param value the value, a null pointer leaves the cell empty.
+     */
+    void set(size_type column, size_type row, Value* value);
+
+    ///
+    //// Read the result
+    ///
+
+    size_type columns() const
+    { return m_columns.size(); }
+
+    size_type rows() const
+    { return m_times.size(); }
+
+    const std::string& name(size_type column) const
+    { return m_columns[column].name; }
+
+    ColumnType type(size_type column) const
+    { return m_columns[column].type; }
+
+    double time(size_type row) const
+    { return m_times[row]; }
+
+    const std::vector < double >& times() const
+    { return m_times; }
+
+    /**
+     * @brief Get the real lane of a \c REAL column, empty otherwise.
+     */
+    const std::vector < double >& reals(size_type column) const
+    { return m_columns[column].reals; }
+
+    /**
+     * @brief Get the integer lane of an \c INTEGER column, empty
+     * otherwise.
+     */
+    const std::vector < int64_t >& integers(size_type column) const
+    { return m_columns[column].integers; }
+
+    /**
+     * @brief Check if a cell has no value.
+     */
+    bool isNull(size_type column, size_type row) const
+    { return not isValid(m_columns[column], row); }
+
+    /**
+     * @brief Get the real of a \c REAL or an \c INTEGER cell.
+     * @throw utils::ArgError if the cell is null or not numeric.
+     */
+    double getReal(size_type column, size_type row) const;
+
+    /**
+     * @brief Get the integer of an \c INTEGER cell.
+     * @throw utils::ArgError if the cell is null or not an integer.
+     */
+    int64_t getInteger(size_type column, size_type row) const;
+
+    /**
+     * @brief Get the value of a \c VALUE cell without copy.
+     * @return the value or null if the cell is null or the column is not
+     * a \c VALUE column.
+     */
+    const Value* getValue(size_type column, size_type row) const;
+
+    /**
+     * @brief Build the value of a cell, whatever its lane.
+     * @return A new value or null if the cell is null.
+     */
+    Value* get(size_type column, size_type row) const;
+
+    /**
+     * @brief Build the \c value::Matrix of the storage plug-ins: a first
+     * row with the names of the columns (\c "time" first) and a row for
+     * each date.
+     * @return A new \c value::Matrix.
+     */
+    Matrix* buildMatrix() const;
+
+private:
+    ResultMatrix& operator=(const ResultMatrix& value);
+
+    struct Column
+    {
+        Column(const std::string& name)
+            : name(name), type(EMPTY)
+        {}
+
+        std::string                 name;
+        ColumnType                  type;
+        std::vector < double >      reals;
+        std::vector < int64_t >     integers;
+        std::vector < Value* >      values;
+        std::vector < uint32_t >    valid;
+    };
+
+    void check(size_type column, size_type row) const;
+    void promote(Column& column, ColumnType type);
+
+    static bool isValid(const Column& column, size_type row)
+    {
+        return column.valid[row / 32] &
+            (static_cast < uint32_t >(1) << (row % 32));
+    }
+
+    static void validate(Column& column, size_type row)
+    {
+        column.valid[row / 32] |= static_cast < uint32_t >(1) << (row % 32);
+    }
+
+    std::vector < double > m_times;
+    std::vector < Column > m_columns;
+};
+
+/**
+ * @brief A functor to test is a Value is a ResultMatrix. To use with
+ * algorithms of test.
+ */
+struct VLE_API IsResultMatrixValue
+{
+    bool operator()(const value::Value& value) const
+    { return value.getType() == Value::RESULTMATRIX; }
+
+    bool operator()(const value::Value* value) const
+    { return value and value->getType() == Value::RESULTMATRIX; }
+};
+
+inline const ResultMatrix& toResultMatrixValue(const Value& value)
+{ return value.toResultMatrix(); }
+
+inline const ResultMatrix* toResultMatrixValue(const Value* value)
+{ return value ? &value->toResultMatrix() : 0; }
+
+inline ResultMatrix& toResultMatrixValue(Value& value)
+{ return value.toResultMatrix(); }
+
+inline ResultMatrix* toResultMatrixValue(Value* value)
+{ return value ? &value->toResultMatrix() : 0; }
+
+}} // namespace vle value
+
+#endif
@@ -0,0 +1,124 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <vle/value/Scalar.hpp>
+#include <vle/value/Boolean.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Integer.hpp>
+#include <vle/value/Null.hpp>
+#include <vle/value/String.hpp>
+
+namespace vle { namespace value {
+
+Value* Scalar::toValue() const
+{
+    switch (m_kind) {
+    case BOOLEAN:
+        return Boolean::create(m_value.boolean);
+    case INTEGER:
+        return Integer::create(m_value.integer);
+    case DOUBLE:
+        return Double::create(m_value.real);
+    case STRING:
+        return String::create(m_string);
+    default:
+        return new Null();
+    }
+}
+
+bool Scalar::isScalar(const Value& value)
+{
+    switch (value.getType()) {
+    case Value::BOOLEAN:
+    case Value::INTEGER:
+    case Value::DOUBLE:
+    case Value::STRING:
+        return true;
+    default:
+        return false;
+    }
+}
+
+Scalar Scalar::fromValue(const Value& value)
+{
+    switch (value.getType()) {
+    case Value::BOOLEAN:
+        return Scalar(value.toBoolean().value());
+    case Value::INTEGER:
+        return Scalar(value.toInteger().value());
+    case Value::DOUBLE:
+        return Scalar(value.toDouble().value());
+    case Value::STRING:
+        return Scalar(value.toString().value());
+    default:
+        throw utils::CastError(_("Value is not a scalar"));
+    }
+}
+
+void Scalar::writeString(std::ostream& out) const
+{
+    switch (m_kind) {
+    case BOOLEAN:
+        Boolean(m_value.boolean).writeString(out);
+        break;
+    case INTEGER:
+        Integer(m_value.integer).writeString(out);
+        break;
+    case DOUBLE:
+        Double(m_value.real).writeString(out);
+        break;
+    case STRING:
+        out << m_string;
+        break;
+    default:
+        out << "NA";
+        break;
+    }
+}
+
+bool Scalar::operator==(const Scalar& other) const
+{
+    if (m_kind != other.m_kind) {
+        return false;
+    }
+
+    switch (m_kind) {
+    case BOOLEAN:
+        return m_value.boolean == other.m_value.boolean;
+    case INTEGER:
+        return m_value.integer == other.m_value.integer;
+    case DOUBLE:
+        return m_value.real == other.m_value.real;
+    case STRING:
+        return m_string == other.m_string;
+    default:
+        return true;
+    }
+}
+
+}} // namespace vle value
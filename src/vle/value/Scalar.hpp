@@ -0,0 +1,207 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef VLE_VALUE_SCALAR_HPP
+#define VLE_VALUE_SCALAR_HPP 1
+
+#include <vle/value/Value.hpp>
+#include <vle/DllDefines.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/i18n.hpp>
+#include <vle/utils/Types.hpp>
+#include <ostream>
+#include <string>
+
+namespace vle { namespace value {
+
+/**
+ * @brief A Scalar stores a boolean, an integer, a real or a string by
+ * value, without the allocation of the \c value::Boolean, \c
+ * value::Integer, \c value::Double and \c value::String classes. The short
+ * strings use the small buffer of \c std::string and do not allocate
+ * either.
+ *
+ * The Scalar is used by the attributes of the events and converted into
+ * the \c value::Value hierarchy only when a composite value is needed.
+ *
+ * @code
+ * value::Scalar x(1.5);
+ * value::Scalar msg("hello");
+ *
+ * double d = x.toDouble();
+ * value::Value* val = msg.toValue(); // A new value::String.
+ * @endcode
+ */
+class VLE_API Scalar
+{
+public:
+    /**
+     * @brief Define the type of the value stored.
+     */
+    enum Kind { NONE, BOOLEAN, INTEGER, DOUBLE, STRING };
+
+    Scalar()
+        : m_kind(NONE)
+    { m_value.real = 0.0; }
+
+    Scalar(bool value)
+        : m_kind(BOOLEAN)
+    { m_value.boolean = value; }
+
+    Scalar(int32_t value)
+        : m_kind(INTEGER)
+    { m_value.integer = value; }
+
+    Scalar(double value)
+        : m_kind(DOUBLE)
+    { m_value.real = value; }
+
+    Scalar(const std::string& value)
+        : m_kind(STRING), m_string(value)
+    { m_value.real = 0.0; }
+
+    Scalar(const char* value)
+        : m_kind(STRING), m_string(value)
+    { m_value.real = 0.0; }
+
+    /**
+     * @brief Get the type of the value stored.
+     */
+    Kind kind() const
+    { return m_kind; }
+
+    bool isNone() const
+    { return m_kind == NONE; }
+
+    bool isBoolean() const
+    { return m_kind == BOOLEAN; }
+
+    bool isInteger() const
+    { return m_kind == INTEGER; }
+
+    bool isDouble() const
+    { return m_kind == DOUBLE; }
+
+    bool isString() const
+    { return m_kind == STRING; }
+
+    /**
+     * @throw utils::CastError if the scalar is not a boolean.
+     */
+    bool toBoolean() const
+    {
+        if (m_kind != BOOLEAN) {
+            throw utils::CastError(_("Scalar is not a boolean"));
+        }
+        return m_value.boolean;
+    }
+
+    /**
+     * @throw utils::CastError if the scalar is not an integer.
+     */
+    int32_t toInteger() const
+    {
+        if (m_kind != INTEGER) {
+            throw utils::CastError(_("Scalar is not an integer"));
+        }
+        return m_value.integer;
+    }
+
+    /**
+     * @throw utils::CastError if the scalar is not a real.
+     */
+    double toDouble() const
+    {
+        if (m_kind != DOUBLE) {
+            throw utils::CastError(_("Scalar is not a double"));
+        }
+        return m_value.real;
+    }
+
+    /**
+     * @throw utils::CastError if the scalar is not a string.
+     */
+    const std::string& toString() const
+    {
+        if (m_kind != STRING) {
+            throw utils::CastError(_("Scalar is not a string"));
+        }
+        return m_string;
+    }
+
+    /**
+     * @brief Build the \c value::Value of the scalar: a \c value::Boolean,
+     * a \c value::Integer, a \c value::Double, a \c value::String or a
+     * \c value::Null.
+     * @return A new value.
+     */
+    Value* toValue() const;
+
+    /**
+     * @brief Check if a value can be stored into a Scalar.
+     * @return true for the \c value::Boolean, \c value::Integer, \c
+     * value::Double and \c value::String values.
+     */
+    static bool isScalar(const Value& value);
+
+    /**
+     * @brief Copy a \c value::Boolean, \c value::Integer, \c
+     * value::Double or \c value::String into a Scalar.
+     * @throw utils::CastError if the value is not a scalar.
+     */
+    static Scalar fromValue(const Value& value);
+
+    /**
+     * @brief Write the scalar like the \c writeString function of the
+     * equivalent \c value::Value.
+     */
+    void writeString(std::ostream& out) const;
+
+    bool operator==(const Scalar& other) const;
+
+    bool operator!=(const Scalar& other) const
+    { return not (*this == other); }
+
+    friend std::ostream& operator<<(std::ostream& out, const Scalar& obj)
+    { obj.writeString(out); return out; }
+
+private:
+    Kind            m_kind;
+
+    union {
+        bool        boolean;
+        int32_t     integer;
+        double      real;
+    } m_value;
+
+    std::string     m_string;
+};
+
+}} // namespace vle value
+
+#endif
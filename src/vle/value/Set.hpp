@@ -33,6 +33,7 @@
 #include <vle/value/Double.hpp>
 #include <vle/value/Integer.hpp>
 #include <vle/value/Null.hpp>
+#include <vle/value/Scalar.hpp>
 #include <vle/value/String.hpp>
 #include <vle/value/Table.hpp>
 #include <vle/value/Tuple.hpp>
@@ -375,6 +376,14 @@ public:
     void add(const Value& value)
     { m_value.push_back(value.clone()); }
 
+    /**
+     * @brief Add a scalar into the set, converted into its \c
+     * value::Value.
+     * @param value the Scalar to add.
+     */
+    void add(const Scalar& value)
+    { m_value.push_back(value.toValue()); }
+
     /**
      * @brief Add a null value into the set.
      */
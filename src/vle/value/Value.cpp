@@ -37,6 +37,7 @@
 #include <vle/value/XML.hpp>
 #include <vle/value/Null.hpp>
 #include <vle/value/Matrix.hpp>
+#include <vle/value/ResultMatrix.hpp>
 #include <sstream>
 
 namespace vle { namespace value {
@@ -150,6 +151,14 @@ const Matrix& Value::toMatrix() const
     return static_cast < const Matrix& >(*this);
 }
 
+const ResultMatrix& Value::toResultMatrix() const
+{
+    if (not isResultMatrix()) {
+        throw utils::CastError(_("Value is not a result matrix"));
+    }
+    return static_cast < const ResultMatrix& >(*this);
+}
+
 Boolean& Value::toBoolean()
 {
     if (not isBoolean()) {
@@ -238,5 +247,13 @@ Matrix& Value::toMatrix()
     return static_cast < Matrix& >(*this);
 }
 
+ResultMatrix& Value::toResultMatrix()
+{
+    if (not isResultMatrix()) {
+        throw utils::CastError(_("Value is not a result matrix"));
+    }
+    return static_cast < ResultMatrix& >(*this);
+}
+
 }} // namespace vle value
 
@@ -47,6 +47,7 @@ namespace vle { namespace value {
     class Xml;
     class Null;
     class Matrix;
+    class ResultMatrix;
 
     /**
      * @brief Virtual class to assign Value into Event object.
@@ -55,7 +56,7 @@ namespace vle { namespace value {
     {
     public:
         enum type { BOOLEAN, INTEGER, DOUBLE, STRING, SET, MAP, TUPLE, TABLE,
-            XMLTYPE, NIL, MATRIX };
+            XMLTYPE, NIL, MATRIX, RESULTMATRIX };
 
 	/**
 	 * @brief Default constructor.
@@ -176,6 +177,9 @@ namespace vle { namespace value {
 	inline bool isMatrix() const
 	{ return getType() == Value::MATRIX; }
 
+	inline bool isResultMatrix() const
+	{ return getType() == Value::RESULTMATRIX; }
+
         const Boolean& toBoolean() const;
         const Integer& toInteger() const;
         const Double& toDouble() const;
@@ -187,6 +191,7 @@ namespace vle { namespace value {
         const Xml& toXml() const;
         const Null& toNull() const;
         const Matrix& toMatrix() const;
+        const ResultMatrix& toResultMatrix() const;
 
         /**
          * @brief Check if the Value is a composite value, ie., a Map, a Set or
@@ -217,6 +222,7 @@ namespace vle { namespace value {
         Xml& toXml();
         Null& toNull();
         Matrix& toMatrix();
+        ResultMatrix& toResultMatrix();
 
         /**
          * @brief Stream operator for the value classes. This operator call the
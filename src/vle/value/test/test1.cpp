@@ -36,15 +36,21 @@
 #include <boost/utility.hpp>
 #include <stdexcept>
 #include <limits>
+#include <cstring>
 #include <fstream>
 #include <functional>
+#include <map>
+#include <sstream>
 #include <vle/value/Value.hpp>
+#include <vle/value/Binary.hpp>
 #include <vle/value/Boolean.hpp>
 #include <vle/value/Double.hpp>
 #include <vle/value/Integer.hpp>
 #include <vle/value/Map.hpp>
 #include <vle/value/Matrix.hpp>
 #include <vle/value/Null.hpp>
+#include <vle/value/ResultMatrix.hpp>
+#include <vle/value/Scalar.hpp>
 #include <vle/value/Set.hpp>
 #include <vle/value/String.hpp>
 #include <vle/value/Table.hpp>
@@ -135,6 +141,54 @@ BOOST_AUTO_TEST_CASE(check_map_value)
     delete(mp);
 }
 
+BOOST_AUTO_TEST_CASE(check_map_order)
+{
+    value::Map mp;
+    std::map < std::string, int > ref;
+
+    for (int i = 0; i < 40; ++i) {
+        std::string key = boost::lexical_cast < std::string >((i * 17) % 40);
+
+        mp.addInt(key, i);
+        ref[key] = i;
+
+        BOOST_REQUIRE_EQUAL(mp.size(), ref.size());
+        BOOST_REQUIRE_EQUAL(mp.getInt(key), i);
+    }
+
+    std::map < std::string, int >::const_iterator jt = ref.begin();
+    for (value::Map::const_iterator it = mp.begin(); it != mp.end();
+         ++it, ++jt) {
+        BOOST_REQUIRE_EQUAL(it->first, jt->first);
+        BOOST_REQUIRE_EQUAL(value::toInteger(it->second), jt->second);
+    }
+
+    mp.addInt("3", 100);
+    BOOST_REQUIRE_EQUAL(mp.size(), 40u);
+    BOOST_REQUIRE_EQUAL(mp.getInt("3"), 100);
+    BOOST_REQUIRE(not mp.exist("40"));
+    BOOST_REQUIRE_THROW(mp.get("40"), utils::ArgError);
+
+    delete mp.give("12");
+    BOOST_REQUIRE_EQUAL(mp.size(), 39u);
+    BOOST_REQUIRE(not mp.exist("12"));
+    delete mp.get("13");
+    BOOST_REQUIRE_EQUAL(mp.value().erase("13"), 1u);
+    BOOST_REQUIRE_EQUAL(mp.value().erase("13"), 0u);
+
+    value::Map small;
+    small.addDouble("y", 2.0);
+    small.addDouble("x", 1.0);
+    small.value()["z"] = new value::Double(3.0);
+    BOOST_REQUIRE_EQUAL(small.begin()->first, "x");
+    BOOST_REQUIRE_EQUAL((small.end() - 1)->first, "z");
+    BOOST_REQUIRE_EQUAL(small.getDouble("z"), 3.0);
+
+    value::Map copy(small);
+    BOOST_REQUIRE_EQUAL(copy.size(), 3u);
+    BOOST_REQUIRE_EQUAL(copy.getDouble("y"), 2.0);
+}
+
 BOOST_AUTO_TEST_CASE(check_set_value)
 {
     value::Set* st = value::Set::create();
@@ -252,3 +306,195 @@ BOOST_AUTO_TEST_CASE(check_matrix)
     delete(mx);
     delete(cpy);
 }
+
+BOOST_AUTO_TEST_CASE(check_result_matrix)
+{
+    value::ResultMatrix result;
+    value::ResultMatrix::size_type x = result.addColumn("top:a.x");
+    value::ResultMatrix::size_type y = result.addColumn("top:a.y");
+    value::ResultMatrix::size_type z = result.addColumn("top:a.z");
+
+    for (int i = 0; i < 40; ++i) {
+        value::ResultMatrix::size_type row = result.addRow(i * 0.5);
+
+        result.setInteger(x, row, i);
+        if (i % 2) {
+            result.set(y, row, value::Double::create(i));
+        }
+    }
+
+    BOOST_REQUIRE_EQUAL(result.rows(), 40u);
+    BOOST_REQUIRE_EQUAL(result.type(x), value::ResultMatrix::INTEGER);
+    BOOST_REQUIRE_EQUAL(result.integers(x).size(), 40u);
+    BOOST_REQUIRE_EQUAL(result.getInteger(x, 39), 39);
+    BOOST_REQUIRE_EQUAL(result.type(y), value::ResultMatrix::REAL);
+    BOOST_REQUIRE(result.isNull(y, 34));
+    BOOST_REQUIRE(not result.isNull(y, 35));
+    BOOST_REQUIRE_EQUAL(result.reals(y)[35], 35.0);
+    BOOST_REQUIRE_EQUAL(result.type(z), value::ResultMatrix::EMPTY);
+    BOOST_REQUIRE(not result.get(z, 0));
+    BOOST_REQUIRE_THROW(result.getReal(y, 0), utils::ArgError);
+    BOOST_REQUIRE_THROW(result.setReal(3, 0, 0.0), utils::ArgError);
+
+    result.setReal(x, 1, 0.25);
+    BOOST_REQUIRE_EQUAL(result.type(x), value::ResultMatrix::REAL);
+    BOOST_REQUIRE_EQUAL(result.getReal(x, 1), 0.25);
+    BOOST_REQUIRE_EQUAL(result.getReal(x, 2), 2.0);
+
+    result.set(z, 3, value::String::create("msg"));
+    BOOST_REQUIRE_EQUAL(result.type(z), value::ResultMatrix::VALUE);
+    BOOST_REQUIRE_EQUAL(value::toString(result.getValue(z, 3)), "msg");
+    result.setInteger(z, 4, 7);
+    BOOST_REQUIRE_EQUAL(value::toInteger(result.getValue(z, 4)), 7);
+
+    value::ResultMatrix* cpy = value::toResultMatrixValue(result.clone());
+    value::Matrix* mx = cpy->buildMatrix();
+    delete cpy;
+
+    BOOST_REQUIRE_EQUAL(mx->columns(), 4u);
+    BOOST_REQUIRE_EQUAL(mx->rows(), 41u);
+    BOOST_REQUIRE_EQUAL(value::toString(mx->get(0, 0)), "time");
+    BOOST_REQUIRE_EQUAL(value::toString(mx->get(2, 0)), "top:a.y");
+    BOOST_REQUIRE_EQUAL(mx->getDouble(0, 40), 19.5);
+    BOOST_REQUIRE_EQUAL(mx->getDouble(1, 40), 39.0);
+    BOOST_REQUIRE(not mx->get(2, 35));
+    BOOST_REQUIRE_EQUAL(mx->getDouble(2, 36), 35.0);
+    BOOST_REQUIRE_EQUAL(mx->getString(3, 4), "msg");
+    delete mx;
+}
+
+BOOST_AUTO_TEST_CASE(check_scalar)
+{
+    value::Scalar none;
+    BOOST_REQUIRE(none.isNone());
+    BOOST_REQUIRE_THROW(none.toDouble(), utils::CastError);
+
+    value::Scalar real(0.5), integer(7), boolean(true), str("abc");
+    BOOST_REQUIRE_EQUAL(real.toDouble(), 0.5);
+    BOOST_REQUIRE_EQUAL(integer.toInteger(), 7);
+    BOOST_REQUIRE_EQUAL(boolean.toBoolean(), true);
+    BOOST_REQUIRE_EQUAL(str.toString(), "abc");
+    BOOST_REQUIRE_THROW(integer.toDouble(), utils::CastError);
+    BOOST_REQUIRE(real != integer);
+
+    value::Map mp;
+    mp.add("x", real);
+    mp.add("s", str);
+    BOOST_REQUIRE_EQUAL(mp.getDouble("x"), 0.5);
+    BOOST_REQUIRE_EQUAL(mp.getString("s"), "abc");
+    BOOST_REQUIRE(value::Scalar::isScalar(*mp.get("x")));
+    BOOST_REQUIRE(value::Scalar::fromValue(*mp.get("s")) == str);
+
+    value::Set st;
+    st.add(integer);
+    BOOST_REQUIRE_EQUAL(st.getInt(0), 7);
+    BOOST_REQUIRE(not value::Scalar::isScalar(st));
+    BOOST_REQUIRE_THROW(value::Scalar::fromValue(st), utils::CastError);
+}
+
+BOOST_AUTO_TEST_CASE(check_binary)
+{
+    value::ResultMatrix result;
+    value::ResultMatrix::size_type x = result.addColumn("top:a.x");
+    value::ResultMatrix::size_type y = result.addColumn("top:a.y");
+    value::ResultMatrix::size_type z = result.addColumn("top:a.z");
+    result.addColumn("top:a.w");
+    for (int i = 0; i < 40; ++i) {
+        result.addRow(i * 0.5);
+        result.setReal(x, i, i * 2.0);
+        if (i % 3) {
+            result.setInteger(y, i, i);
+        }
+    }
+    result.set(z, 3, value::String::create("msg"));
+    result.setInteger(z, 5, 7);
+
+    value::Table table(3, 2);
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 2; ++j) {
+            table.get(i, j) = i * 10 + j;
+        }
+    }
+    value::Tuple tuple(5, 1.5);
+    value::Map mp;
+    mp.addXml("xml", "<a>b</a>");
+    mp.addNull("null");
+    mp.addBoolean("bool", false);
+
+    std::stringstream stream;
+    {
+        value::BinaryWriter writer(stream);
+        writer.write(result);
+        writer.write(table);
+        writer.write(tuple);
+        writer.write(mp);
+        writer.write((const value::Value*)0);
+        BOOST_REQUIRE_EQUAL(writer.size(), stream.str().size());
+    }
+
+    {
+        value::BinaryReader reader(stream);
+        BOOST_REQUIRE_EQUAL(reader.next(), value::Value::RESULTMATRIX);
+
+        value::Value* v = reader.read();
+        BOOST_REQUIRE_EQUAL(v->writeToXml(), result.writeToXml());
+        const value::ResultMatrix& r = v->toResultMatrix();
+        BOOST_REQUIRE_EQUAL(r.type(x), value::ResultMatrix::REAL);
+        BOOST_REQUIRE_EQUAL(r.type(y), value::ResultMatrix::INTEGER);
+        BOOST_REQUIRE_EQUAL(r.type(z), value::ResultMatrix::VALUE);
+        BOOST_REQUIRE(r.isNull(y, 3));
+        delete v;
+
+        value::TableView tv;
+        reader.readTable(tv);
+        BOOST_REQUIRE_EQUAL(tv.width, 3u);
+        BOOST_REQUIRE_EQUAL(tv.height, 2u);
+        BOOST_REQUIRE_EQUAL(tv(2, 1), 21.0);
+
+        v = reader.read();
+        BOOST_REQUIRE_EQUAL(v->writeToXml(), tuple.writeToXml());
+        delete v;
+
+        v = reader.read();
+        BOOST_REQUIRE_EQUAL(v->writeToXml(), mp.writeToXml());
+        delete v;
+
+        BOOST_REQUIRE(not reader.read());
+        BOOST_REQUIRE(reader.eof());
+        BOOST_REQUIRE_THROW(reader.read(), utils::ParseError);
+    }
+
+    std::string buffer(value::toBinary(tuple));
+    std::vector < double > aligned((buffer.size() + 15) / 8);
+    std::memcpy(&aligned[0], buffer.data(), buffer.size());
+    {
+        value::BinaryReader reader(&aligned[0], buffer.size());
+        value::TupleView view;
+        reader.readTuple(view);
+        BOOST_REQUIRE_EQUAL(view.size, 5u);
+        BOOST_REQUIRE_EQUAL(view[4], 1.5);
+        BOOST_REQUIRE(view.data > &aligned[0] and
+                      view.data < &aligned[0] + aligned.size());
+        BOOST_REQUIRE(reader.eof());
+    }
+
+    char* misaligned = reinterpret_cast < char* >(&aligned[0]) + 1;
+    std::memmove(misaligned, buffer.data(), buffer.size());
+    {
+        value::BinaryReader reader(misaligned, buffer.size());
+        value::TupleView view;
+        reader.readTuple(view);
+        BOOST_REQUIRE_EQUAL(view[0], 1.5);
+        BOOST_REQUIRE_EQUAL(reinterpret_cast < std::size_t >(view.data) % 8,
+                            0u);
+    }
+
+    BOOST_REQUIRE_THROW(value::fromBinary(buffer.substr(0, buffer.size() - 1)),
+                        utils::ParseError);
+    BOOST_REQUIRE_THROW(value::fromBinary("VLEXML"), utils::ParseError);
+    {
+        value::BinaryReader reader(buffer.data(), buffer.size());
+        value::TableView view;
+        BOOST_REQUIRE_THROW(reader.readTable(view), utils::ParseError);
+    }
+}
@@ -0,0 +1,804 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <vle/vpz/Cache.hpp>
+#include <vle/vpz/Vpz.hpp>
+#include <vle/vpz/AtomicModel.hpp>
+#include <vle/vpz/CoupledModel.hpp>
+#include <vle/value/Binary.hpp>
+#include <vle/value/Set.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/Path.hpp>
+#include <vle/utils/i18n.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace vle { namespace vpz {
+
+namespace {
+
+const std::size_t HEADER_SIZE = 40;
+
+enum ModelKind { ATOMIC = 0, COUPLED = 1 };
+enum ConnectionKind { INTERNAL = 0, INPUT = 1, OUTPUT = 2 };
+
+template < typename T >
+void put(std::string& out, T value)
+{
+    out.append(reinterpret_cast < const char* >(&value), sizeof(T));
+}
+
+void put(std::string& out, const std::string& str)
+{
+    put(out, static_cast < uint32_t >(str.size()));
+    out.append(str);
+}
+
+/*
+ * A cursor on the image. Each read checks the bounds of the image to
+ * detect truncated or corrupted files.
+ */
+class Cursor
+{
+public:
+    Cursor(const char* begin, const char* end)
+        : m_pos(begin), m_end(end)
+    {}
+
+    template < typename T >
+    T get()
+    {
+        T result;
+        std::memcpy(&result, take(sizeof(T)), sizeof(T));
+        return result;
+    }
+
+    std::string getString()
+    {
+        uint32_t size = get < uint32_t >();
+        const char* str = take(size);
+        return std::string(str, size);
+    }
+
+    const char* take(std::size_t size)
+    {
+        if (static_cast < std::size_t >(m_end - m_pos) < size) {
+            throw utils::FileError(_("Cache: truncated or corrupted image"));
+        }
+
+        const char* result = m_pos;
+        m_pos += size;
+        return result;
+    }
+
+private:
+    const char* m_pos;
+    const char* m_end;
+};
+
+/*
+ * Write the project into a buffer and the values of the conditions and
+ * outputs into a value::BinaryWriter, in the order of the reader.
+ */
+class ImageWriter
+{
+public:
+    ImageWriter(std::string& out, value::BinaryWriter& values)
+        : m_out(out), m_values(values)
+    {}
+
+    void write(const Project& project)
+    {
+        put(m_out, project.author());
+        put(m_out, project.date());
+        put(m_out, project.version());
+
+        write(project.model().model(), project.dynamics(), project.classes(),
+              project.experiment(), project.instance());
+    }
+
+    void write(const BaseModel* model, const Dynamics& dynamics,
+               const Classes& classes, const Experiment& experiment,
+               int instance)
+    {
+        put(m_out, static_cast < int32_t >(instance));
+
+        writeModel(model);
+
+        const DynamicList& dyns(dynamics.dynamiclist());
+        put(m_out, static_cast < uint32_t >(dyns.size()));
+        for (DynamicList::const_iterator it = dyns.begin();
+             it != dyns.end(); ++it) {
+            put(m_out, it->second.name());
+            put(m_out, it->second.package());
+            put(m_out, it->second.library());
+            put(m_out, it->second.language());
+        }
+
+        const ClassList& clss(classes.list());
+        put(m_out, static_cast < uint32_t >(clss.size()));
+        for (ClassList::const_iterator it = clss.begin();
+             it != clss.end(); ++it) {
+            put(m_out, it->first);
+            writeModel(it->second.model());
+        }
+
+        writeExperiment(experiment);
+    }
+
+private:
+    void writeModel(const BaseModel* mdl)
+    {
+        if (not mdl) {
+            put(m_out, static_cast < unsigned char >(0xff));
+            return;
+        }
+
+        put(m_out, static_cast < unsigned char >(
+                mdl->isAtomic() ? ATOMIC : COUPLED));
+        put(m_out, mdl->getName());
+        put(m_out, static_cast < int32_t >(mdl->x()));
+        put(m_out, static_cast < int32_t >(mdl->y()));
+        put(m_out, static_cast < int32_t >(mdl->width()));
+        put(m_out, static_cast < int32_t >(mdl->height()));
+        writePorts(mdl->getInputPortList());
+        writePorts(mdl->getOutputPortList());
+
+        if (mdl->isAtomic()) {
+            const AtomicModel* atom = static_cast < const AtomicModel* >(mdl);
+
+            put(m_out, static_cast < uint32_t >(atom->conditions().size()));
+            for (std::vector < std::string >::const_iterator it =
+                 atom->conditions().begin(); it != atom->conditions().end();
+                 ++it) {
+                put(m_out, *it);
+            }
+            put(m_out, atom->dynamics());
+            put(m_out, atom->observables());
+        } else {
+            const CoupledModel* cpl = static_cast < const CoupledModel* >(mdl);
+
+            const ModelList& models(cpl->getModelList());
+            put(m_out, static_cast < uint32_t >(models.size()));
+            for (ModelList::const_iterator it = models.begin();
+                 it != models.end(); ++it) {
+                writeModel(it->second);
+            }
+
+            writeConnections(cpl);
+        }
+    }
+
+    void writePorts(const ConnectionList& ports)
+    {
+        put(m_out, static_cast < uint32_t >(ports.size()));
+        for (ConnectionList::const_iterator it = ports.begin();
+             it != ports.end(); ++it) {
+            put(m_out, it->first);
+        }
+    }
+
+    void writeConnections(const CoupledModel* cpl)
+    {
+        std::string cnts;
+        uint32_t count = 0;
+
+        const ConnectionList& outputs(cpl->getInternalOutputPortList());
+        for (ConnectionList::const_iterator it = outputs.begin();
+             it != outputs.end(); ++it) {
+            for (ModelPortList::const_iterator jt = it->second.begin();
+                 jt != it->second.end(); ++jt) {
+                put(cnts, static_cast < unsigned char >(OUTPUT));
+                put(cnts, jt->first->getName());
+                put(cnts, jt->second);
+                put(cnts, it->first);
+                ++count;
+            }
+        }
+
+        const ConnectionList& inputs(cpl->getInternalInputPortList());
+        for (ConnectionList::const_iterator it = inputs.begin();
+             it != inputs.end(); ++it) {
+            for (ModelPortList::const_iterator jt = it->second.begin();
+                 jt != it->second.end(); ++jt) {
+                put(cnts, static_cast < unsigned char >(INPUT));
+                put(cnts, it->first);
+                put(cnts, jt->first->getName());
+                put(cnts, jt->second);
+                ++count;
+            }
+        }
+
+        const ModelList& models(cpl->getModelList());
+        for (ModelList::const_iterator it = models.begin();
+             it != models.end(); ++it) {
+            const ConnectionList& ports(it->second->getOutputPortList());
+            for (ConnectionList::const_iterator jt = ports.begin();
+                 jt != ports.end(); ++jt) {
+                for (ModelPortList::const_iterator kt = jt->second.begin();
+                     kt != jt->second.end(); ++kt) {
+                    if (kt->first != cpl) {
+                        put(cnts, static_cast < unsigned char >(INTERNAL));
+                        put(cnts, it->first);
+                        put(cnts, jt->first);
+                        put(cnts, kt->first->getName());
+                        put(cnts, kt->second);
+                        ++count;
+                    }
+                }
+            }
+        }
+
+        put(m_out, count);
+        m_out.append(cnts);
+    }
+
+    void writeExperiment(const Experiment& exp)
+    {
+        put(m_out, exp.name());
+        put(m_out, exp.duration());
+        put(m_out, exp.begin());
+        put(m_out, exp.combination());
+        put(m_out, static_cast < uint32_t >(exp.samples()));
+        put(m_out, exp.scheduler());
+        put(m_out, static_cast < uint32_t >(exp.threads()));
+        put(m_out, static_cast < uint32_t >(exp.partitions()));
+        put(m_out, exp.partitioning());
+        put(m_out, exp.seed());
+
+        const ConditionList& cnds(exp.conditions().conditionlist());
+        put(m_out, static_cast < uint32_t >(cnds.size()));
+        for (ConditionList::const_iterator it = cnds.begin();
+             it != cnds.end(); ++it) {
+            put(m_out, it->first);
+            put(m_out, static_cast < uint32_t >(it->second.conditionvalues()
+                                                .size()));
+            for (ConditionValues::const_iterator jt = it->second.begin();
+                 jt != it->second.end(); ++jt) {
+                put(m_out, jt->first);
+                m_values.write(jt->second);
+            }
+        }
+
+        const Views& views(exp.views());
+        const OutputList& outs(views.outputs().outputlist());
+        put(m_out, static_cast < uint32_t >(outs.size()));
+        for (OutputList::const_iterator it = outs.begin();
+             it != outs.end(); ++it) {
+            const Output& out(it->second);
+
+            put(m_out, out.name());
+            put(m_out, static_cast < unsigned char >(out.format()));
+            put(m_out, out.location());
+            put(m_out, out.plugin());
+            put(m_out, out.package());
+            put(m_out, static_cast < uint32_t >(out.buffer()));
+            m_values.write(out.data());
+        }
+
+        const ViewList& lst(views.viewlist());
+        put(m_out, static_cast < uint32_t >(lst.size()));
+        for (ViewList::const_iterator it = lst.begin();
+             it != lst.end(); ++it) {
+            put(m_out, it->second.name());
+            put(m_out, static_cast < unsigned char >(it->second.type()));
+            put(m_out, it->second.output());
+            put(m_out, it->second.timestep());
+            put(m_out, it->second.data());
+        }
+
+        const ObservableList& obs(views.observables().observablelist());
+        put(m_out, static_cast < uint32_t >(obs.size()));
+        for (ObservableList::const_iterator it = obs.begin();
+             it != obs.end(); ++it) {
+            const ObservablePortList& ports(it->second.observableportlist());
+
+            put(m_out, it->first);
+            put(m_out, static_cast < uint32_t >(ports.size()));
+            for (ObservablePortList::const_iterator jt = ports.begin();
+                 jt != ports.end(); ++jt) {
+                const ViewNameList& names(jt->second.viewnamelist());
+
+                put(m_out, jt->first);
+                put(m_out, static_cast < uint32_t >(names.size()));
+                for (ViewNameList::const_iterator kt = names.begin();
+                     kt != names.end(); ++kt) {
+                    put(m_out, *kt);
+                }
+            }
+        }
+    }
+
+    std::string&         m_out;
+    value::BinaryWriter& m_values;
+};
+
+/*
+ * Build the project with the API used by the SaxStackVpz, from the
+ * project and the values written by the ImageWriter.
+ */
+class ImageReader
+{
+public:
+    ImageReader(Cursor& in, value::BinaryReader& values)
+        : m_in(in), m_values(values)
+    {}
+
+    void read(Project& project)
+    {
+        std::string author = m_in.getString();
+        if (not author.empty()) {
+            project.setAuthor(author);
+        }
+        project.setDate(m_in.getString());
+        project.setVersion(m_in.getString());
+        project.setInstance(m_in.get < int32_t >());
+
+        readModel(0, &project.model(), 0);
+
+        uint32_t dyns = m_in.get < uint32_t >();
+        for (uint32_t i = 0; i < dyns; ++i) {
+            Dynamic dyn(m_in.getString());
+            dyn.setPackage(m_in.getString());
+            dyn.setLibrary(m_in.getString());
+            dyn.setLanguage(m_in.getString());
+            project.dynamics().add(dyn);
+        }
+
+        uint32_t classes = m_in.get < uint32_t >();
+        for (uint32_t i = 0; i < classes; ++i) {
+            Class& cls(project.classes().add(m_in.getString()));
+            readModel(0, 0, &cls);
+        }
+
+        readExperiment(project.experiment());
+    }
+
+private:
+    /*
+     * The new model is attached to its parent, to the project or to the
+     * class before its submodels are read, so the model tree is reachable
+     * from the project if the image is corrupted.
+     */
+    void readModel(CoupledModel* parent, Model* model, Class* cls)
+    {
+        unsigned char kind = m_in.get < unsigned char >();
+        if (kind == 0xff) {
+            return;
+        }
+
+        std::string name = m_in.getString();
+        BaseModel* mdl;
+
+        if (kind == ATOMIC) {
+            mdl = new AtomicModel(name, parent);
+        } else if (kind == COUPLED) {
+            mdl = new CoupledModel(name, parent);
+        } else {
+            throw utils::FileError(_("Cache: truncated or corrupted image"));
+        }
+
+        if (model) {
+            model->setModel(mdl);
+        } else if (cls) {
+            cls->setModel(mdl);
+        }
+
+        mdl->setX(m_in.get < int32_t >());
+        mdl->setY(m_in.get < int32_t >());
+        mdl->setWidth(m_in.get < int32_t >());
+        mdl->setHeight(m_in.get < int32_t >());
+
+        uint32_t ports = m_in.get < uint32_t >();
+        for (uint32_t i = 0; i < ports; ++i) {
+            mdl->addInputPort(m_in.getString());
+        }
+
+        ports = m_in.get < uint32_t >();
+        for (uint32_t i = 0; i < ports; ++i) {
+            mdl->addOutputPort(m_in.getString());
+        }
+
+        if (kind == ATOMIC) {
+            AtomicModel* atom = static_cast < AtomicModel* >(mdl);
+
+            uint32_t cnds = m_in.get < uint32_t >();
+            for (uint32_t i = 0; i < cnds; ++i) {
+                atom->addCondition(m_in.getString());
+            }
+            atom->setDynamics(m_in.getString());
+            atom->setObservables(m_in.getString());
+        } else {
+            CoupledModel* cpl = static_cast < CoupledModel* >(mdl);
+
+            uint32_t models = m_in.get < uint32_t >();
+            for (uint32_t i = 0; i < models; ++i) {
+                readModel(cpl, 0, 0);
+            }
+
+            readConnections(cpl);
+        }
+    }
+
+    void readConnections(CoupledModel* cpl)
+    {
+        uint32_t count = m_in.get < uint32_t >();
+
+        for (uint32_t i = 0; i < count; ++i) {
+            unsigned char kind = m_in.get < unsigned char >();
+            std::string a = m_in.getString();
+            std::string b = m_in.getString();
+            std::string c = m_in.getString();
+
+            switch (kind) {
+            case INTERNAL:
+                cpl->addInternalConnection(a, b, c, m_in.getString());
+                break;
+            case INPUT:
+                cpl->addInputConnection(a, b, c);
+                break;
+            case OUTPUT:
+                cpl->addOutputConnection(a, b, c);
+                break;
+            default:
+                throw utils::FileError(
+                    _("Cache: truncated or corrupted image"));
+            }
+        }
+    }
+
+    void readExperiment(Experiment& exp)
+    {
+        exp.setName(m_in.getString());
+        exp.setDuration(m_in.get < double >());
+        exp.setBegin(m_in.get < double >());
+
+        std::string str = m_in.getString();
+        if (not str.empty()) {
+            exp.setCombination(str);
+        }
+        exp.setSamples(m_in.get < uint32_t >());
+        str = m_in.getString();
+        if (not str.empty()) {
+            exp.setScheduler(str);
+        }
+        exp.setThreads(m_in.get < uint32_t >());
+        exp.setPartitions(m_in.get < uint32_t >());
+        str = m_in.getString();
+        if (not str.empty()) {
+            exp.setPartitioning(str);
+        }
+        exp.setSeed(m_in.get < uint32_t >());
+
+        uint32_t cnds = m_in.get < uint32_t >();
+        for (uint32_t i = 0; i < cnds; ++i) {
+            Condition& cnd(exp.conditions().add(Condition(m_in.getString())));
+
+            uint32_t ports = m_in.get < uint32_t >();
+            for (uint32_t j = 0; j < ports; ++j) {
+                cnd.add(m_in.getString());
+
+                value::Value* val = m_values.read();
+                if (val) {
+                    if (not val->isSet()) {
+                        delete val;
+                        throw utils::FileError(
+                            _("Cache: truncated or corrupted image"));
+                    }
+                    cnd.lastAddedPort().value().swap(val->toSet().value());
+                    delete val;
+                }
+            }
+        }
+
+        Views& views(exp.views());
+        uint32_t outs = m_in.get < uint32_t >();
+        for (uint32_t i = 0; i < outs; ++i) {
+            std::string name = m_in.getString();
+            unsigned char format = m_in.get < unsigned char >();
+            std::string location = m_in.getString();
+            std::string plugin = m_in.getString();
+            std::string package = m_in.getString();
+
+            Output& out(format == Output::LOCAL ?
+                        views.outputs().addLocalStream(name, location, plugin,
+                                                       package) :
+                        views.outputs().addDistantStream(name, location,
+                                                         plugin, package));
+            out.setBuffer(m_in.get < uint32_t >());
+
+            value::Value* data = m_values.read();
+            if (data) {
+                out.setData(data);
+            }
+        }
+
+        uint32_t lst = m_in.get < uint32_t >();
+        for (uint32_t i = 0; i < lst; ++i) {
+            std::string name = m_in.getString();
+            unsigned char type = m_in.get < unsigned char >();
+            std::string output = m_in.getString();
+            double timestep = m_in.get < double >();
+
+            View* view;
+            switch (type) {
+            case View::TIMED:
+                view = &views.addTimedView(name, timestep, output);
+                break;
+            case View::EVENT:
+                view = &views.addEventView(name, output);
+                break;
+            case View::FINISH:
+                view = &views.addFinishView(name, output);
+                break;
+            default:
+                throw utils::FileError(
+                    _("Cache: truncated or corrupted image"));
+            }
+            view->setData(m_in.getString());
+        }
+
+        uint32_t obs = m_in.get < uint32_t >();
+        for (uint32_t i = 0; i < obs; ++i) {
+            Observable& observable(views.addObservable(m_in.getString()));
+
+            uint32_t ports = m_in.get < uint32_t >();
+            for (uint32_t j = 0; j < ports; ++j) {
+                ObservablePort& port(observable.add(m_in.getString()));
+
+                uint32_t names = m_in.get < uint32_t >();
+                for (uint32_t k = 0; k < names; ++k) {
+                    port.add(m_in.getString());
+                }
+            }
+        }
+    }
+
+    Cursor&              m_in;
+    value::BinaryReader& m_values;
+};
+
+/*
+ * Write the header, the project padded to 8 bytes and the values of an
+ * image.
+ */
+void writeImage(std::string& project, const std::string& values,
+                uint64_t hash, uint64_t size, std::ostream& out)
+{
+    std::string header(cache::MAGIC, 8);
+    put(header, cache::VERSION);
+    put(header, cache::ENDIANNESS);
+    put(header, hash);
+    put(header, size);
+
+    std::size_t offset = HEADER_SIZE + project.size();
+    offset += (8 - offset % 8) % 8;
+    put(header, static_cast < uint64_t >(offset));
+
+    project.resize(offset - HEADER_SIZE, '\0');
+
+    out.write(header.data(), header.size());
+    out.write(project.data(), project.size());
+    out.write(values.data(), values.size());
+}
+
+void clearProject(Project& project)
+{
+    delete project.model().model();
+    project.clear();
+}
+
+} // anonymous namespace
+
+std::string Cache::filename(const std::string& filename)
+{
+    if (filename.size() >= 4 and
+        filename.compare(filename.size() - 4, 4, ".vpz") == 0) {
+        return filename + 'c';
+    }
+
+    return filename + ".vpzc";
+}
+
+uint64_t Cache::hash(const std::string& filename)
+{
+    std::ifstream in(filename.c_str(), std::ios::binary);
+
+    if (not in.is_open()) {
+        throw utils::FileError(fmt(
+                _("Cache: cannot open file '%1%'")) % filename);
+    }
+
+    const uint64_t prime = 1099511628211ULL;
+    uint64_t result = 14695981039346656037ULL;
+    std::vector < char > buffer(1 << 16);
+
+    while (in) {
+        in.read(&buffer[0], buffer.size());
+        std::size_t size = in.gcount();
+        std::size_t i = 0;
+
+        for (; i + 8 <= size; i += 8) {
+            uint64_t word;
+            std::memcpy(&word, &buffer[i], 8);
+            result = (result ^ word) * prime;
+        }
+
+        for (; i < size; ++i) {
+            result = (result ^ static_cast < unsigned char >(buffer[i])) *
+                prime;
+        }
+    }
+
+    if (in.bad()) {
+        throw utils::FileError(fmt(
+                _("Cache: cannot read file '%1%'")) % filename);
+    }
+
+    return result;
+}
+
+void Cache::write(const Vpz& vpz, uint64_t hash, uint64_t size,
+                  std::ostream& out)
+{
+    std::string project;
+    std::ostringstream values;
+
+    {
+        value::BinaryWriter writer(values);
+        ImageWriter image(project, writer);
+        image.write(vpz.project());
+    }
+
+    writeImage(project, values.str(), hash, size, out);
+}
+
+void Cache::write(const BaseModel* model, const Dynamics& dynamics,
+                  const Classes& classes, const Experiment& experiment,
+                  int instance, std::ostream& out)
+{
+    std::string project;
+    std::ostringstream values;
+
+    put(project, std::string());
+    put(project, std::string());
+    put(project, std::string());
+
+    {
+        value::BinaryWriter writer(values);
+        ImageWriter image(project, writer);
+        image.write(model, dynamics, classes, experiment, instance);
+    }
+
+    writeImage(project, values.str(), 0, 0, out);
+}
+
+void Cache::read(Vpz& vpz, const void* data, std::size_t size)
+{
+    const char* begin = static_cast < const char* >(data);
+    Cursor cursor(begin, begin + size);
+
+    if (std::memcmp(cursor.take(8), cache::MAGIC, 8) != 0 or
+        cursor.get < uint32_t >() != cache::VERSION or
+        cursor.get < uint32_t >() != cache::ENDIANNESS) {
+        throw utils::FileError(_("Cache: not an image or unknown version"));
+    }
+
+    cursor.get < uint64_t >();
+    cursor.get < uint64_t >();
+    uint64_t offset = cursor.get < uint64_t >();
+
+    if (offset < HEADER_SIZE or offset > size) {
+        throw utils::FileError(_("Cache: truncated or corrupted image"));
+    }
+
+    try {
+        value::BinaryReader values(begin + offset, size - offset);
+        Cursor project(begin + HEADER_SIZE, begin + offset);
+        ImageReader image(project, values);
+
+        image.read(vpz.project());
+    } catch (const utils::ParseError& e) {
+        clearProject(vpz.project());
+        throw utils::FileError(fmt(_("Cache: %1%")) % e.what());
+    } catch (...) {
+        clearProject(vpz.project());
+        throw;
+    }
+}
+
+bool Cache::load(Vpz& vpz, const std::string& filename)
+{
+    namespace bip = boost::interprocess;
+
+    std::string image = Cache::filename(filename);
+    bip::mapped_region region;
+
+    try {
+        bip::file_mapping file(image.c_str(), bip::read_only);
+        bip::mapped_region mapped(file, bip::read_only);
+        region.swap(mapped);
+    } catch (const std::exception& /*e*/) {
+        return false;
+    }
+
+    const char* begin = static_cast < const char* >(region.get_address());
+    if (region.get_size() < HEADER_SIZE) {
+        return false;
+    }
+
+    uint64_t hash, size;
+    std::memcpy(&hash, begin + 16, sizeof(hash));
+    std::memcpy(&size, begin + 24, sizeof(size));
+
+    std::ifstream in(filename.c_str(), std::ios::binary | std::ios::ate);
+    if (not in.is_open() or static_cast < uint64_t >(in.tellg()) != size) {
+        return false;
+    }
+    in.close();
+
+    try {
+        if (Cache::hash(filename) != hash) {
+            return false;
+        }
+
+        read(vpz, begin, region.get_size());
+    } catch (const std::exception& /*e*/) {
+        return false;
+    }
+
+    vpz.setFilename(filename);
+    return true;
+}
+
+void Cache::save(const Vpz& vpz, const std::string& filename)
+{
+    uint64_t size;
+    {
+        std::ifstream in(filename.c_str(), std::ios::binary | std::ios::ate);
+        if (not in.is_open()) {
+            throw utils::FileError(fmt(
+                    _("Cache: cannot open file '%1%'")) % filename);
+        }
+        size = in.tellg();
+    }
+
+    std::ostringstream out;
+    write(vpz, Cache::hash(filename), size, out);
+
+    if (not out) {
+        throw utils::FileError(fmt(
+                _("Cache: cannot write the image of '%1%'")) % filename);
+    }
+
+    utils::Path::writeAtomic(Cache::filename(filename), out.str());
+}
+
+}} // namespace vle vpz
@@ -0,0 +1,160 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef VLE_VPZ_CACHE_HPP
+#define VLE_VPZ_CACHE_HPP
+
+#include <vle/DllDefines.hpp>
+#include <vle/utils/Types.hpp>
+#include <ostream>
+#include <string>
+
+namespace vle { namespace vpz {
+
+class BaseModel;
+class Classes;
+class Dynamics;
+class Experiment;
+class Vpz;
+
+/**
+ * @brief The binary image of a vpz::Project, written next to the vpz file
+ * by the Cache.
+ *
+ * An image starts with a 40 bytes header: the magic string \c VLEIMAGE,
+ * the version and the byte order of the writer (uint32), the hash and the
+ * size of the source file (uint64) and the offset of the values
+ * (uint64). The project follows: the attributes of the project, the model
+ * tree in pre-order (ports, graphics, atomic attributes, submodels and
+ * connections of the coupled models), the dynamics, the classes, the
+ * experiment, the conditions, the outputs, the views and the
+ * observables. The strings are stored as an uint32 size followed by the
+ * characters. The values of the conditions and of the outputs are stored
+ * at the offset of the values, aligned on 8 bytes, as a binary stream of
+ * value::BinaryWriter.
+ */
+namespace cache {
+
+const char MAGIC[] = "VLEIMAGE";
+const uint32_t VERSION = 2;
+const uint32_t ENDIANNESS = 0x01020304;
+
+} // namespace cache
+
+/**
+ * @brief The Cache stores a binary image of a vpz file next to it (\c
+ * model.vpz is cached into \c model.vpzc). The image is keyed by the hash
+ * of the vpz file: a modified vpz file makes the image stale and the vpz
+ * is loaded from the XML again.
+ *
+ * @code
+ * vpz::Vpz* vpz = new vpz::Vpz();
+ *
+ * if (not vpz::Cache::load(*vpz, filename)) {
+ *     vpz->parseFile(filename);
+ *     vpz::Cache::save(*vpz, filename);
+ * }
+ * @endcode
+ */
+class VLE_API Cache
+{
+public:
+    /**
+     * @brief Get the name of the image of a vpz file.
+     * @param filename the vpz file.
+     * @return \c filename with the \c .vpzc extension.
+     */
+    static std::string filename(const std::string& filename);
+
+    /**
+     * @brief Compute the hash (64 bits FNV-1a over words of 8 bytes) of
+     * the content of a file.
+     * @param filename the file.
+     * @throw utils::FileError if the file cannot be read.
+     */
+    static uint64_t hash(const std::string& filename);
+
+    /**
+     * @brief Write the image of a vpz.
+     * @param vpz the vpz to write.
+     * @param hash the hash of the source file.
+     * @param size the size of the source file.
+     * @param out the output stream.
+     */
+    static void write(const Vpz& vpz, uint64_t hash, uint64_t size,
+                      std::ostream& out);
+
+    /**
+     * @brief Write the image of the parts of a project, without building
+     * a vpz::Vpz: used by devs::Snapshot to write the model tree and the
+     * experiment of a running simulation. The author, the date and the
+     * version of the project are empty, the hash and the size of the
+     * source file are 0.
+     * @param model the model tree, can be null.
+     * @param dynamics the dynamics.
+     * @param classes the classes.
+     * @param experiment the experiment.
+     * @param instance the instance of the project.
+     * @param out the output stream.
+     */
+    static void write(const BaseModel* model, const Dynamics& dynamics,
+                      const Classes& classes, const Experiment& experiment,
+                      int instance, std::ostream& out);
+
+    /**
+     * @brief Read the image of a vpz from a memory buffer.
+     * @param vpz the vpz to fill, it must be empty.
+     * @param data the image.
+     * @param size the size of the image.
+     * @throw utils::FileError if the image is truncated or corrupted.
+     */
+    static void read(Vpz& vpz, const void* data, std::size_t size);
+
+    /**
+     * @brief Load a vpz from its image. The image is mapped into memory
+     * and read if its hash is the hash of the vpz file.
+     * @param vpz the vpz to fill, it must be empty.
+     * @param filename the vpz file.
+     * @return true if the vpz is loaded, false if the image does not
+     * exist, is stale or is corrupted: the vpz is left empty.
+     */
+    static bool load(Vpz& vpz, const std::string& filename);
+
+    /**
+     * @brief Write the image of a vpz loaded from a file. The image is
+     * written into a temporary file renamed at the end, so a concurrent
+     * load never reads a partial image.
+     * @param vpz the vpz to write.
+     * @param filename the vpz file.
+     * @throw utils::FileError if the image cannot be written.
+     */
+    static void save(const Vpz& vpz, const std::string& filename);
+};
+
+}} // namespace vle vpz
+
+#endif
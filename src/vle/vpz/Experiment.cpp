@@ -41,6 +41,32 @@ void Experiment::write(std::ostream& out) const
             << "\" ";
     }
 
+    if (m_samples > 0) {
+        out << "samples=\"" << m_samples << "\" ";
+    }
+
+    if (not m_scheduler.empty()) {
+        out << "scheduler=\"" << m_scheduler.c_str()
+            << "\" ";
+    }
+
+    if (m_threads > 1) {
+        out << "threads=\"" << m_threads << "\" ";
+    }
+
+    if (m_partitions > 1) {
+        out << "partitions=\"" << m_partitions << "\" ";
+    }
+
+    if (not m_partitioning.empty()) {
+        out << "partitioning=\"" << m_partitioning.c_str()
+            << "\" ";
+    }
+
+    if (m_seed != 0) {
+        out << "seed=\"" << m_seed << "\" ";
+    }
+
     out << " >\n";
 
     m_conditions.write(out);
@@ -54,6 +80,13 @@ void Experiment::clear()
     m_name.clear();
     m_duration = 1.0;
     m_begin = 0;
+    m_combination.clear();
+    m_samples = 0;
+    m_scheduler.clear();
+    m_threads = 0;
+    m_partitions = 0;
+    m_partitioning.clear();
+    m_seed = 0;
 
     m_conditions.clear();
     m_views.clear();
@@ -96,11 +129,29 @@ void Experiment::setDuration(double duration)
 
 void Experiment::setCombination(const std::string& name)
 {
-    if (name != "linear" and name != "total") {
+    if (name != "linear" and name != "total" and name != "sampled") {
         throw utils::ArgError(fmt(_("Unknow combination '%1%'")) % name);
     }
 
     m_combination.assign(name);
 }
 
+void Experiment::setScheduler(const std::string& name)
+{
+    if (name != "heap" and name != "calendar") {
+        throw utils::ArgError(fmt(_("Unknow scheduler '%1%'")) % name);
+    }
+
+    m_scheduler.assign(name);
+}
+
+void Experiment::setPartitioning(const std::string& name)
+{
+    if (name != "balanced" and name != "roundrobin") {
+        throw utils::ArgError(fmt(_("Unknow partitioning '%1%'")) % name);
+    }
+
+    m_partitioning.assign(name);
+}
+
 }} // namespace vle vpz
@@ -32,6 +32,7 @@
 #include <vle/vpz/Base.hpp>
 #include <vle/vpz/Conditions.hpp>
 #include <vle/vpz/Views.hpp>
+#include <vle/utils/Types.hpp>
 
 namespace vle { namespace vpz {
 
@@ -47,7 +48,8 @@ namespace vle { namespace vpz {
          * date at 0.0.
          */
         Experiment()
-            : m_duration(1.0), m_begin(0.0)
+            : m_duration(1.0), m_begin(0.0), m_samples(0), m_threads(0),
+              m_partitions(0), m_seed(0)
         {}
 
         /**
@@ -184,7 +186,9 @@ namespace vle { namespace vpz {
 
         /**
          * @brief Set the experimental design combination.
-         * @param name The new name of experimental design combination.
+         * @param name The new name of experimental design combination:
+         * `linear', `total' or `sampled'.
+         * @throw utils::ArgError if the name is unknown.
          */
         void setCombination(const std::string& name);
 
@@ -195,11 +199,119 @@ namespace vle { namespace vpz {
         const std::string& combination() const
         { return m_combination; }
 
+        /**
+         * @brief Set the number of points of the `sampled' experimental
+         * design combination.
+         * @param samples The number of points.
+         */
+        void setSamples(unsigned int samples)
+        { m_samples = samples; }
+
+        /**
+         * @brief Get the number of points of the `sampled' experimental
+         * design combination.
+         * @return the number of points.
+         */
+        unsigned int samples() const
+        { return m_samples; }
+
+        /**
+         * @brief Set the scheduler of the internal events of the
+         * simulation.
+         * @param name The name of the scheduler: `heap' or `calendar'.
+         * @throw utils::ArgError if the name is unknown.
+         */
+        void setScheduler(const std::string& name);
+
+        /**
+         * @brief Get the scheduler of the internal events of the
+         * simulation.
+         * @return the name of the scheduler or an empty string to use the
+         * default scheduler.
+         */
+        const std::string& scheduler() const
+        { return m_scheduler; }
+
+        /**
+         * @brief Set the number of threads used to execute the bags of
+         * simultaneous events of the simulation.
+         * @param threads The number of threads, 0 or 1 to execute the bags
+         * sequentially.
+         */
+        void setThreads(unsigned int threads)
+        { m_threads = threads; }
+
+        /**
+         * @brief Get the number of threads used to execute the bags of
+         * simultaneous events of the simulation.
+         * @return the number of threads, 0 or 1 for a sequential execution.
+         */
+        unsigned int threads() const
+        { return m_threads; }
+
+        /**
+         * @brief Set the number of partitions of the simulation. Each
+         * partition simulates a part of the top-level coupled model with
+         * its own thread.
+         * @param partitions The number of partitions, 0 or 1 to use a
+         * single partition.
+         */
+        void setPartitions(unsigned int partitions)
+        { m_partitions = partitions; }
+
+        /**
+         * @brief Get the number of partitions of the simulation.
+         * @return the number of partitions, 0 or 1 for a single partition.
+         */
+        unsigned int partitions() const
+        { return m_partitions; }
+
+        /**
+         * @brief Set the strategy used to assign the children of the
+         * top-level coupled model to the partitions.
+         * @param name The name of the strategy: `balanced' or
+         * `roundrobin'.
+         * @throw utils::ArgError if the name is unknown.
+         */
+        void setPartitioning(const std::string& name);
+
+        /**
+         * @brief Get the strategy used to assign the children of the
+         * top-level coupled model to the partitions.
+         * @return the name of the strategy or an empty string to use the
+         * default strategy.
+         */
+        const std::string& partitioning() const
+        { return m_partitioning; }
+
+        /**
+         * @brief Set the seed of the random streams of the simulation.
+         * Each atomic model draws from its own utils::RandStream derived
+         * from this seed, the instance of the project and its complete
+         * name.
+         * @param seed The seed of the experiment.
+         */
+        void setSeed(uint32_t seed)
+        { m_seed = seed; }
+
+        /**
+         * @brief Get the seed of the random streams of the simulation.
+         * @return the seed, 0 by default.
+         */
+        uint32_t seed() const
+        { return m_seed; }
+
     private:
         std::string         m_name;
         double              m_duration;
         double              m_begin;
         std::string         m_combination;
+        unsigned int        m_samples;
+        std::string         m_scheduler;
+        unsigned int        m_threads;
+        unsigned int        m_partitions;
+        std::string         m_partitioning;
+        uint32_t            m_seed;
         Conditions          m_conditions;
         Views               m_views;
     };
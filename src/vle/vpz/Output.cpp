@@ -31,14 +31,14 @@
 namespace vle { namespace vpz {
 
 Output::Output()
-    : m_format(LOCAL), m_data(0)
+    : m_format(LOCAL), m_data(0), m_buffer(0)
 {
 }
 
 Output::Output(const Output& output)
     : Base(output), m_format(output.m_format), m_name(output.m_name),
     m_plugin(output.m_plugin), m_location(output.m_location),
-    m_package(output.m_package)
+    m_package(output.m_package), m_buffer(output.m_buffer)
 {
     if (output.m_data) {
         m_data = output.m_data->clone();
@@ -67,6 +67,7 @@ void Output::swap(Output& output)
     std::swap(m_location, output.m_location);
     std::swap(m_package, output.m_package);
     std::swap(m_data, output.m_data);
+    std::swap(m_buffer, output.m_buffer);
 }
 
 void Output::write(std::ostream& out) const
@@ -90,6 +91,10 @@ void Output::write(std::ostream& out) const
 
     out << " plugin=\"" << m_plugin.c_str() << "\" ";
 
+    if (m_buffer > 0) {
+        out << " buffer=\"" << m_buffer << "\" ";
+    }
+
     if (m_data) {
         out << ">\n";
         m_data->writeXml(out);
@@ -187,7 +192,8 @@ bool Output::operator==(const Output& output) const
 {
     return m_format == output.format() and m_name == output.name()
         and m_plugin == output.plugin() and m_location == output.location()
-        and m_package == output.package() and m_data == output.data();
+        and m_package == output.package() and m_data == output.data()
+        and m_buffer == output.buffer();
 
 }
 
@@ -246,6 +246,26 @@ namespace vle {
         void setName(const std::string& name)
         { m_name.assign(name); }
 
+        /**
+         * @brief Set the size of the queue between the simulation and
+         * the output plug-in. With a non null size, the plug-in runs on
+         * its own thread and the simulation only waits when the queue is
+         * full.
+         * @param buffer the number of observations queued, 0 to call the
+         * plug-in from the simulation thread.
+         */
+        void setBuffer(unsigned int buffer)
+        { m_buffer = buffer; }
+
+        /**
+         * @brief Get the size of the queue between the simulation and the
+         * output plug-in.
+         * @return the number of observations queued, 0 if the plug-in is
+         * called from the simulation thread.
+         */
+        unsigned int buffer() const
+        { return m_buffer; }
+
 	/**
 	 * @brief A operator to compare two Views
 	 * @param view The View to compare
@@ -260,6 +280,7 @@ namespace vle {
         std::string     m_location;
         std::string     m_package;
         value::Value*   m_data;
+        unsigned int    m_buffer;
     };
 
 }} // namespace vle vpz
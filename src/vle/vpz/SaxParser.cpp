@@ -43,26 +43,228 @@
 #include <vle/value/Null.hpp>
 #include <vle/utils/i18n.hpp>
 #include <boost/cast.hpp>
-#include <boost/algorithm/string/trim.hpp>
-#include <boost/algorithm/string/split.hpp>
-#include <boost/algorithm/string/classification.hpp>
 #include <libxml/SAX2.h>
 #include <libxml/parser.h>
 #include <cerrno>
+#include <clocale>
+#include <cstdlib>
 #include <cstring>
 
 namespace vle { namespace vpz {
 
+namespace {
+
+/**
+ * @brief Switch the LC_NUMERIC category to the "C" locale during a parse
+ * if the decimal point of the current locale is not a dot. The previous
+ * locale is restored by the destructor.
+ */
+class NumericLocale
+{
+public:
+    NumericLocale()
+    {
+        const char* point = std::localeconv()->decimal_point;
+
+        if (point[0] != '.' or point[1] != '\0') {
+            m_locale.assign(std::setlocale(LC_NUMERIC, 0));
+            std::setlocale(LC_NUMERIC, "C");
+        }
+    }
+
+    ~NumericLocale()
+    {
+        if (not m_locale.empty()) {
+            std::setlocale(LC_NUMERIC, m_locale.c_str());
+        }
+    }
+
+private:
+    std::string m_locale;
+};
+
+inline bool isSpace(char c)
+{
+    return c == ' ' or c == '\n' or c == '\t' or c == '\r';
+}
+
+/**
+ * @brief Convert the characters [str, last) to a double. The character
+ * pointed by last must not be a part of a number.
+ */
+inline double toDouble(const char* str, const char* last)
+{
+    char* res = 0;
+
+    errno = 0;
+    double r = std::strtod(str, &res);
+
+    if (res == str or errno != 0) {
+        return xmlCharToDouble((const xmlChar*)std::string(str, last).c_str());
+    }
+
+    return r;
+}
+
+enum TagId {
+    TAG_ATTACHEDVIEW, TAG_BOOLEAN, TAG_CLASS, TAG_CLASSES, TAG_CONDITION,
+    TAG_CONDITIONS, TAG_CONNECTION, TAG_CONNECTIONS, TAG_DESTINATION,
+    TAG_DOUBLE, TAG_DYNAMIC, TAG_DYNAMICS, TAG_EXPERIMENT, TAG_IN,
+    TAG_INTEGER, TAG_KEY, TAG_MAP, TAG_MATRIX, TAG_MODEL, TAG_NULL,
+    TAG_OBSERVABLE, TAG_OBSERVABLES, TAG_ORIGIN, TAG_OUT, TAG_OUTPUT,
+    TAG_OUTPUTS, TAG_PORT, TAG_SET, TAG_STRING, TAG_STRUCTURES,
+    TAG_SUBMODELS, TAG_TABLE, TAG_TUPLE, TAG_VIEW, TAG_VIEWS,
+    TAG_VLE_PROJECT, TAG_XML, TAG_UNKNOWN
+};
+
+} // anonymous namespace
+
+const SaxParser::Tag SaxParser::tags[] = {
+    { "attachedview", &SaxParser::onAttachedView,
+        &SaxParser::onEndAttachedView },
+    { "boolean", &SaxParser::onBoolean, &SaxParser::onEndBoolean },
+    { "class", &SaxParser::onClass, &SaxParser::onEndClass },
+    { "classes", &SaxParser::onClasses, &SaxParser::onEndClasses },
+    { "condition", &SaxParser::onCondition, &SaxParser::onEndCondition },
+    { "conditions", &SaxParser::onConditions, &SaxParser::onEndConditions },
+    { "connection", &SaxParser::onConnection, &SaxParser::onEndConnection },
+    { "connections", &SaxParser::onConnections,
+        &SaxParser::onEndConnections },
+    { "destination", &SaxParser::onDestination,
+        &SaxParser::onEndDestination },
+    { "double", &SaxParser::onDouble, &SaxParser::onEndDouble },
+    { "dynamic", &SaxParser::onDynamic, &SaxParser::onEndDynamic },
+    { "dynamics", &SaxParser::onDynamics, &SaxParser::onEndDynamics },
+    { "experiment", &SaxParser::onExperiment, &SaxParser::onEndExperiment },
+    { "in", &SaxParser::onIn, &SaxParser::onEndIn },
+    { "integer", &SaxParser::onInteger, &SaxParser::onEndInteger },
+    { "key", &SaxParser::onKey, &SaxParser::onEndKey },
+    { "map", &SaxParser::onMap, &SaxParser::onEndMap },
+    { "matrix", &SaxParser::onMatrix, &SaxParser::onEndMatrix },
+    { "model", &SaxParser::onModel, &SaxParser::onEndModel },
+    { "null", &SaxParser::onNull, &SaxParser::onEndNull },
+    { "observable", &SaxParser::onObservable, &SaxParser::onEndObservable },
+    { "observables", &SaxParser::onObservables,
+        &SaxParser::onEndObservables },
+    { "origin", &SaxParser::onOrigin, &SaxParser::onEndOrigin },
+    { "out", &SaxParser::onOut, &SaxParser::onEndOut },
+    { "output", &SaxParser::onOutput, &SaxParser::onEndOutput },
+    { "outputs", &SaxParser::onOutputs, &SaxParser::onEndOutputs },
+    { "port", &SaxParser::onPort, &SaxParser::onEndPort },
+    { "set", &SaxParser::onSet, &SaxParser::onEndSet },
+    { "string", &SaxParser::onString, &SaxParser::onEndString },
+    { "structures", &SaxParser::onStructures, &SaxParser::onEndStructures },
+    { "submodels", &SaxParser::onSubModels, &SaxParser::onEndSubModels },
+    { "table", &SaxParser::onTable, &SaxParser::onEndTable },
+    { "tuple", &SaxParser::onTuple, &SaxParser::onEndTuple },
+    { "view", &SaxParser::onView, &SaxParser::onEndView },
+    { "views", &SaxParser::onViews, &SaxParser::onEndViews },
+    { "vle_project", &SaxParser::onVLEProject, &SaxParser::onEndVLEProject },
+    { "xml", &SaxParser::onXML, &SaxParser::onEndXML }
+};
+
+const SaxParser::Tag* SaxParser::findTag(const xmlChar* name)
+{
+    const char* str = (const char*)name;
+    const std::size_t len = std::strlen(str);
+    TagId id = TAG_UNKNOWN;
+
+    switch (str[0]) {
+    case 'a':
+        id = TAG_ATTACHEDVIEW;
+        break;
+    case 'b':
+        id = TAG_BOOLEAN;
+        break;
+    case 'c':
+        switch (len) {
+        case 5: id = TAG_CLASS; break;
+        case 7: id = TAG_CLASSES; break;
+        case 9: id = TAG_CONDITION; break;
+        case 10: id = str[3] == 'd' ? TAG_CONDITIONS : TAG_CONNECTION; break;
+        case 11: id = TAG_CONNECTIONS; break;
+        }
+        break;
+    case 'd':
+        switch (len) {
+        case 6: id = TAG_DOUBLE; break;
+        case 7: id = TAG_DYNAMIC; break;
+        case 8: id = TAG_DYNAMICS; break;
+        case 11: id = TAG_DESTINATION; break;
+        }
+        break;
+    case 'e':
+        id = TAG_EXPERIMENT;
+        break;
+    case 'i':
+        id = len == 2 ? TAG_IN : TAG_INTEGER;
+        break;
+    case 'k':
+        id = TAG_KEY;
+        break;
+    case 'm':
+        switch (len) {
+        case 3: id = TAG_MAP; break;
+        case 5: id = TAG_MODEL; break;
+        case 6: id = TAG_MATRIX; break;
+        }
+        break;
+    case 'n':
+        id = TAG_NULL;
+        break;
+    case 'o':
+        switch (len) {
+        case 3: id = TAG_OUT; break;
+        case 6: id = str[1] == 'r' ? TAG_ORIGIN : TAG_OUTPUT; break;
+        case 7: id = TAG_OUTPUTS; break;
+        case 10: id = TAG_OBSERVABLE; break;
+        case 11: id = TAG_OBSERVABLES; break;
+        }
+        break;
+    case 'p':
+        id = TAG_PORT;
+        break;
+    case 's':
+        switch (len) {
+        case 3: id = TAG_SET; break;
+        case 6: id = TAG_STRING; break;
+        case 9: id = TAG_SUBMODELS; break;
+        case 10: id = TAG_STRUCTURES; break;
+        }
+        break;
+    case 't':
+        id = str[1] == 'u' ? TAG_TUPLE : TAG_TABLE;
+        break;
+    case 'v':
+        switch (len) {
+        case 4: id = TAG_VIEW; break;
+        case 5: id = TAG_VIEWS; break;
+        case 11: id = TAG_VLE_PROJECT; break;
+        }
+        break;
+    case 'x':
+        id = TAG_XML;
+        break;
+    }
+
+    if (id != TAG_UNKNOWN and std::strcmp(str, tags[id].name) == 0) {
+        return &tags[id];
+    }
+
+    return 0;
+}
+
 SaxParser::SaxParser(Vpz& vpz)
     : m_stop(false), m_vpzstack(vpz), m_vpz(vpz), m_isValue(false),
-    m_isVPZ(false)
+    m_isVPZ(false), m_numbers(false), m_count(0), m_tuple(0), m_table(0),
+    m_width(0), m_height(0)
 {
-    fillTagList();
 }
 
 void SaxParser::parseFile(const std::string& filename)
 {
-    setlocale(LC_ALL, "C");
+    NumericLocale locale;
+
     memset(&m_sax, 0, sizeof(xmlSAXHandler));
     m_sax.initialized = XML_SAX2_MAGIC;
     m_sax.startDocument = &SaxParser::onStartDocument;
@@ -89,14 +291,12 @@ void SaxParser::parseFile(const std::string& filename)
         throw utils::SaxParserError(fmt(
                 _("Error when parsing file '%1%': %2%")) % filename % m_error);
     }
-
-    xmlMemoryDump();
-    setlocale(LC_ALL, "");
 }
 
 void SaxParser::parseMemory(const std::string& buffer)
 {
-    setlocale(LC_ALL, "C");
+    NumericLocale locale;
+
     memset(&m_sax, 0, sizeof(xmlSAXHandler));
     m_sax.initialized = XML_SAX2_MAGIC;
     m_sax.startDocument = &SaxParser::onStartDocument;
@@ -122,8 +322,6 @@ void SaxParser::parseMemory(const std::string& buffer)
         throw utils::SaxParserError(fmt(
                 _("Error when parsing memory: %1%")) % m_error);
     }
-    xmlMemoryDump();
-    setlocale(LC_ALL, "");
 }
 
 void SaxParser::stopParser(const std::string& error)
@@ -140,6 +338,7 @@ void SaxParser::clearParserState()
     m_isValue = false;
     m_isVPZ = false;
     m_stop = false;
+    m_numbers = false;
 }
 
 void SaxParser::onStartDocument(void* ctx)
@@ -167,10 +366,10 @@ void SaxParser::onStartElement(void* ctx, const xmlChar* name,
 
     if (not sax->isStopped()) {
         sax->clearLastCharactersStored();
-        StartFuncList::iterator it = sax->m_starts.find(name);
-        if (it != sax->m_starts.end()) {
+        const Tag* tag = findTag(name);
+        if (tag) {
             try {
-                (sax->*(it->second))(atts);
+                (sax->*(tag->start))(atts);
             } catch (const std::exception& e) {
                 sax->stopParser(e.what());
             }
@@ -186,10 +385,10 @@ void SaxParser::onEndElement(void* ctx, const xmlChar* name)
     SaxParser* sax = static_cast < SaxParser* >(ctx);
 
     if (not sax->isStopped()) {
-        EndFuncList::iterator it = sax->m_ends.find(name);
-        if (it != sax->m_ends.end()) {
+        const Tag* tag = findTag(name);
+        if (tag) {
             try {
-                (sax->*(it->second))();
+                (sax->*(tag->end))();
             } catch (const std::exception& e) {
                 sax->stopParser(e.what());
             }
@@ -205,9 +404,15 @@ void SaxParser::onCharacters(void* ctx, const xmlChar* ch, int len)
     SaxParser* sax = static_cast < SaxParser* >(ctx);
 
     if (not sax->isStopped()) {
-        std::string buf((const char*)ch, len);
-
-        sax->addToCharacters(buf);
+        if (sax->m_numbers) {
+            try {
+                sax->readNumbers((const char*)ch, len);
+            } catch (const std::exception& e) {
+                sax->stopParser(e.what());
+            }
+        } else {
+            sax->addToCharacters((const char*)ch, len);
+        }
     }
 }
 
@@ -217,10 +422,75 @@ void SaxParser::onCDataBlock(void* ctx, const xmlChar* value, int len)
     SaxParser* sax = static_cast < SaxParser* >(ctx);
 
     if (not sax->isStopped()) {
-        std::string buf((const char*)value, len);
+        sax->m_cdata.assign((const char*)value, len);
+    }
+}
+
+void SaxParser::readNumbers(const char* str, std::size_t len)
+{
+    const char* end = str + len;
+
+    if (not m_lastCharacters.empty()) {
+        const char* last = str;
+        while (last != end and not isSpace(*last)) {
+            ++last;
+        }
+
+        m_lastCharacters.append(str, last);
+        if (last == end) {
+            return;
+        }
+
+        pushNumber(xmlCharToDouble((const xmlChar*)m_lastCharacters.c_str()));
+        m_lastCharacters.clear();
+        str = last;
+    }
+
+    for (;;) {
+        while (str != end and isSpace(*str)) {
+            ++str;
+        }
+
+        if (str == end) {
+            return;
+        }
+
+        const char* last = str;
+        while (last != end and not isSpace(*last)) {
+            ++last;
+        }
+
+        if (last == end) {
+            m_lastCharacters.assign(str, end);
+            return;
+        }
+
+        pushNumber(toDouble(str, last));
+        str = last;
+    }
+}
+
+void SaxParser::pushNumber(double value)
+{
+    if (m_tuple) {
+        m_tuple->add(value);
+    } else if (m_count < m_width * m_height) {
+        m_table[(m_count % m_width) * m_height + m_count / m_width] = value;
+    }
+
+    ++m_count;
+}
+
+std::size_t SaxParser::endNumbers()
+{
+    m_numbers = false;
 
-        sax->m_cdata.assign(buf);
+    if (not m_lastCharacters.empty()) {
+        pushNumber(xmlCharToDouble((const xmlChar*)m_lastCharacters.c_str()));
+        m_lastCharacters.clear();
     }
+
+    return m_count;
 }
 
 void SaxParser::onWarning(void* /* ctx */, const char *msg, ...)
@@ -241,8 +511,6 @@ void SaxParser::onWarning(void* /* ctx */, const char *msg, ...)
 
 void SaxParser::onError(void* ctx, const char *msg, ...)
 {
-    setlocale(LC_ALL, "");
-
     SaxParser* sax = static_cast < SaxParser* >(ctx);
     char* buffer = new char[1024];
     memset(buffer, 0, 1024);
@@ -258,8 +526,6 @@ void SaxParser::onError(void* ctx, const char *msg, ...)
 
 void SaxParser::onFatalError(void* ctx, const char *msg, ...)
 {
-    setlocale(LC_ALL, "");
-
     SaxParser* sax = static_cast < SaxParser* >(ctx);
     char* buffer = new char[1024];
     memset(buffer, 0, 1024);
@@ -376,6 +642,11 @@ void SaxParser::onKey(const xmlChar** att)
 void SaxParser::onTuple(const xmlChar**)
 {
     m_valuestack.pushTuple();
+
+    m_tuple = &m_valuestack.topValue()->toTuple();
+    m_table = 0;
+    m_count = 0;
+    m_numbers = true;
 }
 
 void SaxParser::onTable(const xmlChar** att)
@@ -403,6 +674,14 @@ void SaxParser::onTable(const xmlChar** att)
             _("Table value tag can not convert attributes 'width' or "
               "'height': %1%")) % e.what());
     }
+
+    value::Table& table(m_valuestack.topValue()->toTable());
+    m_tuple = 0;
+    m_table = table.value().data();
+    m_width = table.width();
+    m_height = table.height();
+    m_count = 0;
+    m_numbers = true;
 }
 
 void SaxParser::onXML(const xmlChar**)
@@ -596,22 +875,7 @@ void SaxParser::onEndMap()
 
 void SaxParser::onEndTuple()
 {
-    value::Tuple& tuple(m_valuestack.topValue()->toTuple());
-
-    std::string cpy(lastCharactersStored());
-    boost::algorithm::trim(cpy);
-
-    std::vector < std::string > result;
-    boost::algorithm::split(result, cpy,
-                            boost::algorithm::is_any_of(" \n\t\r"));
-
-    for (std::vector < std::string >::iterator it = result.begin();
-         it != result.end(); ++it) {
-        boost::algorithm::trim(*it);
-        if (not (*it).empty()) {
-            tuple.add(xmlCharToDouble((const xmlChar*)((*it).c_str())));
-        }
-    }
+    endNumbers();
 
     m_valuestack.popValue();
 }
@@ -620,13 +884,6 @@ void SaxParser::onEndTable()
 {
     value::Table& table(m_valuestack.topValue()->toTable());
 
-    std::string cpy(lastCharactersStored());
-    boost::algorithm::trim(cpy);
-
-    std::vector < std::string > result;
-    boost::algorithm::split(result, cpy,
-                            boost::algorithm::is_any_of(" \n\t\r"));
-
     size_t size;
     try {
         size = boost::numeric_cast < size_t >(table.width() * table.height());
@@ -636,31 +893,11 @@ void SaxParser::onEndTable()
             table.width() % table.height());
     }
 
-    if (result.size() != size) {
+    if (endNumbers() != size) {
         throw utils::SaxParserError(
             _("VPZ parser: bad height or width for number of real in table"));
     }
 
-    value::Table::index i = 0;
-    value::Table::index j = 0;
-    for (std::vector < std::string >::iterator it = result.begin(); it !=
-         result.end(); ++it) {
-        boost::algorithm::trim(*it);
-        if (not (*it).empty()) {
-            table.get(i, j) = xmlCharToDouble((const xmlChar*)((*it).c_str()));
-            if (i + 1 >= table.width()) {
-                i = 0;
-                if (j + 1 >= table.height()) {
-                    break;
-                } else {
-                    j++;
-                }
-            } else {
-                i++;
-            }
-        }
-    }
-
     m_valuestack.popValue();
 }
 
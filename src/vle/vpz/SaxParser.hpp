@@ -34,7 +34,6 @@
 #include <vle/vpz/SaxStackVpz.hpp>
 #include <vle/DllDefines.hpp>
 #include <vle/value/Value.hpp>
-#include <map>
 
 namespace vle { namespace vpz {
 
@@ -162,9 +161,10 @@ namespace vle { namespace vpz {
         /**
          * @brief Append characters to the last characters readed.
          * @param characters The characters to append.
+         * @param len The number of characters.
          */
-        void addToCharacters(const std::string& characters)
-        { m_lastCharacters.append(characters); }
+        void addToCharacters(const char* characters, std::size_t len)
+        { m_lastCharacters.append(characters, len); }
 
         /**
          * @brief Stop the parsing of the XML file.
@@ -190,19 +190,60 @@ namespace vle { namespace vpz {
         bool          m_isValue;
         bool          m_isVPZ;
 
-        struct XmlCompare
+        typedef void (SaxParser::* startfunc)(const xmlChar**);
+        typedef void (SaxParser::* endfunc)();
+
+        /**
+         * @brief A tag of the vpz and value languages with its start and end
+         * element functions.
+         */
+        struct Tag
         {
-            inline bool operator()(const xmlChar* s1, const xmlChar* s2) const
-            { return xmlStrcmp(s1, s2) < 0; }
+            const char* name;
+            startfunc   start;
+            endfunc     end;
         };
 
-        typedef void (SaxParser::* startfunc)(const xmlChar**);
-        typedef void (SaxParser::* endfunc)();
-        typedef std::map < const xmlChar*, startfunc, XmlCompare > StartFuncList;
-        typedef std::map < const xmlChar*, endfunc, XmlCompare > EndFuncList;
+        static const Tag tags[];
+
+        /**
+         * @brief Find the tag of an element name. The tags are indexed by
+         * their first character and their length, so a single string
+         * comparison is done.
+         * @param name The name of the element.
+         * @return The tag or null if the name is unknown.
+         */
+        static const Tag* findTag(const xmlChar* name);
 
-        StartFuncList   m_starts;
-        EndFuncList     m_ends;
+        /**
+         * @brief Parse the numbers of the characters of a tuple or a table
+         * directly into the value on the top of the value stack. A number
+         * split between two calls of onCharacters is kept into the last
+         * characters buffer.
+         * @param str The characters.
+         * @param len The number of characters.
+         */
+        void readNumbers(const char* str, std::size_t len);
+
+        /**
+         * @brief Store a number read into the tuple or the table.
+         * @param value The number.
+         */
+        void pushNumber(double value);
+
+        /**
+         * @brief Parse the last number of a tuple or a table and stop the
+         * numbers parsing.
+         * @return The count of numbers read.
+         */
+        std::size_t endNumbers();
+
+        bool          m_numbers; /**< true into a tuple or a table. */
+        std::size_t   m_count; /**< count of numbers read. */
+        value::Tuple* m_tuple; /**< the current tuple or null. */
+        double*       m_table; /**< the data of the current table or null. */
+        std::size_t   m_width;
+        std::size_t   m_height;
 
         void onBoolean(const xmlChar** att);
         void onInteger(const xmlChar** att);
@@ -281,64 +322,6 @@ namespace vle { namespace vpz {
         void onEndAttachedView();
         void onEndClasses();
         void onEndClass();
-
-        void add(const char* name, startfunc fct, endfunc efct)
-        {
-            m_starts[(const xmlChar*)name] = fct;
-            m_ends[(const xmlChar*)name] = efct;
-        }
-
-        void fillTagList()
-        {
-            add("boolean", &SaxParser::onBoolean, &SaxParser::onEndBoolean);
-            add("integer", &SaxParser::onInteger, &SaxParser::onEndInteger);
-            add("double", &SaxParser::onDouble, &SaxParser::onEndDouble);
-            add("string", &SaxParser::onString, &SaxParser::onEndString);
-            add("set", &SaxParser::onSet, &SaxParser::onEndSet);
-            add("matrix", &SaxParser::onMatrix, &SaxParser::onEndMatrix);
-            add("map", &SaxParser::onMap, &SaxParser::onEndMap);
-            add("key", &SaxParser::onKey, &SaxParser::onEndKey);
-            add("tuple", &SaxParser::onTuple, &SaxParser::onEndTuple);
-            add("table", &SaxParser::onTable, &SaxParser::onEndTable);
-            add("xml", &SaxParser::onXML, &SaxParser::onEndXML);
-            add("null", &SaxParser::onNull, &SaxParser::onEndNull);
-            add("vle_project", &SaxParser::onVLEProject,
-                &SaxParser::onEndVLEProject);
-            add("structures", &SaxParser::onStructures,
-                &SaxParser::onEndStructures);
-            add("model", &SaxParser::onModel, &SaxParser::onEndModel);
-            add("in", &SaxParser::onIn, &SaxParser::onEndIn);
-            add("out", &SaxParser::onOut, &SaxParser::onEndOut);
-            add("port", &SaxParser::onPort, &SaxParser::onEndPort);
-            add("submodels", &SaxParser::onSubModels,
-                &SaxParser::onEndSubModels);
-            add("connections", &SaxParser::onConnections,
-                &SaxParser::onEndConnections);
-            add("connection", &SaxParser::onConnection,
-                &SaxParser::onEndConnection);
-            add("origin", &SaxParser::onOrigin, &SaxParser::onEndOrigin);
-            add("destination", &SaxParser::onDestination,
-                &SaxParser::onEndDestination);
-            add("dynamics", &SaxParser::onDynamics, &SaxParser::onEndDynamics);
-            add("dynamic", &SaxParser::onDynamic, &SaxParser::onEndDynamic);
-            add("experiment", &SaxParser::onExperiment,
-                &SaxParser::onEndExperiment);
-            add("conditions", &SaxParser::onConditions,
-                &SaxParser::onEndConditions);
-            add("condition", &SaxParser::onCondition, &SaxParser::onEndCondition);
-            add("views", &SaxParser::onViews, &SaxParser::onEndViews);
-            add("outputs", &SaxParser::onOutputs, &SaxParser::onEndOutputs);
-            add("output", &SaxParser::onOutput, &SaxParser::onEndOutput);
-            add("view", &SaxParser::onView, &SaxParser::onEndView);
-            add("observables", &SaxParser::onObservables,
-                &SaxParser::onEndObservables);
-            add("observable", &SaxParser::onObservable,
-                &SaxParser::onEndObservable);
-            add("attachedview", &SaxParser::onAttachedView,
-                &SaxParser::onEndAttachedView);
-            add("classes", &SaxParser::onClasses, &SaxParser::onEndClasses);
-            add("class", &SaxParser::onClass, &SaxParser::onEndClass);
-        }
     };
 
     /**
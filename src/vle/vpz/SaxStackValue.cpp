@@ -35,9 +35,14 @@ namespace vle { namespace vpz {
 bool ValueStackSax::isCompositeParent() const
 {
     if (not m_valuestack.empty()) {
-        const value::Value* val = m_valuestack.top();
-
-        return val->isMap() or val->isSet() or val->isMatrix();
+        switch (m_valuestack.back()->getType()) {
+        case value::Value::MAP:
+        case value::Value::SET:
+        case value::Value::MATRIX:
+            return true;
+        default:
+            return false;
+        }
     }
     return false;
 }
@@ -92,7 +97,7 @@ void ValueStackSax::pushMap()
 void ValueStackSax::pushMapKey(const std::string& key)
 {
     if (not m_valuestack.empty()) {
-        if (not m_valuestack.top()->isMap()) {
+        if (not m_valuestack.back()->isMap()) {
             throw utils::SaxParserError();
         }
     }
@@ -171,7 +176,7 @@ void ValueStackSax::pushNull()
 void ValueStackSax::popValue()
 {
     if (not m_valuestack.empty()) {
-        m_valuestack.pop();
+        m_valuestack.pop_back();
     }
 }
 
@@ -182,42 +187,56 @@ value::Value* ValueStackSax::topValue()
             _("Empty sax parser value stack for the top operation"));
     }
 
-    return m_valuestack.top();
+    return m_valuestack.back();
 }
 
 void ValueStackSax::pushOnVectorValue(value::Value* val)
 {
+    const value::Value::type type = val->getType();
+
     if (not m_valuestack.empty()) {
-        if (m_valuestack.top()->isSet()) {
-            m_valuestack.top()->toSet().add(val);
-        } else if (m_valuestack.top()->isMap()) {
-            m_valuestack.top()->toMap().add(m_lastkey, val);
-        } else if (m_valuestack.top()->isMatrix()) {
-            value::Matrix& mx(m_valuestack.top()->toMatrix());
-            if (not val->isNull()) {
-                mx.addToLastCell(val);
+        value::Value* parent = m_valuestack.back();
+
+        switch (parent->getType()) {
+        case value::Value::SET:
+            static_cast < value::Set* >(parent)->add(val);
+            break;
+        case value::Value::MAP:
+            static_cast < value::Map* >(parent)->add(m_lastkey, val);
+            break;
+        case value::Value::MATRIX: {
+            value::Matrix* mx = static_cast < value::Matrix* >(parent);
+            if (type != value::Value::NIL) {
+                mx->addToLastCell(val);
+            } else {
+                delete val;
             }
-            mx.moveLastCell();
+            mx->moveLastCell();
+            break;
+        }
+        default:
+            break;
         }
     } else {
         m_result.push_back(val);
     }
 
-    if (val->isSet() or val->isMap() or val->isTuple() or val->isTable() or
-        val->isMatrix()) {
-        m_valuestack.push(val);
-    }
-
-    if (val->isNull()) {
-        delete val;
+    switch (type) {
+    case value::Value::SET:
+    case value::Value::MAP:
+    case value::Value::TUPLE:
+    case value::Value::TABLE:
+    case value::Value::MATRIX:
+        m_valuestack.push_back(val);
+        break;
+    default:
+        break;
     }
 }
 
 void ValueStackSax::clear()
 {
-    while (not m_valuestack.empty())
-        m_valuestack.pop();
-
+    m_valuestack.clear();
     m_result.clear();
 }
 
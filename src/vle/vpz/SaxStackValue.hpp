@@ -28,11 +28,11 @@
 #ifndef VLE_SAX_STACK_VALUE_HPP
 #define VLE_SAX_STACK_VALUE_HPP
 
-#include <stack>
 #include <vle/value/Value.hpp>
 #include <vle/value/Matrix.hpp>
 #include <vle/value/Table.hpp>
 #include <vle/DllDefines.hpp>
+#include <vector>
 
 namespace vle { namespace vpz {
 
@@ -142,7 +142,7 @@ namespace vle { namespace vpz {
          * @brief Pop the current head. If stack is empty, do nothing.
          */
         inline void pop()
-        { m_valuestack.pop(); }
+        { m_valuestack.pop_back(); }
 
         /**
          * @brief Return true if this sax parser stack is empty.
@@ -229,7 +229,7 @@ namespace vle { namespace vpz {
          * @brief Store the value stack, usefull for composite value, Map, Set,
          * Matrix.
          */
-        std::stack < value::Value* >  m_valuestack;
+        std::vector < value::Value* > m_valuestack;
 
         /**
          * @brief Store result of Values parsing from trame, simple value,
@@ -520,6 +520,12 @@ void SaxStackVpz::pushExperiment(const xmlChar** att)
     const xmlChar* duration = 0;
     const xmlChar* begin = 0;
     const xmlChar* combination = 0;
+    const xmlChar* samples = 0;
+    const xmlChar* scheduler = 0;
+    const xmlChar* threads = 0;
+    const xmlChar* partitions = 0;
+    const xmlChar* partitioning = 0;
+    const xmlChar* seed = 0;
 
     for (int i = 0; att[i] != 0; i += 2) {
         if (xmlStrcmp(att[i], (const xmlChar*)"name") == 0) {
@@ -530,6 +536,18 @@ void SaxStackVpz::pushExperiment(const xmlChar** att)
             begin = att[i + 1];
         } else if (xmlStrcmp(att[i], (const xmlChar*)"combination") == 0) {
             combination = att[i + 1];
+        } else if (xmlStrcmp(att[i], (const xmlChar*)"samples") == 0) {
+            samples = att[i + 1];
+        } else if (xmlStrcmp(att[i], (const xmlChar*)"scheduler") == 0) {
+            scheduler = att[i + 1];
+        } else if (xmlStrcmp(att[i], (const xmlChar*)"threads") == 0) {
+            threads = att[i + 1];
+        } else if (xmlStrcmp(att[i], (const xmlChar*)"partitions") == 0) {
+            partitions = att[i + 1];
+        } else if (xmlStrcmp(att[i], (const xmlChar*)"partitioning") == 0) {
+            partitioning = att[i + 1];
+        } else if (xmlStrcmp(att[i], (const xmlChar*)"seed") == 0) {
+            seed = att[i + 1];
         }
     }
 
@@ -550,6 +568,30 @@ void SaxStackVpz::pushExperiment(const xmlChar** att)
     if (combination) {
         exp.setCombination(xmlCharToString(combination));
     }
+
+    if (samples) {
+        exp.setSamples(xmlCharToUnsignedInt(samples));
+    }
+
+    if (scheduler) {
+        exp.setScheduler(xmlCharToString(scheduler));
+    }
+
+    if (threads) {
+        exp.setThreads(xmlCharToUnsignedInt(threads));
+    }
+
+    if (partitions) {
+        exp.setPartitions(xmlCharToUnsignedInt(partitions));
+    }
+
+    if (partitioning) {
+        exp.setPartitioning(xmlCharToString(partitioning));
+    }
+
+    if (seed) {
+        exp.setSeed(xmlCharToUnsignedInt(seed));
+    }
 }
 
 void SaxStackVpz::pushConditions()
@@ -660,6 +702,7 @@ void SaxStackVpz::pushOutput(const xmlChar** att)
     const xmlChar* plugin = 0;
     const xmlChar* location = 0;
     const xmlChar* package = 0;
+    const xmlChar* buffer = 0;
 
     for (int i = 0; att[i] != 0; i += 2) {
         if (xmlStrcmp(att[i], (const xmlChar*)"name") == 0) {
@@ -672,6 +715,8 @@ void SaxStackVpz::pushOutput(const xmlChar** att)
             location = att[i + 1];
         } else if (xmlStrcmp(att[i], (const xmlChar*)"package") == 0) {
             package = att[i + 1];
+        } else if (xmlStrcmp(att[i], (const xmlChar*)"buffer") == 0) {
+            buffer = att[i + 1];
         }
     }
 
@@ -683,6 +728,9 @@ void SaxStackVpz::pushOutput(const xmlChar** att)
             location ? xmlCharToString(location) : std::string(),
             xmlCharToString(plugin),
             package ? xmlCharToString(package) : std::string());
+        if (buffer) {
+            result.setBuffer(xmlCharToUnsignedInt(buffer));
+        }
         push(&result);
     } else if (xmlStrcmp(format, (const xmlChar*)"distant") == 0) {
         Output& result = outs.addDistantStream(
@@ -690,6 +738,9 @@ void SaxStackVpz::pushOutput(const xmlChar** att)
             location ? xmlCharToString(location) : std::string(),
             xmlCharToString(plugin),
             package ? xmlCharToString(package) : std::string());
+        if (buffer) {
+            result.setBuffer(xmlCharToUnsignedInt(buffer));
+        }
         push(&result);
     } else {
         throw utils::SaxParserError(fmt(
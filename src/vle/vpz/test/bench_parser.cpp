@@ -0,0 +1,146 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2013 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2013 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2013 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Loading benchmark of the vpz::SaxParser. The benchmark generates vpz
+ * files of increasing size: a coupled model of n atomic models connected
+ * in a ring, one condition per model with a set of doubles, a map and a
+ * tuple, and a table of n rows. Each file is written into the current
+ * directory, parsed with vpz::Vpz and removed.
+ *
+ * Usage: bench_parser [models]
+ */
+
+#include <vle/vpz/Vpz.hpp>
+#include <vle/value/Value.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/timer.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace vle;
+
+void generate(std::ostream& out, std::size_t models)
+{
+    out << "<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n"
+        << "<vle_project version=\"1.0\" date=\"\" author=\"bench\">\n"
+        << "<structures>\n<model name=\"top\" type=\"coupled\">\n"
+        << "<submodels>\n";
+
+    for (std::size_t i = 0; i < models; ++i) {
+        out << "<model name=\"m" << i << "\" type=\"atomic\""
+            << " dynamics=\"dyn\" conditions=\"c" << i << "\">"
+            << "<in><port name=\"in\" /></in>"
+            << "<out><port name=\"out\" /></out></model>\n";
+    }
+
+    out << "</submodels>\n<connections>\n";
+
+    for (std::size_t i = 0; i < models; ++i) {
+        out << "<connection type=\"internal\"><origin model=\"m" << i
+            << "\" port=\"out\" /><destination model=\"m"
+            << (i + 1) % models << "\" port=\"in\" /></connection>\n";
+    }
+
+    out << "</connections>\n</model>\n</structures>\n"
+        << "<dynamics><dynamic name=\"dyn\" package=\"bench\""
+        << " library=\"bench\" type=\"local\" /></dynamics>\n"
+        << "<experiment name=\"bench\" duration=\"100\" begin=\"0\""
+        << " seed=\"1\">\n<conditions>\n";
+
+    for (std::size_t i = 0; i < models; ++i) {
+        out << "<condition name=\"c" << i << "\">"
+            << "<port name=\"values\"><set>";
+        for (std::size_t j = 0; j < 16; ++j) {
+            out << "<double>" << i * 0.25 + j << "</double>";
+        }
+        out << "</set></port>"
+            << "<port name=\"parameters\"><map>"
+            << "<key name=\"id\"><integer>" << i << "</integer></key>"
+            << "<key name=\"name\"><string>m" << i << "</string></key>"
+            << "<key name=\"active\"><boolean>true</boolean></key>"
+            << "</map></port>"
+            << "<port name=\"curve\"><tuple>";
+        for (std::size_t j = 0; j < 32; ++j) {
+            out << (j ? " " : "") << i + j * 0.125;
+        }
+        out << "</tuple></port></condition>\n";
+    }
+
+    out << "<condition name=\"table\"><port name=\"data\">"
+        << "<table width=\"8\" height=\"" << models << "\">\n";
+    for (std::size_t i = 0; i < models; ++i) {
+        for (std::size_t j = 0; j < 8; ++j) {
+            out << i + j * 0.5 << (j == 7 ? "\n" : " ");
+        }
+    }
+    out << "</table></port></condition>\n"
+        << "</conditions>\n</experiment>\n</vle_project>\n";
+}
+
+void run(std::size_t models)
+{
+    const std::string filename = "bench_parser.vpz";
+
+    {
+        std::ofstream out(filename.c_str());
+        generate(out, models);
+    }
+
+    std::ifstream in(filename.c_str(), std::ios::binary | std::ios::ate);
+    double size = static_cast < double >(in.tellg()) / (1024.0 * 1024.0);
+    in.close();
+
+    boost::timer timer;
+    vpz::Vpz vpz(filename);
+    double elapsed = timer.elapsed();
+
+    std::cout << models << " models, " << size << " MB: " << elapsed
+              << " s, " << size / elapsed << " MB/s ("
+              << vpz.project().experiment().conditions().conditionlist().size()
+              << " conditions)\n";
+
+    std::remove(filename.c_str());
+}
+
+int main(int argc, char* argv[])
+{
+    std::size_t models = 100000;
+
+    if (argc > 1) {
+        models = boost::lexical_cast < std::size_t >(argv[1]);
+    }
+
+    for (std::size_t n = 1000; n < models; n *= 10) {
+        run(n);
+    }
+    run(models);
+
+    return EXIT_SUCCESS;
+}
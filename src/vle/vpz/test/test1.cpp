@@ -43,6 +43,7 @@
 #include <vle/value/Set.hpp>
 #include <vle/value/Map.hpp>
 #include <vle/value/Matrix.hpp>
+#include <vle/value/Binary.hpp>
 #include <vle/value/Tuple.hpp>
 #include <vle/value/Table.hpp>
 #include <vle/value/XML.hpp>
@@ -608,3 +609,88 @@ BOOST_AUTO_TEST_CASE(value_matrix_of_matrix_io)
     delete v;
     delete v2;
 }
+
+BOOST_AUTO_TEST_CASE(value_binary_io)
+{
+    const char* t1 = "<?xml version=\"1.0\"?>\n"
+        "<map>"
+        "<key name=\"set\"><set><integer>1</integer><string>test</string>"
+        "<boolean>true</boolean></set></key>"
+        "<key name=\"tuple\"><tuple>1.5 2.5 3.5</tuple></key>"
+        "<key name=\"table\"><table width=\"2\" height=\"3\">"
+        "1 2 3 4 5 6</table></key>"
+        "<key name=\"matrix\"><matrix rows=\"2\" columns=\"2\" "
+        "columnmax=\"4\" rowmax=\"4\" columnstep=\"2\" rowstep=\"3\">"
+        "<double>0.25</double><null /><null /><string>b</string>"
+        "</matrix></key>"
+        "<key name=\"double\"><double>-1e-300</double></key>"
+        "</map>";
+
+    value::Value* v = vpz::Vpz::parseValue(t1);
+    std::string binary(value::toBinary(*v));
+    value::Value* v2 = value::fromBinary(binary);
+
+    BOOST_REQUIRE_EQUAL(v2->writeToXml(), v->writeToXml());
+    BOOST_REQUIRE_EQUAL(value::toBinary(*v2), binary);
+
+    std::string xml("<?xml version=\"1.0\"?>\n" + v2->writeToXml());
+    value::Value* v3 = vpz::Vpz::parseValue(xml);
+    BOOST_REQUIRE_EQUAL(value::toBinary(*v3), binary);
+
+    const value::Matrix& m = value::toMapValue(v2)->getMatrix("matrix");
+    BOOST_REQUIRE_EQUAL(m.resizeColumn(), 2u);
+    BOOST_REQUIRE_EQUAL(m.resizeRow(), 3u);
+    BOOST_REQUIRE_EQUAL(m.matrix().shape()[0], 4u);
+    BOOST_REQUIRE(not m.get(1, 0));
+
+    delete v;
+    delete v2;
+    delete v3;
+}
+
+BOOST_AUTO_TEST_CASE(value_numbers_bulk)
+{
+    std::string t1("<?xml version=\"1.0\"?>\n<tuple>\n");
+    for (int i = 0; i < 10000; ++i) {
+        t1 += boost::lexical_cast < std::string >(i * 0.5);
+        t1 += (i % 7 == 0) ? "\n\t" : "  ";
+    }
+    t1 += "</tuple>\n";
+
+    value::Tuple* v = value::toTupleValue(vpz::Vpz::parseValue(t1));
+    BOOST_REQUIRE_EQUAL(v->size(), (size_t)10000);
+    for (int i = 0; i < 10000; ++i) {
+        BOOST_REQUIRE_EQUAL(v->operator[](i), i * 0.5);
+    }
+    delete v;
+
+    std::string t2("<?xml version=\"1.0\"?>\n"
+                   "<table width=\"7\" height=\"1000\">");
+    for (int i = 0; i < 7000; ++i) {
+        t2 += boost::lexical_cast < std::string >(i);
+        t2 += (i % 7 == 6) ? "\r\n" : " ";
+    }
+    t2 += "</table>\n";
+
+    value::Table* w = value::toTableValue(vpz::Vpz::parseValue(t2));
+    for (int i = 0; i < 7000; ++i) {
+        BOOST_REQUIRE_EQUAL(w->get(i % 7, i / 7), (double)i);
+    }
+    delete w;
+
+    const char* t3 = "<?xml version=\"1.0\"?>\n"
+        "<table width=\"2\" height=\"3\">1 2 3 4 5</table>";
+    BOOST_CHECK_THROW(vpz::Vpz::parseValue(t3), std::exception);
+
+    const char* t4 = "<?xml version=\"1.0\"?>\n"
+        "<tuple>1 2 x 4</tuple>";
+    BOOST_CHECK_THROW(vpz::Vpz::parseValue(t4), std::exception);
+
+    const char* t5 = "<?xml version=\"1.0\"?>\n"
+        "<set><integer>1</integer><null /><double>2.5</double></set>";
+    value::Set* s = value::toSetValue(vpz::Vpz::parseValue(t5));
+    BOOST_REQUIRE_EQUAL(s->size(), (size_t)3);
+    BOOST_REQUIRE(s->get(1)->isNull());
+    BOOST_REQUIRE_EQUAL(value::toDouble(s->get(2)), 2.5);
+    delete s;
+}
@@ -37,6 +37,7 @@
 #include <vle/vpz/Vpz.hpp>
 #include <vle/vpz/AtomicModel.hpp>
 #include <vle/vpz/CoupledModel.hpp>
+#include <vle/vpz/Cache.hpp>
 #include <vle/value/Set.hpp>
 #include <vle/value/Integer.hpp>
 #include <vle/value/Double.hpp>
@@ -45,6 +46,8 @@
 #include <limits>
 #include <fstream>
 #include <iostream>
+#include <sstream>
+#include <cstdio>
 
 
 struct F
@@ -307,6 +310,35 @@ BOOST_AUTO_TEST_CASE(experiment_vpz)
     }
 }
 
+BOOST_AUTO_TEST_CASE(experiment_clear)
+{
+    vpz::Experiment experiment;
+    experiment.setName("test1");
+    experiment.setDuration(10.0);
+    experiment.setBegin(2.0);
+    experiment.setCombination("sampled");
+    experiment.setSamples(12);
+    experiment.setScheduler("calendar");
+    experiment.setThreads(4);
+    experiment.setPartitions(3);
+    experiment.setPartitioning("roundrobin");
+    experiment.setSeed(123);
+
+    experiment.clear();
+
+    vpz::Experiment empty;
+    BOOST_REQUIRE_EQUAL(experiment.name(), empty.name());
+    BOOST_REQUIRE_EQUAL(experiment.duration(), empty.duration());
+    BOOST_REQUIRE_EQUAL(experiment.begin(), empty.begin());
+    BOOST_REQUIRE_EQUAL(experiment.combination(), empty.combination());
+    BOOST_REQUIRE_EQUAL(experiment.samples(), empty.samples());
+    BOOST_REQUIRE_EQUAL(experiment.scheduler(), empty.scheduler());
+    BOOST_REQUIRE_EQUAL(experiment.threads(), empty.threads());
+    BOOST_REQUIRE_EQUAL(experiment.partitions(), empty.partitions());
+    BOOST_REQUIRE_EQUAL(experiment.partitioning(), empty.partitioning());
+    BOOST_REQUIRE_EQUAL(experiment.seed(), empty.seed());
+}
+
 BOOST_AUTO_TEST_CASE(experiment_measures_vpz)
 {
     const char* xml=
@@ -425,6 +457,140 @@ BOOST_AUTO_TEST_CASE(experiment_measures_vpz)
     }
 }
 
+BOOST_AUTO_TEST_CASE(cache_vpz)
+{
+    const char* xml=
+        "<?xml version=\"1.0\"?>\n"
+        "<vle_project version=\"1.0\" author=\"Gauthier Quesnel\""
+        " date=\"Mon, 12 Feb 2007 23:40:31 +0100\" >\n"
+        " <structures>\n"
+        "  <model name=\"top\" type=\"coupled\" x=\"1\" y=\"2\">\n"
+        "   <in><port name=\"i\" /></in>\n"
+        "   <out><port name=\"o\" /></out>\n"
+        "   <submodels>\n"
+        "    <model name=\"a\" type=\"atomic\" conditions=\"c1,c2\""
+        "           dynamics=\"d1\" observables=\"obs\" >\n"
+        "     <in><port name=\"in\" /></in>\n"
+        "     <out><port name=\"out\" /></out>\n"
+        "    </model>\n"
+        "    <model name=\"b\" type=\"atomic\" dynamics=\"d1\" >\n"
+        "     <in><port name=\"in\" /></in>\n"
+        "     <out><port name=\"out\" /></out>\n"
+        "    </model>\n"
+        "   </submodels>\n"
+        "   <connections>\n"
+        "    <connection type=\"input\">\n"
+        "     <origin model=\"top\" port=\"i\" />\n"
+        "     <destination model=\"a\" port=\"in\" />\n"
+        "    </connection>\n"
+        "    <connection type=\"internal\">\n"
+        "     <origin model=\"a\" port=\"out\" />\n"
+        "     <destination model=\"b\" port=\"in\" />\n"
+        "    </connection>\n"
+        "    <connection type=\"output\">\n"
+        "     <origin model=\"b\" port=\"out\" />\n"
+        "     <destination model=\"top\" port=\"o\" />\n"
+        "    </connection>\n"
+        "   </connections>\n"
+        "  </model>\n"
+        " </structures>\n"
+        " <dynamics>\n"
+        "  <dynamic name=\"d1\" library=\"lib\" package=\"pkg\" />\n"
+        " </dynamics>\n"
+        " <classes>\n"
+        "  <class name=\"cls\">\n"
+        "   <model name=\"c\" type=\"atomic\" dynamics=\"d1\" />\n"
+        "  </class>\n"
+        " </classes>\n"
+        " <experiment name=\"exp\" duration=\"10\" begin=\"2\""
+        "             combination=\"linear\" seed=\"17\">\n"
+        "  <conditions>\n"
+        "   <condition name=\"c1\">\n"
+        "    <port name=\"x\"><double>1.5</double><integer>3</integer>"
+        "</port>\n"
+        "    <port name=\"y\"><map><key name=\"k\"><string>v</string></key>"
+        "</map></port>\n"
+        "   </condition>\n"
+        "   <condition name=\"c2\">\n"
+        "    <port name=\"z\"><tuple>1 2 3</tuple></port>\n"
+        "   </condition>\n"
+        "  </conditions>\n"
+        "  <views>\n"
+        "   <outputs>\n"
+        "    <output name=\"o1\" format=\"local\" plugin=\"storage\""
+        "            package=\"vle.output\" >\n"
+        "     <map><key name=\"rows\"><integer>5</integer></key></map>\n"
+        "    </output>\n"
+        "    <output name=\"o2\" format=\"distant\" plugin=\"file\""
+        "            location=\"127.0.0.1:8888\" />\n"
+        "   </outputs>\n"
+        "   <observables>\n"
+        "    <observable name=\"obs\">\n"
+        "     <port name=\"p\"><attachedview name=\"v1\" />"
+        "<attachedview name=\"v2\" /></port>\n"
+        "     <port name=\"q\" />\n"
+        "    </observable>\n"
+        "   </observables>\n"
+        "   <view name=\"v1\" type=\"timed\" timestep=\"0.5\" output=\"o1\" />\n"
+        "   <view name=\"v2\" type=\"event\" output=\"o2\" />\n"
+        "  </views>\n"
+        " </experiment>\n"
+        "</vle_project>\n";
+
+    const std::string filename("cache_vpz.vpz");
+    {
+        std::ofstream out(filename.c_str());
+        out << xml;
+    }
+
+    vpz::Vpz vpz(filename);
+    BOOST_REQUIRE_EQUAL(vpz::Cache::filename(filename), "cache_vpz.vpzc");
+
+    vpz::Vpz missing;
+    std::remove(vpz::Cache::filename(filename).c_str());
+    BOOST_REQUIRE(not vpz::Cache::load(missing, filename));
+    BOOST_REQUIRE(missing.project().model().model() == 0);
+
+    vpz::Cache::save(vpz, filename);
+
+    vpz::Vpz cached;
+    BOOST_REQUIRE(vpz::Cache::load(cached, filename));
+    BOOST_REQUIRE_EQUAL(cached.filename(), filename);
+    BOOST_REQUIRE_EQUAL(cached.writeToString(), vpz.writeToString());
+    BOOST_REQUIRE_EQUAL(cached.project().experiment().seed(), 17u);
+
+    const vpz::CoupledModel* top = dynamic_cast < const vpz::CoupledModel* >(
+        cached.project().model().model());
+    BOOST_REQUIRE(top);
+    BOOST_REQUIRE_EQUAL(top->getModelList().size(),
+                        (vpz::ModelList::size_type)2);
+    BOOST_REQUIRE(top->existInternalConnection("a", "out", "b", "in"));
+
+    {
+        std::ostringstream image;
+        vpz::Cache::write(vpz, 0, 0, image);
+        const std::string str(image.str());
+
+        for (std::string::size_type i = 0; i < str.size(); i += 7) {
+            vpz::Vpz truncated;
+            BOOST_REQUIRE_THROW(vpz::Cache::read(truncated, str.data(), i),
+                                utils::FileError);
+            BOOST_REQUIRE(truncated.project().model().model() == 0);
+        }
+    }
+
+    {
+        std::ofstream out(filename.c_str(), std::ios::app);
+        out << "\n";
+    }
+
+    vpz::Vpz stale;
+    BOOST_REQUIRE(not vpz::Cache::load(stale, filename));
+
+    std::remove(vpz::Cache::filename(filename).c_str());
+    std::remove(filename.c_str());
+}
+
 BOOST_AUTO_TEST_CASE(translator_vpz)
 {
 }